@@ -0,0 +1,49 @@
+#version 430
+
+#include "../fragments/fs_common_inputs.glsl"
+
+// We output a single color to the color buffer
+layout(location = 0) out vec4 frag_color;
+
+////////////////////////////////////////////////////////////////
+/////////////// Instance Level Uniforms ////////////////////////
+////////////////////////////////////////////////////////////////
+
+// Same as frag_blinn_phong_textured, but the diffuse texture is a page in a
+// texture array shared by several materials, and u_TextureLayer selects the
+// layer for the current instance (see TextureArrayBuilder)
+struct Material {
+	sampler2DArray Diffuse;
+	float          Shininess;
+};
+// Create a uniform for the material
+uniform Material u_Material;
+
+////////////////////////////////////////////////////////////////
+///////////// Application Level Uniforms ///////////////////////
+////////////////////////////////////////////////////////////////
+
+#include "../fragments/multiple_point_lights.glsl"
+
+////////////////////////////////////////////////////////////////
+/////////////// Frame Level Uniforms ///////////////////////////
+////////////////////////////////////////////////////////////////
+
+#include "../fragments/frame_uniforms.glsl"
+
+// https://learnopengl.com/Advanced-Lighting/Advanced-Lighting
+void main() {
+	// Normalize our input normal
+	vec3 normal = normalize(inNormal);
+
+	// Use the lighting calculation that we included from our partial file
+	vec3 lightAccumulation = CalcAllLightContribution(inWorldPos, normal, u_CamPos.xyz, u_Material.Shininess);
+
+	// Get the albedo from this instance's layer of the diffuse array
+	vec4 textureColor = texture(u_Material.Diffuse, vec3(inUV, u_TextureLayer));
+
+	// combine for the final result
+	vec3 result = lightAccumulation  * inColor * textureColor.rgb;
+
+	frag_color = vec4(result, textureColor.a);
+}
\ No newline at end of file
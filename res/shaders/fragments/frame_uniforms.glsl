@@ -20,4 +20,6 @@ layout (std140, binding = 1) uniform b_InstanceLevelUniforms {
     uniform mat4 u_Model;
     // Normal Matrix for transforming normals
     uniform mat4 u_NormalMatrix;
+    // The layer to sample from when the material uses texture arrays
+    uniform int  u_TextureLayer;
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "IComponent.h"
 #include <typeindex>
 #include <optional>
+#include <algorithm>
 
 namespace Gameplay {
 	/// <summary>
@@ -206,6 +207,32 @@ namespace Gameplay {
 			}
 		}
 
+		/// <summary>
+		/// Sorts all components of the given type, which changes the order that Each will visit them in.
+		/// Uses a stable sort, so components that compare equal keep their relative order
+		/// </summary>
+		/// <typeparam name="ComponentType">The type of component to sort</typeparam>
+		/// <param name="comparison">A function that returns true if the first component should come before the second</param>
+		template <
+			typename ComponentType,
+			typename = typename std::enable_if<std::is_base_of<IComponent, ComponentType>::value>::type>
+		static void Sort(std::function<bool(const std::shared_ptr<ComponentType>&, const std::shared_ptr<ComponentType>&)> comparison) {
+			// We can use typeid and type_index to get a unique ID for our types
+			std::type_index type = std::type_index(typeid(ComponentType));
+			LOG_ASSERT(_TypeLoadRegistry[type] != nullptr, "You must register component types before creating them!");
+
+			std::vector<std::weak_ptr<IComponent>>& componentStore = _Components[type];
+			std::stable_sort(componentStore.begin(), componentStore.end(), [&](const std::weak_ptr<IComponent>& a, const std::weak_ptr<IComponent>& b) {
+				std::shared_ptr<IComponent> left = a.lock();
+				std::shared_ptr<IComponent> right = b.lock();
+				// Expired components get moved to the end
+				if (left == nullptr || right == nullptr) {
+					return left != nullptr && right == nullptr;
+				}
+				return comparison(std::dynamic_pointer_cast<ComponentType>(left), std::dynamic_pointer_cast<ComponentType>(right));
+			});
+		}
+
 		/// <summary>
 		/// Attempts to register a given type as a component, should be called for each component type 
 		/// at the start of you application
@@ -5,25 +5,26 @@
 
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
+#include "Gameplay/InputEngine.h"
 #include "Utils/JsonGlmHelpers.h"
 #include "Utils/ImGuiHelper.h"
 
 ControllerInput::ControllerInput()
 	: IComponent(),
-	_controllerConnected(false)
+	_controllerConnected(false),
+	_controllerID(GLFW_JOYSTICK_1)
 { }
 
 ControllerInput::~ControllerInput() = default;
 
 void ControllerInput::Awake()
 {
-	_window = GetGameObject()->GetScene()->Window;
 }
 
 void ControllerInput::Update(float deltaTime)
 {
-
-	_controllerConnected = glfwJoystickPresent(_controllerID);
+	// Read through the input engine so that gamepads can be recorded and replayed
+	_controllerConnected = InputEngine::IsGamepadConnected(_controllerID);
 }
 
 void ControllerInput::RenderImGui()
@@ -48,19 +49,15 @@ bool ControllerInput::IsValid()
 void ControllerInput::SetController(int ID)
 {
 	_controllerID = ID;
-	_controllerConnected = glfwJoystickPresent(ID);
+	_controllerConnected = InputEngine::IsGamepadConnected(ID);
 }
 
 bool ControllerInput::GetButtonDown(int ID)
 {
-	auto buttons = glfwGetJoystickButtons(_controllerID, &_buttonCount);
-
-	return buttons[ID];
+	return InputEngine::GetGamepadButton(_controllerID, ID);
 }
 
 float ControllerInput::GetAxisValue(int ID)
 {
-	auto axes = glfwGetJoystickAxes(_controllerID, &_axesCount);
-
-	return axes[ID];
+	return InputEngine::GetGamepadAxis(_controllerID, ID);
 }
\ No newline at end of file
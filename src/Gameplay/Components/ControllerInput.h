@@ -1,8 +1,6 @@
 #pragma once
 #include "IComponent.h"
 
-struct GLFWwindow;
-
 class ControllerInput : public Gameplay::IComponent
 {
 public:
@@ -31,11 +29,5 @@ public:
 protected:
 	bool _controllerConnected = false;
 	int _controllerID;
-	int _buttonCount;
-	int _axesCount;
-
-	unsigned char* buttonList;
-
-	GLFWwindow* _window;
 };
 
@@ -5,6 +5,7 @@
 
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
+#include "Gameplay/InputEngine.h"
 #include "Utils/JsonGlmHelpers.h"
 #include "Utils/ImGuiHelper.h"
 #include "Gameplay/GameObject.h"
@@ -26,8 +27,6 @@ FirstPersonCamera::~FirstPersonCamera() = default;
 
 void FirstPersonCamera::Awake()
 {
-	_window = GetGameObject()->GetScene()->Window;
-
 	_controller = GetComponent<ControllerInput>();
 	
 	if (_controller == nullptr)
@@ -59,9 +58,9 @@ void FirstPersonCamera::Update(float deltaTime)
 
 	//Else, use KBM
 	else {
-		if (glfwGetMouseButton(_window, 0)) {
+		if (InputEngine::IsMouseButtonDown(GLFW_MOUSE_BUTTON_LEFT)) {
 			if (_isMousePressed == false) {
-				glfwGetCursorPos(_window, &_prevMousePos.x, &_prevMousePos.y);
+				_prevMousePos = InputEngine::GetMousePos();
 			}
 			_isMousePressed = true;
 		}
@@ -70,8 +69,7 @@ void FirstPersonCamera::Update(float deltaTime)
 		}
 
 		if (_isMousePressed) {
-			glm::dvec2 currentMousePos;
-			glfwGetCursorPos(_window, &currentMousePos.x, &currentMousePos.y);
+			glm::dvec2 currentMousePos = InputEngine::GetMousePos();
 
 			_currentRot.x += static_cast<float>(currentMousePos.x - _prevMousePos.x) * _mouseSensitivity.x;
 			_currentRot.y += static_cast<float>(currentMousePos.y - _prevMousePos.y) * _mouseSensitivity.y;
@@ -2,8 +2,6 @@
 #include "IComponent.h"
 #include "Gameplay/Components/ControllerInput.h"
 
-struct GLFWwindow;
-
 /// <summary>
 /// A simple behaviour that allows movement of a gameobject with WASD, mouse,
 /// and ctrl + space
@@ -32,7 +30,6 @@ protected:
 	glm::vec2 _currentRot;
 
 	bool _isMousePressed = false;
-	GLFWwindow* _window;
 
 	ControllerInput::Sptr _controller;
 	glm::vec2 _controllerSensitivity;
@@ -7,6 +7,11 @@ namespace Gameplay {
 		return _context;
 	}
 
+	int IComponent::ProfilerZone() const {
+		static int zone = Profiler::RegisterZone("Component");
+		return zone;
+	}
+
 	std::weak_ptr<IComponent>& IComponent::SelfRef() {
 		return _weakSelfPtr;
 	}
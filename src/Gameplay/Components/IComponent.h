@@ -6,6 +6,7 @@
 #include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/ResourceManager/IResource.h"
 #include "Utils/TypeHelpers.h"
+#include "Utils/Profiler.h"
 
 namespace Gameplay {
 	// We pre-declare GameObject to avoid circular dependencies in the headers
@@ -65,6 +66,19 @@ namespace Gameplay {
 		/// <param name="body"></param>
 		virtual void OnTriggerVolumeLeaving(const std::shared_ptr<Physics::RigidBody>& body) {};
 
+		/// <summary>
+		/// Invoked when the rigidbody attached to the parent gameobject starts touching
+		/// another rigidbody
+		/// </summary>
+		/// <param name="body">The body that we have started touching</param>
+		virtual void OnCollisionEntered(const std::shared_ptr<Physics::RigidBody>& body) {};
+		/// <summary>
+		/// Invoked when the rigidbody attached to the parent gameobject stops touching
+		/// another rigidbody
+		/// </summary>
+		/// <param name="body">The body that we are no longer touching</param>
+		virtual void OnCollisionLeaving(const std::shared_ptr<Physics::RigidBody>& body) {};
+
 		/// <summary>
 		/// Allows components to perform an action before child GUI items are rendered
 		/// </summary>
@@ -98,6 +112,13 @@ namespace Gameplay {
 		/// <param name="deltaTime">The time since the last frame, in seconds</param>
 		virtual void Update(float deltaTime) {};
 
+		/// <summary>
+		/// Invoked once for every fixed simulation step, before physics is stepped. Use this
+		/// for gameplay that needs to run at a consistent rate, such as applying forces
+		/// </summary>
+		/// <param name="fixedDeltaTime">The length of a simulation step, in seconds</param>
+		virtual void FixedUpdate(float fixedDeltaTime) {};
+
 		/// <summary>
 		/// All components should override this to allow us to render component
 		/// info in ImGui for easy editing
@@ -112,6 +133,12 @@ namespace Gameplay {
 		/// </summary>
 		virtual std::string ComponentTypeName() const = 0;
 
+		/// <summary>
+		/// Returns the profiler zone that this component's updates are timed under, one per component type.
+		/// This is also implemented by MAKE_TYPENAME
+		/// </summary>
+		virtual int ProfilerZone() const;
+
 		/// <summary>
 		/// Gets the gameobject that this component is attached to
 		/// </summary>
@@ -182,4 +209,6 @@ namespace Gameplay {
 // Defines the ComponentTypeName interface to match those used elsewhere by other systems
 #define MAKE_TYPENAME(T) \
 	inline virtual std::string ComponentTypeName() const { \
-		static std::string name = StringTools::SanitizeClassName(typeid(T).name()); return name; }
+		static std::string name = StringTools::SanitizeClassName(typeid(T).name()); return name; } \
+	inline virtual int ProfilerZone() const { \
+		static int zone = Profiler::RegisterZone(#T); return zone; }
@@ -2,6 +2,7 @@
 #include <GLFW/glfw3.h>
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
+#include "Gameplay/InputEngine.h"
 #include "Utils/ImGuiHelper.h"
 
 void JumpBehaviour::Awake()
@@ -72,7 +73,7 @@ void JumpBehaviour::Update(float deltaTime) {
 	//Else, use the keyboard
 	else
 	{
-		if (glfwGetKey(GetGameObject()->GetScene()->Window, GLFW_KEY_SPACE) && _onGround)
+		if (InputEngine::IsKeyDown(GLFW_KEY_SPACE) && _onGround)
 		{
 			_body->ApplyImpulse(glm::vec3(0.0f, 0.0f, _impulse));
 			_startingJump = true;
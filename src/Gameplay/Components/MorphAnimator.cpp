@@ -16,7 +16,6 @@ MorphAnimator::~MorphAnimator() = default;
 
 void MorphAnimator::Awake()
 {
-	thisObject = this->GetComponent<RenderComponent>()->GetMesh();
 }
 
 void MorphAnimator::Update(float deltaTime)
@@ -55,9 +54,24 @@ void MorphAnimator::Update(float deltaTime)
 		}
 	}
 
+	morphState.frame0 = currentClip.frames[currentClip.currentFrame];
+	morphState.frame1 = currentClip.frames[currentClip.nextFrame];
+	morphState.t = t;
+}
+
+const MorphAnimator::MorphState& MorphAnimator::GetMorphState() const
+{
+	return morphState;
+}
+
+void MorphAnimator::ApplyMorph(const MorphState& state, const VertexArrayObject::Sptr& mesh, const Gameplay::Material::Sptr& material)
+{
+	if (state.frame0 == nullptr || state.frame1 == nullptr || mesh == nullptr)
+		return;
+
 	//This shit whack
-	std::vector<BufferAttribute> pos0 = currentClip.frames[currentClip.currentFrame]->Mesh->GetBufferBinding(AttribUsage::Position)->Attributes;
-	std::vector<BufferAttribute> pos1 = currentClip.frames[currentClip.nextFrame]->Mesh->GetBufferBinding(AttribUsage::Position)->Attributes;
+	std::vector<BufferAttribute> pos0 = state.frame0->Mesh->GetBufferBinding(AttribUsage::Position)->Attributes;
+	std::vector<BufferAttribute> pos1 = state.frame1->Mesh->GetBufferBinding(AttribUsage::Position)->Attributes;
 
 	//Resize the buffer attributes of the first frame to only hold the position
 	pos0.resize(1);
@@ -67,11 +81,12 @@ void MorphAnimator::Update(float deltaTime)
 	//Resize this frame's buffer attributes to only hold the position as well
 	pos1.resize(1);
 
-	thisObject->AddVertexBuffer(currentClip.frames[currentClip.currentFrame]->Mesh->GetBufferBinding(AttribUsage::Position)->Buffer, pos0);
-	thisObject->AddVertexBuffer(currentClip.frames[currentClip.nextFrame]->Mesh->GetBufferBinding(AttribUsage::Position)->Buffer, pos1);
+	mesh->AddVertexBuffer(state.frame0->Mesh->GetBufferBinding(AttribUsage::Position)->Buffer, pos0);
+	mesh->AddVertexBuffer(state.frame1->Mesh->GetBufferBinding(AttribUsage::Position)->Buffer, pos1);
 
 	//Pass the lerp param as a uniform
-	this->GetComponent<RenderComponent>()->GetMaterial()->Set("t", t);
+	if (material != nullptr)
+		material->Set("t", state.t);
 }
 
 void MorphAnimator::AddClip(std::vector<Gameplay::MeshResource::Sptr> inFrames, float dur, std::string inName)
@@ -23,6 +23,21 @@ public:
 
 	std::string GetActiveAnim();
 
+	//The frames to blend between and how far along we are, the mesh itself is only
+	//touched on the render thread (see ApplyMorph) so that Update can run on any thread
+	struct MorphState
+	{
+		Gameplay::MeshResource::Sptr frame0;
+		Gameplay::MeshResource::Sptr frame1;
+		float t = 0.0f;
+	};
+
+	const MorphState& GetMorphState() const;
+
+	//Binds the morph frames to the mesh and passes the blend to the material, must be called
+	//from the thread that owns the GL context
+	static void ApplyMorph(const MorphState& state, const VertexArrayObject::Sptr& mesh, const Gameplay::Material::Sptr& material);
+
 	//Holds the info for an animation clip
 	struct animInfo
 	{
@@ -48,9 +63,8 @@ public:
 
 protected:
 
-	VertexArrayObject::Sptr thisObject;
-
 	animInfo currentClip;
+	MorphState morphState;
 
 	float timer;
 
@@ -5,6 +5,7 @@
 
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
+#include "Gameplay/InputEngine.h"
 #include "Utils/JsonGlmHelpers.h"
 #include "Utils/ImGuiHelper.h"
 #include "Gameplay/GameObject.h"
@@ -29,8 +30,6 @@ PlayerControl::~PlayerControl() = default;
 
 void PlayerControl::Awake()
 {
-	_window = GetGameObject()->GetScene()->Window;
-
 	_controller = GetComponent<ControllerInput>();
 
 	if (_controller == nullptr)
@@ -143,9 +142,9 @@ void PlayerControl::Update(float deltaTime)
 	//Else, use KBM
 	else
 	{
-		if (glfwGetMouseButton(_window, 0)) {
+		if (InputEngine::IsMouseButtonDown(GLFW_MOUSE_BUTTON_LEFT)) {
 			if (_isMousePressed == false) {
-				glfwGetCursorPos(_window, &_prevMousePos.x, &_prevMousePos.y);
+				_prevMousePos = InputEngine::GetMousePos();
 			}
 			_isMousePressed = true;
 		}
@@ -154,8 +153,7 @@ void PlayerControl::Update(float deltaTime)
 		}
 
 		if (_isMousePressed) {
-			glm::dvec2 currentMousePos;
-			glfwGetCursorPos(_window, &currentMousePos.x, &currentMousePos.y);
+			glm::dvec2 currentMousePos = InputEngine::GetMousePos();
 
 			_currentRot.x += static_cast<float>(currentMousePos.x - _prevMousePos.x) * _mouseSensitivity.x;
 			_currentRot.y += static_cast<float>(currentMousePos.y - _prevMousePos.y) * _mouseSensitivity.y;
@@ -167,22 +165,22 @@ void PlayerControl::Update(float deltaTime)
 			_prevMousePos = currentMousePos;
 
 			glm::vec3 input = glm::vec3(0.0f);
-			if (glfwGetKey(_window, GLFW_KEY_W)) {
+			if (InputEngine::IsKeyDown(GLFW_KEY_W)) {
 				input.z -= _moveSpeeds.x;
 			}
-			if (glfwGetKey(_window, GLFW_KEY_S)) {
+			if (InputEngine::IsKeyDown(GLFW_KEY_S)) {
 				input.z += _moveSpeeds.x;
 			}
-			if (glfwGetKey(_window, GLFW_KEY_A)) {
+			if (InputEngine::IsKeyDown(GLFW_KEY_A)) {
 				input.x -= _moveSpeeds.y;
 			}
-			if (glfwGetKey(_window, GLFW_KEY_D)) {
+			if (InputEngine::IsKeyDown(GLFW_KEY_D)) {
 				input.x += _moveSpeeds.y;
 			}
-			if (glfwGetKey(_window, GLFW_KEY_LEFT_CONTROL)) {
+			if (InputEngine::IsKeyDown(GLFW_KEY_LEFT_CONTROL)) {
 				input.y -= _moveSpeeds.z;
 			}
-			if (glfwGetKey(_window, GLFW_KEY_LEFT_SHIFT)) {
+			if (InputEngine::IsKeyDown(GLFW_KEY_LEFT_SHIFT)) {
 				input *= _shiftMultipler;
 			}
 
@@ -3,8 +3,6 @@
 #include "Gameplay/Components/ControllerInput.h"
 #include "BoomerangBehavior.h"
 
-struct GLFWwindow;
-
 /// <summary>
 /// A simple behaviour that allows movement of a gameobject with WASD, mouse,
 /// and ctrl + space
@@ -45,7 +43,6 @@ protected:
 	bool _isMoving = false;
 	bool _isSprinting = false;
 	float _spintVal = 5.0f;
-	GLFWwindow* _window;
 
 	ControllerInput::Sptr _controller;
 	glm::vec2 _controllerSensitivity;
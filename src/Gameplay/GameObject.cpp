@@ -28,6 +28,7 @@ namespace Gameplay {
 		_worldTransform(MAT4_IDENTITY),
 		_inverseWorldTransform(MAT4_IDENTITY),
 		_isWorldTransformDirty(true),
+		_transformVersion(0),
 		_parent(WeakRef()),
 		_children(std::vector<WeakRef>()),
 		_renderFlag(0)
@@ -102,9 +103,22 @@ namespace Gameplay {
 		}
 	}
 
+	void GameObject::OnCollisionEntered(const std::shared_ptr<Physics::RigidBody>& body) {
+		for (auto& component : _components) {
+			component->OnCollisionEntered(body);
+		}
+	}
+
+	void GameObject::OnCollisionLeaving(const std::shared_ptr<Physics::RigidBody>& body) {
+		for (auto& component : _components) {
+			component->OnCollisionLeaving(body);
+		}
+	}
+
 	void GameObject::SetPosition(const glm::vec3& position) {
 		_position = position;
 		_isLocalTransformDirty = true;
+		_transformVersion++;
 	}
 
 	const glm::vec3& GameObject::GetPosition() const {
@@ -114,6 +128,7 @@ namespace Gameplay {
 	void GameObject::SetRotation(const glm::quat& value) {
 		_rotation = value;
 		_isLocalTransformDirty = true;
+		_transformVersion++;
 	}
 
 	const glm::quat& GameObject::GetRotation() const {
@@ -123,6 +138,7 @@ namespace Gameplay {
 	void GameObject::SetRotation(const glm::vec3& eulerAngles) {
 		_rotation = glm::quat(glm::radians(eulerAngles));
 		_isLocalTransformDirty = true;
+		_transformVersion++;
 	}
 
 	glm::vec3 GameObject::GetRotationEuler() const {
@@ -132,12 +148,17 @@ namespace Gameplay {
 	void GameObject::SetScale(const glm::vec3& value) {
 		_scale = value;
 		_isLocalTransformDirty = true;
+		_transformVersion++;
 	}
 
 	const glm::vec3& GameObject::GetScale() const {
 		return _scale;
 	}
 
+	uint32_t GameObject::GetTransformVersion() const {
+		return _transformVersion;
+	}
+
 	const glm::mat4& GameObject::GetTransform() const {
 		_RecalcWorldTransform();
 		return _worldTransform;
@@ -193,6 +214,7 @@ namespace Gameplay {
 	void GameObject::Update(float dt) {
 		for (auto& component : _components) {
 			if (component->IsEnabled) {
+				PROFILE_ZONE(component->ProfilerZone());
 				component->Update(dt);
 			}
 		}
@@ -202,6 +224,15 @@ namespace Gameplay {
 		_PurgeDeletedChildren();
 	}
 
+	void GameObject::FixedUpdate(float fixedDeltaTime) {
+		for (auto& component : _components) {
+			if (component->IsEnabled) {
+				PROFILE_ZONE(component->ProfilerZone());
+				component->FixedUpdate(fixedDeltaTime);
+			}
+		}
+	}
+
 	bool GameObject::Has(const std::type_index& type) {
 		// Iterate over all the pointers in the components list
 		for (const auto& ptr : _components) {
@@ -334,7 +365,10 @@ namespace Gameplay {
 			}
 
 			// Render position label
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Position", &_position.x, 0.01f);
+			if (LABEL_LEFT(ImGui::DragFloat3, "Position", &_position.x, 0.01f)) {
+				_isLocalTransformDirty = true;
+				_transformVersion++;
+			}
 			
 			// Get the ImGui storage state so we can avoid gimbal locking issues by storing euler angles in the editor
 			glm::vec3 euler = GetRotationEuler();
@@ -360,7 +394,10 @@ namespace Gameplay {
 			}
 			
 			// Draw the scale
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &_scale.x, 0.01f, 0.0f);
+			if (LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &_scale.x, 0.01f, 0.0f)) {
+				_isLocalTransformDirty = true;
+				_transformVersion++;
+			}
 
 			ImGui::Separator();
 			ImGui::TextUnformatted("Components");
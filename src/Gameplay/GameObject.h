@@ -157,6 +157,19 @@ namespace Gameplay {
 		/// <param name="body">The body that has left our trigger volume</param>
 		void OnTriggerVolumeLeaving(const std::shared_ptr<Physics::RigidBody>& body);
 
+		/// <summary>
+		/// Invoked when the rigidbody attached to this game object (if any) starts
+		/// touching another rigidbody
+		/// </summary>
+		/// <param name="body">The body that we have started touching</param>
+		void OnCollisionEntered(const std::shared_ptr<Physics::RigidBody>& body);
+		/// <summary>
+		/// Invoked when the rigidbody attached to this game object (if any) stops
+		/// touching another rigidbody
+		/// </summary>
+		/// <param name="body">The body that we are no longer touching</param>
+		void OnCollisionLeaving(const std::shared_ptr<Physics::RigidBody>& body);
+
 		/// <summary>
 		/// Sets the game object's world position
 		/// </summary>
@@ -211,6 +224,12 @@ namespace Gameplay {
 		const glm::mat4& GetLocalTransform() const;
 		const glm::mat4& GetInverseLocalTransform() const;
 
+		/// <summary>
+		/// Gets a counter that is incremented whenever the object's position, rotation or scale
+		/// changes. Systems can store this and compare it later to cheaply detect changes
+		/// </summary>
+		uint32_t GetTransformVersion() const;
+
 		/// <summary>
 		/// Allows components to render GUI elements to the screen
 		/// </summary>
@@ -231,6 +250,11 @@ namespace Gameplay {
 		/// </summary>
 		/// <param name="deltaTime">The time since the last frame, in seconds</param>
 		void Update(float dt);
+		/// <summary>
+		/// Calls fixed update on all enabled components in this object
+		/// </summary>
+		/// <param name="fixedDeltaTime">The length of a simulation step, in seconds</param>
+		void FixedUpdate(float fixedDeltaTime);
 
 		/// <summary>
 		/// Checks whether this gameobject has a component of the given type
@@ -342,6 +366,9 @@ namespace Gameplay {
 		mutable glm::mat4 _inverseWorldTransform;
 		mutable bool _isWorldTransformDirty;
 
+		// Incremented on every position, rotation or scale change
+		uint32_t _transformVersion;
+
 		// For the hierarchy
 		WeakRef _parent;
 		std::vector<WeakRef> _children;
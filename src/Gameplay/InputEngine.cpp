@@ -1,6 +1,13 @@
 #include "Gameplay/InputEngine.h"
 #include <locale>
 #include <codecvt>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cfloat>
+#include <cmath>
+
+#include "Logging.h"
 
 GLFWwindow* InputEngine::__window = nullptr;
 glm::dvec2 InputEngine::__mousePos  = glm::dvec2(0.0);
@@ -10,14 +17,54 @@ std::wstring InputEngine::__inputText = LR"()";
 
 ButtonState InputEngine::__mouseState[GLFW_MOUSE_BUTTON_LAST + 1];
 ButtonState InputEngine::__keyState[GLFW_KEY_LAST + 1];
+InputEngine::GamepadState InputEngine::__gamepads[MAX_GAMEPADS];
+
+std::vector<uint16_t> InputEngine::__changedButtons;
+bool InputEngine::__isButtonChanged[NUM_BUTTONS];
+double InputEngine::__buttonEventTime[NUM_BUTTONS];
+double InputEngine::__sampleTime = 0.0;
+double InputEngine::__cursorEventTime = DBL_MAX;
+double InputEngine::__gamepadEventTime = DBL_MAX;
+
+InputEngine::Mode InputEngine::__mode = InputEngine::Mode::Live;
+std::string InputEngine::__recordingPath;
+std::vector<uint8_t> InputEngine::__frameData;
+size_t InputEngine::__frameCount = 0;
+size_t InputEngine::__readOffset = 0;
+size_t InputEngine::__replayFrame = 0;
+ButtonState InputEngine::__recordedButtons[NUM_BUTTONS];
+glm::dvec2 InputEngine::__recordedMousePos = glm::dvec2(0.0);
+InputEngine::GamepadState InputEngine::__recordedGamepads[MAX_GAMEPADS];
+
+// Appends the raw bytes of a value to the end of a recording
+template <typename T>
+static void WriteValue(std::vector<uint8_t>& data, const T& value) {
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+	data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+// Reads a value from a recording, returns false if the recording is truncated
+template <typename T>
+static bool ReadValue(const std::vector<uint8_t>& data, size_t& offset, T& value) {
+	if (offset + sizeof(T) > data.size()) {
+		return false;
+	}
+	memcpy(&value, data.data() + offset, sizeof(T));
+	offset += sizeof(T);
+	return true;
+}
 
 void InputEngine::Init(GLFWwindow* window)
 {
 	__window = window;
+	if (__window == nullptr) {
+		return;
+	}
 	glfwSetCharCallback(__window, InputEngine::__CharCallback);
 	glfwSetMouseButtonCallback(__window, InputEngine::__MouseButtonCallback);
 	glfwSetKeyCallback(__window, InputEngine::__KeyCallback);
 	glfwSetScrollCallback(__window, InputEngine::__MouseScrollCallback);
+	glfwSetCursorPosCallback(__window, InputEngine::__CursorPosCallback);
 }
 
 ButtonState InputEngine::GetKeyState(int keyCode) {
@@ -45,8 +92,59 @@ const glm::dvec2& InputEngine::GetMouseDelta() {
 	return __mousePos - __prevMousePos;
 }
 
+const glm::dvec2& InputEngine::GetScrollDelta() {
+	return __scrollDelta;
+}
+
+double InputEngine::GetSampleTime() {
+	return __sampleTime;
+}
+
+double InputEngine::GetKeyEventTime(int keyCode) {
+	return (keyCode >= 0 && keyCode <= GLFW_KEY_LAST) ? __buttonEventTime[keyCode] : 0.0;
+}
+
+double InputEngine::GetMouseEventTime(int button) {
+	return (button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST) ? __buttonEventTime[GLFW_KEY_LAST + 1 + button] : 0.0;
+}
+
+double InputEngine::GetOldestEventTime() {
+	double result = std::min(__sampleTime, std::min(__cursorEventTime, __gamepadEventTime));
+	for (uint16_t button : __changedButtons) {
+		result = std::min(result, __buttonEventTime[button]);
+	}
+	return result;
+}
+
+bool InputEngine::HasInputEvents() {
+	if (__mode == Mode::Replaying) {
+		return false;
+	}
+	return !__changedButtons.empty() || __cursorEventTime != DBL_MAX || __gamepadEventTime != DBL_MAX;
+}
+
+bool InputEngine::IsGamepadConnected(int id) {
+	return (id >= 0 && id < MAX_GAMEPADS) ? __gamepads[id].Connected : false;
+}
+
+bool InputEngine::GetGamepadButton(int id, int button) {
+	if (!IsGamepadConnected(id) || button < 0 || button >= __gamepads[id].NumButtons) {
+		return false;
+	}
+	return __gamepads[id].Buttons[button] == GLFW_PRESS;
+}
+
+float InputEngine::GetGamepadAxis(int id, int axis) {
+	if (!IsGamepadConnected(id) || axis < 0 || axis >= __gamepads[id].NumAxes) {
+		return 0.0f;
+	}
+	return __gamepads[id].Axes[axis];
+}
+
 void InputEngine::SetCursorMode(CursorMode mode) {
-	glfwSetInputMode(__window, GLFW_CURSOR, *mode);
+	if (__window != nullptr) {
+		glfwSetInputMode(__window, GLFW_CURSOR, *mode);
+	}
 }
 
 std::wstring InputEngine::GetInputText() {
@@ -58,57 +156,432 @@ std::string InputEngine::GetInputTextAscii() {
 	return StringConvert.to_bytes(__inputText);
 }
 
+float InputEngine::BeginFrame(float dt) {
+	__sampleTime = __GetTime();
+
+	if (__mode == Mode::Replaying) {
+		if (__ReadFrame(dt)) {
+			__replayFrame++;
+			return dt;
+		}
+		LOG_INFO("Input replay finished after {} frames", __replayFrame);
+		StopReplay();
+	}
+
+	__SampleLive();
+	if (__mode == Mode::Recording) {
+		__WriteFrame(dt);
+	}
+	return dt;
+}
+
 void InputEngine::EndFrame() {
 	__prevMousePos = __mousePos;
-	glfwGetCursorPos(__window, &__mousePos.x, &__mousePos.y);
 
 	__scrollDelta.x = __scrollDelta.y = 0.0;
 	__inputText.clear();
+	__cursorEventTime = __gamepadEventTime = DBL_MAX;
 
 	// Since we used a bit field for our enum values, we can do a quick and
-	// to convert from pressed or released to down/up
-	for (int ix = 0; ix < GLFW_KEY_LAST + 1; ix++) {
-		__keyState[ix] = (ButtonState)(*__keyState[ix] & 0b01);
+	// to convert from pressed or released to down/up. Only buttons that got an
+	// event this frame can be in the pressed or released state
+	for (uint16_t button : __changedButtons) {
+		__Button(button) = (ButtonState)(*__Button(button) & 0b01);
+		// Replays go through the same conversion, so the next frame only needs to store real changes
+		__recordedButtons[button] = (ButtonState)(*__recordedButtons[button] & 0b01);
+		__isButtonChanged[button] = false;
+	}
+	__changedButtons.clear();
+}
+
+void InputEngine::StartRecording(const std::string& path) {
+	if (__mode == Mode::Replaying) {
+		LOG_WARN("Cannot record input while a replay is running");
+		return;
+	}
+
+	__mode = Mode::Recording;
+	__recordingPath = path;
+	__frameData.clear();
+	__frameCount = 0;
+
+	// Replays start from a clean state, so the first frame stores everything that differs from that
+	for (int ix = 0; ix < NUM_BUTTONS; ix++) {
+		__recordedButtons[ix] = ButtonState::Up;
+		if ((*__Button(ix) & 0b11) != 0 && !__isButtonChanged[ix]) {
+			__isButtonChanged[ix] = true;
+			__changedButtons.push_back((uint16_t)ix);
+		}
+	}
+	__recordedMousePos = glm::dvec2(0.0);
+	memset(__recordedGamepads, 0, sizeof(__recordedGamepads));
+}
+
+bool InputEngine::StopRecording() {
+	if (__mode != Mode::Recording) {
+		return false;
+	}
+	__mode = Mode::Live;
+
+	RecordingHeader header;
+	header.Version     = RECORDING_VERSION;
+	header.NumGamepads = MAX_GAMEPADS;
+	header.NumFrames   = (uint32_t)__frameCount;
+	header.DataSize    = (uint32_t)__frameData.size();
+
+	std::ofstream file(__recordingPath, std::ios::binary);
+	if (!file.is_open()) {
+		LOG_ERROR("Failed to open \"{}\" for writing the input recording", __recordingPath);
+		__frameData.clear();
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(&header), sizeof(RecordingHeader));
+	file.write(reinterpret_cast<const char*>(__frameData.data()), __frameData.size());
+	file.close();
+
+	LOG_INFO("Wrote {} frames of input ({:.2f} KB) to \"{}\"", __frameCount, __frameData.size() / 1024.0f, __recordingPath);
+	__frameData.clear();
+	__frameData.shrink_to_fit();
+	return true;
+}
+
+bool InputEngine::IsRecording() {
+	return __mode == Mode::Recording;
+}
+
+bool InputEngine::StartReplay(const std::string& path) {
+	if (__mode == Mode::Recording) {
+		LOG_WARN("Stopping the input recording to start a replay");
+		StopRecording();
+	}
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		LOG_ERROR("Failed to open input recording \"{}\"", path);
+		return false;
 	}
 
-	for (int ix = 0; ix < GLFW_MOUSE_BUTTON_LAST + 1; ix++) {
-		__mouseState[ix] = (ButtonState)(*__mouseState[ix] & 0b01);
+	RecordingHeader header;
+	char expected[4];
+	memcpy(expected, header.HeaderBytes, 4);
+	file.read(reinterpret_cast<char*>(&header), sizeof(RecordingHeader));
+	if (!file || memcmp(header.HeaderBytes, expected, 4) != 0) {
+		LOG_ERROR("\"{}\" is not an input recording", path);
+		return false;
 	}
+	if (header.Version != RECORDING_VERSION || header.NumGamepads != MAX_GAMEPADS) {
+		LOG_ERROR("Input recording \"{}\" was made with an incompatible version", path);
+		return false;
+	}
+
+	std::vector<uint8_t> data(header.DataSize);
+	file.read(reinterpret_cast<char*>(data.data()), header.DataSize);
+	if (!file) {
+		LOG_ERROR("Input recording \"{}\" is truncated", path);
+		return false;
+	}
+
+	__frameData  = std::move(data);
+	__frameCount = header.NumFrames;
+	__readOffset = 0;
+	__replayFrame = 0;
+	__ResetState();
+	__mode = Mode::Replaying;
+	LOG_INFO("Replaying {} frames of input from \"{}\"", __frameCount, path);
+	return true;
+}
+
+void InputEngine::StopReplay() {
+	if (__mode != Mode::Replaying) {
+		return;
+	}
+	__mode = Mode::Live;
+	__frameData.clear();
+	__frameData.shrink_to_fit();
+	// Don't leave anything from the replay held down
+	__ResetState();
+}
+
+bool InputEngine::IsReplaying() {
+	return __mode == Mode::Replaying;
+}
+
+size_t InputEngine::GetReplayFrame() {
+	return __replayFrame;
+}
+
+size_t InputEngine::GetReplayFrameCount() {
+	return __mode == Mode::Replaying ? __frameCount : 0;
+}
+
+size_t InputEngine::GetRecordedFrameCount() {
+	return __mode == Mode::Recording ? __frameCount : 0;
+}
+
+size_t InputEngine::GetRecordingSize() {
+	return __mode == Mode::Recording ? __frameData.size() : 0;
+}
+
+ButtonState& InputEngine::__Button(int index) {
+	return index <= GLFW_KEY_LAST ? __keyState[index] : __mouseState[index - (GLFW_KEY_LAST + 1)];
+}
+
+void InputEngine::__SetButton(int index, ButtonState state, double time) {
+	__Button(index) = state;
+	__buttonEventTime[index] = time;
+	if (!__isButtonChanged[index]) {
+		__isButtonChanged[index] = true;
+		__changedButtons.push_back((uint16_t)index);
+	}
+}
+
+double InputEngine::__GetTime() {
+	// GLFW isn't initialized when running headless
+	return __window != nullptr ? glfwGetTime() : 0.0;
+}
+
+void InputEngine::__SampleLive() {
+	// Headless, the only input we can get is from replays
+	if (__window == nullptr) {
+		return;
+	}
+
+	glfwGetCursorPos(__window, &__mousePos.x, &__mousePos.y);
+
+	// Gamepads are sampled once here so that every reader sees the same values for the whole frame
+	GamepadState previous[MAX_GAMEPADS];
+	memcpy(previous, __gamepads, sizeof(__gamepads));
+	memset(__gamepads, 0, sizeof(__gamepads));
+	for (int id = 0; id < MAX_GAMEPADS; id++) {
+		GamepadState& pad = __gamepads[id];
+		pad.Connected = glfwJoystickPresent(GLFW_JOYSTICK_1 + id) == GLFW_TRUE;
+		if (!pad.Connected) {
+			continue;
+		}
+
+		int count = 0;
+		const unsigned char* buttons = glfwGetJoystickButtons(GLFW_JOYSTICK_1 + id, &count);
+		pad.NumButtons = buttons != nullptr ? std::min(count, MAX_GAMEPAD_BUTTONS) : 0;
+		memcpy(pad.Buttons, buttons, pad.NumButtons);
+
+		const float* axes = glfwGetJoystickAxes(GLFW_JOYSTICK_1 + id, &count);
+		pad.NumAxes = axes != nullptr ? std::min(count, MAX_GAMEPAD_AXES) : 0;
+		memcpy(pad.Axes, axes, pad.NumAxes * sizeof(float));
+
+		// We only see gamepad changes when we poll, so the best time we have for them is now. Sticks are
+		// never perfectly still, so tiny axis changes aren't counted
+		bool changed = pad.NumButtons != previous[id].NumButtons || memcmp(pad.Buttons, previous[id].Buttons, pad.NumButtons) != 0;
+		for (int axis = 0; axis < pad.NumAxes && !changed; axis++) {
+			changed = std::abs(pad.Axes[axis] - previous[id].Axes[axis]) > GAMEPAD_AXIS_EVENT_THRESHOLD;
+		}
+		if (changed) {
+			__gamepadEventTime = std::min(__gamepadEventTime, __sampleTime);
+		}
+	}
+}
+
+void InputEngine::__ResetState() {
+	for (int ix = 0; ix < NUM_BUTTONS; ix++) {
+		__Button(ix) = ButtonState::Up;
+		__isButtonChanged[ix] = false;
+	}
+	__changedButtons.clear();
+	__mousePos = __prevMousePos = glm::dvec2(0.0);
+	__scrollDelta = glm::dvec2(0.0);
+	__inputText.clear();
+	memset(__gamepads, 0, sizeof(__gamepads));
+}
+
+// Frame layout:
+//     float    dt
+//     uint8    flags (FrameFlags)
+//     uint16   number of button changes, followed by that many (uint16 button, uint8 state)
+//     dvec2    mouse position           (FrameMouseMoved)
+//     dvec2    scroll delta             (FrameScrolled)
+//     uint16   length, uint32[length]   (FrameText)
+//     MAX_GAMEPADS x (uint8 connected, uint8 buttons, uint8 axes, uint8[buttons], float[axes]) (FrameGamepads)
+void InputEngine::__WriteFrame(float dt) {
+	WriteValue(__frameData, dt);
+	size_t flagsOffset = __frameData.size();
+	WriteValue(__frameData, (uint8_t)0);
+	uint8_t flags = 0;
+
+	size_t countOffset = __frameData.size();
+	WriteValue(__frameData, (uint16_t)0);
+	uint16_t numChanges = 0;
+	for (uint16_t button : __changedButtons) {
+		ButtonState state = __Button(button);
+		if (*state != *__recordedButtons[button]) {
+			WriteValue(__frameData, button);
+			WriteValue(__frameData, (uint8_t)*state);
+			__recordedButtons[button] = state;
+			numChanges++;
+		}
+	}
+	memcpy(__frameData.data() + countOffset, &numChanges, sizeof(uint16_t));
+
+	if (__mousePos != __recordedMousePos) {
+		flags |= FrameMouseMoved;
+		WriteValue(__frameData, __mousePos);
+		__recordedMousePos = __mousePos;
+	}
+
+	if (__scrollDelta != glm::dvec2(0.0)) {
+		flags |= FrameScrolled;
+		WriteValue(__frameData, __scrollDelta);
+	}
+
+	if (!__inputText.empty()) {
+		flags |= FrameText;
+		uint16_t length = (uint16_t)std::min(__inputText.size(), (size_t)UINT16_MAX);
+		WriteValue(__frameData, length);
+		for (uint16_t ix = 0; ix < length; ix++) {
+			WriteValue(__frameData, (uint32_t)__inputText[ix]);
+		}
+	}
+
+	// Gamepads are only stored when something on one of them changed
+	bool gamepadsChanged = false;
+	for (int id = 0; id < MAX_GAMEPADS && !gamepadsChanged; id++) {
+		const GamepadState& pad = __gamepads[id];
+		const GamepadState& prev = __recordedGamepads[id];
+		gamepadsChanged =
+			pad.Connected != prev.Connected ||
+			pad.NumButtons != prev.NumButtons ||
+			pad.NumAxes != prev.NumAxes ||
+			memcmp(pad.Buttons, prev.Buttons, pad.NumButtons) != 0 ||
+			memcmp(pad.Axes, prev.Axes, pad.NumAxes * sizeof(float)) != 0;
+	}
+	if (gamepadsChanged) {
+		flags |= FrameGamepads;
+		for (int id = 0; id < MAX_GAMEPADS; id++) {
+			const GamepadState& pad = __gamepads[id];
+			WriteValue(__frameData, (uint8_t)pad.Connected);
+			WriteValue(__frameData, (uint8_t)pad.NumButtons);
+			WriteValue(__frameData, (uint8_t)pad.NumAxes);
+			__frameData.insert(__frameData.end(), pad.Buttons, pad.Buttons + pad.NumButtons);
+			const uint8_t* axes = reinterpret_cast<const uint8_t*>(pad.Axes);
+			__frameData.insert(__frameData.end(), axes, axes + pad.NumAxes * sizeof(float));
+		}
+		memcpy(__recordedGamepads, __gamepads, sizeof(__gamepads));
+	}
+
+	__frameData[flagsOffset] = flags;
+	__frameCount++;
+}
+
+bool InputEngine::__ReadFrame(float& dt) {
+	if (__replayFrame >= __frameCount) {
+		return false;
+	}
+
+	size_t& offset = __readOffset;
+	uint8_t flags = 0;
+	uint16_t numChanges = 0;
+	if (!ReadValue(__frameData, offset, dt) || !ReadValue(__frameData, offset, flags) || !ReadValue(__frameData, offset, numChanges)) {
+		LOG_WARN("Input recording is truncated at frame {}", __replayFrame);
+		return false;
+	}
+
+	for (uint16_t ix = 0; ix < numChanges; ix++) {
+		uint16_t button = 0;
+		uint8_t state = 0;
+		if (!ReadValue(__frameData, offset, button) || !ReadValue(__frameData, offset, state) || button >= NUM_BUTTONS) {
+			LOG_WARN("Input recording is corrupt at frame {}", __replayFrame);
+			return false;
+		}
+		__SetButton(button, (ButtonState)(state & 0b11), __sampleTime);
+	}
+
+	bool valid = true;
+	if (flags & FrameMouseMoved) {
+		valid &= ReadValue(__frameData, offset, __mousePos);
+	}
+	if (flags & FrameScrolled) {
+		valid &= ReadValue(__frameData, offset, __scrollDelta);
+	}
+	if (valid && (flags & FrameText)) {
+		uint16_t length = 0;
+		valid &= ReadValue(__frameData, offset, length);
+		for (uint16_t ix = 0; valid && ix < length; ix++) {
+			uint32_t character = 0;
+			valid &= ReadValue(__frameData, offset, character);
+			__inputText.push_back((wchar_t)character);
+		}
+	}
+	if (valid && (flags & FrameGamepads)) {
+		memset(__gamepads, 0, sizeof(__gamepads));
+		for (int id = 0; valid && id < MAX_GAMEPADS; id++) {
+			GamepadState& pad = __gamepads[id];
+			uint8_t connected = 0, numButtons = 0, numAxes = 0;
+			valid &= ReadValue(__frameData, offset, connected) && ReadValue(__frameData, offset, numButtons) && ReadValue(__frameData, offset, numAxes);
+			valid &= numButtons <= MAX_GAMEPAD_BUTTONS && numAxes <= MAX_GAMEPAD_AXES;
+			valid &= offset + numButtons + numAxes * sizeof(float) <= __frameData.size();
+			if (valid) {
+				pad.Connected  = connected != 0;
+				pad.NumButtons = numButtons;
+				pad.NumAxes    = numAxes;
+				memcpy(pad.Buttons, __frameData.data() + offset, numButtons);
+				offset += numButtons;
+				memcpy(pad.Axes, __frameData.data() + offset, numAxes * sizeof(float));
+				offset += numAxes * sizeof(float);
+			}
+		}
+	}
+
+	if (!valid) {
+		LOG_WARN("Input recording is corrupt at frame {}", __replayFrame);
+	}
+	return valid;
 }
 
 
 void InputEngine::__KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-	if (key == GLFW_KEY_UNKNOWN)
+	if (key == GLFW_KEY_UNKNOWN || __mode == Mode::Replaying)
 		return;
 
 	switch (action) {
 		case GLFW_PRESS:
-			__keyState[key] = ButtonState::Pressed;
+			__SetButton(key, ButtonState::Pressed, glfwGetTime());
 			break;
 		case GLFW_RELEASE:
-			__keyState[key] = ButtonState::Released;
+			__SetButton(key, ButtonState::Released, glfwGetTime());
 			break;
-		default:
+		default:
 			break;
 	}
 }
 
 void InputEngine::__CharCallback(GLFWwindow* window, uint32_t keycode) {
+	if (__mode == Mode::Replaying)
+		return;
+
 	__inputText.push_back(keycode);
 }
 
 void InputEngine::__MouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
-	if (button > GLFW_MOUSE_BUTTON_LAST)
+	if (button > GLFW_MOUSE_BUTTON_LAST || __mode == Mode::Replaying)
 		return;
 
 	if (action == GLFW_PRESS) {
-		__mouseState[button] = ButtonState::Pressed;
+		__SetButton(GLFW_KEY_LAST + 1 + button, ButtonState::Pressed, glfwGetTime());
 	} else if (action == GLFW_RELEASE) {
-		__mouseState[button] = ButtonState::Released;
+		__SetButton(GLFW_KEY_LAST + 1 + button, ButtonState::Released, glfwGetTime());
 	}
 }
 
+void InputEngine::__CursorPosCallback(GLFWwindow* window, double x, double y) {
+	if (__mode == Mode::Replaying)
+		return;
+
+	// The position itself is read when sampling, we only need to know when it first moved
+	__cursorEventTime = std::min(__cursorEventTime, __GetTime());
+}
+
 void InputEngine::__MouseScrollCallback(GLFWwindow* window, double x, double y) {
+	if (__mode == Mode::Replaying)
+		return;
+
 	__scrollDelta.x += x;
 	__scrollDelta.y += y;
 }
@@ -2,6 +2,8 @@
 
 #include <GLM/glm.hpp>
 #include <string>
+#include <vector>
+#include <cstdint>
 #include <EnumToString.h>
 #include "GLFW/glfw3.h"
 
@@ -18,8 +20,27 @@ ENUM(CursorMode, int,
 	 Hidden   = GLFW_CURSOR_HIDDEN
 );
 
+/// <summary>
+/// Static input layer that gameplay code should read from instead of querying GLFW directly. Input is
+/// sampled once per frame in BeginFrame, which also lets us record every frame of input to a file and
+/// feed it back in later, so that a play session can be replayed exactly (including without a window)
+/// </summary>
 class InputEngine {
 public:
+	/// <summary>
+	/// The number of gamepads (GLFW joysticks, starting at GLFW_JOYSTICK_1) that are sampled each frame
+	/// </summary>
+	static constexpr int MAX_GAMEPADS        = 4;
+	static constexpr int MAX_GAMEPAD_BUTTONS = 32;
+	static constexpr int MAX_GAMEPAD_AXES    = 8;
+	// How far a gamepad axis has to move between frames to count as an input event
+	static constexpr float GAMEPAD_AXIS_EVENT_THRESHOLD = 0.02f;
+
+	/// <summary>
+	/// Hooks the input callbacks for the given window. May be skipped entirely when running headless,
+	/// in which case input only comes from replays
+	/// </summary>
+	/// <param name="window">The window to receive input from</param>
 	static void Init(GLFWwindow* window);
 
 	static ButtonState GetKeyState(int keyCode);
@@ -31,14 +52,139 @@ public:
 	static const glm::dvec2& GetMousePos();
 	static const glm::dvec2& GetMouseDelta();
 
+	static const glm::dvec2& GetScrollDelta();
+
+	/// <summary>
+	/// Gets the time (in GLFW time) that input was sampled for this frame in BeginFrame
+	/// </summary>
+	static double GetSampleTime();
+	/// <summary>
+	/// Gets the time (in GLFW time) that the last press or release event for a key or mouse button
+	/// was received, which may be well before the frame's input was sampled
+	/// </summary>
+	static double GetKeyEventTime(int keyCode);
+	static double GetMouseEventTime(int button);
+	/// <summary>
+	/// Gets the time of the earliest input event applied this frame, or the sample time if nothing changed.
+	/// This covers key and mouse button changes, cursor movement, and gamepad button and axis changes. GLFW
+	/// only reports gamepads when we poll them, so gamepad changes are timed when input is sampled
+	/// </summary>
+	static double GetOldestEventTime();
+	/// <summary>
+	/// Checks whether any live input event was applied this frame. Gamepad changes are timed at the sample
+	/// time, so the event time alone can't tell us about them. Replayed frames never have live events
+	/// </summary>
+	static bool HasInputEvents();
+
+	/// <summary>
+	/// Checks whether the gamepad with the given ID was connected at the start of the frame
+	/// </summary>
+	/// <param name="id">The ID of the gamepad, ex GLFW_JOYSTICK_1</param>
+	static bool IsGamepadConnected(int id);
+	/// <summary>
+	/// Gets whether a button on a gamepad is held, using the raw GLFW joystick button order
+	/// </summary>
+	/// <param name="id">The ID of the gamepad, ex GLFW_JOYSTICK_1</param>
+	/// <param name="button">The index of the button</param>
+	/// <returns>True if the button is down, false if it is up or does not exist</returns>
+	static bool GetGamepadButton(int id, int button);
+	/// <summary>
+	/// Gets the value of an axis on a gamepad, using the raw GLFW joystick axis order
+	/// </summary>
+	/// <param name="id">The ID of the gamepad, ex GLFW_JOYSTICK_1</param>
+	/// <param name="axis">The index of the axis</param>
+	/// <returns>The axis value in the [-1, 1] range, or 0 if the axis does not exist</returns>
+	static float GetGamepadAxis(int id, int axis);
+
 	static void SetCursorMode(CursorMode mode);
 
 	static std::wstring GetInputText();
 	static std::string  GetInputTextAscii();
 
+	/// <summary>
+	/// Samples the input for this frame, should be called once per frame after polling events and as
+	/// close to the simulation update as possible, before any gameplay code reads input. When recording,
+	/// the frame is appended to the recording, when replaying the frame is loaded from the replay instead
+	/// of from the window
+	/// </summary>
+	/// <param name="dt">The time in seconds since the last frame</param>
+	/// <returns>The frame time to use, which is the recorded frame time while replaying</returns>
+	static float BeginFrame(float dt);
 	static void EndFrame();
 
+	/// <summary>
+	/// Starts recording input, the recording is written to the given file when StopRecording is called
+	/// </summary>
+	/// <param name="path">The file to write the recording to</param>
+	static void StartRecording(const std::string& path);
+	/// <summary>
+	/// Stops recording and writes the recorded frames to the file given to StartRecording
+	/// </summary>
+	/// <returns>True if the file was written</returns>
+	static bool StopRecording();
+	static bool IsRecording();
+
+	/// <summary>
+	/// Loads an input recording and starts feeding it in, starting with the next call to BeginFrame.
+	/// Live input is ignored until the replay ends or StopReplay is called
+	/// </summary>
+	/// <param name="path">The recording to load</param>
+	/// <returns>True if the recording was loaded</returns>
+	static bool StartReplay(const std::string& path);
+	static void StopReplay();
+	static bool IsReplaying();
+	/// <summary>
+	/// Gets the number of frames that have been replayed, and the number of frames in the replay
+	/// </summary>
+	static size_t GetReplayFrame();
+	static size_t GetReplayFrameCount();
+	/// <summary>
+	/// Gets the number of frames in the current recording, and the number of bytes they take up
+	/// </summary>
+	static size_t GetRecordedFrameCount();
+	static size_t GetRecordingSize();
+
 private:
+	struct GamepadState {
+		bool    Connected;
+		int     NumButtons;
+		int     NumAxes;
+		uint8_t Buttons[MAX_GAMEPAD_BUTTONS];
+		float   Axes[MAX_GAMEPAD_AXES];
+	};
+
+	// Will be put at the start of a recording, followed by NumFrames variable length frames
+	struct RecordingHeader {
+		// A check value so we can ensure that we're loading in the right file type
+		char     HeaderBytes[4] ={ 'I', 'N', 'P', 'R' };
+		// The version code, bump this when the frame layout changes
+		uint16_t Version;
+		// The number of gamepads stored in each gamepad block
+		uint16_t NumGamepads;
+		// The number of frames in the file
+		uint32_t NumFrames;
+		// The number of bytes of frame data following the header
+		uint32_t DataSize;
+	};
+	static constexpr uint16_t RECORDING_VERSION = 0x01;
+
+	// Flags for the optional blocks in a recorded frame
+	enum FrameFlags : uint8_t {
+		FrameMouseMoved = 1 << 0,
+		FrameScrolled   = 1 << 1,
+		FrameText       = 1 << 2,
+		FrameGamepads   = 1 << 3
+	};
+
+	// Mouse buttons are stored in the same change list as keys, offset past the last key
+	static constexpr int NUM_BUTTONS = GLFW_KEY_LAST + 1 + GLFW_MOUSE_BUTTON_LAST + 1;
+
+	enum class Mode {
+		Live,
+		Recording,
+		Replaying
+	};
+
 	static GLFWwindow*  __window;
 	static ButtonState  __keyState[GLFW_KEY_LAST + 1];
 	static ButtonState  __mouseState[GLFW_MOUSE_BUTTON_LAST + 1];
@@ -46,9 +192,39 @@ private:
 	static glm::dvec2   __prevMousePos;
 	static glm::dvec2   __scrollDelta;
 	static std::wstring __inputText;
+	static GamepadState __gamepads[MAX_GAMEPADS];
+
+	// Buttons that received an event this frame, EndFrame only needs to visit these
+	static std::vector<uint16_t> __changedButtons;
+	static bool                  __isButtonChanged[NUM_BUTTONS];
+	static double                __buttonEventTime[NUM_BUTTONS];
+	static double                __sampleTime;
+	// The first cursor move and gamepad change this frame, or DBL_MAX if there wasn't one
+	static double                __cursorEventTime;
+	static double                __gamepadEventTime;
+
+	static Mode                 __mode;
+	static std::string          __recordingPath;
+	static std::vector<uint8_t> __frameData;
+	static size_t               __frameCount;
+	static size_t               __readOffset;
+	static size_t               __replayFrame;
+	// What the last recorded frame left the input in, frames only store what changed since then
+	static ButtonState          __recordedButtons[NUM_BUTTONS];
+	static glm::dvec2           __recordedMousePos;
+	static GamepadState         __recordedGamepads[MAX_GAMEPADS];
+
+	static ButtonState& __Button(int index);
+	static void __SetButton(int index, ButtonState state, double time);
+	static double __GetTime();
+	static void __SampleLive();
+	static void __ResetState();
+	static void __WriteFrame(float dt);
+	static bool __ReadFrame(float& dt);
 
 	static void __KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 	static void __CharCallback(GLFWwindow* window, uint32_t keycode);
 	static void __MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
 	static void __MouseScrollCallback(GLFWwindow* window, double x, double y);
+	static void __CursorPosCallback(GLFWwindow* window, double x, double y);
 };
\ No newline at end of file
@@ -1,29 +1,40 @@
 #include "Gameplay/Material.h"
+#include <algorithm>
+#include <cstring>
 #include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/JsonGlmHelpers.h"
 #include "Graphics/TextureCube.h"
 #include "Graphics/Texture2D.h"
+#include "Graphics/Texture2DArray.h"
 #include "Logging.h"
 #include "Utils/ImGuiHelper.h"
+#include "Utils/HashUtils.h"
 
 namespace Gameplay {
 
 	Material::Material(const Shader::Sptr& shader) :
 		IResource(),
 		_shader(shader),
-		_uniforms(std::unordered_map<std::string, UniformData>())
+		_uniforms(std::unordered_map<std::string, UniformData>()),
+		_textureLayer(0),
+		_batchKey(0),
+		_isBatchKeyDirty(true)
 	{ }
 
 	Material::Material() :
 		IResource(),
 		_shader(nullptr),
-		_uniforms(std::unordered_map<std::string, UniformData>())
+		_uniforms(std::unordered_map<std::string, UniformData>()),
+		_textureLayer(0),
+		_batchKey(0),
+		_isBatchKeyDirty(true)
 	{ }
 
 	void Material::Set(const std::string& name, ShaderDataType type, const void* value, size_t arraySize)
 	{
 		// Try and find the matching uniform
 		UniformData& uniform = _GetUniform(name);
+		_isBatchKeyDirty = true;
 
 		// We have a uniform, let's see if we can update it
 		if (uniform.Location != -2) {
@@ -57,6 +68,118 @@ namespace Gameplay {
 		return _shader;
 	}
 
+	void Material::EachTexture(const std::function<void(const ITexture::Sptr&)>& callback) const {
+		for (const auto& [key, uniform] : _uniforms) {
+			if (uniform.IsTextureResource() && uniform.TextureAsset != nullptr) {
+				callback(uniform.TextureAsset);
+			}
+		}
+	}
+
+	void Material::UseTextureArrays(const Shader::Sptr& arrayShader, const std::unordered_map<std::string, ITexture::Sptr>& pages, int layer) {
+		std::unordered_map<std::string, UniformData> oldUniforms = std::move(_uniforms);
+		_uniforms.clear();
+		_shader = arrayShader;
+
+		// Copy all our parameters over to the new shader, swapping out any textures we have pages for
+		for (auto& [name, data] : oldUniforms) {
+			if (data.Location < 0) {
+				continue;
+			}
+			if (data.IsTextureResource()) {
+				auto it = pages.find(name);
+				ITexture::Sptr texture = it != pages.end() ? it->second : data.TextureAsset;
+				Set(name, ShaderDataType::None, &texture);
+			} else {
+				Set(name, data.Type, data.ArraySize > 1 ? data.ArrayBlock : data.Value, data.ArraySize);
+			}
+		}
+
+		_textureLayer = layer;
+		_isBatchKeyDirty = true;
+	}
+
+	uint64_t Material::GetBatchKey() const {
+		if (_isBatchKeyDirty) {
+			_batchKey = _ComputeKey(false);
+			_isBatchKeyDirty = false;
+		}
+		return _batchKey;
+	}
+
+	bool Material::IsSameBatch(const Material& other) const {
+		// Different keys are always different state, equal keys could still be a collision
+		if (GetBatchKey() != other.GetBatchKey() || _shader != other._shader) {
+			return false;
+		}
+
+		// With the same shader, both materials have the same set of active uniforms
+		for (auto& [name, data] : _uniforms) {
+			if (data.Location < 0) {
+				continue;
+			}
+			auto it = other._uniforms.find(name);
+			if (it == other._uniforms.end() || it->second.Type != data.Type || it->second.ArraySize != data.ArraySize) {
+				return false;
+			}
+			const UniformData& otherData = it->second;
+
+			if (data.IsTextureResource()) {
+				if (data.TextureAsset != otherData.TextureAsset) {
+					return false;
+				}
+			} else {
+				const void* value      = data.ArraySize > 1 ? data.ArrayBlock : data.Value;
+				const void* otherValue = otherData.ArraySize > 1 ? otherData.ArrayBlock : otherData.Value;
+				if (memcmp(value, otherValue, ShaderDataTypeSize(data.Type) * glm::max(data.ArraySize, (size_t)1)) != 0) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	uint64_t Material::_ComputeKey(bool textureLayoutsOnly) const {
+		uint64_t result = HashUtils::FNV_OFFSET_BASIS;
+		const Shader* shader = _shader.get();
+		HashUtils::HashBytes(result, &shader, sizeof(Shader*));
+
+		// Unordered map iteration order is not stable, so we sort the names first
+		std::vector<const std::string*> names;
+		names.reserve(_uniforms.size());
+		for (auto& [name, data] : _uniforms) {
+			if (data.Location >= 0) {
+				names.push_back(&name);
+			}
+		}
+		std::sort(names.begin(), names.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+
+		for (const std::string* name : names) {
+			const UniformData& data = _uniforms.at(*name);
+			HashUtils::HashBytes(result, name->data(), name->size());
+
+			if (data.IsTextureResource()) {
+				Texture2D::Sptr texture2D = std::dynamic_pointer_cast<Texture2D>(data.TextureAsset);
+				// When grouping textures into arrays, we only care that 2D textures are interchangeable
+				if (textureLayoutsOnly && texture2D != nullptr) {
+					const Texture2DDescription& descr = texture2D->GetDescription();
+					uint32_t layout[] = {
+						descr.Width, descr.Height, (uint32_t)*descr.Format, texture2D->GetNumLevels(),
+						(uint32_t)*descr.HorizontalWrap, (uint32_t)*descr.VerticalWrap,
+						(uint32_t)*descr.MinificationFilter, (uint32_t)*descr.MagnificationFilter
+					};
+					HashUtils::HashBytes(result, layout, sizeof(layout));
+				} else {
+					const ITexture* texture = data.TextureAsset.get();
+					HashUtils::HashBytes(result, &texture, sizeof(ITexture*));
+				}
+			} else {
+				HashUtils::HashBytes(result, data.ArraySize > 1 ? data.ArrayBlock : data.Value, ShaderDataTypeSize(data.Type) * glm::max(data.ArraySize, (size_t)1));
+			}
+		}
+		return result;
+	}
+
 	void Material::Apply() {
 		if (_shader != nullptr) {
 			// Skip the reserved # of texture slots
@@ -92,6 +215,9 @@ namespace Gameplay {
 		ImGui::PushID(this);
 
 		if (ImGui::CollapsingHeader(Name.c_str())) {
+			// Values can be edited in place, so assume they have changed
+			_isBatchKeyDirty = true;
+
 			// Draw all of our valid uniforms
 			for (auto&[key, value] : _uniforms) {
 				if (value.Location != -2 && value.Location != -1) {
@@ -118,6 +244,7 @@ namespace Gameplay {
 		result->OverrideGUID(Guid(data["guid"]));
 		result->Name = data["name"].get<std::string>();
 		result->_shader = ResourceManager::Get<Shader>(Guid(data["shader"]));
+		result->_textureLayer = JsonGet(data, "texture_layer", 0);
 
 		// material specific parameters'
 		if (data.contains("parameters") && data["parameters"].is_object()) {
@@ -138,7 +265,8 @@ namespace Gameplay {
 			{ "guid", GetGUID().str() },
 			{ "name", Name },
 			{ "shader", _shader ? _shader->GetGUID().str() : "null" },
-			{ "parameters", nlohmann::json() }
+			{ "parameters", nlohmann::json() },
+			{ "texture_layer", _textureLayer }
 		};
 
 		// Store all the uniforms
@@ -671,13 +799,15 @@ namespace Gameplay {
 			case ShaderDataType::TexCube_Int:
 				result.TextureAsset = ResourceManager::Get<TextureCube>(Guid(blob["value"].get<std::string>()));
 				break;
+			case ShaderDataType::Tex2D_Array:
+				result.TextureAsset = ResourceManager::Get<Texture2DArray>(Guid(blob["value"].get<std::string>()));
+				break;
 			case ShaderDataType::Tex1D:
 			case ShaderDataType::Tex1D_Array:
 			case ShaderDataType::Tex1D_Shadow:
 			case ShaderDataType::Tex1D_ShadowArray:
 			case ShaderDataType::Tex2D_Rect:
 			case ShaderDataType::Tex2D_Rect_Shadow:
-			case ShaderDataType::Tex2D_Array:
 			case ShaderDataType::Tex2D_Shadow:
 			case ShaderDataType::Tex2D_ShadowArray:
 			case ShaderDataType::Tex2D_MultisampleArray:
@@ -1,8 +1,11 @@
 #pragma once
 #include <memory>
+#include <functional>
 #include "Graphics/Shader.h"
 #include "Graphics/ITexture.h"
 
+class TextureArrayBuilder;
+
 namespace Gameplay {
 	/// <summary>
 	/// Helper structure for material parameters to our shader
@@ -60,6 +63,45 @@ namespace Gameplay {
 		/// </summary>
 		const Shader::Sptr& GetShader() const;
 
+		/// <summary>
+		/// Invokes a callback for each texture that is currently assigned to this material
+		/// </summary>
+		/// <param name="callback">The function to invoke for each texture</param>
+		void EachTexture(const std::function<void(const ITexture::Sptr&)>& callback) const;
+
+		/// <summary>
+		/// Gets the texture array layer that this material's textures are stored in, this is
+		/// passed to the shader per instance as u_TextureLayer
+		/// </summary>
+		int GetTextureLayer() const { return _textureLayer; }
+		/// <summary>
+		/// Sets the texture array layer that this material's textures are stored in
+		/// </summary>
+		void SetTextureLayer(int layer) { _textureLayer = layer; }
+
+		/// <summary>
+		/// Switches this material over to a shader that samples from texture arrays, replacing the textures
+		/// for the given uniforms with texture array pages. All other parameters are copied over
+		/// </summary>
+		/// <param name="arrayShader">The shader to switch to, should declare sampler2DArray for all uniforms in pages</param>
+		/// <param name="pages">A map of uniform names to the texture array to use for that uniform</param>
+		/// <param name="layer">The layer within the pages that contains this material's textures</param>
+		void UseTextureArrays(const Shader::Sptr& arrayShader, const std::unordered_map<std::string, ITexture::Sptr>& pages, int layer);
+
+		/// <summary>
+		/// Gets a key that identifies this material's GPU state. Materials with the same key
+		/// can be drawn one after another without calling Apply, since they only differ by
+		/// texture layer
+		/// </summary>
+		uint64_t GetBatchKey() const;
+		/// <summary>
+		/// Checks whether another material has the same GPU state as this one, so that it can be drawn
+		/// without calling Apply. Batch keys are only hashes, so this compares the shader, textures and
+		/// uniform values directly
+		/// </summary>
+		/// <param name="other">The material to compare against</param>
+		bool IsSameBatch(const Material& other) const;
+
 		/// <summary>
 		/// Handles applying this material's state to the OpenGL pipeline
 		/// Will bind the shader, update material uniforms, and bind textures
@@ -173,7 +215,24 @@ namespace Gameplay {
 		/// </summary>
 		std::unordered_map<std::string, UniformData> _uniforms;
 
+		/// <summary>
+		/// The texture array layer to use when drawing with this material
+		/// </summary>
+		int _textureLayer;
+
+		// Cached result of GetBatchKey, cleared when parameters change
+		mutable uint64_t _batchKey;
+		mutable bool     _isBatchKeyDirty;
+
 		UniformData& _GetUniform(const std::string& name);
 
+		/// <summary>
+		/// Calculates a hash of this material's shader and parameters
+		/// </summary>
+		/// <param name="textureLayoutsOnly">If true, 2D textures are hashed by their size, format and sampler state instead of by identity</param>
+		uint64_t _ComputeKey(bool textureLayoutsOnly) const;
+
+		friend class ::TextureArrayBuilder;
+
 	};
 }
\ No newline at end of file
@@ -1,15 +1,31 @@
 #include "MeshResource.h"
 #include <filesystem>
+#include <thread>
+#include <atomic>
+#include <unordered_set>
+#include <algorithm>
+#include <cstring>
+#include <btBulletCollisionCommon.h>
 
 #include "Utils/ObjLoader.h"
+#include "Utils/OptimizedObjLoader.h"
+#include "Utils/ProceduralMeshCache.h"
+#include "Utils/GlmBulletConversions.h"
 
 namespace Gameplay {
+	bool MeshResource::_keepCollisionData = true;
+
 	MeshResource::MeshResource() :
 		IResource(),
 		Filename(""),
 		MeshBuilderParams(std::vector<MeshBuilderParam>()),
 		Mesh(nullptr),
-		BulletTriMesh(nullptr)
+		CollisionData(nullptr),
+		BulletTriMesh(nullptr),
+		BulletBvhShape(nullptr),
+		_hasBounds(false),
+		_boundsCenter(glm::vec3(0.0f)),
+		_boundsRadius(1.0f)
 	{ }
 
 	MeshResource::MeshResource(const std::string& filename) :
@@ -17,9 +33,14 @@ namespace Gameplay {
 		Filename(filename),
 		MeshBuilderParams(std::vector<MeshBuilderParam>()),
 		Mesh(nullptr),
-		BulletTriMesh(nullptr)
+		CollisionData(nullptr),
+		BulletTriMesh(nullptr),
+		BulletBvhShape(nullptr),
+		_hasBounds(false),
+		_boundsCenter(glm::vec3(0.0f)),
+		_boundsRadius(1.0f)
 	{
-		Mesh = ObjLoader::LoadFromFile(filename);
+		Mesh = ObjLoader::LoadFromFile(filename, _keepCollisionData ? &CollisionData : nullptr);
 	}
 
 	MeshResource::~MeshResource() = default;
@@ -44,21 +65,18 @@ namespace Gameplay {
 		MeshResource::Sptr result = std::make_shared<MeshResource>();
 		if (blob.contains("params") && blob["params"].is_array()) {
 			std::vector<nlohmann::json> meshbuilderParams = blob["params"].get<std::vector<nlohmann::json>>();
-			MeshBuilder<VertexPosNormTexColTangents> mesh;
 			for (int ix = 0; ix < meshbuilderParams.size(); ix++) {
 				MeshBuilderParam p = MeshBuilderParam::FromJson(meshbuilderParams[ix]);
 				result->MeshBuilderParams.push_back(p);
-				MeshFactory::AddParameterized(mesh, p);
 			}
-			MeshFactory::CalculateTBN(mesh);
-			result->Mesh = mesh.Bake();
+			result->GenerateMesh();
 		} else {
 			result->Filename = JsonGet<std::string>(blob, "filename", "null");
 			if (result->Filename != "null" && std::filesystem::exists(result->Filename)) {
 				#ifdef OPTIMIZED_OBJ_LOADER
-				result->Mesh = OptimizedObjLoader::LoadFromFile(result->Filename);
+				result->Mesh = OptimizedObjLoader::LoadFromFile(result->Filename, _keepCollisionData ? &result->CollisionData : nullptr);
 				#else
-				result->Mesh = ObjLoader::LoadFromFile(result->Filename);
+				result->Mesh = ObjLoader::LoadFromFile(result->Filename, _keepCollisionData ? &result->CollisionData : nullptr);
 				#endif
 
 			}
@@ -67,15 +85,235 @@ namespace Gameplay {
 	}
 
 	void MeshResource::GenerateMesh() {
-		MeshBuilder<VertexPosNormTexColTangents> mesh;
-		for (auto& param : MeshBuilderParams) {
-			MeshFactory::AddParameterized(mesh, param);
-		}
-		MeshFactory::CalculateTBN(mesh);
-		Mesh = mesh.Bake();
+		// The cache will share meshes with identical params, and skip re-baking meshes we've seen before
+		Mesh = ProceduralMeshCache::Get(MeshBuilderParams, _keepCollisionData ? &CollisionData : nullptr);
+		_hasBounds = false;
 	}
 
 	void MeshResource::AddParam(const MeshBuilderParam & param) {
 		MeshBuilderParams.push_back(param);
 	}
+
+	void MeshResource::GetBoundingSphere(glm::vec3& center, float& radius) {
+		if (!_hasBounds) {
+			_hasBounds = true;
+
+			// Prefer the CPU copy, otherwise pull just the positions back from the GPU
+			std::vector<glm::vec3> positions;
+			if (CollisionData != nullptr) {
+				positions = CollisionData->Positions;
+			} else if (Mesh != nullptr) {
+				const VertexArrayObject::VertexDeclaration& vDecl = Mesh->GetVDecl();
+				auto it = std::find_if(vDecl.begin(), vDecl.end(), [](const BufferAttribute& attrib) {
+					return attrib.Usage == AttribUsage::Position;
+				});
+				const auto* vertBuff = Mesh->GetBufferBinding(AttribUsage::Position);
+				if (it != vDecl.end() && vertBuff != nullptr) {
+					std::vector<uint8_t> vertexStore(vertBuff->Buffer->GetTotalSize());
+					glGetNamedBufferSubData(vertBuff->Buffer->GetHandle(), 0, vertexStore.size(), vertexStore.data());
+					positions.resize(vertBuff->Buffer->GetElementCount());
+					for (size_t ix = 0; ix < positions.size(); ix++) {
+						memcpy(&positions[ix], vertexStore.data() + (ix * it->Stride) + it->Offset, sizeof(glm::vec3));
+					}
+				}
+			}
+
+			// The center of the AABB is close enough to the best fitting sphere for culling
+			if (!positions.empty()) {
+				glm::vec3 min = positions[0], max = positions[0];
+				for (const glm::vec3& pos : positions) {
+					min = glm::min(min, pos);
+					max = glm::max(max, pos);
+				}
+				_boundsCenter = (min + max) * 0.5f;
+				_boundsRadius = 0.0f;
+				for (const glm::vec3& pos : positions) {
+					_boundsRadius = glm::max(_boundsRadius, glm::distance(_boundsCenter, pos));
+				}
+			}
+		}
+		center = _boundsCenter;
+		radius = _boundsRadius;
+	}
+
+	const std::shared_ptr<btTriangleMesh>& MeshResource::GetBulletTriMesh() {
+		// We've already calculated the mesh, use existing
+		if (BulletTriMesh != nullptr) {
+			return BulletTriMesh;
+		}
+
+		// Prefer the CPU copy, this avoids stalling on the GPU and works without a context
+		if (CollisionData != nullptr) {
+			_BuildTriMeshFromCollisionData();
+			return BulletTriMesh;
+		}
+		LOG_TRACE("Mesh \"{}\" has no collision data, reading back from GPU", Filename);
+
+		// Get the VAO from the mesh and make sure it exists
+		VertexArrayObject::Sptr vao = Mesh;
+		if (vao == nullptr) {
+			LOG_WARN("Mesh resource not fully configured!");
+			return BulletTriMesh;
+		}
+
+		// Get the vertex declaration from the VAO so we can pull out positions
+		const VertexArrayObject::VertexDeclaration& VDecl = vao->GetVDecl();
+		if (VDecl.size() == 0) {
+			LOG_WARN("Mesh does not have a vertex declaration, unable to determine position elements");
+			return BulletTriMesh;
+		}
+
+		// Get the attribute for positions from the vertex declaration
+		auto& it = std::find_if(VDecl.begin(), VDecl.end(), [](const BufferAttribute& attrib) {
+			return attrib.Usage == AttribUsage::Position;
+		});
+		if (it == VDecl.end()) {
+			LOG_WARN("Mesh vertex declaration does not have a position element");
+			return BulletTriMesh;
+		}
+		BufferAttribute posAttrib = *it;
+
+		// Get the VBO that contains our data about the position elements
+		const auto* vertBuff = vao->GetBufferBinding(AttribUsage::Position);
+		if (vertBuff != nullptr) {
+			// Shorthand our buffers
+			IndexBuffer::Sptr indexBuff = vao->GetIndexBuffer();
+			VertexBuffer::Sptr vertexBuff = vertBuff->Buffer;
+
+			// Create the bullet physics triangle mesh
+			btTriangleMesh* triMesh = new btTriangleMesh();
+
+			// Helper for extracting an int from a raw index buffer datastore
+			auto getBufferIndex = [](IndexBuffer::Sptr buff, uint8_t* dataStore, int offset) {
+				switch (buff->GetElementType())
+				{
+					case IndexType::UByte:
+						return (int)*(dataStore + offset);
+					case IndexType::UShort:
+						return (int)*(reinterpret_cast<uint16_t*>(dataStore) + offset);
+					case IndexType::UInt:
+						return (int)*(reinterpret_cast<uint32_t*>(dataStore) + offset);
+					case IndexType::Unknown:
+					default:
+						return 0;
+				}
+			};
+
+			// Allocate some space to read data from OpenGL and read our buffer data back into CPU memory
+			uint8_t* vertexStore = reinterpret_cast<uint8_t*>(malloc(vertexBuff->GetTotalSize()));
+			glGetNamedBufferSubData(vertexBuff->GetHandle(), 0, vertexBuff->GetTotalSize(), vertexStore);
+			triMesh->preallocateVertices(vao->GetVertexCount());
+
+			// If our data is indexed, we use the index buffer to add our triangles
+			if (indexBuff != nullptr) {
+				// Allocate and read space for the indices
+				uint8_t* indexStore = reinterpret_cast<uint8_t*>(malloc(indexBuff->GetTotalSize()));
+				glGetNamedBufferSubData(indexBuff->GetHandle(), 0, indexBuff->GetTotalSize(), indexStore);
+
+				// Iterate over index triangles
+				for (int ix = 0; ix < indexBuff->GetElementCount(); ix+=3) {
+					// Extract index from the raw data
+					int i1 = getBufferIndex(indexBuff, indexStore, ix);
+					int i2 = getBufferIndex(indexBuff, indexStore, ix + 1);
+					int i3 = getBufferIndex(indexBuff, indexStore, ix + 2);
+
+					// Find the positions for the indices
+					glm::vec3 p1 = *reinterpret_cast<glm::vec3*>(vertexStore + (i1 * posAttrib.Stride) + posAttrib.Offset);
+					glm::vec3 p2 = *reinterpret_cast<glm::vec3*>(vertexStore + (i2 * posAttrib.Stride) + posAttrib.Offset);
+					glm::vec3 p3 = *reinterpret_cast<glm::vec3*>(vertexStore + (i3 * posAttrib.Stride) + posAttrib.Offset);
+
+					// Add the triangle
+					triMesh->addTriangle(ToBt(p1), ToBt(p2), ToBt(p3));
+				}
+			
+				// Free the data we copied the indices into
+				free(indexStore);
+
+			}
+			// We only have vertex data, create triangles sequentially
+			else {
+				// Iterate over triangles, and add each to the mesh
+				for (int ix = 0; ix < vertexBuff->GetElementCount(); ix+=3) {
+					glm::vec3 p1 = *reinterpret_cast<glm::vec3*>(vertexStore + ((ix + 0) * posAttrib.Stride) + posAttrib.Offset);
+					glm::vec3 p2 = *reinterpret_cast<glm::vec3*>(vertexStore + ((ix + 1) * posAttrib.Stride) + posAttrib.Offset);
+					glm::vec3 p3 = *reinterpret_cast<glm::vec3*>(vertexStore + ((ix + 2) * posAttrib.Stride) + posAttrib.Offset);
+					triMesh->addTriangle(ToBt(p1), ToBt(p2), ToBt(p3));
+				}
+			}
+
+			// free our vertex store data
+			free(vertexStore);
+
+			// Store the bullet tri mesh so that other colliders can share it
+			BulletTriMesh = std::shared_ptr<btTriangleMesh>(triMesh);
+		}
+		return BulletTriMesh;
+	}
+
+	void MeshResource::_BuildTriMeshFromCollisionData() {
+		if (CollisionData == nullptr || BulletTriMesh != nullptr) {
+			return;
+		}
+
+		// Keep the mesh indexed, so shared vertices are only stored once
+		btTriangleMesh* triMesh = new btTriangleMesh();
+		triMesh->preallocateVertices((int)CollisionData->Positions.size());
+		for (const glm::vec3& pos : CollisionData->Positions) {
+			triMesh->findOrAddVertex(ToBt(pos), false);
+		}
+
+		if (CollisionData->Indices.size() > 0) {
+			triMesh->preallocateIndices((int)CollisionData->Indices.size());
+			for (size_t ix = 0; ix + 2 < CollisionData->Indices.size(); ix += 3) {
+				triMesh->addTriangleIndices(CollisionData->Indices[ix], CollisionData->Indices[ix + 1], CollisionData->Indices[ix + 2]);
+			}
+		} else {
+			triMesh->preallocateIndices((int)CollisionData->Positions.size());
+			for (int ix = 0; ix + 2 < (int)CollisionData->Positions.size(); ix += 3) {
+				triMesh->addTriangleIndices(ix, ix + 1, ix + 2);
+			}
+		}
+
+		BulletTriMesh = std::shared_ptr<btTriangleMesh>(triMesh);
+	}
+
+	void MeshResource::BuildBulletTriMeshes(const std::vector<MeshResource::Sptr>& meshes) {
+		// Collect the unique meshes that still need building
+		std::vector<MeshResource*> work;
+		std::unordered_set<MeshResource*> seen;
+		for (const auto& mesh : meshes) {
+			if (mesh != nullptr && mesh->BulletTriMesh == nullptr && mesh->CollisionData != nullptr && seen.insert(mesh.get()).second) {
+				work.push_back(mesh.get());
+			}
+		}
+		if (work.empty()) {
+			return;
+		}
+
+		// Each worker pulls meshes off a shared counter until there are none left
+		std::atomic_int next(0);
+		auto worker = [&]() {
+			for (int ix = next++; ix < (int)work.size(); ix = next++) {
+				work[ix]->_BuildTriMeshFromCollisionData();
+			}
+		};
+
+		unsigned int numThreads = std::min((unsigned int)work.size(), std::max(1u, std::thread::hardware_concurrency()));
+		std::vector<std::thread> workers;
+		for (unsigned int ix = 1; ix < numThreads; ix++) {
+			workers.emplace_back(worker);
+		}
+		worker();
+		for (std::thread& thread : workers) {
+			thread.join();
+		}
+	}
+
+	void MeshResource::SetKeepCollisionData(bool value) {
+		_keepCollisionData = value;
+	}
+
+	bool MeshResource::GetKeepCollisionData() {
+		return _keepCollisionData;
+	}
 }
\ No newline at end of file
@@ -1,10 +1,14 @@
 #pragma once
+#include <unordered_map>
 #include "Utils/ResourceManager/IResource.h"
 #include "Graphics/VertexArrayObject.h"
 #include "Utils/MeshFactory.h"
+#include "Utils/CollisionMesh.h"
 
-// bullet triangle mesh pre-declaration
+// bullet triangle mesh pre-declarations
 class btTriangleMesh;
+class btBvhTriangleMeshShape;
+class btConvexHullShape;
 
 namespace Gameplay {
 	/// <summary>
@@ -47,12 +51,26 @@ namespace Gameplay {
 		/// </summary>
 		MeshResource::Sptr             ColliderMeshData;
 		/// <summary>
+		/// A CPU side copy of the positions and triangles, captured at load time if KeepCollisionData
+		/// is enabled so that physics shapes can be built without touching the GPU
+		/// </summary>
+		CollisionMesh::Sptr            CollisionData;
+		/// <summary>
 		/// Allows for bullet to generate a triangle mesh from this mesh and cache it
 		/// </summary>
 		std::shared_ptr<btTriangleMesh> BulletTriMesh;
+		/// <summary>
+		/// The shared static triangle mesh shape (with its BVH) for this mesh, created by TriangleMeshCollider
+		/// </summary>
+		std::shared_ptr<btBvhTriangleMeshShape> BulletBvhShape;
+		/// <summary>
+		/// The simplified convex hulls for this mesh, created by ConvexMeshCollider and keyed by the hull settings
+		/// </summary>
+		std::unordered_map<uint64_t, std::shared_ptr<btConvexHullShape>> BulletHullShapes;
 
 		/// <summary>
-		/// Generates a new mesh from the mesh builder parameters
+		/// Generates a new mesh from the mesh builder parameters. Meshes are cached by a hash
+		/// of the parameters, so identical parameter lists will share the same VAO
 		/// </summary>
 		void GenerateMesh();
 		/// <summary>
@@ -61,9 +79,51 @@ namespace Gameplay {
 		/// <param name="param">The parameter to add</param>
 		void AddParam(const MeshBuilderParam& param);
 
+		/// <summary>
+		/// Gets the bullet triangle mesh for this mesh's geometry, generating and caching it
+		/// in BulletTriMesh if it has not been created yet. Uses CollisionData if available,
+		/// otherwise falls back to reading the mesh back from the GPU
+		/// </summary>
+		/// <returns>The triangle mesh, or nullptr if the mesh has no geometry</returns>
+		const std::shared_ptr<btTriangleMesh>& GetBulletTriMesh();
+
+		/// <summary>
+		/// Gets a sphere in the mesh's local space that contains all of its vertices. This is calculated the
+		/// first time it's needed, from CollisionData if available, otherwise by reading the positions back
+		/// from the GPU, so the first call must be made on the thread with the GL context
+		/// </summary>
+		/// <param name="center">Receives the center of the sphere</param>
+		/// <param name="radius">Receives the radius of the sphere, a unit sphere is used for meshes without geometry</param>
+		void GetBoundingSphere(glm::vec3& center, float& radius);
+
+		/// <summary>
+		/// Builds the bullet triangle meshes for all the given meshes in parallel on worker threads.
+		/// Only meshes with CollisionData are built, others will be built on demand by GetBulletTriMesh
+		/// </summary>
+		/// <param name="meshes">The meshes to build, duplicates and nulls are ignored</param>
+		static void BuildBulletTriMeshes(const std::vector<MeshResource::Sptr>& meshes);
+
+		/// <summary>
+		/// Sets whether meshes loaded after this call will keep a CPU copy of their positions and indices
+		/// in CollisionData, defaults to true
+		/// </summary>
+		static void SetKeepCollisionData(bool value);
+		static bool GetKeepCollisionData();
+
 		// Inherited from IResource
 
 		virtual nlohmann::json ToJson() const override;
 		static MeshResource::Sptr FromJson(const nlohmann::json& blob);
+
+	protected:
+		static bool _keepCollisionData;
+
+		// The cached bounding sphere, see GetBoundingSphere
+		bool      _hasBounds;
+		glm::vec3 _boundsCenter;
+		float     _boundsRadius;
+
+		// Builds BulletTriMesh from CollisionData, does not touch OpenGL so it is safe to call from any thread
+		void _BuildTriMeshFromCollisionData();
 	};
 }
\ No newline at end of file
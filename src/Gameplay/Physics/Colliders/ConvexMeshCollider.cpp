@@ -1,43 +1,128 @@
 #include "ConvexMeshCollider.h"
+#include <cstring>
 #include <BulletCollision/CollisionShapes/btShapeHull.h>
+#include <GLM/gtc/constants.hpp>
 
 #include "Gameplay/GameObject.h"
-#include "Gameplay/MeshResource.h"
 #include "Gameplay/Components/RenderComponent.h"
 
 #include "Utils/GlmBulletConversions.h"
+#include "Utils/JsonGlmHelpers.h"
+#include "Utils/ImGuiHelper.h"
 
 namespace Gameplay::Physics {
-	ConvexMeshCollider::Sptr ConvexMeshCollider::Create() {
-		return std::shared_ptr<ConvexMeshCollider>(new ConvexMeshCollider());
+	ConvexMeshCollider::Sptr ConvexMeshCollider::Create(int maxVertices /*= 32*/, float margin /*= 0.04f*/) {
+		return std::shared_ptr<ConvexMeshCollider>(new ConvexMeshCollider(maxVertices, margin));
 	}
 
 	ConvexMeshCollider::~ConvexMeshCollider() = default;
 
-	ConvexMeshCollider::ConvexMeshCollider() :
+	ConvexMeshCollider::ConvexMeshCollider(int maxVertices, float margin) :
 		ICollider(ColliderType::ConvexMesh),
-		_triMesh(nullptr)
+		_mesh(nullptr),
+		_maxVertices(maxVertices),
+		_margin(margin)
 	{ }
 
 	btCollisionShape* ConvexMeshCollider::CreateShape() const {
-		// https://pybullet.org/Bullet/phpBB3/viewtopic.php?t=4513
-		if (_triMesh == nullptr) {
+		if (_mesh == nullptr) {
+			return nullptr;
+		}
+		std::shared_ptr<btConvexHullShape> hull = GetSharedHull(_mesh, _maxVertices, _margin);
+		if (hull == nullptr) {
+			return nullptr;
+		}
+
+		// The hull is tiny, so we copy the points rather than sharing the shape, this lets each
+		// collider own (and delete) its shape as usual
+		btConvexHullShape* result = new btConvexHullShape(&hull->getUnscaledPoints()[0].x(), hull->getNumPoints(), sizeof(btVector3));
+		result->setMargin(hull->getMargin());
+		return result;
+	}
+
+	std::shared_ptr<btConvexHullShape> ConvexMeshCollider::GetSharedHull(const MeshResource::Sptr& mesh, int maxVertices, float margin) {
+		// Hulls are keyed by their settings, so colliders with different limits on the same mesh don't collide
+		maxVertices = glm::max(maxVertices, 4);
+		uint32_t marginBits;
+		memcpy(&marginBits, &margin, sizeof(uint32_t));
+		uint64_t key = ((uint64_t)maxVertices << 32) | marginBits;
+		auto it = mesh->BulletHullShapes.find(key);
+		if (it != mesh->BulletHullShapes.end()) {
+			return it->second;
+		}
+
+		btTriangleMesh* triMesh = mesh->GetBulletTriMesh().get();
+		if (triMesh == nullptr) {
 			return nullptr;
 		}
-		btConvexShape* result = new btConvexTriangleMeshShape(_triMesh);
 
+		// https://pybullet.org/Bullet/phpBB3/viewtopic.php?t=4513
 		// The hull shape will calculate the convex hull that contains our shape
-		//btShapeHull* hull = new btShapeHull(result);
-		//float margin = result->getMargin();
-		//bool build = hull->buildHull(margin);
-		//if (!build) {
-		//	LOG_WARN("Failed to build hull for convex mesh");
-		//}
-		//delete hull;
+		btConvexTriangleMeshShape source(triMesh);
+		btShapeHull hull(&source);
+		if (!hull.buildHull(source.getMargin())) {
+			LOG_WARN("Failed to build hull for convex mesh");
+			return nullptr;
+		}
 
+		std::vector<btVector3> points(hull.getVertexPointer(), hull.getVertexPointer() + hull.numVertices());
+
+		// If the hull is still too detailed, keep only the points that are furthest along a set of
+		// evenly spread directions (a fibonacci sphere), which preserves the overall shape
+		if ((int)points.size() > maxVertices) {
+			std::vector<btVector3> simplified;
+			std::vector<bool> used(points.size(), false);
+			for (int ix = 0; ix < maxVertices; ix++) {
+				float z = 1.0f - (2.0f * ix + 1.0f) / maxVertices;
+				float r = sqrtf(1.0f - z * z);
+				float phi = ix * glm::pi<float>() * (3.0f - sqrtf(5.0f));
+				btVector3 dir(cosf(phi) * r, sinf(phi) * r, z);
+
+				int best = 0;
+				btScalar bestDot = -BT_LARGE_FLOAT;
+				for (int p = 0; p < points.size(); p++) {
+					btScalar dot = points[p].dot(dir);
+					if (dot > bestDot) {
+						bestDot = dot;
+						best = p;
+					}
+				}
+				if (!used[best]) {
+					used[best] = true;
+					simplified.push_back(points[best]);
+				}
+			}
+			points = simplified;
+		}
+
+		std::shared_ptr<btConvexHullShape> result = std::make_shared<btConvexHullShape>(&points[0].x(), (int)points.size(), sizeof(btVector3));
+		result->setMargin(margin);
+		LOG_TRACE("Generated convex hull for \"{}\" with {} points (from {} hull points, {} triangles)", mesh->Filename, points.size(), hull.numVertices(), triMesh->getNumTriangles());
+
+		mesh->BulletHullShapes[key] = result;
 		return result;
 	}
 
+	ConvexMeshCollider* ConvexMeshCollider::SetMaxVertices(int value) {
+		_maxVertices = value;
+		_isDirty = true;
+		return this;
+	}
+
+	int ConvexMeshCollider::GetMaxVertices() const {
+		return _maxVertices;
+	}
+
+	ConvexMeshCollider* ConvexMeshCollider::SetMargin(float value) {
+		_margin = value;
+		_isDirty = true;
+		return this;
+	}
+
+	float ConvexMeshCollider::GetMargin() const {
+		return _margin;
+	}
+
 	void ConvexMeshCollider::Awake(GameObject* context)
 	{
 		// Get the components from the gameobject that we'll need to generate the mesh
@@ -55,119 +140,27 @@ namespace Gameplay::Physics {
 			mesh = mesh->ColliderMeshData;
 		}
 
-		// We've already calculated the mesh, use existing
-		if (mesh->BulletTriMesh != nullptr) {
-			_triMesh = mesh->BulletTriMesh.get();
-		}
-		// We need to calculate the triangle mesh from the mesh data
-		else {
-			// Get the VAO from the mesh and make sure it exists
-			VertexArrayObject::Sptr vao = mesh->Mesh;
-			if (vao == nullptr) {
-				LOG_WARN("Mesh resource not fully configured!");
-				return;
-			}
-
-			// Get the vertex declaration from the VAO so we can pull out positions
-			const VertexArrayObject::VertexDeclaration& VDecl = vao->GetVDecl();
-			if (VDecl.size() == 0) {
-				LOG_WARN("Mesh does not have a vertex declaration, unable to determine position elements");
-				return;
-			}
-
-			// Get the attribute for positions from the vertex declaration
-			auto& it = std::find_if(VDecl.begin(), VDecl.end(), [](const BufferAttribute& attrib) {
-				return attrib.Usage == AttribUsage::Position;
-			});
-			if (it == VDecl.end()) {
-				LOG_WARN("Mesh vertex declaration does not have a position element");
-				return;
-			}
-			BufferAttribute posAttrib = *it;
-
-			// Get the VBO that contains our data about the position elements
-			const auto* vertBuff = vao->GetBufferBinding(AttribUsage::Position);
-			if (vertBuff != nullptr) {
-				// Shorthand our buffers
-				IndexBuffer::Sptr indexBuff = vao->GetIndexBuffer();
-				VertexBuffer::Sptr vertexBuff = vertBuff->Buffer;
-
-				// Create the bullet physics triangle mesh
-				_triMesh = new btTriangleMesh();
-
-				// Helper for extracting an int from a raw index buffer datastore
-				auto getBufferIndex = [](IndexBuffer::Sptr buff, uint8_t* dataStore, int offset) {
-					switch (buff->GetElementType())
-					{
-						case IndexType::UByte:
-							return (int)*(dataStore + offset);
-						case IndexType::UShort:
-							return (int)*(reinterpret_cast<uint16_t*>(dataStore) + offset);
-						case IndexType::UInt:
-							return (int)*(reinterpret_cast<uint32_t*>(dataStore) + offset);
-						case IndexType::Unknown:
-						default:
-							return 0;
-					}
-				};
-
-				// Allocate some space to read data from OpenGL and read our buffer data back into CPU memory
-				uint8_t* vertexStore = reinterpret_cast<uint8_t*>(malloc(vertexBuff->GetTotalSize()));
-				glGetNamedBufferSubData(vertexBuff->GetHandle(), 0, vertexBuff->GetTotalSize(), vertexStore);
-				_triMesh->preallocateVertices(vao->GetVertexCount());
-
-				// If our data is indexed, we use the index buffer to add our triangles
-				if (indexBuff != nullptr) {
-					// Allocate and read space for the indices
-					uint8_t* indexStore = reinterpret_cast<uint8_t*>(malloc(indexBuff->GetTotalSize()));
-					glGetNamedBufferSubData(indexBuff->GetHandle(), 0, indexBuff->GetTotalSize(), indexStore);
-
-					// Iterate over index triangles
-					for (int ix = 0; ix < indexBuff->GetElementCount(); ix+=3) {
-						// Extract index from the raw data
-						int i1 = getBufferIndex(indexBuff, indexStore, ix);
-						int i2 = getBufferIndex(indexBuff, indexStore, ix + 1);
-						int i3 = getBufferIndex(indexBuff, indexStore, ix + 2);
-
-						// Find the positions for the indices
-						glm::vec3 p1 = *reinterpret_cast<glm::vec3*>(vertexStore + (i1 * posAttrib.Stride) + posAttrib.Offset);
-						glm::vec3 p2 = *reinterpret_cast<glm::vec3*>(vertexStore + (i2 * posAttrib.Stride) + posAttrib.Offset);
-						glm::vec3 p3 = *reinterpret_cast<glm::vec3*>(vertexStore + (i3 * posAttrib.Stride) + posAttrib.Offset);
-
-						// Add the triangle
-						_triMesh->addTriangle(ToBt(p1), ToBt(p2), ToBt(p3));
-					}
-			
-					// Free the data we copied the indices into
-					free(indexStore);
-
-				}
-				// We only have vertex data, create triangles sequentially
-				else {
-					// Iterate over triangles, and add each to the mesh
-					for (int ix = 0; ix < vertexBuff->GetElementCount(); ix+=3) {
-						glm::vec3 p1 = *reinterpret_cast<glm::vec3*>(vertexStore + ((ix + 0) * posAttrib.Stride) + posAttrib.Offset);
-						glm::vec3 p2 = *reinterpret_cast<glm::vec3*>(vertexStore + ((ix + 1) * posAttrib.Stride) + posAttrib.Offset);
-						glm::vec3 p3 = *reinterpret_cast<glm::vec3*>(vertexStore + ((ix + 2) * posAttrib.Stride) + posAttrib.Offset);
-						_triMesh->addTriangle(ToBt(p1), ToBt(p2), ToBt(p3));
-					}
-				}
-
-				// free our vertex store data
-				free(vertexStore);
+		// The hull itself is generated (or fetched from the mesh's cache) when the shape is created
+		_mesh = mesh;
+	}
 
-				// Store the bullet tri mesh in the MeshResource in case we want it later
-				mesh->BulletTriMesh = std::shared_ptr<btTriangleMesh>(_triMesh);
-			}
-		}
+	std::string ConvexMeshCollider::GetShapeKey() const {
+		// Our parameters don't include the mesh, so we need to add it to the key ourselves
+		return ICollider::GetShapeKey() + "@" + std::to_string(reinterpret_cast<uintptr_t>(_mesh.get()));
 	}
 
 	void ConvexMeshCollider::FromJson(const nlohmann::json& data) {
+		_maxVertices = JsonGet(data, "max_vertices", _maxVertices);
+		_margin = JsonGet(data, "margin", _margin);
 	}
 
 	void ConvexMeshCollider::ToJson(nlohmann::json& blob) const {
+		blob["max_vertices"] = _maxVertices;
+		blob["margin"] = _margin;
 	}
 
 	void ConvexMeshCollider::DrawImGui() {
+		_isDirty |= LABEL_LEFT(ImGui::SliderInt, "Max Vertices", &_maxVertices, 4, 255);
+		_isDirty |= LABEL_LEFT(ImGui::DragFloat, "Margin      ", &_margin, 0.001f, 0.0f, 1.0f);
 	}
 }
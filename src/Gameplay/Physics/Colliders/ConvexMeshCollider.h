@@ -1,26 +1,59 @@
 #pragma once
 
 #include "Gameplay/Physics/ICollider.h"
+#include "Gameplay/MeshResource.h"
+
+class btConvexHullShape;
 
 namespace Gameplay::Physics {
 	/// <summary>
 	/// A complex collider type that allows us to construct collision hulls from arbitrary convex meshes
+	///
+	/// The mesh is simplified down to a convex hull with at most MaxVertices points, hulls are cached
+	/// in the MeshResource so every collider with the same mesh and settings shares the same hull
 	/// </summary>
 	class ConvexMeshCollider final : public ICollider {
 	public:
 		typedef std::shared_ptr<ConvexMeshCollider> Sptr;
-		static ConvexMeshCollider::Sptr Create();
+		static ConvexMeshCollider::Sptr Create(int maxVertices = 32, float margin = 0.04f);
 		virtual ~ConvexMeshCollider();
 
+		/// <summary>
+		/// Sets the maximum number of points the simplified hull can have. Fewer points make
+		/// collision queries cheaper, at the cost of accuracy
+		/// </summary>
+		ConvexMeshCollider* SetMaxVertices(int value);
+		int GetMaxVertices() const;
+
+		/// <summary>
+		/// Sets the collision margin for the hull
+		/// </summary>
+		ConvexMeshCollider* SetMargin(float value);
+		float GetMargin() const;
+
+		/// <summary>
+		/// Gets the shared simplified hull for the given mesh and settings, generating it if it
+		/// does not exist yet
+		/// </summary>
+		/// <param name="mesh">The mesh to generate the hull from</param>
+		/// <param name="maxVertices">The maximum number of points in the hull</param>
+		/// <param name="margin">The collision margin for the hull</param>
+		/// <returns>The shared hull, or nullptr if the mesh has no geometry</returns>
+		static std::shared_ptr<btConvexHullShape> GetSharedHull(const MeshResource::Sptr& mesh, int maxVertices, float margin);
+
 		// Inherited from ICollider
 		virtual void Awake(GameObject* context) override;
 		virtual void DrawImGui() override;
 		virtual void ToJson(nlohmann::json& blob) const override;
 		virtual void FromJson(const nlohmann::json& data) override;
+		virtual std::string GetShapeKey() const override;
 
 	protected:
-		btTriangleMesh* _triMesh;
-		ConvexMeshCollider();
+		MeshResource::Sptr _mesh;
+		int                _maxVertices;
+		float              _margin;
+
+		ConvexMeshCollider(int maxVertices, float margin);
 
 		virtual btCollisionShape* CreateShape() const override;
 	};
@@ -0,0 +1,367 @@
+#include "Gameplay/Physics/Colliders/TriangleMeshCollider.h"
+#include <fstream>
+#include <chrono>
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h>
+
+#include "Gameplay/GameObject.h"
+#include "Gameplay/Components/RenderComponent.h"
+#include "Gameplay/Physics/RigidBody.h"
+#include "Gameplay/Physics/Colliders/ConvexMeshCollider.h"
+#include "Utils/HashUtils.h"
+
+#include "Logging.h"
+
+namespace Gameplay::Physics {
+	TriangleMeshCollider::Sptr TriangleMeshCollider::Create() {
+		return std::shared_ptr<TriangleMeshCollider>(new TriangleMeshCollider());
+	}
+
+	TriangleMeshCollider::~TriangleMeshCollider() = default;
+
+	TriangleMeshCollider::TriangleMeshCollider() :
+		ICollider(ColliderType::ConcaveMesh),
+		_bvhShape(nullptr)
+	{ }
+
+	btCollisionShape* TriangleMeshCollider::CreateShape() const {
+		if (_bvhShape == nullptr) {
+			return nullptr;
+		}
+		// The scaled shape lets us apply per-collider scaling without touching the shared BVH
+		return new btScaledBvhTriangleMeshShape(_bvhShape.get(), btVector3(1.0f, 1.0f, 1.0f));
+	}
+
+	void TriangleMeshCollider::Awake(GameObject* context)
+	{
+		// Get the components from the gameobject that we'll need to generate the mesh
+		RenderComponent::Sptr renderer = context->Get<RenderComponent>();
+		MeshResource::Sptr mesh = (renderer != nullptr ? renderer->GetMeshResource() : nullptr);
+
+		// If we have no mesh, we can't create a collider for it!
+		if (mesh == nullptr) {
+			LOG_WARN("Mesh collider attached to gameobject without a mesh!");
+			return;
+		}
+
+		// If we have an explicit collider, grab that instead
+		if (mesh->ColliderMeshData != nullptr) {
+			mesh = mesh->ColliderMeshData;
+		}
+
+		// Bullet will not generate contacts for moving concave meshes, let the user know
+		RigidBody::Sptr body = context->Get<RigidBody>();
+		if (body != nullptr && body->GetType() != RigidBodyType::Static) {
+			LOG_WARN("Triangle mesh collider on \"{}\" is attached to a non-static rigidbody, it will not collide correctly!", context->Name);
+		}
+
+		_bvhShape = GetSharedShape(mesh);
+	}
+
+	std::shared_ptr<btBvhTriangleMeshShape> TriangleMeshCollider::GetSharedShape(const MeshResource::Sptr& mesh) {
+		// Another collider has already loaded the shape, share it
+		if (mesh->BulletBvhShape != nullptr) {
+			return mesh->BulletBvhShape;
+		}
+
+		btTriangleMesh* triMesh = mesh->GetBulletTriMesh().get();
+		if (triMesh == nullptr) {
+			return nullptr;
+		}
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+		uint64_t hash = _HashTriMesh(triMesh);
+
+		// Only meshes loaded from files get a cache, generated meshes are cheap to rebuild
+		std::string cacheFile = mesh->Filename.empty() ? "" : mesh->Filename + ".bvh";
+		std::shared_ptr<btBvhTriangleMeshShape> result = nullptr;
+		if (!cacheFile.empty()) {
+			result = _LoadCachedShape(cacheFile, triMesh, hash);
+		}
+
+		if (result != nullptr) {
+			auto endTime = std::chrono::high_resolution_clock::now();
+			LOG_TRACE("Loaded cached BVH \"{}\" in {} ms", cacheFile, std::chrono::duration<float, std::milli>(endTime - startTime).count());
+		}
+		// No cache or it was out of date, build the tree and store it for next time
+		else {
+			result = std::make_shared<btBvhTriangleMeshShape>(triMesh, true, true);
+
+			auto endTime = std::chrono::high_resolution_clock::now();
+			LOG_TRACE("Built BVH for \"{}\" in {} ms ({} triangles)", mesh->Filename, std::chrono::duration<float, std::milli>(endTime - startTime).count(), triMesh->getNumTriangles());
+
+			if (!cacheFile.empty()) {
+				_SaveCachedShape(cacheFile, result.get(), hash);
+			}
+		}
+
+		// Store the shape in the MeshResource so other colliders can share it
+		mesh->BulletBvhShape = result;
+		return result;
+	}
+
+	uint64_t TriangleMeshCollider::_HashTriMesh(btTriangleMesh* triMesh) {
+		// Hashes the vertex positions and indices of all the subparts
+		uint64_t hash = HashUtils::FNV_OFFSET_BASIS;
+
+		for (int part = 0; part < triMesh->getNumSubParts(); part++) {
+			const unsigned char* vertexBase = nullptr;
+			const unsigned char* indexBase = nullptr;
+			int numVerts, vertexStride, indexStride, numFaces;
+			PHY_ScalarType vertexType, indexType;
+			triMesh->getLockedReadOnlyVertexIndexBase(&vertexBase, numVerts, vertexType, vertexStride, &indexBase, indexStride, numFaces, indexType, part);
+
+			// Only hash the xyz components, the 4th component of each vertex is padding
+			size_t componentSize = vertexType == PHY_DOUBLE ? sizeof(double) : sizeof(float);
+			HashUtils::HashBytes(hash, &numVerts, sizeof(int));
+			for (int ix = 0; ix < numVerts; ix++) {
+				HashUtils::HashBytes(hash, vertexBase + ix * vertexStride, componentSize * 3);
+			}
+
+			HashUtils::HashBytes(hash, &numFaces, sizeof(int));
+			HashUtils::HashBytes(hash, indexBase, (size_t)numFaces * indexStride);
+
+			triMesh->unLockReadOnlyVertexBase(part);
+		}
+
+		return hash;
+	}
+
+	std::shared_ptr<btBvhTriangleMeshShape> TriangleMeshCollider::_LoadCachedShape(const std::string& filename, btTriangleMesh* triMesh, uint64_t hash) {
+		std::ifstream file(filename, std::ios::binary);
+		if (!file) {
+			return nullptr;
+		}
+
+		CacheHeader header;
+		file.read(reinterpret_cast<char*>(&header), sizeof(CacheHeader));
+		if (!file || memcmp(header.HeaderBytes, "BVHC", 4) != 0 || header.Version != CACHE_VERSION || header.PointerSize != sizeof(void*)) {
+			LOG_WARN("BVH cache \"{}\" is invalid or from an older version, rebuilding", filename);
+			return nullptr;
+		}
+		if (header.MeshHash != hash) {
+			LOG_INFO("BVH cache \"{}\" is out of date, rebuilding", filename);
+			return nullptr;
+		}
+
+		// Bullet deserializes in place, so the buffer needs to be aligned and outlive the shape
+		void* buffer = btAlignedAlloc(header.BufferSize, 16);
+		file.read(reinterpret_cast<char*>(buffer), header.BufferSize);
+		if (!file) {
+			LOG_WARN("BVH cache \"{}\" is truncated, rebuilding", filename);
+			btAlignedFree(buffer);
+			return nullptr;
+		}
+
+		btQuantizedBvh* bvh = btOptimizedBvh::deSerializeInPlace(buffer, header.BufferSize, false);
+		if (bvh == nullptr) {
+			LOG_WARN("Failed to deserialize BVH cache \"{}\", rebuilding", filename);
+			btAlignedFree(buffer);
+			return nullptr;
+		}
+
+		// Create the shape without building a tree, and hand it the tree we loaded
+		btBvhTriangleMeshShape* shape = new btBvhTriangleMeshShape(triMesh, true, false);
+		shape->setOptimizedBvh(static_cast<btOptimizedBvh*>(bvh));
+
+		// The shape does not own the tree, so we clean it up alongside the shape
+		return std::shared_ptr<btBvhTriangleMeshShape>(shape, [bvh, buffer](btBvhTriangleMeshShape* shape) {
+			delete shape;
+			bvh->~btQuantizedBvh();
+			btAlignedFree(buffer);
+		});
+	}
+
+	void TriangleMeshCollider::_SaveCachedShape(const std::string& filename, btBvhTriangleMeshShape* shape, uint64_t hash) {
+		btOptimizedBvh* bvh = shape->getOptimizedBvh();
+		if (bvh == nullptr) {
+			return;
+		}
+
+		// Serialize into an aligned scratch buffer, then dump it to disk
+		unsigned int size = bvh->calculateSerializeBufferSize();
+		void* buffer = btAlignedAlloc(size, 16);
+		if (!bvh->serializeInPlace(buffer, size, false)) {
+			LOG_WARN("Failed to serialize BVH for \"{}\"", filename);
+			btAlignedFree(buffer);
+			return;
+		}
+
+		CacheHeader header;
+		header.Version     = CACHE_VERSION;
+		header.PointerSize = sizeof(void*);
+		header.MeshHash    = hash;
+		header.BufferSize  = size;
+
+		std::ofstream file(filename, std::ios::binary);
+		if (file) {
+			file.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+			file.write(reinterpret_cast<const char*>(buffer), size);
+		} else {
+			LOG_WARN("Failed to open BVH cache \"{}\" for writing", filename);
+		}
+
+		btAlignedFree(buffer);
+	}
+
+	void TriangleMeshCollider::Benchmark(const std::vector<MeshResource::Sptr>& meshes, int numBodies, int numSteps) {
+		// Gather the triangle meshes and the bounds of the level
+		std::vector<btTriangleMesh*> triMeshes;
+		btVector3 boundsMin( BT_LARGE_FLOAT,  BT_LARGE_FLOAT,  BT_LARGE_FLOAT);
+		btVector3 boundsMax(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+		for (const auto& resource : meshes) {
+			MeshResource::Sptr mesh = resource->ColliderMeshData != nullptr ? resource->ColliderMeshData : resource;
+			btTriangleMesh* triMesh = mesh->GetBulletTriMesh().get();
+			if (triMesh == nullptr) {
+				continue;
+			}
+			btVector3 aabbMin, aabbMax;
+			triMesh->calculateAabbBruteForce(aabbMin, aabbMax);
+			boundsMin.setMin(aabbMin);
+			boundsMax.setMax(aabbMax);
+			triMeshes.push_back(triMesh);
+		}
+		if (triMeshes.empty()) {
+			LOG_WARN("No meshes to benchmark!");
+			return;
+		}
+
+		// Compare building the tree from scratch against loading it from the cache file. The shared shape
+		// is already in memory, so we load a separate copy straight from the disk and throw it away
+		double buildTime = 0.0, loadTime = 0.0;
+		int numCached = 0;
+		for (const auto& resource : meshes) {
+			MeshResource::Sptr mesh = resource->ColliderMeshData != nullptr ? resource->ColliderMeshData : resource;
+			btTriangleMesh* triMesh = mesh->GetBulletTriMesh().get();
+			if (triMesh == nullptr || mesh->Filename.empty()) {
+				continue;
+			}
+			// Makes sure the cache file has been written before we time loading it
+			GetSharedShape(mesh);
+			std::string cacheFile = mesh->Filename + ".bvh";
+
+			auto start = std::chrono::high_resolution_clock::now();
+			delete new btBvhTriangleMeshShape(triMesh, true, true);
+			auto mid = std::chrono::high_resolution_clock::now();
+			std::shared_ptr<btBvhTriangleMeshShape> loaded = _LoadCachedShape(cacheFile, triMesh, _HashTriMesh(triMesh));
+			auto end = std::chrono::high_resolution_clock::now();
+
+			if (loaded == nullptr) {
+				LOG_WARN("Could not load BVH cache \"{}\", leaving it out of the timings", cacheFile);
+				continue;
+			}
+			loaded = nullptr;
+			buildTime += std::chrono::duration<double, std::milli>(mid - start).count();
+			loadTime  += std::chrono::duration<double, std::milli>(end - mid).count();
+			numCached++;
+		}
+		LOG_INFO("BVH build: {:.3f} ms, load from cache file: {:.3f} ms ({} meshes)", buildTime, loadTime, numCached);
+
+		// Runs the drop test with the given level shapes, and returns the average and max step times
+		auto runWorld = [&](const std::vector<btCollisionShape*>& levelShapes, double& avgMs, double& maxMs) {
+			btDefaultCollisionConfiguration config;
+			btCollisionDispatcher dispatcher(&config);
+			btDbvtBroadphase broadphase;
+			btSequentialImpulseConstraintSolver solver;
+			btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &config);
+			world.setGravity(btVector3(0.0f, 0.0f, -9.81f));
+
+			std::vector<btRigidBody*> bodies;
+			for (btCollisionShape* shape : levelShapes) {
+				btRigidBody* body = new btRigidBody(0.0f, nullptr, shape);
+				world.addRigidBody(body);
+				bodies.push_back(body);
+			}
+
+			// Drop the spheres in a grid over the level
+			btSphereShape sphere(0.25f);
+			btVector3 inertia;
+			sphere.calculateLocalInertia(1.0f, inertia);
+			int side = (int)ceil(sqrt((double)numBodies));
+			btVector3 extents = boundsMax - boundsMin;
+			for (int ix = 0; ix < numBodies; ix++) {
+				btTransform transform;
+				transform.setIdentity();
+				transform.setOrigin(btVector3(
+					boundsMin.x() + extents.x() * ((ix % side) + 0.5f) / side,
+					boundsMin.y() + extents.y() * ((ix / side) + 0.5f) / side,
+					boundsMax.z() + 2.0f + (ix % 3)
+				));
+				btRigidBody* body = new btRigidBody(1.0f, new btDefaultMotionState(transform), &sphere, inertia);
+				world.addRigidBody(body);
+				bodies.push_back(body);
+			}
+
+			double total = 0.0;
+			maxMs = 0.0;
+			for (int step = 0; step < numSteps; step++) {
+				auto start = std::chrono::high_resolution_clock::now();
+				world.stepSimulation(1.0f / 60.0f, 1, 1.0f / 60.0f);
+				auto end = std::chrono::high_resolution_clock::now();
+				double ms = std::chrono::duration<double, std::milli>(end - start).count();
+				total += ms;
+				maxMs = std::max(maxMs, ms);
+			}
+			avgMs = total / numSteps;
+
+			for (btRigidBody* body : bodies) {
+				world.removeRigidBody(body);
+				delete body->getMotionState();
+				delete body;
+			}
+		};
+
+		// Full convex triangle meshes, using every triangle of the mesh
+		std::vector<btCollisionShape*> convexShapes;
+		for (btTriangleMesh* triMesh : triMeshes) {
+			convexShapes.push_back(new btConvexTriangleMeshShape(triMesh));
+		}
+		double convexAvg, convexMax;
+		runWorld(convexShapes, convexAvg, convexMax);
+		for (btCollisionShape* shape : convexShapes) {
+			delete shape;
+		}
+
+		// Simplified hulls, as used by ConvexMeshCollider
+		std::vector<btCollisionShape*> hullShapes;
+		for (const auto& resource : meshes) {
+			MeshResource::Sptr mesh = resource->ColliderMeshData != nullptr ? resource->ColliderMeshData : resource;
+			std::shared_ptr<btConvexHullShape> hull = ConvexMeshCollider::GetSharedHull(mesh, 32, 0.04f);
+			if (hull != nullptr) {
+				hullShapes.push_back(hull.get());
+			}
+		}
+		double hullAvg, hullMax;
+		runWorld(hullShapes, hullAvg, hullMax);
+
+		// BVH triangle meshes, as used by TriangleMeshCollider
+		std::vector<btCollisionShape*> bvhShapes;
+		for (const auto& resource : meshes) {
+			MeshResource::Sptr mesh = resource->ColliderMeshData != nullptr ? resource->ColliderMeshData : resource;
+			if (mesh->BulletBvhShape != nullptr) {
+				bvhShapes.push_back(mesh->BulletBvhShape.get());
+			}
+		}
+		double bvhAvg, bvhMax;
+		runWorld(bvhShapes, bvhAvg, bvhMax);
+
+		LOG_INFO("Physics benchmark ({} meshes, {} bodies, {} steps)", triMeshes.size(), numBodies, numSteps);
+		LOG_INFO("\tConvex mesh: avg {:.3f} ms, max {:.3f} ms", convexAvg, convexMax);
+		LOG_INFO("\tConvex hull: avg {:.3f} ms, max {:.3f} ms", hullAvg, hullMax);
+		LOG_INFO("\tBVH mesh:    avg {:.3f} ms, max {:.3f} ms", bvhAvg, bvhMax);
+	}
+
+	std::string TriangleMeshCollider::GetShapeKey() const {
+		// Our parameters don't include the mesh, so we need to add it to the key ourselves
+		return ICollider::GetShapeKey() + "@" + std::to_string(reinterpret_cast<uintptr_t>(_bvhShape.get()));
+	}
+
+	void TriangleMeshCollider::FromJson(const nlohmann::json& data) {
+	}
+
+	void TriangleMeshCollider::ToJson(nlohmann::json& blob) const {
+	}
+
+	void TriangleMeshCollider::DrawImGui() {
+	}
+}
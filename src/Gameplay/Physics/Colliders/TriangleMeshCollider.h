@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Gameplay/Physics/ICollider.h"
+#include "Gameplay/MeshResource.h"
+
+// Bullet pre-declarations
+class btBvhTriangleMeshShape;
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// A collider for static, arbitrary (including concave) meshes. The triangles are stored in a
+	/// quantized AABB tree (BVH), which is shared between all colliders using the same mesh and
+	/// cached to a file next to the mesh so that it does not need to be rebuilt on load
+	///
+	/// NOTE: Bullet does not support concave meshes on dynamic bodies, this collider should only
+	/// be used on static rigidbodies and trigger volumes
+	/// </summary>
+	class TriangleMeshCollider final : public ICollider {
+	public:
+		typedef std::shared_ptr<TriangleMeshCollider> Sptr;
+		static TriangleMeshCollider::Sptr Create();
+		virtual ~TriangleMeshCollider();
+
+		/// <summary>
+		/// Gets the shared BVH triangle mesh shape for the given mesh, loading it from the cache file
+		/// if it is up to date, or building it (and writing the cache) otherwise
+		/// </summary>
+		/// <param name="mesh">The mesh resource to get the shape for</param>
+		/// <returns>The shared shape, or nullptr if the mesh has no geometry</returns>
+		static std::shared_ptr<btBvhTriangleMeshShape> GetSharedShape(const MeshResource::Sptr& mesh);
+
+		/// <summary>
+		/// Runs a small standalone physics benchmark, dropping spheres onto the given meshes
+		/// using a full convex triangle mesh shape, a simplified convex hull and a BVH triangle mesh shape, and logs
+		/// the step times for each, as well as the BVH build and cache load times
+		/// </summary>
+		/// <param name="meshes">The meshes to use as the static level geometry</param>
+		/// <param name="numBodies">The number of dynamic spheres to drop onto the geometry</param>
+		/// <param name="numSteps">The number of 60Hz steps to simulate for each shape type</param>
+		static void Benchmark(const std::vector<MeshResource::Sptr>& meshes, int numBodies = 200, int numSteps = 600);
+
+		// Inherited from ICollider
+		virtual void Awake(GameObject* context) override;
+		virtual void DrawImGui() override;
+		virtual void ToJson(nlohmann::json& blob) const override;
+		virtual void FromJson(const nlohmann::json& data) override;
+		virtual std::string GetShapeKey() const override;
+
+	protected:
+		std::shared_ptr<btBvhTriangleMeshShape> _bvhShape;
+
+		TriangleMeshCollider();
+
+		virtual btCollisionShape* CreateShape() const override;
+
+	private:
+		// Will be put at the start of the cache file, contains info about the contents of the file
+		struct CacheHeader {
+			// A check value so we can ensure that we're loading in the right file type
+			char     HeaderBytes[4] ={ 'B', 'V', 'H', 'C' };
+			// The version code, bump this when the layout changes
+			uint16_t Version;
+			// The serialized BVH stores raw pointer sized fields, so we can't load 32 bit caches in 64 bit builds
+			uint16_t PointerSize;
+			// Hash of the triangle data, the cache is rebuilt if the mesh has changed
+			uint64_t MeshHash;
+			// The number of bytes of BVH data following the header
+			uint32_t BufferSize;
+		};
+		static constexpr uint16_t CACHE_VERSION = 0x01;
+
+		static uint64_t _HashTriMesh(btTriangleMesh* triMesh);
+		static std::shared_ptr<btBvhTriangleMeshShape> _LoadCachedShape(const std::string& filename, btTriangleMesh* triMesh, uint64_t hash);
+		static void _SaveCachedShape(const std::string& filename, btBvhTriangleMeshShape* shape, uint64_t hash);
+	};
+}
@@ -0,0 +1,134 @@
+#include "Gameplay/Physics/ContactDispatcher.h"
+#include <algorithm>
+
+#include "Gameplay/Physics/RigidBody.h"
+#include "Gameplay/Physics/TriggerVolume.h"
+
+namespace Gameplay::Physics {
+	bool ContactDispatcher::ContactPair::operator<(const ContactPair& other) const {
+		return A < other.A || (A == other.A && B < other.B);
+	}
+
+	bool ContactDispatcher::ContactPair::operator==(const ContactPair& other) const {
+		return A == other.A && B == other.B;
+	}
+
+	ContactDispatcher::ContactDispatcher() :
+		_current(),
+		_previous(),
+		_begin(),
+		_persist(),
+		_end()
+	{ }
+
+	void ContactDispatcher::Update(btCollisionWorld* world) {
+		// Last frame's pairs become our previous list, and we reuse the old storage for this frame
+		_previous.swap(_current);
+		_current.clear();
+		_begin.clear();
+		_persist.clear();
+		_end.clear();
+
+		// Every pair of objects that the narrowphase found touching has a manifold with at least one contact
+		btDispatcher* dispatcher = world->getDispatcher();
+		const int numManifolds = dispatcher->getNumManifolds();
+		_current.reserve(numManifolds);
+		for (int ix = 0; ix < numManifolds; ix++) {
+			const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(ix);
+			if (manifold->getNumContacts() == 0) {
+				continue;
+			}
+
+			const btCollisionObject* a = manifold->getBody0();
+			const btCollisionObject* b = manifold->getBody1();
+			if (b < a) {
+				std::swap(a, b);
+			}
+			_current.push_back({ a, b });
+		}
+
+		// Sort so we can diff against last frame in a single pass, compound shapes can produce more than
+		// one manifold for the same pair so we remove duplicates as well
+		std::sort(_current.begin(), _current.end());
+		_current.erase(std::unique(_current.begin(), _current.end()), _current.end());
+
+		// Walk both sorted lists together to split the pairs into begin, persist and end
+		auto curr = _current.begin();
+		auto prev = _previous.begin();
+		while (curr != _current.end() || prev != _previous.end()) {
+			if (prev == _previous.end() || (curr != _current.end() && *curr < *prev)) {
+				_begin.push_back(*curr++);
+			} else if (curr == _current.end() || *prev < *curr) {
+				_end.push_back(*prev++);
+			} else {
+				_persist.push_back(*curr);
+				++curr;
+				++prev;
+			}
+		}
+	}
+
+	void ContactDispatcher::Dispatch() {
+		// Only changes need to resolve the components, persisting pairs cost nothing here
+		for (const ContactPair& pair : _begin) {
+			_DispatchPair(pair, true);
+		}
+		for (const ContactPair& pair : _end) {
+			_DispatchPair(pair, false);
+		}
+	}
+
+	void ContactDispatcher::RemoveObject(const btCollisionObject* object) {
+		auto matches = [object](const ContactPair& pair) {
+			return pair.A == object || pair.B == object;
+		};
+		_current.erase(std::remove_if(_current.begin(), _current.end(), matches), _current.end());
+		_begin.erase(std::remove_if(_begin.begin(), _begin.end(), matches), _begin.end());
+		_persist.erase(std::remove_if(_persist.begin(), _persist.end(), matches), _persist.end());
+		_end.erase(std::remove_if(_end.begin(), _end.end(), matches), _end.end());
+	}
+
+	const std::vector<ContactDispatcher::ContactPair>& ContactDispatcher::GetBeginContacts() const {
+		return _begin;
+	}
+
+	const std::vector<ContactDispatcher::ContactPair>& ContactDispatcher::GetPersistingContacts() const {
+		return _persist;
+	}
+
+	const std::vector<ContactDispatcher::ContactPair>& ContactDispatcher::GetEndContacts() const {
+		return _end;
+	}
+
+	// Resolves the physics component from the weak pointer that we store in all our collision object user pointers
+	static std::shared_ptr<PhysicsBase> GetComponent(const btCollisionObject* object) {
+		std::weak_ptr<IComponent>* ref = reinterpret_cast<std::weak_ptr<IComponent>*>(object->getUserPointer());
+		return ref != nullptr ? std::static_pointer_cast<PhysicsBase>(ref->lock()) : nullptr;
+	}
+
+	void ContactDispatcher::_DispatchPair(const ContactPair& pair, bool begin) {
+		bool isBodyA = pair.A->getInternalType() == btCollisionObject::CO_RIGID_BODY;
+		bool isBodyB = pair.B->getInternalType() == btCollisionObject::CO_RIGID_BODY;
+
+		// We don't have trigger-trigger interactions
+		if (!isBodyA && !isBodyB) {
+			return;
+		}
+
+		std::shared_ptr<PhysicsBase> a = GetComponent(pair.A);
+		std::shared_ptr<PhysicsBase> b = GetComponent(pair.B);
+		if (a == nullptr || b == nullptr) {
+			return;
+		}
+
+		// The other side of every event is always a rigid body, triggers only ever receive events
+		if (isBodyB) {
+			std::shared_ptr<RigidBody> body = std::static_pointer_cast<RigidBody>(b);
+			begin ? a->_OnContactBegin(body) : a->_OnContactEnd(body);
+		}
+		if (isBodyA) {
+			std::shared_ptr<RigidBody> body = std::static_pointer_cast<RigidBody>(a);
+			begin ? b->_OnContactBegin(body) : b->_OnContactEnd(body);
+		}
+	}
+}
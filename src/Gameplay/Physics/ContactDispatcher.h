@@ -0,0 +1,72 @@
+#pragma once
+#include <vector>
+#include <btBulletDynamicsCommon.h>
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// Tracks every touching pair of collision objects in a physics world, and dispatches begin and end
+	/// events to the rigid bodies and trigger volumes involved. This is done in a single pass over the
+	/// dispatcher's contact manifolds after each step, so the cost is linear in the number of contacts
+	/// in the world rather than per trigger
+	/// </summary>
+	class ContactDispatcher {
+	public:
+		/// <summary>
+		/// A pair of collision objects that are touching, A is always the lower address so that
+		/// pairs can be sorted and compared between frames
+		/// </summary>
+		struct ContactPair {
+			const btCollisionObject* A;
+			const btCollisionObject* B;
+
+			bool operator <(const ContactPair& other) const;
+			bool operator ==(const ContactPair& other) const;
+		};
+
+		ContactDispatcher();
+		~ContactDispatcher() = default;
+
+		/// <summary>
+		/// Collects the touching pairs from the world's dispatcher, and sorts them into the lists
+		/// of pairs that began, persisted or ended since the last update
+		/// </summary>
+		/// <param name="world">The world that was just stepped</param>
+		void Update(btCollisionWorld* world);
+		/// <summary>
+		/// Invokes the begin and end contact events on the physics components for the pairs
+		/// collected by the last update
+		/// </summary>
+		void Dispatch();
+
+		/// <summary>
+		/// Removes all pairs involving the given object, must be called when a collision object is
+		/// destroyed so that we never dispatch events for it
+		/// </summary>
+		/// <param name="object">The object that is being removed from the world</param>
+		void RemoveObject(const btCollisionObject* object);
+
+		/// <summary>
+		/// Gets the pairs that started touching in the last update, sorted
+		/// </summary>
+		const std::vector<ContactPair>& GetBeginContacts() const;
+		/// <summary>
+		/// Gets the pairs that were touching before the last update and still are, sorted
+		/// </summary>
+		const std::vector<ContactPair>& GetPersistingContacts() const;
+		/// <summary>
+		/// Gets the pairs that stopped touching in the last update, sorted
+		/// </summary>
+		const std::vector<ContactPair>& GetEndContacts() const;
+
+	protected:
+		std::vector<ContactPair> _current;
+		std::vector<ContactPair> _previous;
+
+		std::vector<ContactPair> _begin;
+		std::vector<ContactPair> _persist;
+		std::vector<ContactPair> _end;
+
+		// Invokes the begin (or end) event for both sides of a pair
+		static void _DispatchPair(const ContactPair& pair, bool begin);
+	};
+}
@@ -14,6 +14,7 @@
 #include "Gameplay/Physics/Colliders/ConeCollider.h"
 #include "Gameplay/Physics/Colliders/CylinderCollider.h"
 #include "Gameplay/Physics/Colliders/ConvexMeshCollider.h"
+#include "Gameplay/Physics/Colliders/TriangleMeshCollider.h"
 
 namespace Gameplay::Physics {
 	const char* ColliderTypeComboNames = "Plane\0Box\0Sphere\0Capsule\0Cone\0Cylinder\0Convex Mesh\0Concave Mesh\0Terrain\0";
@@ -21,30 +22,29 @@ namespace Gameplay::Physics {
 	ICollider::ICollider(ColliderType type) :
 		_type(type),
 		_shape(nullptr),
+		_isDirty(true),
 		_position(glm::vec3(0.0f)),
 		_rotation(glm::vec3(0.0f)),
 		_scale(glm::vec3(1.0f)),
 		_guid(Guid::New())
 	{ }
 
-	ICollider::~ICollider() {
-		if (_shape != nullptr) {
-			delete _shape;
-			_shape = nullptr;
-		}
-	}
+	ICollider::~ICollider() = default;
 
 	ColliderType ICollider::GetType() const {
 		return _type;
 	}
 
 	btCollisionShape* ICollider::GetShape() const {
-		if (_shape == nullptr) {
-			_shape = CreateShape();
-		}
 		return _shape;
 	}
 
+	std::string ICollider::GetShapeKey() const {
+		nlohmann::json blob;
+		ToJson(blob);
+		return ~_type + blob.dump();
+	}
+
 	ICollider* ICollider::SetPosition(const glm::vec3& value) {
 		_position = value;
 		_isDirty  = true;
@@ -89,7 +89,7 @@ namespace Gameplay::Physics {
 			case ColliderType::Cone:        return ConeCollider::Create();
 			case ColliderType::Cylinder:    return CylinderCollider::Create();
 			case ColliderType::ConvexMesh:  return ConvexMeshCollider::Create();
-			case ColliderType::ConcaveMesh: throw std::runtime_error("Collider type not supported!"); return nullptr;
+			case ColliderType::ConcaveMesh: return TriangleMeshCollider::Create();
 			case ColliderType::Terrain:     throw std::runtime_error("Collider type not supported!"); return nullptr;
 			case ColliderType::Unknown:
 			default:
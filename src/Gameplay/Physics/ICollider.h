@@ -28,7 +28,7 @@ ENUM(ColliderType, int,
 	 Cylinder  = 6,
 	 // Convex meshes have no inward faces, ie no caves
 	 ConvexMesh = 7,
-	 // Concave meshes can have inward faces (NOT IMPLEMENTED)
+	 // Concave meshes can have inward faces, static bodies only
 	 ConcaveMesh = 8,
 	 // Used for creating terrain colliders,
 	 // much more complex than the other colliders (NOT IMPLEMENTED)
@@ -89,9 +89,17 @@ namespace Gameplay::Physics {
 		/// </summary>
 		virtual ColliderType GetType() const;
 		/// <summary>
-		/// Gets this collider's bullet collision shape
+		/// Gets this collider's bullet collision shape, or nullptr if the collider has not been
+		/// added to a body yet. The shape is owned by the ShapeCache and may be shared with other
+		/// bodies, so it should not be modified
 		/// </summary>
 		btCollisionShape* GetShape() const;
+		/// <summary>
+		/// Gets a canonical description of the shape this collider will create, colliders
+		/// with identical keys can share their bullet shapes. The default implementation
+		/// uses the collider type and its serialized parameters
+		/// </summary>
+		virtual std::string GetShapeKey() const;
 
 		/// <summary>
 		/// Sets the collider's position relative to it's RigidBody
@@ -144,7 +152,8 @@ namespace Gameplay::Physics {
 	protected:
 		// Stores type 
 		ColliderType _type;
-		// Stores shape, note that mutable lets us modify in const functions
+		// Stores shape, note that mutable lets us modify in const functions. Not owned by the
+		// collider, see ShapeCache
 		mutable btCollisionShape* _shape;
 		mutable bool _isDirty;
 
@@ -159,6 +168,7 @@ namespace Gameplay::Physics {
 	private:
 		// Allow RigidBody to access protected and private members
 		friend class PhysicsBase;
+		friend class ShapeCache;
 
 		// These are private so derived classes don't accidentally use these
 		glm::vec3 _position;
@@ -2,6 +2,7 @@
 
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
+#include "Gameplay/Physics/ShapeCache.h"
 
 #include "Utils/GlmBulletConversions.h"
 #include "Utils/ImGuiHelper.h"
@@ -17,12 +18,14 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		_isShapeDirty(true),
 		_collisionGroup(0x01),
 		_collisionMask(0xFFFFFFFF),
-		_prevScale(glm::vec3(1.0f))
+		_prevScale(glm::vec3(1.0f)),
+		_syncedTransformVersion(0),
+		_baseScale(glm::vec3(1.0f))
 	{ }
 
 	PhysicsBase::~PhysicsBase() {
-		if (_scene != nullptr) {
-			delete _shape;
+		if (_shape != nullptr) {
+			ShapeCache::Release(_shapeKey);
 		}
 	}
 
@@ -169,58 +172,55 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 	void PhysicsBase::RemoveCollider(const ICollider::Sptr& collider) {
 		auto& it = std::find(_colliders.begin(), _colliders.end(), collider);
 		if (it != _colliders.end()) {
-			if (collider->GetShape() != nullptr) {
-				_shape->removeChildShape(collider->GetShape());
-				_isShapeDirty = true;
-			}
+			// The shape may be shared, so rather than removing the child we'll grab a new shape next frame
+			_isShapeDirty = true;
 			_colliders.erase(it);
 		}
 	}
 
+	const std::vector<ICollider::Sptr>& PhysicsBase::GetColliders() const {
+		return _colliders;
+	}
 
-	void PhysicsBase::_AddColliderToShape(ICollider* collider) {
-		// Create the bullet collision shape from the collider
-		btCollisionShape* newShape = collider->CreateShape();
-		collider->_shape = newShape;
 
-		// If the shape actually exists
-		if (newShape != nullptr) {
-			// We convert our shape parameters to a bullet transform
-			btTransform transform;
-			transform.setIdentity();
-			transform.setOrigin(ToBt(collider->_position));
-			transform.setRotation(ToBt(glm::quat(glm::radians(collider->_rotation))));
-			newShape->setLocalScaling(ToBt(collider->_scale));
+	void PhysicsBase::_RebuildShape() {
+		GameObject* context = GetGameObject();
 
-			// Add the shape to the compound shape
-			_shape->addChildShape(transform, newShape);
+		// Acquire the new shape before releasing the old one, so a shape we're the only user of
+		// doesn't get deleted and rebuilt if the key has not changed
+		std::string oldKey = _shapeKey;
+		btCompoundShape* oldShape = _shape;
+		_shape = ShapeCache::Acquire(_colliders, _baseScale, context->GetScale(), _shapeKey);
+		_prevScale = context->GetScale();
+		for (auto& collider : _colliders) {
+			collider->_isDirty = false;
+		}
 
-			// Remove any existing collision manifolds, so that our body can properly be updated with it's new shape
-			if (_scene != nullptr) {
-				_scene->GetPhysicsWorld()->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(_GetBroadphaseHandle(), _scene->GetPhysicsWorld()->getDispatcher());
-			}
+		// Swap the shape on the bullet object, and remove any existing collision manifolds so
+		// that our body can properly be updated with it's new shape
+		btCollisionObject* object = _GetCollisionObject();
+		if (object != nullptr && _shape != oldShape) {
+			object->setCollisionShape(_shape);
+			_scene->GetPhysicsWorld()->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(_GetBroadphaseHandle(), _scene->GetPhysicsWorld()->getDispatcher());
+		}
 
-			// Our inertia has changed, so flag mass as dirty so it's recalculated
-			_isShapeDirty = true;
+		if (oldShape != nullptr) {
+			ShapeCache::Release(oldKey);
 		}
+		_isShapeDirty = false;
 	}
 
 	bool PhysicsBase::_HandleShapeDirty() {
-		bool wasDirty = false;
+		// Only need to check the scale if something has touched the transform
+		bool isDirty = _isShapeDirty || (_IsTransformChanged() && GetGameObject()->GetScale() != _prevScale);
 		for (auto& collider : _colliders) {
-			if (collider->_isDirty) {
-				// If the collider already had a shape, delete it
-				if (collider->_shape != nullptr) {
-					_shape->removeChildShape(collider->_shape);
-					delete collider->_shape;
-				}
-				_AddColliderToShape(collider.get());
-				collider->_isDirty = false;
-				wasDirty = true;
-			}
+			isDirty |= collider->_isDirty;
 		}
 
-		return wasDirty;
+		if (isDirty) {
+			_RebuildShape();
+		}
+		return isDirty;
 	}
 
 	bool PhysicsBase::_HandleGroupDirty() {
@@ -243,11 +243,6 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		transform.setIdentity();
 		transform.setOrigin(ToBt(context->GetPosition()));	 
 		transform.setRotation(ToBt(context->GetRotation()));
-		if (context->GetScale() != _prevScale) {
-			_shape->setLocalScaling(ToBt(context->GetScale()));
-			_scene->GetPhysicsWorld()->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(_GetBroadphaseHandle(), _scene->GetPhysicsWorld()->getDispatcher());
-			_prevScale = context->GetScale();
-		}
 	}
 
 	void PhysicsBase::_CopyGameobjectTransformFrom(const btTransform& transform) {
@@ -256,5 +251,12 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		// Update the pos and rotation params
 		context->SetPosition(ToGlm(transform.getOrigin()));
 		context->SetRotation(ToGlm(transform.getRotation()));
+
+		// Bullet already has this transform, so don't count it as a change
+		_syncedTransformVersion = context->GetTransformVersion();
+	}
+
+	bool PhysicsBase::_IsTransformChanged() const {
+		return GetGameObject()->GetTransformVersion() != _syncedTransformVersion;
 	}
 }
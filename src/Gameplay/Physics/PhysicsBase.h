@@ -8,6 +8,8 @@ namespace Gameplay {
 	class Scene;
 
 	namespace Physics {
+		class RigidBody;
+
 		/// <summary>
 		/// Provides a base class for physics components, including shape generation and utilities
 		/// for converting to and from Bullet transforms
@@ -68,6 +70,10 @@ namespace Gameplay {
 			/// </summary>
 			/// <param name="collider">The collider to remove</param>
 			void RemoveCollider(const ICollider::Sptr& collider);
+			/// <summary>
+			/// Gets the list of colliders attached to this body
+			/// </summary>
+			const std::vector<ICollider::Sptr>& GetColliders() const;
 
 
 			/// <summary>
@@ -89,8 +95,10 @@ namespace Gameplay {
 		protected:
 			Scene*        _scene;
 
-			// Stores the bullet shape associated with the physics object
+			// Stores the bullet shape associated with the physics object, this is owned by
+			// the ShapeCache and may be shared with other bodies
 			btCompoundShape* _shape;
+			std::string      _shapeKey;
 
 			// List of colliders and whether they have been changed
 			std::vector<ICollider::Sptr> _colliders;
@@ -102,6 +110,10 @@ namespace Gameplay {
 			mutable bool _isGroupMaskDirty;
 
 			glm::vec3 _prevScale;
+			// The gameobject's transform version the last time we synced with Bullet, see GameObject::GetTransformVersion
+			uint32_t  _syncedTransformVersion;
+			// The scale of the object when it was awoken, colliders are sized relative to this
+			glm::vec3 _baseScale;
 
 			PhysicsBase();
 
@@ -110,20 +122,31 @@ namespace Gameplay {
 			void ToJsonBase(nlohmann::json& output) const;
 			void FromJsonBase(const nlohmann::json& input);
 
-			// Handles adding a collider to our compound shape
-			void _AddColliderToShape(ICollider* collider);
+			// Gets our compound shape from the shape cache, replacing the existing one
+			void _RebuildShape();
+
+			// Invoked by the ContactDispatcher when a rigid body starts or stops touching this object
+			virtual void _OnContactBegin(const std::shared_ptr<RigidBody>& body) {}
+			virtual void _OnContactEnd(const std::shared_ptr<RigidBody>& body) {}
+			friend class ContactDispatcher;
 
-			// Handles resolving any dirty state stuff for our object
+			// Handles resolving any dirty state stuff for our object, rebuilding the shape if
+			// any colliders or the object's scale have changed
 			bool _HandleShapeDirty();
 
 			bool _HandleGroupDirty();
 
 			// Copies the gameobject's transform the the bullet transform
 			void _CopyGameobjectTransformTo(btTransform& transform);
+			// Copies a bullet transform to the gameobject, without flagging it as a change that needs to be sent back
 			void _CopyGameobjectTransformFrom(const btTransform& transform);
+			// Returns true if the gameobject's transform has been changed by something other than physics since our last sync
+			bool _IsTransformChanged() const;
 
 			// Gets the bullet broadphase proxy that we can use for clearing collisions
 			virtual btBroadphaseProxy* _GetBroadphaseHandle() = 0;
+			// Gets the bullet object that uses our shape, or nullptr if it has not been created
+			virtual btCollisionObject* _GetCollisionObject() = 0;
 
 			static int _editorSelectedColliderType;
 		};
@@ -0,0 +1,193 @@
+#include "Gameplay/Physics/PhysicsQueries.h"
+#include <btBulletDynamicsCommon.h>
+#include <LinearMath/btThreads.h>
+
+#include "Utils/GlmBulletConversions.h"
+
+namespace Gameplay::Physics {
+	// Small batches aren't worth handing out to other threads
+	static const int QUERY_GRAIN_SIZE = 16;
+
+	// Resolves the physics component from the weak pointer that we store in all our collision object user pointers
+	static PhysicsBase::Sptr GetComponent(const btCollisionObject* object) {
+		std::weak_ptr<IComponent>* ref = reinterpret_cast<std::weak_ptr<IComponent>*>(object->getUserPointer());
+		return ref != nullptr ? std::static_pointer_cast<PhysicsBase>(ref->lock()) : nullptr;
+	}
+
+	// Triggers are ghost objects, which callbacks will happily report unless we filter them out
+	static bool IsFilteredTrigger(btBroadphaseProxy* proxy, bool includeTriggers) {
+		return !includeTriggers && static_cast<btCollisionObject*>(proxy->m_clientObject)->getInternalType() == btCollisionObject::CO_GHOST_OBJECT;
+	}
+
+	struct RayCallback : public btCollisionWorld::ClosestRayResultCallback {
+		bool IncludeTriggers;
+
+		RayCallback(const btVector3& from, const btVector3& to, bool includeTriggers) :
+			ClosestRayResultCallback(from, to),
+			IncludeTriggers(includeTriggers) { }
+
+		virtual bool needsCollision(btBroadphaseProxy* proxy) const override {
+			return ClosestRayResultCallback::needsCollision(proxy) && !IsFilteredTrigger(proxy, IncludeTriggers);
+		}
+	};
+
+	struct SweepCallback : public btCollisionWorld::ClosestConvexResultCallback {
+		bool IncludeTriggers;
+
+		SweepCallback(const btVector3& from, const btVector3& to, bool includeTriggers) :
+			ClosestConvexResultCallback(from, to),
+			IncludeTriggers(includeTriggers) { }
+
+		virtual bool needsCollision(btBroadphaseProxy* proxy) const override {
+			return ClosestConvexResultCallback::needsCollision(proxy) && !IsFilteredTrigger(proxy, IncludeTriggers);
+		}
+	};
+
+	struct OverlapCallback : public btCollisionWorld::ContactResultCallback {
+		const btCollisionObject* QueryObject;
+		bool                     IncludeTriggers;
+		OverlapResult*           Result;
+
+		OverlapCallback(const btCollisionObject* queryObject, OverlapResult* result, bool includeTriggers) :
+			ContactResultCallback(),
+			QueryObject(queryObject),
+			IncludeTriggers(includeTriggers),
+			Result(result) { }
+
+		virtual bool needsCollision(btBroadphaseProxy* proxy) const override {
+			return ContactResultCallback::needsCollision(proxy) && !IsFilteredTrigger(proxy, IncludeTriggers);
+		}
+
+		virtual btScalar addSingleResult(btManifoldPoint& cp, const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1) override {
+			// The dispatcher may swap the pair (ex for compound or mesh children), so the hit is whichever one isn't our
+			// test sphere. We get a result per contact point, so skip objects we've already got
+			const btCollisionObject* hit = colObj0Wrap->getCollisionObject() == QueryObject ? colObj1Wrap->getCollisionObject() : colObj0Wrap->getCollisionObject();
+			PhysicsBase::Sptr object = GetComponent(hit);
+			if (object == nullptr) {
+				return 0;
+			}
+			for (int ix = 0; ix < Result->Count; ix++) {
+				if (Result->Objects[ix] == object) {
+					return 0;
+				}
+			}
+			if (Result->Count < Result->Capacity) {
+				Result->Objects[Result->Count++] = object;
+			} else {
+				Result->Truncated = true;
+			}
+			return 0;
+		}
+	};
+
+	// Fills out a hit from one of the closest hit callbacks
+	static void StoreHit(QueryHit& hit, bool hasHit, const btCollisionObject* object, const btVector3& point, const btVector3& normal, btScalar fraction) {
+		hit.Hit = hasHit && object != nullptr;
+		if (hit.Hit) {
+			hit.Point    = ToGlm(point);
+			hit.Normal   = ToGlm(normal);
+			hit.Fraction = fraction;
+			hit.Object   = GetComponent(object);
+		} else {
+			hit.Object   = nullptr;
+		}
+	}
+
+	struct RaycastBody : public btIParallelForBody {
+		btCollisionWorld*   World;
+		const RaycastQuery* Queries;
+		QueryHit*           Results;
+
+		virtual void forLoop(int start, int end) const override {
+			for (int ix = start; ix < end; ix++) {
+				const RaycastQuery& query = Queries[ix];
+				btVector3 from = ToBt(query.From);
+				btVector3 to   = ToBt(query.To);
+
+				RayCallback callback(from, to, query.IncludeTriggers);
+				callback.m_collisionFilterGroup = query.Group;
+				callback.m_collisionFilterMask  = query.Mask;
+				World->rayTest(from, to, callback);
+
+				StoreHit(Results[ix], callback.hasHit(), callback.m_collisionObject, callback.m_hitPointWorld, callback.m_hitNormalWorld, callback.m_closestHitFraction);
+			}
+		}
+	};
+
+	struct SphereCastBody : public btIParallelForBody {
+		btCollisionWorld*      World;
+		const SphereCastQuery* Queries;
+		QueryHit*              Results;
+
+		virtual void forLoop(int start, int end) const override {
+			for (int ix = start; ix < end; ix++) {
+				const SphereCastQuery& query = Queries[ix];
+				btTransform from, to;
+				from.setIdentity();
+				from.setOrigin(ToBt(query.From));
+				to.setIdentity();
+				to.setOrigin(ToBt(query.To));
+
+				// The shape lives on the stack, so casts don't allocate
+				btSphereShape sphere(query.Radius);
+				SweepCallback callback(from.getOrigin(), to.getOrigin(), query.IncludeTriggers);
+				callback.m_collisionFilterGroup = query.Group;
+				callback.m_collisionFilterMask  = query.Mask;
+				World->convexSweepTest(&sphere, from, to, callback);
+
+				StoreHit(Results[ix], callback.hasHit(), callback.m_hitCollisionObject, callback.m_hitPointWorld, callback.m_hitNormalWorld, callback.m_closestHitFraction);
+			}
+		}
+	};
+
+	struct OverlapBody : public btIParallelForBody {
+		btCollisionWorld*   World;
+		const OverlapQuery* Queries;
+		OverlapResult*      Results;
+
+		virtual void forLoop(int start, int end) const override {
+			for (int ix = start; ix < end; ix++) {
+				const OverlapQuery& query = Queries[ix];
+				OverlapResult& result = Results[ix];
+				result.Count = 0;
+				result.Truncated = false;
+
+				btSphereShape sphere(query.Radius);
+				btCollisionObject object;
+				object.setCollisionShape(&sphere);
+				object.getWorldTransform().setIdentity();
+				object.getWorldTransform().setOrigin(ToBt(query.Position));
+
+				OverlapCallback callback(&object, &result, query.IncludeTriggers);
+				callback.m_collisionFilterGroup = query.Group;
+				callback.m_collisionFilterMask  = query.Mask;
+				World->contactTest(&object, callback);
+			}
+		}
+	};
+
+	void PhysicsQueries::Raycast(btCollisionWorld* world, const RaycastQuery* queries, QueryHit* results, int count) {
+		RaycastBody body;
+		body.World   = world;
+		body.Queries = queries;
+		body.Results = results;
+		btParallelFor(0, count, QUERY_GRAIN_SIZE, body);
+	}
+
+	void PhysicsQueries::SphereCast(btCollisionWorld* world, const SphereCastQuery* queries, QueryHit* results, int count) {
+		SphereCastBody body;
+		body.World   = world;
+		body.Queries = queries;
+		body.Results = results;
+		btParallelFor(0, count, QUERY_GRAIN_SIZE, body);
+	}
+
+	void PhysicsQueries::Overlap(btCollisionWorld* world, const OverlapQuery* queries, OverlapResult* results, int count) {
+		OverlapBody body;
+		body.World   = world;
+		body.Queries = queries;
+		body.Results = results;
+		// contactTest adds and removes manifolds in the dispatcher's shared list without a lock, so these can't be split up
+		body.forLoop(0, count);
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <memory>
+#include <GLM/glm.hpp>
+
+#include "Gameplay/Physics/PhysicsBase.h"
+
+class btCollisionWorld;
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// A ray from one point to another, the closest hit will be reported
+	/// </summary>
+	struct RaycastQuery {
+		glm::vec3 From;
+		glm::vec3 To;
+		// The group the query belongs to, objects whose mask does not include this group are ignored
+		int  Group           = 0x01;
+		// The groups that the query can hit
+		int  Mask            = -1;
+		// Whether trigger volumes should be reported as hits
+		bool IncludeTriggers = false;
+	};
+
+	/// <summary>
+	/// A sphere swept from one point to another, the closest hit will be reported
+	/// </summary>
+	struct SphereCastQuery {
+		glm::vec3 From;
+		glm::vec3 To;
+		float     Radius;
+		int  Group           = 0x01;
+		int  Mask            = -1;
+		bool IncludeTriggers = false;
+	};
+
+	/// <summary>
+	/// A sphere at a point, every object touching it will be reported
+	/// </summary>
+	struct OverlapQuery {
+		glm::vec3 Position;
+		float     Radius;
+		int  Group           = 0x01;
+		int  Mask            = -1;
+		bool IncludeTriggers = false;
+	};
+
+	/// <summary>
+	/// The result of a ray or sphere cast
+	/// </summary>
+	struct QueryHit {
+		// True if the cast hit anything, the rest of the fields are only valid if this is true
+		bool              Hit;
+		// The world space point of the hit
+		glm::vec3         Point;
+		// The world space surface normal at the hit
+		glm::vec3         Normal;
+		// How far along the cast the hit was, in the range [0, 1]
+		float             Fraction;
+		// The physics component that was hit
+		PhysicsBase::Sptr Object;
+	};
+
+	/// <summary>
+	/// The result of an overlap test. The caller provides the storage for the objects,
+	/// so running a query never allocates
+	/// </summary>
+	struct OverlapResult {
+		// Caller provided array that will receive the overlapping objects
+		PhysicsBase::Sptr* Objects  = nullptr;
+		// The number of elements in Objects
+		int                Capacity = 0;
+		// The number of objects written to Objects
+		int                Count    = 0;
+		// True if there were more overlapping objects than would fit in Objects
+		bool               Truncated = false;
+	};
+
+	/// <summary>
+	/// Runs batches of ray casts, sphere casts and overlap tests against a physics world. Ray and sphere cast
+	/// batches are split between Bullet's task scheduler threads when one is available, overlap tests always run
+	/// on the calling thread (see Overlap). These should be called while the world is not being stepped
+	/// (ex: from Update, after the scene has done its physics step)
+	/// </summary>
+	class PhysicsQueries {
+	public:
+		PhysicsQueries() = delete;
+
+		/// <summary>
+		/// Runs a batch of raycasts
+		/// </summary>
+		/// <param name="world">The world to query</param>
+		/// <param name="queries">The rays to cast</param>
+		/// <param name="results">Receives the result for each query, must be the same length as queries</param>
+		/// <param name="count">The number of queries</param>
+		static void Raycast(btCollisionWorld* world, const RaycastQuery* queries, QueryHit* results, int count);
+		/// <summary>
+		/// Runs a batch of sphere casts
+		/// </summary>
+		/// <param name="world">The world to query</param>
+		/// <param name="queries">The spheres to cast</param>
+		/// <param name="results">Receives the result for each query, must be the same length as queries</param>
+		/// <param name="count">The number of queries</param>
+		static void SphereCast(btCollisionWorld* world, const SphereCastQuery* queries, QueryHit* results, int count);
+		/// <summary>
+		/// Runs a batch of sphere overlap tests. Unlike the casts, these run serially on the calling thread,
+		/// since contact tests create and release manifolds through the world's shared dispatcher, which
+		/// is not safe to use from multiple threads at once
+		/// </summary>
+		/// <param name="world">The world to query</param>
+		/// <param name="queries">The spheres to test</param>
+		/// <param name="results">Receives the result for each query, Objects and Capacity must be set by the caller</param>
+		/// <param name="count">The number of queries</param>
+		static void Overlap(btCollisionWorld* world, const OverlapQuery* queries, OverlapResult* results, int count);
+	};
+}
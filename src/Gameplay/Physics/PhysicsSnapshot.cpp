@@ -0,0 +1,194 @@
+#include "Gameplay/Physics/PhysicsSnapshot.h"
+#include <algorithm>
+
+#include "Logging.h"
+
+namespace Gameplay::Physics {
+	bool PhysicsSnapshot::ManifoldState::operator<(const ManifoldState& other) const {
+		return Body0 < other.Body0 || (Body0 == other.Body0 && Body1 < other.Body1);
+	}
+
+	PhysicsSnapshot::PhysicsSnapshot() :
+		_frame(0),
+		_numCollisionObjects(0),
+		_bodies(),
+		_manifolds(),
+		_points()
+	{ }
+
+	void PhysicsSnapshot::Capture(btDiscreteDynamicsWorld* world, uint64_t frame) {
+		_frame = frame;
+		_bodies.clear();
+		_manifolds.clear();
+		_points.clear();
+
+		// Store the state of every dynamic body, in the world's object order
+		const btCollisionObjectArray& objects = world->getCollisionObjectArray();
+		_numCollisionObjects = objects.size();
+		for (int ix = 0; ix < objects.size(); ix++) {
+			btRigidBody* body = btRigidBody::upcast(objects[ix]);
+			if (body == nullptr || body->isStaticOrKinematicObject()) {
+				continue;
+			}
+
+			BodyState state;
+			state.Body             = body;
+			state.Transform        = body->getWorldTransform();
+			state.LinearVelocity   = body->getLinearVelocity();
+			state.AngularVelocity  = body->getAngularVelocity();
+			state.DeactivationTime = body->getDeactivationTime();
+			state.ActivationState  = body->getActivationState();
+			_bodies.push_back(state);
+		}
+
+		// Store the contact points for each pair, these carry the impulses the solver warm starts from
+		btDispatcher* dispatcher = world->getDispatcher();
+		const int numManifolds = dispatcher->getNumManifolds();
+		for (int ix = 0; ix < numManifolds; ix++) {
+			const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(ix);
+			ManifoldState state;
+			state.Body0      = manifold->getBody0();
+			state.Body1      = manifold->getBody1();
+			state.FirstPoint = (int)_points.size();
+			state.NumPoints  = manifold->getNumContacts();
+			for (int jx = 0; jx < state.NumPoints; jx++) {
+				_points.push_back(manifold->getContactPoint(jx));
+			}
+			_manifolds.push_back(state);
+		}
+
+		// Sorting lets us look up pairs with a binary search when restoring
+		std::sort(_manifolds.begin(), _manifolds.end());
+	}
+
+	bool PhysicsSnapshot::Restore(btDiscreteDynamicsWorld* world) const {
+		// Make sure the world has the same bodies in the same order before touching anything, we
+		// can't dereference our body pointers until we know they are still alive
+		const btCollisionObjectArray& objects = world->getCollisionObjectArray();
+		if (objects.size() != _numCollisionObjects) {
+			LOG_WARN("Cannot restore physics snapshot from frame {}, objects have been added or removed", _frame);
+			return false;
+		}
+		size_t bodyIx = 0;
+		for (int ix = 0; ix < objects.size(); ix++) {
+			btRigidBody* body = btRigidBody::upcast(objects[ix]);
+			if (body == nullptr || body->isStaticOrKinematicObject()) {
+				continue;
+			}
+			if (bodyIx >= _bodies.size() || _bodies[bodyIx].Body != body) {
+				LOG_WARN("Cannot restore physics snapshot from frame {}, bodies have changed", _frame);
+				return false;
+			}
+			bodyIx++;
+		}
+		if (bodyIx != _bodies.size()) {
+			LOG_WARN("Cannot restore physics snapshot from frame {}, bodies have changed", _frame);
+			return false;
+		}
+
+		// Put the bodies back where they were, at the end of a step the interpolation state matches the current state
+		for (const BodyState& state : _bodies) {
+			btRigidBody* body = state.Body;
+			body->setWorldTransform(state.Transform);
+			body->setInterpolationWorldTransform(state.Transform);
+			body->setLinearVelocity(state.LinearVelocity);
+			body->setAngularVelocity(state.AngularVelocity);
+			body->setInterpolationLinearVelocity(state.LinearVelocity);
+			body->setInterpolationAngularVelocity(state.AngularVelocity);
+			body->clearForces();
+			body->forceActivationState(state.ActivationState);
+			body->setDeactivationTime(state.DeactivationTime);
+		}
+
+		// Update the broadphase and narrowphase for the restored transforms, so that every pair that was touching has a manifold
+		world->performDiscreteCollisionDetection();
+
+		// Replace the contact points in each manifold with the captured ones, pairs that weren't touching are emptied
+		btDispatcher* dispatcher = world->getDispatcher();
+		const int numManifolds = dispatcher->getNumManifolds();
+		for (int ix = 0; ix < numManifolds; ix++) {
+			btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(ix);
+			manifold->clearManifold();
+
+			ManifoldState key;
+			key.Body0 = manifold->getBody0();
+			key.Body1 = manifold->getBody1();
+			auto it = std::lower_bound(_manifolds.begin(), _manifolds.end(), key);
+			if (it != _manifolds.end() && it->Body0 == key.Body0 && it->Body1 == key.Body1) {
+				for (int jx = 0; jx < it->NumPoints; jx++) {
+					manifold->addManifoldPoint(_points[it->FirstPoint + jx]);
+				}
+			}
+		}
+
+		// Send the restored transforms out to the motion states, so gameobjects follow the rollback
+		for (const BodyState& state : _bodies) {
+			world->synchronizeSingleMotionState(state.Body);
+		}
+		return true;
+	}
+
+	uint64_t PhysicsSnapshot::GetFrame() const {
+		return _frame;
+	}
+
+	size_t PhysicsSnapshot::GetBodyCount() const {
+		return _bodies.size();
+	}
+
+	size_t PhysicsSnapshot::GetMemoryUsage() const {
+		return _bodies.size() * sizeof(BodyState) + _manifolds.size() * sizeof(ManifoldState) + _points.size() * sizeof(btManifoldPoint);
+	}
+
+	PhysicsSnapshotRing::PhysicsSnapshotRing(int capacity) :
+		_snapshots(std::max(capacity, 1)),
+		_head(-1),
+		_count(0)
+	{ }
+
+	void PhysicsSnapshotRing::Push(btDiscreteDynamicsWorld* world, uint64_t frame) {
+		_head = (_head + 1) % (int)_snapshots.size();
+		_count = std::min(_count + 1, (int)_snapshots.size());
+		_snapshots[_head].Capture(world, frame);
+	}
+
+	const PhysicsSnapshot* PhysicsSnapshotRing::Find(uint64_t frame) const {
+		// Search from newest to oldest, rollbacks are usually only a few frames
+		for (int ix = 0; ix < _count; ix++) {
+			int slot = (_head - ix + (int)_snapshots.size()) % (int)_snapshots.size();
+			if (_snapshots[slot].GetFrame() == frame) {
+				return &_snapshots[slot];
+			}
+		}
+		return nullptr;
+	}
+
+	void PhysicsSnapshotRing::DiscardAfter(uint64_t frame) {
+		while (_count > 0 && _snapshots[_head].GetFrame() > frame) {
+			_head = (_head - 1 + (int)_snapshots.size()) % (int)_snapshots.size();
+			_count--;
+		}
+	}
+
+	void PhysicsSnapshotRing::Clear() {
+		_head = -1;
+		_count = 0;
+	}
+
+	int PhysicsSnapshotRing::GetCapacity() const {
+		return (int)_snapshots.size();
+	}
+
+	int PhysicsSnapshotRing::GetCount() const {
+		return _count;
+	}
+
+	size_t PhysicsSnapshotRing::GetMemoryUsage() const {
+		size_t result = 0;
+		for (int ix = 0; ix < _count; ix++) {
+			int slot = (_head - ix + (int)_snapshots.size()) % (int)_snapshots.size();
+			result += _snapshots[slot].GetMemoryUsage();
+		}
+		return result;
+	}
+}
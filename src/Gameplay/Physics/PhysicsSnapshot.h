@@ -0,0 +1,122 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <btBulletDynamicsCommon.h>
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// A copy of the simulation state of a Bullet world at the end of a step: the transforms, velocities and
+	/// activation state of every dynamic body, as well as the contact points (and their accumulated impulses,
+	/// which the solver uses to warm start) for every touching pair. All data is kept in flat arrays that are
+	/// reused between captures, so capturing into an existing snapshot does not allocate once it has grown
+	///
+	/// Static and kinematic bodies are driven by their gameobjects, so they are not part of the snapshot
+	/// </summary>
+	class PhysicsSnapshot {
+	public:
+		PhysicsSnapshot();
+		~PhysicsSnapshot() = default;
+
+		/// <summary>
+		/// Copies the state of the world into this snapshot, replacing its contents
+		/// </summary>
+		/// <param name="world">The world to capture</param>
+		/// <param name="frame">A caller defined frame number to tag the snapshot with</param>
+		void Capture(btDiscreteDynamicsWorld* world, uint64_t frame = 0);
+		/// <summary>
+		/// Restores the world to the state in this snapshot. This will fail if bodies have been
+		/// added to or removed from the world since the snapshot was captured
+		/// </summary>
+		/// <param name="world">The world to restore, must be the world that was captured</param>
+		/// <returns>True if the world was restored</returns>
+		bool Restore(btDiscreteDynamicsWorld* world) const;
+
+		/// <summary>
+		/// Gets the frame number the snapshot was captured with
+		/// </summary>
+		uint64_t GetFrame() const;
+		/// <summary>
+		/// Gets the number of bodies stored in the snapshot
+		/// </summary>
+		size_t GetBodyCount() const;
+		/// <summary>
+		/// Gets the number of bytes of state stored in the snapshot
+		/// </summary>
+		size_t GetMemoryUsage() const;
+
+	protected:
+		struct BodyState {
+			btRigidBody* Body;
+			btTransform  Transform;
+			btVector3    LinearVelocity;
+			btVector3    AngularVelocity;
+			float        DeactivationTime;
+			int          ActivationState;
+		};
+
+		struct ManifoldState {
+			const btCollisionObject* Body0;
+			const btCollisionObject* Body1;
+			int                      FirstPoint;
+			int                      NumPoints;
+
+			bool operator <(const ManifoldState& other) const;
+		};
+
+		uint64_t                     _frame;
+		// The number of objects in the world when captured, used to detect the world changing
+		int                          _numCollisionObjects;
+		std::vector<BodyState>       _bodies;
+		std::vector<ManifoldState>   _manifolds;
+		std::vector<btManifoldPoint> _points;
+	};
+
+	/// <summary>
+	/// A fixed size ring of recent snapshots, for rolling back to any of the last N frames
+	/// </summary>
+	class PhysicsSnapshotRing {
+	public:
+		/// <summary>
+		/// Creates a new ring that can hold the given number of frames
+		/// </summary>
+		/// <param name="capacity">The number of snapshots to keep</param>
+		PhysicsSnapshotRing(int capacity = 60);
+		~PhysicsSnapshotRing() = default;
+
+		/// <summary>
+		/// Captures the world into the slot for the given frame, overwriting the oldest snapshot if full
+		/// </summary>
+		/// <param name="world">The world to capture</param>
+		/// <param name="frame">The frame number to store the snapshot under</param>
+		void Push(btDiscreteDynamicsWorld* world, uint64_t frame);
+		/// <summary>
+		/// Finds the snapshot for a given frame
+		/// </summary>
+		/// <param name="frame">The frame number to search for</param>
+		/// <returns>The snapshot, or nullptr if the frame is not in the ring</returns>
+		const PhysicsSnapshot* Find(uint64_t frame) const;
+		/// <summary>
+		/// Drops every snapshot newer than the given frame, call this after rolling back so that the
+		/// re-simulated frames replace the old ones
+		/// </summary>
+		/// <param name="frame">The newest frame to keep</param>
+		void DiscardAfter(uint64_t frame);
+		/// <summary>
+		/// Removes all snapshots, keeping their storage for reuse
+		/// </summary>
+		void Clear();
+
+		int GetCapacity() const;
+		int GetCount() const;
+		/// <summary>
+		/// Gets the total number of bytes of state stored in the ring
+		/// </summary>
+		size_t GetMemoryUsage() const;
+
+	protected:
+		std::vector<PhysicsSnapshot> _snapshots;
+		// The index of the most recent snapshot
+		int _head;
+		int _count;
+	};
+}
@@ -12,6 +12,38 @@
 #include "Utils/GlmBulletConversions.h"
 
 namespace Gameplay::Physics {
+	std::vector<RigidBody*> RigidBody::_movedBodies;
+	std::mutex RigidBody::_movedBodiesMutex;
+	std::vector<RigidBody*> RigidBody::_interpolatingBodies;
+	std::vector<RigidBody*> RigidBody::_forcedBodies;
+
+	RigidBody::MotionState::MotionState(RigidBody* owner, const btTransform& transform) :
+		_owner(owner),
+		_transform(transform)
+	{ }
+
+	void RigidBody::MotionState::SetTransform(const btTransform& transform) {
+		_transform = transform;
+	}
+
+	const btTransform& RigidBody::MotionState::GetTransform() const {
+		return _transform;
+	}
+
+	void RigidBody::MotionState::getWorldTransform(btTransform& worldTrans) const {
+		worldTrans = _transform;
+	}
+
+	void RigidBody::MotionState::setWorldTransform(const btTransform& worldTrans) {
+		// Bullet only calls this for active dynamic bodies, so this is our list of bodies that moved
+		_transform = worldTrans;
+		if (!_owner->_isQueuedForSync) {
+			std::lock_guard<std::mutex> lock(_movedBodiesMutex);
+			_owner->_isQueuedForSync = true;
+			_movedBodies.push_back(_owner);
+		}
+	}
+
 	RigidBody::RigidBody(RigidBodyType type) :
 		PhysicsBase(),
 		_type(type),
@@ -27,13 +59,33 @@ namespace Gameplay::Physics {
 		_angularVelocity(btVector3(0, 0, 0)),
 		_angularVelocityDirty(false),
 		_angularFactor(btVector3(1, 1, 1)),
-		_angularFactorDirty(false)
+		_angularFactorDirty(false),
+		_isQueuedForSync(false),
+		_prevTransform(btTransform::getIdentity()),
+		_currTransform(btTransform::getIdentity()),
+		_isInterpolating(false),
+		_frameForce(btVector3(0, 0, 0)),
+		_frameTorque(btVector3(0, 0, 0)),
+		_hasFrameForces(false)
 	{ }
 
 	RigidBody::~RigidBody() {
+		// Make sure we don't leave a dangling pointer in the moved list
+		if (_isQueuedForSync) {
+			std::lock_guard<std::mutex> lock(_movedBodiesMutex);
+			_movedBodies.erase(std::remove(_movedBodies.begin(), _movedBodies.end(), this), _movedBodies.end());
+		}
+		if (_isInterpolating) {
+			_interpolatingBodies.erase(std::remove(_interpolatingBodies.begin(), _interpolatingBodies.end(), this), _interpolatingBodies.end());
+		}
+		if (_hasFrameForces) {
+			_forcedBodies.erase(std::remove(_forcedBodies.begin(), _forcedBodies.end(), this), _forcedBodies.end());
+		}
+
 		if (_body != nullptr) {
-			// Remove from the physics world
+			// Remove from the physics world, and make sure no contact events are sent for us
 			_scene->GetPhysicsWorld()->removeRigidBody(_body);
+			_scene->GetContactDispatcher().RemoveObject(_body);
 
 			// Clean up all our memory
 			delete _motionState;
@@ -100,27 +152,50 @@ namespace Gameplay::Physics {
 		return ToGlm(_angularFactor);
 	}
 
+	// Dynamic bodies are allowed to sleep, so anything that pushes on them needs to wake them up
+	// Bullet clears forces after every step, so forces from outside a fixed step are held until the
+	// end of the frame and applied to every step, see ApplyFrameForces
+
 	void RigidBody::ApplyForce(const glm::vec3& worldForce) {
-		_body->applyCentralForce(ToBt(worldForce));
+		_body->activate();
+		if (_scene->IsInFixedStep()) {
+			_body->applyCentralForce(ToBt(worldForce));
+		} else {
+			_AddFrameForce(ToBt(worldForce), btVector3(0, 0, 0));
+		}
 	}
 
 	void RigidBody::ApplyForce(const glm::vec3& worldForce, const glm::vec3& localOffset) {
-		_body->applyForce(ToBt(worldForce), ToBt(localOffset));
+		_body->activate();
+		if (_scene->IsInFixedStep()) {
+			_body->applyForce(ToBt(worldForce), ToBt(localOffset));
+		} else {
+			// Same split as btRigidBody::applyForce, an offset force is a central force plus a torque
+			_AddFrameForce(ToBt(worldForce), ToBt(localOffset).cross(ToBt(worldForce) * _body->getLinearFactor()));
+		}
 	}
 
 	void RigidBody::ApplyImpulse(const glm::vec3& worldForce) {
+		_body->activate();
 		_body->applyCentralImpulse(ToBt(worldForce));
 	}
 
 	void RigidBody::ApplyImpulse(const glm::vec3& worldForce, const glm::vec3& localOffset) {
+		_body->activate();
 		_body->applyImpulse(ToBt(worldForce), ToBt(localOffset));
 	}
 
 	void RigidBody::ApplyTorque(const glm::vec3& worldTorque) {
-		_body->applyTorque(ToBt(worldTorque));
+		_body->activate();
+		if (_scene->IsInFixedStep()) {
+			_body->applyTorque(ToBt(worldTorque));
+		} else {
+			_AddFrameForce(btVector3(0, 0, 0), ToBt(worldTorque));
+		}
 	}
 
 	void RigidBody::ApplyTorqueImpulse(const glm::vec3& worldTorque) {
+		_body->activate();
 		_body->applyTorqueImpulse(ToBt(worldTorque));
 	}
 
@@ -134,15 +209,18 @@ namespace Gameplay::Physics {
 			// Set appropriate flags
 			if (_type == RigidBodyType::Kinematic) {
 				_body->setCollisionFlags(flags | btCollisionObject::CF_KINEMATIC_OBJECT);
+				_body->forceActivationState(DISABLE_DEACTIVATION);
 			}
 			// If the object is static, disable it's gravity and notify bullet
 			else if (_type == RigidBodyType::Static) {
 				_body->setCollisionFlags(flags | btCollisionObject::CF_KINEMATIC_OBJECT);
 				_body->setGravity(btVector3(0.0f, 0.0f, 0.0f));
+				_body->forceActivationState(DISABLE_DEACTIVATION);
 			} else {
 				// If dynamic, we need to restore gravity from the scene
 				_body->setCollisionFlags(flags);
 				_body->setGravity(_scene->GetPhysicsWorld()->getGravity());
+				_body->forceActivationState(ACTIVE_TAG);
 			}
 		}
 	}
@@ -155,25 +233,38 @@ namespace Gameplay::Physics {
 		// Update any dirty state that may have changed
 		_HandleStateDirty();
 
-		if (_type != RigidBodyType::Static) {		
-			btTransform transform;
-			_CopyGameobjectTransformTo(transform);
-
-			// Copy to body and to it's motion state
-			if (_type == RigidBodyType::Dynamic) {
-				_body->setWorldTransform(transform);
-			} else {
-				// Kinematics prefer to be driven my motion state for some reason :|
-				_body->getMotionState()->setWorldTransform(transform);
+		// Only send the transform to Bullet if something other than physics has moved the object
+		if (_IsTransformChanged()) {
+			if (_type != RigidBodyType::Static) {
+				btTransform transform;
+				_CopyGameobjectTransformTo(transform);
+
+				// Copy to body and to it's motion state
+				if (_type == RigidBodyType::Dynamic) {
+					_body->setWorldTransform(transform);
+					_body->setInterpolationWorldTransform(transform);
+					_motionState->SetTransform(transform);
+					_body->activate();
+					// Teleports shouldn't be interpolated
+					_prevTransform = transform;
+					_currTransform = transform;
+				} else {
+					// Kinematics prefer to be driven my motion state for some reason :|
+					_motionState->SetTransform(transform);
+				}
 			}
+			_syncedTransformVersion = GetGameObject()->GetTransformVersion();
 		}
 	}
 
 	void RigidBody::PhysicsPostStep(float dt) {
 		// Kinematics are driven externally and statics don't move, so only need to get data out for dynamics!
 		if (_type == RigidBodyType::Dynamic) {
-			btTransform transform = _body->getWorldTransform();
-			_CopyGameobjectTransformFrom(transform);
+			// Keep the last two step results around for interpolation, the gameobject gets the exact
+			// result here so that fixed updates see the real simulation state
+			_prevTransform = _currTransform;
+			_currTransform = _motionState->GetTransform();
+			_CopyGameobjectTransformFrom(_currTransform);
 
 			// Store a copy of our velocities
 			_linearVelocity = _body->getLinearVelocity();
@@ -181,10 +272,77 @@ namespace Gameplay::Physics {
 		}
 	}
 
+	void RigidBody::SyncMovedBodies(float dt) {
+		// Flag everything that was interpolating, anything that doesn't move this step will be left flagged
+		for (RigidBody* body : _interpolatingBodies) {
+			body->_isInterpolating = false;
+		}
+
+		for (RigidBody* body : _movedBodies) {
+			body->_isQueuedForSync = false;
+			body->_isInterpolating = true;
+			body->PhysicsPostStep(dt);
+		}
+
+		// Bodies that moved last step but not this one have come to rest, snap them to where they ended up
+		for (RigidBody* body : _interpolatingBodies) {
+			if (!body->_isInterpolating) {
+				body->_prevTransform = body->_currTransform;
+				body->_CopyGameobjectTransformFrom(body->_currTransform);
+			}
+		}
+
+		// The bodies that moved this step are the ones we interpolate until the next step
+		_interpolatingBodies.swap(_movedBodies);
+		_movedBodies.clear();
+	}
+
+	void RigidBody::InterpolateBodies(float alpha) {
+		for (RigidBody* body : _interpolatingBodies) {
+			btTransform transform;
+			transform.setOrigin(body->_prevTransform.getOrigin().lerp(body->_currTransform.getOrigin(), alpha));
+			transform.setRotation(body->_prevTransform.getRotation().slerp(body->_currTransform.getRotation(), alpha));
+			body->_CopyGameobjectTransformFrom(transform);
+		}
+	}
+
+	void RigidBody::RestoreSimulatedTransforms() {
+		for (RigidBody* body : _interpolatingBodies) {
+			if (!body->_IsTransformChanged()) {
+				body->_CopyGameobjectTransformFrom(body->_currTransform);
+			}
+		}
+	}
+
+	void RigidBody::ApplyFrameForces() {
+		for (RigidBody* body : _forcedBodies) {
+			body->_body->applyCentralForce(body->_frameForce);
+			body->_body->applyTorque(body->_frameTorque);
+		}
+	}
+
+	void RigidBody::ClearFrameForces() {
+		for (RigidBody* body : _forcedBodies) {
+			body->_frameForce.setZero();
+			body->_frameTorque.setZero();
+			body->_hasFrameForces = false;
+		}
+		_forcedBodies.clear();
+	}
+
+	void RigidBody::_AddFrameForce(const btVector3& force, const btVector3& torque) {
+		_frameForce += force;
+		_frameTorque += torque;
+		if (!_hasFrameForces) {
+			_hasFrameForces = true;
+			_forcedBodies.push_back(this);
+		}
+	}
+
 	void RigidBody::Awake() {
 		GameObject* context = GetGameObject();
 		_scene = context->GetScene();
-		_prevScale = context->GetScale();
+		_baseScale = context->GetScale();
 
 		// Awake all our colliders to let them do initialization
 		// that requires the gameobject
@@ -192,27 +350,24 @@ namespace Gameplay::Physics {
 			collider->Awake(context);
 		}
 
-		// Create our compound shape and add all colliders
-		_shape = new btCompoundShape(true, _colliders.size());
-		_shape->setLocalScaling(ToBt(context->GetScale()));
-		for (auto& collider : _colliders) {
-			_AddColliderToShape(collider.get());
-		}
-		_isShapeDirty = false;
+		// Get our compound shape from the cache, bodies with identical colliders will share it
+		_RebuildShape();
 
 		// Update inertia
 		_shape->calculateLocalInertia(_mass, _inertia);
 		_isMassDirty = false;
 
-		// Create a default motion state instance for tracking the bodies motion
-		_motionState = new btDefaultMotionState();
-
 		// Get the object's starting transform, create a bullet representation for it
 		btTransform transform; 
 		transform.setIdentity();
 		transform.setOrigin(ToBt(context->GetPosition()));
 		transform.setRotation(ToBt(context->GetRotation()));
-		_motionState->setWorldTransform(transform);
+
+		// Create our motion state, which will let us know when Bullet moves the body
+		_motionState = new MotionState(this, transform);
+		_prevTransform = transform;
+		_currTransform = transform;
+		_syncedTransformVersion = context->GetTransformVersion();
 
 		// Create the bullet rigidbody and add it to the physics scene
 		_body = new btRigidBody(_mass, _motionState, _shape, _inertia);
@@ -231,7 +386,11 @@ namespace Gameplay::Physics {
 			_body->setCollisionFlags(_body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
 		}
 	
-		_body->setActivationState(DISABLE_DEACTIVATION);
+		// Dynamic bodies can go to sleep once they come to rest so Bullet stops moving (and reporting) them,
+		// kinematic bodies need to stay awake so that Bullet keeps reading their motion state
+		if (_type != RigidBodyType::Dynamic) {
+			_body->setActivationState(DISABLE_DEACTIVATION);
+		}
 
 		// Copy over group and mask info
 		_body->getBroadphaseProxy()->m_collisionFilterGroup = _collisionGroup;
@@ -273,18 +432,21 @@ namespace Gameplay::Physics {
 		if (_type == RigidBodyType::Dynamic) {
 			// If outside code has changed our velocity, send that to Bullet
 			if (_linearVelocityDirty) {
+				_body->activate();
 				_body->setLinearVelocity(_linearVelocity);
 				_linearVelocityDirty = false;
 			}
 
 			// If outside code has changed our angular velocity, send that to Bullet
 			if (_angularVelocityDirty) {
+				_body->activate();
 				_body->setAngularVelocity(_angularVelocity);
 				_angularVelocityDirty = false;
 			}
 
 			// If outside code has changed the angular factor, send to Bullet
 			if (_angularFactorDirty) {
+				_body->activate();
 				_body->setAngularFactor(_angularFactor);
 				_angularFactorDirty = false;
 			}
@@ -309,6 +471,7 @@ namespace Gameplay::Physics {
 				// Recalulcate our inertia properties and send to bullet
 				_shape->calculateLocalInertia(_mass, _inertia);
 				_body->setMassProps(_mass, _inertia);
+				_body->activate();
 			}
 			_isMassDirty = false;
 		}
@@ -318,5 +481,17 @@ namespace Gameplay::Physics {
 		return _body != nullptr ? _body->getBroadphaseProxy() : nullptr;
 	}
 
+	btCollisionObject* RigidBody::_GetCollisionObject() {
+		return _body;
+	}
+
+	void RigidBody::_OnContactBegin(const std::shared_ptr<RigidBody>& body) {
+		GetGameObject()->OnCollisionEntered(body);
+	}
+
+	void RigidBody::_OnContactEnd(const std::shared_ptr<RigidBody>& body) {
+		GetGameObject()->OnCollisionLeaving(body);
+	}
+
 }
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <mutex>
 #include <EnumToString.h>
 #include <btBulletCollisionCommon.h>
 #include <btBulletDynamicsCommon.h>
@@ -109,12 +110,18 @@ namespace Gameplay::Physics {
 		/// <summary>
 		/// Applies a force in world space to this object, this would be used
 		/// if you want to apply a force every frame on an object
+		/// 
+		/// Forces applied outside of a fixed step (ex from Update) act on every
+		/// step in the frame, forces applied from FixedUpdate only act on that step
 		/// </summary>
 		/// <param name="worldForce">The force in world space and Newtons</param>
 		void ApplyForce(const glm::vec3& worldForce);
 		/// <summary>
 		/// Applies a force in world space to this object, this would be used
 		/// if you want to apply a force every frame on an object
+		/// 
+		/// Forces applied outside of a fixed step (ex from Update) act on every
+		/// step in the frame, forces applied from FixedUpdate only act on that step
 		/// </summary>
 		/// <param name="worldForce">The force in world space and Newtons</param>
 		/// <param name="localOffset">The offset from the object in worldspace units to apply the force</param>
@@ -132,7 +139,8 @@ namespace Gameplay::Physics {
 		/// <param name="localOffset">The offset from the object in worldspace units to apply the impulse</param>
 		void ApplyImpulse(const glm::vec3& worldForce, const glm::vec3& localOffset);
 		/// <summary>
-		/// Applies torque (rotational energy) to the object
+		/// Applies torque (rotational energy) to the object, like forces this lasts
+		/// for the whole frame if applied outside of a fixed step
 		/// </summary>
 		/// <param name="worldTorque">The torque, in world units and in Nm</param>
 		void ApplyTorque(const glm::vec3& worldTorque);
@@ -159,12 +167,43 @@ namespace Gameplay::Physics {
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPreStep(float dt) override;
 		/// <summary>
-		/// Invoked for each RigidBody after the physics world is stepped forward a frame,
+		/// Invoked for each RigidBody that Bullet moved during the last step,
 		/// handles copying transform to the OpenGL state
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPostStep(float dt) override;
 
+		/// <summary>
+		/// Invokes PhysicsPostStep on only the bodies that Bullet reported as moved during
+		/// the last step, sleeping and static bodies are skipped entirely
+		/// </summary>
+		/// <param name="dt">The time in seconds since the last frame</param>
+		static void SyncMovedBodies(float dt);
+		/// <summary>
+		/// Moves the gameobjects of bodies that moved in the last step to a blend between their
+		/// transforms from the last two steps, so rendering is smooth when frames and steps don't line up
+		/// 
+		/// The blended transforms are only for rendering, RestoreSimulatedTransforms needs to be called
+		/// before anything reads or steps the simulation again
+		/// </summary>
+		/// <param name="alpha">How far we are between the last step and the next one, in the range [0, 1]</param>
+		static void InterpolateBodies(float alpha);
+		/// <summary>
+		/// Moves the gameobjects of interpolated bodies back to the result of the last step, so that gameplay
+		/// and physics never see a blended transform. Bodies whose gameobject has been moved by something else
+		/// since they were interpolated are left alone, so that the move gets sent to Bullet
+		/// </summary>
+		static void RestoreSimulatedTransforms();
+		/// <summary>
+		/// Applies the forces and torques that were applied to bodies outside of a fixed step this frame,
+		/// should be called before each step since Bullet clears forces after stepping
+		/// </summary>
+		static void ApplyFrameForces();
+		/// <summary>
+		/// Drops the forces and torques applied outside of a fixed step, called once the frame's steps are done
+		/// </summary>
+		static void ClearFrameForces();
+
 		// Inherited from IComponent
 		virtual void Awake() override;
 		virtual void RenderImGui() override;
@@ -173,6 +212,27 @@ namespace Gameplay::Physics {
 		MAKE_TYPENAME(RigidBody)
 
 	protected:
+		/// <summary>
+		/// Motion state that lets Bullet tell us when it has moved a body, rather than us
+		/// polling every body after each step
+		/// </summary>
+		class MotionState : public btMotionState {
+		public:
+			MotionState(RigidBody* owner, const btTransform& transform);
+
+			// Sets the transform without notifying the owner, used when the gameobject drives the body
+			void SetTransform(const btTransform& transform);
+			const btTransform& GetTransform() const;
+
+			// Inherited from btMotionState
+			virtual void getWorldTransform(btTransform& worldTrans) const override;
+			virtual void setWorldTransform(const btTransform& worldTrans) override;
+
+		private:
+			RigidBody*  _owner;
+			btTransform _transform;
+		};
+
 		// The physics update mode for the body (static, dynamic, kinematic)
 		RigidBodyType _type;
 
@@ -188,7 +248,7 @@ namespace Gameplay::Physics {
 
 		// Our bullet state stuff
 		btRigidBody*     _body;
-		btMotionState*   _motionState;
+		MotionState*     _motionState;
 		btVector3        _inertia;
 		btVector3        _linearVelocity;
 		bool             _linearVelocityDirty;
@@ -196,11 +256,37 @@ namespace Gameplay::Physics {
 		bool             _angularVelocityDirty;
 		btVector3        _angularFactor;
 		bool             _angularFactorDirty;
+		// True if this body is in _movedBodies, waiting for its transform to be copied out
+		bool             _isQueuedForSync;
+		// Our transforms at the end of the last two steps, for render interpolation
+		btTransform      _prevTransform;
+		btTransform      _currTransform;
+		// True if this body is in _interpolatingBodies
+		bool             _isInterpolating;
+		// The force and torque applied outside of a fixed step this frame, re-applied before each step
+		btVector3        _frameForce;
+		btVector3        _frameTorque;
+		// True if this body is in _forcedBodies
+		bool             _hasFrameForces;
 
+		// Bodies that Bullet has moved since the last call to SyncMovedBodies, the mutex is needed
+		// since the multithreaded world may update motion states from worker threads
+		static std::vector<RigidBody*> _movedBodies;
+		static std::mutex              _movedBodiesMutex;
+		// Bodies that moved during the last step, and need interpolating until the next one
+		static std::vector<RigidBody*> _interpolatingBodies;
+		// Bodies that have had forces applied outside of a fixed step this frame
+		static std::vector<RigidBody*> _forcedBodies;
 
 		// Handles resolving any dirty state stuff for our object
 		void _HandleStateDirty();
+		// Adds a force and torque to this frame's totals, making sure we're in _forcedBodies
+		void _AddFrameForce(const btVector3& force, const btVector3& torque);
 
 		virtual btBroadphaseProxy* _GetBroadphaseHandle() override;
+		virtual btCollisionObject* _GetCollisionObject() override;
+
+		virtual void _OnContactBegin(const std::shared_ptr<RigidBody>& body) override;
+		virtual void _OnContactEnd(const std::shared_ptr<RigidBody>& body) override;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "Gameplay/Physics/ShapeCache.h"
+#include <chrono>
+
+#include "Utils/GlmBulletConversions.h"
+#include "Utils/ImGuiHelper.h"
+
+#include "Logging.h"
+
+namespace Gameplay::Physics {
+	std::unordered_map<std::string, ShapeCache::Entry> ShapeCache::_shapes;
+	size_t ShapeCache::_bytesSaved = 0;
+	double ShapeCache::_timeSavedMs = 0.0;
+	size_t ShapeCache::_references = 0;
+
+	// Appends the raw bytes of a vector to a key, exact float matching is what we want here
+	static void AppendVec3(std::string& key, const glm::vec3& value) {
+		key.append(reinterpret_cast<const char*>(&value.x), sizeof(glm::vec3));
+	}
+
+	btCompoundShape* ShapeCache::Acquire(const std::vector<ICollider::Sptr>& colliders, const glm::vec3& baseScale, const glm::vec3& scale, std::string& outKey) {
+		// Build the canonical description of the collider list
+		std::string key;
+		for (const auto& collider : colliders) {
+			key += collider->GetShapeKey();
+			AppendVec3(key, collider->GetPosition());
+			AppendVec3(key, collider->GetRotation());
+			AppendVec3(key, collider->GetScale());
+			key += '|';
+		}
+		AppendVec3(key, baseScale);
+		AppendVec3(key, scale);
+		outKey = key;
+		_references++;
+
+		// Another body already has this exact shape, share it
+		auto it = _shapes.find(key);
+		if (it != _shapes.end()) {
+			Entry& entry = it->second;
+			entry.RefCount++;
+			_bytesSaved  += entry.Bytes;
+			_timeSavedMs += entry.BuildTimeMs;
+			for (int ix = 0; ix < colliders.size(); ix++) {
+				colliders[ix]->_shape = entry.Children[ix];
+			}
+			return entry.Shape;
+		}
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		Entry entry;
+		entry.RefCount = 1;
+		entry.Shape = new btCompoundShape(true, (int)colliders.size());
+		entry.Bytes = sizeof(btCompoundShape);
+
+		// The compound is scaled to the base scale before children are added, so colliders are sized
+		// relative to the object's scale when it was set up
+		entry.Shape->setLocalScaling(ToBt(baseScale));
+		for (const auto& collider : colliders) {
+			btCollisionShape* child = collider->CreateShape();
+			collider->_shape = child;
+			entry.Children.push_back(child);
+
+			if (child != nullptr) {
+				// We convert our shape parameters to a bullet transform
+				btTransform transform;
+				transform.setIdentity();
+				transform.setOrigin(ToBt(collider->GetPosition()));
+				transform.setRotation(ToBt(glm::quat(glm::radians(collider->GetRotation()))));
+				child->setLocalScaling(ToBt(collider->GetScale()));
+
+				entry.Shape->addChildShape(transform, child);
+				entry.Bytes += sizeof(btCompoundShapeChild) + child->calculateSerializeBufferSize();
+			}
+		}
+		// Apply any change in scale since setup
+		if (scale != baseScale) {
+			entry.Shape->setLocalScaling(ToBt(scale));
+		}
+
+		auto endTime = std::chrono::high_resolution_clock::now();
+		entry.BuildTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+		_shapes[key] = entry;
+		return entry.Shape;
+	}
+
+	void ShapeCache::Release(const std::string& key) {
+		auto it = _shapes.find(key);
+		if (it == _shapes.end()) {
+			LOG_WARN("Releasing a collision shape that is not in the cache!");
+			return;
+		}
+
+		Entry& entry = it->second;
+		entry.RefCount--;
+		_references--;
+		if (entry.RefCount > 0) {
+			_bytesSaved -= entry.Bytes;
+			return;
+		}
+
+		// Last user is gone, clean up the compound and all the children we created
+		delete entry.Shape;
+		for (btCollisionShape* child : entry.Children) {
+			delete child;
+		}
+		_shapes.erase(it);
+	}
+
+	size_t ShapeCache::GetShapeCount() {
+		return _shapes.size();
+	}
+
+	size_t ShapeCache::GetBytesSaved() {
+		return _bytesSaved;
+	}
+
+	double ShapeCache::GetTimeSavedMs() {
+		return _timeSavedMs;
+	}
+
+	void ShapeCache::RenderImGui() {
+		ImGui::Text("Shapes: %d unique for %d bodies", (int)_shapes.size(), (int)_references);
+		ImGui::Text("Memory saved: %.2f KB", _bytesSaved / 1024.0f);
+		ImGui::Text("Build time saved: %.3f ms", _timeSavedMs);
+	}
+}
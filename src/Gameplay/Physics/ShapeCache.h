@@ -0,0 +1,67 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <string>
+
+#include "Gameplay/Physics/ICollider.h"
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// Shares compound collision shapes between physics bodies with identical collider lists. Shapes are
+	/// keyed by a canonical description of every collider (type, parameters, local transform) along with
+	/// the body's scale, and are reference counted so that they are deleted when the last body using them
+	/// releases its reference
+	///
+	/// The cache owns the compound shapes and all of their children, colliders only keep a non-owning
+	/// pointer to their child shape
+	/// </summary>
+	class ShapeCache {
+	public:
+		ShapeCache() = delete;
+
+		/// <summary>
+		/// Gets a compound shape for the given colliders, creating one if no body is using an identical shape.
+		/// Every call must be balanced by a call to Release with the key that was returned
+		/// </summary>
+		/// <param name="colliders">The colliders to build the shape from, these must already be awake</param>
+		/// <param name="baseScale">The scale of the object when the colliders were set up, colliders are sized relative to this</param>
+		/// <param name="scale">The current scale of the object</param>
+		/// <param name="outKey">Will receive the key that should be passed to Release</param>
+		/// <returns>The shared compound shape</returns>
+		static btCompoundShape* Acquire(const std::vector<ICollider::Sptr>& colliders, const glm::vec3& baseScale, const glm::vec3& scale, std::string& outKey);
+		/// <summary>
+		/// Releases a reference to a shape returned by Acquire, deleting the shape if it is no longer in use
+		/// </summary>
+		/// <param name="key">The key that was returned by Acquire</param>
+		static void Release(const std::string& key);
+
+		/// <summary>
+		/// Gets the number of unique shapes currently alive
+		/// </summary>
+		static size_t GetShapeCount();
+		/// <summary>
+		/// Gets the estimated number of bytes that sharing has saved, compared to giving each body its own shape
+		/// </summary>
+		static size_t GetBytesSaved();
+		/// <summary>
+		/// Gets the total time in milliseconds that would have been spent building shapes that were shared instead
+		/// </summary>
+		static double GetTimeSavedMs();
+
+		static void RenderImGui();
+
+	protected:
+		struct Entry {
+			btCompoundShape*               Shape;
+			std::vector<btCollisionShape*> Children;
+			int                            RefCount;
+			size_t                         Bytes;
+			double                         BuildTimeMs;
+		};
+
+		static std::unordered_map<std::string, Entry> _shapes;
+		static size_t _bytesSaved;
+		static double _timeSavedMs;
+		static size_t _references;
+	};
+}
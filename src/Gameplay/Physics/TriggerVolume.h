@@ -4,7 +4,7 @@
 #include "Gameplay/Physics/RigidBody.h"
 #include "EnumToString.h"
 
-class btPairCachingGhostObject;
+class btGhostObject;
 
 namespace Gameplay::Physics {
 
@@ -33,8 +33,8 @@ namespace Gameplay::Physics {
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPreStep(float dt) override;
 		/// <summary>
-		/// Invoked for each RigidBody after the physics world is stepped forward a frame,
-		/// handles copying transform to the OpenGL state
+		/// Invoked for each TriggerVolume after the physics world is stepped forward a frame,
+		/// enter and leave events are handled for the whole world by the scene's ContactDispatcher
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPostStep(float dt) override;
@@ -51,12 +51,17 @@ namespace Gameplay::Physics {
 		MAKE_TYPENAME(TriggerVolume);
 
 	protected:
-		btPairCachingGhostObject*   _ghost;
+		btGhostObject*              _ghost;
 		TriggerTypeFlags            _typeFlags;
 
-		std::vector<std::weak_ptr<RigidBody>> _currentCollisions;
-
 		virtual btBroadphaseProxy* _GetBroadphaseHandle() override;
+		virtual btCollisionObject* _GetCollisionObject() override;
+
+		// Returns true if the body's type matches our type flags, and it's not attached to our own gameobject
+		bool _AcceptsBody(const std::shared_ptr<RigidBody>& body) const;
+
+		virtual void _OnContactBegin(const std::shared_ptr<RigidBody>& body) override;
+		virtual void _OnContactEnd(const std::shared_ptr<RigidBody>& body) override;
 
 	};
 }
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "Gameplay/RenderSnapshot.h"
+#include <algorithm>
+#include <chrono>
+#include <GLM/gtc/matrix_transform.hpp>
+
+#include "Gameplay/GameObject.h"
+#include "Gameplay/Components/ComponentManager.h"
+#include "Gameplay/Components/RenderComponent.h"
+#include "Utils/Profiler.h"
+
+namespace Gameplay {
+	void RenderSnapshot::Extract(Scene& scene, const glm::ivec2& viewportSize) {
+		PROFILE_SCOPE("RenderSnapshot::Extract");
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		Camera::Sptr cameras[NUM_VIEWS] = { scene.MainCamera, scene.MainCamera2 };
+		for (int ix = 0; ix < NUM_VIEWS; ix++) {
+			ViewState& view = _views[ix];
+			view.IsValid = cameras[ix] != nullptr;
+			if (view.IsValid) {
+				view.View           = cameras[ix]->GetView();
+				view.Projection     = cameras[ix]->GetProjection();
+				view.ViewProjection = cameras[ix]->GetViewProjection();
+				view.Position       = cameras[ix]->GetGameObject()->GetPosition();
+			}
+		}
+
+		// Clearing keeps the capacity, so this only allocates when the scene grows
+		_items.clear();
+		ComponentManager::Each<RenderComponent>([&](const RenderComponent::Sptr& renderable) {
+			if (renderable->GetMesh() == nullptr) {
+				return;
+			}
+
+			// If we don't have a material, try getting the scene's fallback material
+			// If none exists, do not draw anything
+			if (renderable->GetMaterial() == nullptr) {
+				if (scene.DefaultMaterial != nullptr) {
+					renderable->SetMaterial(scene.DefaultMaterial);
+				} else {
+					return;
+				}
+			}
+
+			DrawItem& item = _items.emplace_back();
+			item.Mesh      = renderable->GetMesh();
+			item.Material  = renderable->GetMaterial();
+			item.Transform = renderable->GetGameObject()->GetTransform();
+			item.BatchKey  = item.Material->GetBatchKey();
+
+			MorphAnimator::Sptr animator = renderable->GetComponent<MorphAnimator>();
+			item.IsMorphed = animator != nullptr;
+			if (item.IsMorphed) {
+				item.Morph = animator->GetMorphState();
+			}
+		});
+
+		PROFILE_COUNTER("Draw Items", _items.size());
+
+		// Sort our renderables so that materials which share GPU state get drawn back to back
+		std::sort(_items.begin(), _items.end(), [](const DrawItem& a, const DrawItem& b) {
+			return a.BatchKey < b.BatchKey;
+		});
+
+		// Record each viewport's GUI, to be drawn over the scene later
+		glm::mat4 proj = glm::ortho(0.0f, (float)viewportSize.x, (float)viewportSize.y, 0.0f, -1.0f, 1.0f);
+		GuiBatcher::SetProjection(proj);
+		GuiBatcher::SetWindowSize(viewportSize);
+		for (int ix = 0; ix < NUM_VIEWS; ix++) {
+			GuiBatcher::BeginCapture(_views[ix].Gui);
+			scene.RenderGUI(ix + 1);
+			GuiBatcher::EndCapture();
+		}
+
+		auto endTime = std::chrono::high_resolution_clock::now();
+		_extractTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <GLM/glm.hpp>
+
+#include "Gameplay/Scene.h"
+#include "Gameplay/Material.h"
+#include "Gameplay/Components/MorphAnimator.h"
+#include "Graphics/VertexArrayObject.h"
+#include "Graphics/GuiBatcher.h"
+
+namespace Gameplay {
+	/// <summary>
+	/// A copy of everything needed to draw a frame of a scene: the camera for each viewport, the transform,
+	/// mesh, material and animation state of every renderable, and the GUI for each viewport. Once a
+	/// snapshot has been extracted, the scene can keep simulating (ex on another thread) while the snapshot
+	/// is drawn, since drawing never reads the scene's objects
+	///
+	/// The buffers are reused between frames, so a snapshot should be kept around and extracted into
+	/// every frame rather than created per frame
+	/// </summary>
+	class RenderSnapshot {
+	public:
+		// The number of viewports (split screen cameras) we capture
+		static constexpr int NUM_VIEWS = 2;
+
+		struct ViewState {
+			bool                 IsValid = false;
+			glm::mat4            View;
+			glm::mat4            Projection;
+			glm::mat4            ViewProjection;
+			glm::vec3            Position;
+			// The GUI drawn on top of this view's viewport
+			GuiBatcher::DrawList Gui;
+		};
+
+		struct DrawItem {
+			VertexArrayObject::Sptr   Mesh;
+			Gameplay::Material::Sptr  Material;
+			glm::mat4                 Transform;
+			uint64_t                  BatchKey;
+			bool                      IsMorphed;
+			MorphAnimator::MorphState Morph;
+		};
+
+		RenderSnapshot() = default;
+
+		/// <summary>
+		/// Copies the render state out of the scene, nothing may modify the scene while this is running.
+		/// Must be called from the thread that owns the GL context, since building the GUI may load font atlases
+		/// </summary>
+		/// <param name="scene">The scene to extract from</param>
+		/// <param name="viewportSize">The size of each view's viewport in pixels, used for the GUI</param>
+		void Extract(Scene& scene, const glm::ivec2& viewportSize);
+
+		const ViewState& GetView(int index) const { return _views[index]; }
+		/// <summary>
+		/// Gets the renderables, sorted so that materials which share GPU state are next to each other
+		/// </summary>
+		const std::vector<DrawItem>& GetItems() const { return _items; }
+		/// <summary>
+		/// Gets how long the last call to Extract took, in milliseconds
+		/// </summary>
+		double GetExtractTimeMs() const { return _extractTimeMs; }
+
+	protected:
+		ViewState             _views[NUM_VIEWS];
+		std::vector<DrawItem> _items;
+		double                _extractTimeMs = 0.0;
+	};
+}
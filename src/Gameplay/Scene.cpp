@@ -3,27 +3,72 @@
 #include <GLFW/glfw3.h>
 #include <locale>
 #include <codecvt>
+#include <chrono>
+#include <cmath>
+#include <LinearMath/btThreads.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
 
 #include "Utils/FileHelpers.h"
 #include "Utils/GlmBulletConversions.h"
+#include "Utils/Profiler.h"
 
 #include "Gameplay/Physics/RigidBody.h"
 #include "Gameplay/Physics/TriggerVolume.h"
 #include "Gameplay/MeshResource.h"
+#include "Gameplay/Components/RenderComponent.h"
 
 #include "Graphics/DebugDraw.h"
+#include "Graphics/GpuProfiler.h"
 #include "Graphics/TextureCube.h"
+#include "Graphics/TextureStreamer.h"
 #include "Graphics/VertexArrayObject.h"
 
 namespace Gameplay {
-	Scene::Scene() :
+	// Checks whether a bounding sphere is at least partly inside the frustum of a view projection matrix
+	inline bool IsSphereInFrustum(const glm::mat4& viewProjection, const glm::vec3& center, float radius) {
+		// The frustum planes are the sums and differences of the last row with each of the others
+		glm::mat4 rows = glm::transpose(viewProjection);
+		glm::vec4 planes[6] = {
+			rows[3] + rows[0], rows[3] - rows[0],
+			rows[3] + rows[1], rows[3] - rows[1],
+			rows[3] + rows[2], rows[3] - rows[2]
+		};
+		for (const glm::vec4& plane : planes) {
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius * glm::length(glm::vec3(plane))) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	btITaskScheduler* Scene::_taskScheduler = nullptr;
+	int               Scene::_physicsThreadCount = 0;
+	uint64_t          Scene::_nextSerial = 1;
+
+	Scene::Scene(bool headless) :
 		_objects(std::vector<GameObject::Sptr>()),
 		_deletionQueue(std::vector<std::weak_ptr<GameObject>>()),
 		Lights(std::vector<Light>()),
 		IsPlaying(false),
 		MainCamera(nullptr),
 		DefaultMaterial(nullptr),
+		Window(nullptr),
 		_isAwake(false),
+		_isHeadless(headless),
+		_serial(_nextSerial++),
+		_frameTimings(),
+		_isPhysicsMultithreaded(false),
+		_contactDispatcher(),
+		_fixedTimeStep(1.0f / 60.0f),
+		_maxSimulationSteps(5),
+		_simulationAccumulator(0.0f),
+		_lastSimulationSteps(0),
+		_interpolationAlpha(0.0f),
+		_isInFixedStep(false),
+		_simulationStep(0),
+		_postStepCallback(nullptr),
 		_filePath(""),
 		_skyboxShader(nullptr),
 		_skyboxMesh(nullptr),
@@ -31,10 +76,14 @@ namespace Gameplay {
 		_skyboxRotation(glm::mat3(1.0f)),
 		_gravity(glm::vec3(0.0f, 0.0f, -9.81f))
 	{
-		_lightingUbo = std::make_shared<UniformBuffer<LightingUboStruct>>();
-		_lightingUbo->GetData().AmbientCol = glm::vec3(0.1f);
-		_lightingUbo->Update();
-		_lightingUbo->Bind(LIGHT_UBO_BINDING_SLOT);
+		// Headless scenes have no GL context to create buffers in
+		_headlessLighting = LightingUboStruct();
+		if (!_isHeadless) {
+			_lightingUbo = std::make_shared<UniformBuffer<LightingUboStruct>>();
+			_lightingUbo->Bind(LIGHT_UBO_BINDING_SLOT);
+		}
+		_GetLightingData().AmbientCol = glm::vec3(0.1f);
+		_UpdateLightingUbo();
 
 		_InitPhysics();
 
@@ -49,6 +98,134 @@ namespace Gameplay {
 		_bulletDebugDraw->setDebugMode((btIDebugDraw::DebugDrawModes)mode);
 	}
 
+	void Scene::SetPhysicsMultithreaded(bool enabled) {
+		if (enabled == _isPhysicsMultithreaded) {
+			return;
+		}
+		if (_isAwake) {
+			LOG_WARN("Physics threading can only be changed before the scene is awoken");
+			return;
+		}
+
+		// Nothing has been added to the world yet, so we can just re-create it
+		int debugMode = _bulletDebugDraw->getDebugMode();
+		_CleanupPhysics();
+		delete _bulletDebugDraw;
+		_isPhysicsMultithreaded = enabled;
+		_InitPhysics();
+		_bulletDebugDraw->setDebugMode(debugMode);
+	}
+
+	bool Scene::IsPhysicsMultithreaded() const {
+		return _isPhysicsMultithreaded;
+	}
+
+	void Scene::SetPhysicsThreadCount(int numThreads) {
+		_physicsThreadCount = numThreads;
+		if (_taskScheduler != nullptr) {
+			_taskScheduler->setNumThreads(numThreads > 0 ? numThreads : _taskScheduler->getMaxNumThreads());
+		}
+	}
+
+	int Scene::GetPhysicsThreadCount() {
+		return _taskScheduler != nullptr ? _taskScheduler->getNumThreads() : 1;
+	}
+
+	btITaskScheduler* Scene::_GetTaskScheduler() {
+		static bool isInitialized = false;
+		if (!isInitialized) {
+			isInitialized = true;
+			// Returns nullptr when Bullet was built without BT_THREADSAFE
+			_taskScheduler = btCreateDefaultTaskScheduler();
+			if (_taskScheduler != nullptr) {
+				_taskScheduler->setNumThreads(_physicsThreadCount > 0 ? _physicsThreadCount : _taskScheduler->getMaxNumThreads());
+				btSetTaskScheduler(_taskScheduler);
+				LOG_INFO("Physics task scheduler \"{}\" running with {} threads", _taskScheduler->getName(), _taskScheduler->getNumThreads());
+			} else {
+				LOG_WARN("Bullet was not built with BT_THREADSAFE, multithreaded physics is unavailable");
+			}
+		}
+		return _taskScheduler;
+	}
+
+	void Scene::BenchmarkPhysicsThreading(const std::vector<int>& bodyCounts, int numSteps) {
+		// Runs the test in a standalone world, so it does not disturb the scene
+		auto runWorld = [&](bool multithreaded, int numBodies) {
+			btDefaultCollisionConfiguration config;
+			btDbvtBroadphase broadphase;
+			btCollisionDispatcher* dispatcher;
+			btConstraintSolver* solver;
+			btDiscreteDynamicsWorld* world;
+			if (multithreaded) {
+				dispatcher = new btCollisionDispatcherMt(&config);
+				solver = new btConstraintSolverPoolMt(BT_MAX_THREAD_COUNT);
+				world = new btDiscreteDynamicsWorldMt(dispatcher, &broadphase, static_cast<btConstraintSolverPoolMt*>(solver), nullptr, &config);
+			} else {
+				dispatcher = new btCollisionDispatcher(&config);
+				solver = new btSequentialImpulseConstraintSolver();
+				world = new btDiscreteDynamicsWorld(dispatcher, &broadphase, solver, &config);
+			}
+			world->setGravity(btVector3(0.0f, 0.0f, -9.81f));
+
+			std::vector<btRigidBody*> bodies;
+			btStaticPlaneShape ground(btVector3(0.0f, 0.0f, 1.0f), 0.0f);
+			bodies.push_back(new btRigidBody(0.0f, nullptr, &ground));
+			world->addRigidBody(bodies.back());
+
+			// Drop the boxes in a set of separate piles, so there are many islands to solve in parallel
+			btBoxShape box(btVector3(0.5f, 0.5f, 0.5f));
+			btVector3 inertia;
+			box.calculateLocalInertia(1.0f, inertia);
+			const int pileSize = 50;
+			int numPiles = (numBodies + pileSize - 1) / pileSize;
+			int side = (int)ceil(sqrt((double)numPiles));
+			for (int ix = 0; ix < numBodies; ix++) {
+				int pile = ix / pileSize;
+				int level = ix % pileSize;
+				btTransform transform;
+				transform.setIdentity();
+				transform.setOrigin(btVector3(
+					(pile % side) * 6.0f + (level % 2) * 0.25f,
+					(pile / side) * 6.0f + ((level / 2) % 2) * 0.25f,
+					0.5f + level * 1.1f
+				));
+				bodies.push_back(new btRigidBody(1.0f, new btDefaultMotionState(transform), &box, inertia));
+				world->addRigidBody(bodies.back());
+			}
+
+			double total = 0.0;
+			for (int step = 0; step < numSteps; step++) {
+				auto start = std::chrono::high_resolution_clock::now();
+				world->stepSimulation(1.0f / 60.0f, 1, 1.0f / 60.0f);
+				auto end = std::chrono::high_resolution_clock::now();
+				total += std::chrono::duration<double, std::milli>(end - start).count();
+			}
+
+			for (btRigidBody* body : bodies) {
+				world->removeRigidBody(body);
+				delete body->getMotionState();
+				delete body;
+			}
+			delete world;
+			delete solver;
+			delete dispatcher;
+
+			return total / numSteps;
+		};
+
+		bool canThread = _GetTaskScheduler() != nullptr;
+		LOG_INFO("Physics threading benchmark ({} steps, {} threads)", numSteps, GetPhysicsThreadCount());
+		for (int numBodies : bodyCounts) {
+			double single = runWorld(false, numBodies);
+			if (canThread) {
+				double multi = runWorld(true, numBodies);
+				LOG_INFO("\t{} bodies: single {:.3f} ms, multi {:.3f} ms ({:.2f}x)", numBodies, single, multi, single / multi);
+			} else {
+				LOG_INFO("\t{} bodies: single {:.3f} ms", numBodies, single);
+			}
+		}
+	}
+
 	void Scene::SetSkyboxShader(const std::shared_ptr<Shader>& shader) {
 		_skyboxShader = shader;
 	}
@@ -67,8 +244,8 @@ namespace Gameplay {
 
 	void Scene::SetSkyboxRotation(const glm::mat3& value) {
 		_skyboxRotation = value;
-		_lightingUbo->GetData().EnvironmentRotation = value;
-		_lightingUbo->Update();
+		_GetLightingData().EnvironmentRotation = value;
+		_UpdateLightingUbo();
 	}
 
 	const glm::mat3& Scene::GetSkyboxRotation() const {
@@ -104,28 +281,35 @@ namespace Gameplay {
 	}
 
 	void Scene::SetAmbientLight(const glm::vec3& value) {
-		_lightingUbo->GetData().AmbientCol = glm::vec3(0.1f);
-		_lightingUbo->Update();
+		_GetLightingData().AmbientCol = glm::vec3(0.1f);
+		_UpdateLightingUbo();
 	}
 
 	const glm::vec3& Scene::GetAmbientLight() const { 
-		return _lightingUbo->GetData().AmbientCol;
+		return _lightingUbo != nullptr ? _lightingUbo->GetData().AmbientCol : _headlessLighting.AmbientCol;
 	}
 
 	void Scene::Awake() {
+		PROFILE_SCOPE("Scene::Awake");
 		// Not a huge fan of this, but we need to get window size to notify our camera
 		// of the current screen size
-		int width, height;
-		glfwGetWindowSize(Window, &width, &height);
-		MainCamera->ResizeWindow(width, height);
+		if (Window != nullptr && MainCamera != nullptr) {
+			int width, height;
+			glfwGetWindowSize(Window, &width, &height);
+			MainCamera->ResizeWindow(width, height);
+		}
 
-		if (_skyboxMesh == nullptr) {
+		// The skybox needs a GL context for its mesh
+		if (_skyboxMesh == nullptr && !_isHeadless) {
 			_skyboxMesh = ResourceManager::CreateAsset<MeshResource>();
 			_skyboxMesh->AddParam(MeshBuilderParam::CreateCube(glm::vec3(0.0f), glm::vec3(1.0f)));
 			_skyboxMesh->AddParam(MeshBuilderParam::CreateInvert());
 			_skyboxMesh->GenerateMesh();
 		}
 
+		// Build the collision meshes for any mesh colliders up front, on worker threads
+		_PrebuildCollisionMeshes();
+
 		// Call awake on all gameobjects
 		for (auto& obj : _objects) {
 			obj->Awake();
@@ -136,32 +320,192 @@ namespace Gameplay {
 		_isAwake = true;
 	}
 
+	// Returns the time since the given time point in milliseconds, and resets it to now
+	static double LapMs(std::chrono::high_resolution_clock::time_point& start) {
+		auto now = std::chrono::high_resolution_clock::now();
+		double result = std::chrono::duration<double, std::milli>(now - start).count();
+		start = now;
+		return result;
+	}
+
 	void Scene::DoPhysics(float dt) {
+		PROFILE_SCOPE("Scene::DoPhysics");
+		_frameTimings.FixedUpdate    = 0.0;
+		_frameTimings.PhysicsPreStep = 0.0;
+		_frameTimings.PhysicsStep    = 0.0;
+		_frameTimings.PhysicsSync    = 0.0;
+		_frameTimings.Contacts       = 0.0;
+		_frameTimings.Interpolation  = 0.0;
+		_frameTimings.Steps          = 0;
+
+		// While editing we still need to keep Bullet up to date with any changes to our objects
+		if (!IsPlaying) {
+			auto timer = std::chrono::high_resolution_clock::now();
+			_PhysicsPreStep(_fixedTimeStep);
+			Gameplay::Physics::RigidBody::ClearFrameForces();
+			_frameTimings.PhysicsPreStep = LapMs(timer);
+			return;
+		}
+
+		// Run as many fixed steps as we have time banked for, up to our catch-up limit
+		_simulationAccumulator += dt;
+		int numSteps = 0;
+		while (_simulationAccumulator >= _fixedTimeStep && numSteps < _maxSimulationSteps) {
+			_DoFixedStep(_fixedTimeStep);
+			_simulationAccumulator -= _fixedTimeStep;
+			numSteps++;
+		}
+
+		// If we hit the limit, drop the time we couldn't simulate rather than carrying it into the next frame,
+		// otherwise one hitch would make every following frame run the maximum number of steps
+		if (_simulationAccumulator >= _fixedTimeStep) {
+			_simulationAccumulator = fmodf(_simulationAccumulator, _fixedTimeStep);
+		}
+		_lastSimulationSteps = numSteps;
+		_frameTimings.Steps = numSteps;
+		PROFILE_COUNTER("Physics Steps", numSteps);
+
+		// Forces from Update only last for the frame they were applied in, and anything applied during the
+		// last step (ex from contact events) shouldn't pile up over frames where no steps run
+		Gameplay::Physics::RigidBody::ClearFrameForces();
+		if (numSteps == 0) {
+			_physicsWorld->clearForces();
+		}
+
+		// Render a blend of the last two steps, based on how far we are into the next one
+		_interpolationAlpha = _simulationAccumulator / _fixedTimeStep;
+		PROFILE_SCOPE("Physics Interpolation");
+		auto timer = std::chrono::high_resolution_clock::now();
+		Gameplay::Physics::RigidBody::InterpolateBodies(_interpolationAlpha);
+		_frameTimings.Interpolation = LapMs(timer);
+	}
+
+	void Scene::DrawPhysicsDebug() {
+		PROFILE_SCOPE("Physics Debug Draw");
+		PROFILE_GPU_SCOPE("Physics Debug Draw (GPU)");
+		if (_bulletDebugDraw->getDebugMode() != btIDebugDraw::DBG_NoDebug) {
+			_physicsWorld->debugDrawWorld();
+			DebugDrawer::Get().FlushAll();
+		}
+	}
+
+	void Scene::_PhysicsPreStep(float dt) {
+		PROFILE_SCOPE("Physics Pre Step");
 		ComponentManager::Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
 			body->PhysicsPreStep(dt);
 		});
 		ComponentManager::Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
 			body->PhysicsPreStep(dt);
 		});
+	}
 
-		if (IsPlaying) {
+	void Scene::_DoFixedStep(float dt, bool dispatchEvents) {
+		PROFILE_SCOPE("Physics Fixed Step");
+		auto timer = std::chrono::high_resolution_clock::now();
+		_isInFixedStep = true;
 
-			_physicsWorld->stepSimulation(dt, 15);
+		// Fixed rate gameplay runs first, so that forces and such are applied in the step
+		{
+			PROFILE_SCOPE("Scene::FixedUpdate");
+			for (auto& obj : _objects) {
+				obj->FixedUpdate(dt);
+			}
+		}
+		_frameTimings.FixedUpdate += LapMs(timer);
 
-			ComponentManager::Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
-				body->PhysicsPostStep(dt);
-			});
-			ComponentManager::Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
-				body->PhysicsPostStep(dt);
-			});
-			if (_bulletDebugDraw->getDebugMode() != btIDebugDraw::DBG_NoDebug) {
-				_physicsWorld->debugDrawWorld();
-				DebugDrawer::Get().FlushAll();
+		_PhysicsPreStep(dt);
+		// Bullet clears forces after every step, so the forces from Update need to go in again for each one
+		Gameplay::Physics::RigidBody::ApplyFrameForces();
+		_frameTimings.PhysicsPreStep += LapMs(timer);
+
+		// No sub-stepping, we are handling the fixed step ourselves
+		{
+			PROFILE_SCOPE("Physics Step");
+			_physicsWorld->stepSimulation(dt, 0);
+		}
+		_frameTimings.PhysicsStep += LapMs(timer);
+
+		// Only copy transforms out for the bodies Bullet actually moved
+		{
+			PROFILE_SCOPE("Physics Sync");
+			Gameplay::Physics::RigidBody::SyncMovedBodies(dt);
+		}
+		_frameTimings.PhysicsSync += LapMs(timer);
+
+		// One pass over the world's contacts handles collision and trigger events for every body. The contact
+		// lists are always updated, so that the next step's events are relative to this one
+		{
+			PROFILE_SCOPE("Physics Contacts");
+			_contactDispatcher.Update(_physicsWorld);
+			if (dispatchEvents) {
+				_contactDispatcher.Dispatch();
 			}
 		}
+		_frameTimings.Contacts += LapMs(timer);
+		_isInFixedStep = false;
+
+		_simulationStep++;
+		if (_postStepCallback) {
+			_postStepCallback(_simulationStep);
+		}
+	}
+
+	bool Scene::IsHeadless() const {
+		return _isHeadless;
+	}
+
+	uint64_t Scene::GetSerial() const {
+		return _serial;
+	}
+
+	const Scene::FrameTimings& Scene::GetLastFrameTimings() const {
+		return _frameTimings;
+	}
+
+	Scene::LightingUboStruct& Scene::_GetLightingData() {
+		return _lightingUbo != nullptr ? _lightingUbo->GetData() : _headlessLighting;
+	}
+
+	void Scene::_UpdateLightingUbo() {
+		if (_lightingUbo != nullptr) {
+			_lightingUbo->Update();
+		}
+	}
+
+	void Scene::SetFixedTimeStep(float value) {
+		_fixedTimeStep = glm::max(value, 0.001f);
+	}
+
+	float Scene::GetFixedTimeStep() const {
+		return _fixedTimeStep;
+	}
+
+	void Scene::SetMaxSimulationSteps(int value) {
+		_maxSimulationSteps = glm::max(value, 1);
+	}
+
+	int Scene::GetMaxSimulationSteps() const {
+		return _maxSimulationSteps;
+	}
+
+	int Scene::GetLastSimulationSteps() const {
+		return _lastSimulationSteps;
+	}
+
+	float Scene::GetInterpolationAlpha() const {
+		return _interpolationAlpha;
+	}
+
+	bool Scene::IsInFixedStep() const {
+		return _isInFixedStep;
 	}
 
 	void Scene::Update(float dt) {
+		PROFILE_SCOPE("Scene::Update");
+		auto timer = std::chrono::high_resolution_clock::now();
+		// The last frame left dynamic bodies at their interpolated transforms for rendering, gameplay
+		// and the fixed steps need to start from where the simulation actually is
+		Gameplay::Physics::RigidBody::RestoreSimulatedTransforms();
 		_FlushDeleteQueue();
 		if (IsPlaying) {
 			for (auto& obj : _objects) {
@@ -169,14 +513,58 @@ namespace Gameplay {
 			}
 		}
 		_FlushDeleteQueue();
+		_frameTimings.Update = LapMs(timer);
 	}
 
 	void Scene::PreRender() {
-		_lightingUbo->Bind(LIGHT_UBO_BINDING);
+		if (_lightingUbo != nullptr) {
+			_lightingUbo->Bind(LIGHT_UBO_BINDING);
+		}
+	}
+
+	void Scene::UpdateTextureStreaming(const glm::vec2& viewportSize) {
+		Camera::Sptr cameras[] = { MainCamera, MainCamera2 };
+
+		ComponentManager::Each<RenderComponent>([&](const RenderComponent::Sptr& renderable) {
+			if (renderable->GetMesh() == nullptr || renderable->GetMaterial() == nullptr) {
+				return;
+			}
+
+			// We move the mesh's bounding sphere into world space (scaled by the largest axis, so it still contains
+			// the mesh), and project that into screen space for each camera that can see it, using the largest size we find
+			glm::vec3 center(0.0f);
+			float radius = 1.0f;
+			if (renderable->GetMeshResource() != nullptr) {
+				renderable->GetMeshResource()->GetBoundingSphere(center, radius);
+			}
+			const glm::mat4& transform = renderable->GetGameObject()->GetTransform();
+			center = glm::vec3(transform * glm::vec4(center, 1.0f));
+			radius *= glm::max(glm::length(glm::vec3(transform[0])), glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+
+			float pixels = 0.0f;
+			for (const auto& camera : cameras) {
+				if (camera == nullptr || !IsSphereInFrustum(camera->GetViewProjection(), center, radius)) {
+					continue;
+				}
+				float distance = glm::distance(glm::vec3(camera->GetGameObject()->GetTransform()[3]), center);
+				float projected = radius * camera->GetProjection()[1][1] * viewportSize.y / glm::max(distance, 0.01f);
+				pixels = glm::max(pixels, projected);
+			}
+
+			// Textures that aren't on screen don't need any more mips, they'll be dropped if they stay hidden
+			if (pixels <= 0.0f) {
+				return;
+			}
+
+			renderable->GetMaterial()->EachTexture([&](const ITexture::Sptr& texture) {
+				TextureStreamer::ReportUsage(std::dynamic_pointer_cast<Texture2D>(texture), pixels);
+			});
+		});
 	}
 
 	void Scene::RenderGUI(int viewportID)
 	{
+		PROFILE_SCOPE("Scene::RenderGUI");
 		for (auto& obj : _objects) {
 			// Parents handle rendering for children, so ignore parented objects
 			if (obj->GetParent() == nullptr) {
@@ -188,7 +576,7 @@ namespace Gameplay {
 	void Scene::SetShaderLight(int index, bool update /*= true*/) {
 		if (index >= 0 && index < Lights.size() && index < MAX_LIGHTS) {
 			// Get a reference to the light UBO data so we can update it
-			LightingUboStruct& data = _lightingUbo->GetData();
+			LightingUboStruct& data = _GetLightingData();
 			Light& light = Lights[index];
 
 			// Copy to the ubo data
@@ -197,13 +585,13 @@ namespace Gameplay {
 			data.Lights[index].Attenuation = 1.0f / (1.0f + light.Range);
 
 			// If requested, send the new data to the UBO
-			if (update)	_lightingUbo->Update();
+			if (update)	_UpdateLightingUbo();
 		}
 	}
 
 	void Scene::SetupShaderAndLights() {
 		// Get a reference to the light UBO data so we can update it
-		LightingUboStruct& data = _lightingUbo->GetData();
+		LightingUboStruct& data = _GetLightingData();
 		// Send in how many active lights we have and the global lighting settings
 		data.AmbientCol = glm::vec3(0.1f);
 		data.NumLights = Lights.size();
@@ -214,15 +602,62 @@ namespace Gameplay {
 		}
 
 		// Send updated data to OpenGL
-		_lightingUbo->Update();
+		_UpdateLightingUbo();
 	}
 
 	btDynamicsWorld* Scene::GetPhysicsWorld() const {
 		return _physicsWorld;
 	}
 
+	Physics::ContactDispatcher& Scene::GetContactDispatcher() {
+		return _contactDispatcher;
+	}
+
+	void Scene::Raycast(const Physics::RaycastQuery* queries, Physics::QueryHit* results, int count) const {
+		Physics::PhysicsQueries::Raycast(_physicsWorld, queries, results, count);
+	}
+
+	void Scene::SphereCast(const Physics::SphereCastQuery* queries, Physics::QueryHit* results, int count) const {
+		Physics::PhysicsQueries::SphereCast(_physicsWorld, queries, results, count);
+	}
+
+	void Scene::Overlap(const Physics::OverlapQuery* queries, Physics::OverlapResult* results, int count) const {
+		Physics::PhysicsQueries::Overlap(_physicsWorld, queries, results, count);
+	}
+
+	void Scene::CapturePhysicsSnapshot(Physics::PhysicsSnapshot& snapshot, uint64_t frame) const {
+		// Both our world types are discrete dynamics worlds
+		snapshot.Capture(static_cast<btDiscreteDynamicsWorld*>(_physicsWorld), frame);
+	}
+
+	bool Scene::RestorePhysicsSnapshot(const Physics::PhysicsSnapshot& snapshot) {
+		if (!snapshot.Restore(static_cast<btDiscreteDynamicsWorld*>(_physicsWorld))) {
+			return false;
+		}
+		// The restore updated the motion states, send the transforms out to the gameobjects
+		Gameplay::Physics::RigidBody::SyncMovedBodies(0.0f);
+		_simulationStep = snapshot.GetFrame();
+		return true;
+	}
+
+	void Scene::ResimulatePhysics(int numSteps, float timeStep) {
+		// Re-simulated steps run exactly like live ones so they don't diverge, only the events are held back
+		for (int ix = 0; ix < numSteps; ix++) {
+			_DoFixedStep(timeStep, false);
+		}
+	}
+
+	uint64_t Scene::GetSimulationStep() const {
+		return _simulationStep;
+	}
+
+	void Scene::SetPostStepCallback(const std::function<void(uint64_t)>& callback) {
+		_postStepCallback = callback;
+	}
+
 	Scene::Sptr Scene::FromJson(const nlohmann::json& data)
 	{
+		PROFILE_SCOPE("Scene::FromJson");
 		Scene::Sptr result = std::make_shared<Scene>();
 		result->DefaultMaterial = ResourceManager::Get<Material>(Guid(data["default_material"]));
 
@@ -230,6 +665,11 @@ namespace Gameplay {
 			result->SetAmbientLight(ParseJsonVec3(data["ambient"]));
 		}
 
+		// Needs to be set before any objects are added to the world
+		result->SetPhysicsMultithreaded(JsonGet(data, "physics_multithreaded", false));
+		result->SetFixedTimeStep(JsonGet(data, "fixed_time_step", 1.0f / 60.0f));
+		result->SetMaxSimulationSteps(JsonGet(data, "max_simulation_steps", 5));
+
 		if (data.contains("skybox") && data["skybox"].is_object()) {
 			nlohmann::json& blob = data["skybox"].get<nlohmann::json>();
 			result->_skyboxMesh = ResourceManager::Get<MeshResource>(Guid(blob["mesh"]));
@@ -274,6 +714,9 @@ namespace Gameplay {
 		blob["default_material"] = DefaultMaterial ? DefaultMaterial->GetGUID().str() : "null";
 
 		blob["ambient"] = GlmToJson(GetAmbientLight());
+		blob["physics_multithreaded"] = _isPhysicsMultithreaded;
+		blob["fixed_time_step"] = _fixedTimeStep;
+		blob["max_simulation_steps"] = _maxSimulationSteps;
 
 		blob["skybox"] = nlohmann::json();
 		blob["skybox"]["mesh"] = _skyboxMesh ? _skyboxMesh->GetGUID().str() : "null";
@@ -312,6 +755,7 @@ namespace Gameplay {
 
 	Scene::Sptr Scene::Load(const std::string& path)
 	{
+		PROFILE_SCOPE("Scene::Load");
 		LOG_INFO("Loading scene from \"{}\"", path);
 		std::string content = FileHelpers::ReadFile(path);
 		nlohmann::json blob = nlohmann::json::parse(content);
@@ -329,18 +773,37 @@ namespace Gameplay {
 	}
 
 	void Scene::_InitPhysics() {
+		// Fall back to a single threaded world if we can't get a task scheduler
+		if (_isPhysicsMultithreaded && _GetTaskScheduler() == nullptr) {
+			_isPhysicsMultithreaded = false;
+		}
+
 		_collisionConfig = new btDefaultCollisionConfiguration();
-		_collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
 		_broadphaseInterface = new btDbvtBroadphase();
 		_ghostCallback = new btGhostPairCallback();
 		_broadphaseInterface->getOverlappingPairCache()->setInternalGhostPairCallback(_ghostCallback);
-		_constraintSolver = new btSequentialImpulseConstraintSolver();
-		_physicsWorld = new btDiscreteDynamicsWorld(
-			_collisionDispatcher,
-			_broadphaseInterface,
-			_constraintSolver,
-			_collisionConfig
-		);
+		if (_isPhysicsMultithreaded) {
+			// The dispatcher runs narrowphase in parallel, and the solver pool lets each thread
+			// solve a different simulation island with its own solver
+			_collisionDispatcher = new btCollisionDispatcherMt(_collisionConfig);
+			_constraintSolver = new btConstraintSolverPoolMt(BT_MAX_THREAD_COUNT);
+			_physicsWorld = new btDiscreteDynamicsWorldMt(
+				_collisionDispatcher,
+				_broadphaseInterface,
+				static_cast<btConstraintSolverPoolMt*>(_constraintSolver),
+				nullptr,
+				_collisionConfig
+			);
+		} else {
+			_collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
+			_constraintSolver = new btSequentialImpulseConstraintSolver();
+			_physicsWorld = new btDiscreteDynamicsWorld(
+				_collisionDispatcher,
+				_broadphaseInterface,
+				_constraintSolver,
+				_collisionConfig
+			);
+		}
 		_physicsWorld->setGravity(ToBt(_gravity));
 		// TODO bullet debug drawing
 		_bulletDebugDraw = new BulletDebugDraw();
@@ -348,6 +811,31 @@ namespace Gameplay {
 		_bulletDebugDraw->setDebugMode(btIDebugDraw::DBG_NoDebug);
 	}
 
+	void Scene::_PrebuildCollisionMeshes() {
+		std::vector<MeshResource::Sptr> meshes;
+		auto gatherMeshes = [&](const Gameplay::Physics::PhysicsBase* body) {
+			RenderComponent::Sptr renderer = body->GetGameObject()->Get<RenderComponent>();
+			if (renderer == nullptr || renderer->GetMeshResource() == nullptr) {
+				return;
+			}
+			for (const auto& collider : body->GetColliders()) {
+				ColliderType type = collider->GetType();
+				if (type == ColliderType::ConvexMesh || type == ColliderType::ConcaveMesh) {
+					MeshResource::Sptr mesh = renderer->GetMeshResource();
+					meshes.push_back(mesh->ColliderMeshData != nullptr ? mesh->ColliderMeshData : mesh);
+					return;
+				}
+			}
+		};
+		ComponentManager::Each<Gameplay::Physics::RigidBody>([&](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
+			gatherMeshes(body.get());
+		});
+		ComponentManager::Each<Gameplay::Physics::TriggerVolume>([&](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
+			gatherMeshes(body.get());
+		});
+		MeshResource::BuildBulletTriMeshes(meshes);
+	}
+
 	void Scene::_CleanupPhysics() {
 		delete _physicsWorld;
 		delete _constraintSolver;
@@ -386,18 +874,26 @@ namespace Gameplay {
 
 	void Scene::DrawSkybox(Camera::Sptr cam)
 	{
+		if (cam != nullptr) {
+			DrawSkybox(cam->GetView(), cam->GetProjection());
+		}
+	}
+
+	void Scene::DrawSkybox(const glm::mat4& view, const glm::mat4& projection)
+	{
+		PROFILE_SCOPE("Skybox");
+		PROFILE_GPU_SCOPE("Skybox (GPU)");
 		if (_skyboxShader != nullptr &&
 			_skyboxMesh != nullptr &&
 			_skyboxMesh->Mesh != nullptr &&
-			_skyboxTexture != nullptr &&
-			cam != nullptr) {
+			_skyboxTexture != nullptr) {
 			
 			glDepthMask(false);
 			glDisable(GL_CULL_FACE);
 			glDepthFunc(GL_LEQUAL);
 
 			_skyboxShader->Bind();
-			_skyboxShader->SetUniformMatrix("u_View", cam->GetProjection() * glm::mat4(glm::mat3(cam->GetView())));
+			_skyboxShader->SetUniformMatrix("u_View", projection * glm::mat4(glm::mat3(view)));
 			_skyboxShader->SetUniformMatrix("u_EnvironmentRotation", _skyboxRotation);
 			_skyboxTexture->Bind(0);
 			_skyboxMesh->Mesh->Draw();
@@ -1,4 +1,5 @@
 #pragma once
+#include <functional>
 #include <btBulletDynamicsCommon.h>
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 
@@ -7,10 +8,14 @@
 #include "Gameplay/Light.h"
 
 #include "Physics/BulletDebugDraw.h"
+#include "Gameplay/Physics/ContactDispatcher.h"
+#include "Gameplay/Physics/PhysicsQueries.h"
+#include "Gameplay/Physics/PhysicsSnapshot.h"
 
 #include "Graphics/UniformBuffer.h"
 
 struct GLFWwindow;
+class btITaskScheduler;
 
 class TextureCube;
 class Shader;
@@ -55,11 +60,75 @@ namespace Gameplay {
 		bool                       IsPlaying;
 
 
-		Scene();
+		/// <summary>
+		/// Creates a new scene
+		/// </summary>
+		/// <param name="headless">If true, the scene will not touch GLFW or OpenGL at all, so that it can be simulated without a window</param>
+		Scene(bool headless = false);
 		~Scene();
 
+		/// <summary>
+		/// Gets whether this scene was created without any rendering resources
+		/// </summary>
+		bool IsHeadless() const;
+		/// <summary>
+		/// Gets a number that is unique to this scene for the lifetime of the program, unlike the scene's
+		/// address this is never reused, so it can be used to tell when a scene has been replaced
+		/// </summary>
+		uint64_t GetSerial() const;
+
+		/// <summary>
+		/// The CPU time spent in each phase of the last frame, in milliseconds
+		/// </summary>
+		struct FrameTimings {
+			double Update;
+			double FixedUpdate;
+			double PhysicsPreStep;
+			double PhysicsStep;
+			double PhysicsSync;
+			double Contacts;
+			double Interpolation;
+			int    Steps;
+		};
+		/// <summary>
+		/// Gets the timings for the last calls to Update and DoPhysics
+		/// </summary>
+		const FrameTimings& GetLastFrameTimings() const;
+
 		void SetPhysicsDebugDrawMode(BulletDebugMode mode);
 
+		/// <summary>
+		/// Switches this scene between a single threaded Bullet world and a multithreaded one
+		/// (btDiscreteDynamicsWorldMt), which runs collision dispatch, island solving and
+		/// integration in parallel on Bullet's task scheduler. The world is re-created, so this
+		/// can only be changed before the scene is awoken. If Bullet was not built with
+		/// BT_THREADSAFE, the scene will fall back to a single threaded world
+		/// </summary>
+		/// <param name="enabled">True to use the multithreaded world</param>
+		void SetPhysicsMultithreaded(bool enabled);
+		/// <summary>
+		/// Gets whether this scene's physics world is multithreaded
+		/// </summary>
+		bool IsPhysicsMultithreaded() const;
+
+		/// <summary>
+		/// Sets the number of threads used by Bullet's task scheduler for all multithreaded scenes,
+		/// or 0 to use all available threads
+		/// </summary>
+		static void SetPhysicsThreadCount(int numThreads);
+		/// <summary>
+		/// Gets the number of threads the physics task scheduler is using, or 1 if multithreading is not supported
+		/// </summary>
+		static int GetPhysicsThreadCount();
+
+		/// <summary>
+		/// Runs a standalone physics scaling benchmark, stepping piles of dynamic boxes in single and
+		/// multithreaded worlds for each of the given body counts, and logs the step times
+		/// </summary>
+		/// <param name="bodyCounts">The numbers of dynamic bodies to test with</param>
+		/// <param name="numSteps">The number of 60Hz steps to simulate for each test</param>
+		static void BenchmarkPhysicsThreading(const std::vector<int>& bodyCounts = { 250, 500, 1000, 2000, 4000 }, int numSteps = 300);
+
 		void SetSkyboxShader(const std::shared_ptr<Shader>& shader);
 		std::shared_ptr<Shader> GetSkyboxShader() const;
 
@@ -125,13 +194,44 @@ namespace Gameplay {
 		void Awake();
 
 		/// <summary>
-		/// Performs physics updates for all physics bodies in this scene,
-		/// should be called after Update in the main loop
+		/// Advances the fixed step simulation by the time since the last frame, should be called
+		/// after Update in the main loop. Each fixed step invokes FixedUpdate on all gameobjects and
+		/// then steps physics, afterwards dynamic bodies are interpolated between the last two steps.
+		/// The interpolated transforms are for rendering, the next Update moves the bodies back
 		/// 
 		/// Only invokes events if IsPlaying is true
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
 		void DoPhysics(float dt);
+		/// <summary>
+		/// Draws the physics world with the current physics debug draw mode, using the DebugDrawer's
+		/// current view projection. This reads the physics world, so it may not run at the same time as DoPhysics
+		/// </summary>
+		void DrawPhysicsDebug();
+
+		/// <summary>
+		/// Sets the length of a simulation step, in seconds, default 1/60
+		/// </summary>
+		void SetFixedTimeStep(float value);
+		float GetFixedTimeStep() const;
+		/// <summary>
+		/// Sets the maximum number of fixed steps that can run in a single frame, time beyond
+		/// this is dropped so that the simulation slows down rather than spiraling after a hitch
+		/// </summary>
+		void SetMaxSimulationSteps(int value);
+		int GetMaxSimulationSteps() const;
+		/// <summary>
+		/// Gets the number of fixed steps that ran during the last call to DoPhysics
+		/// </summary>
+		int GetLastSimulationSteps() const;
+		/// <summary>
+		/// Gets how far between the last step and the next one the rendered transforms are, in the range [0, 1]
+		/// </summary>
+		float GetInterpolationAlpha() const;
+		/// <summary>
+		/// Returns true while a fixed step is running (ex during FixedUpdate and contact events)
+		/// </summary>
+		bool IsInFixedStep() const;
 
 		/// <summary>
 		/// Performs updates on all enabled components and gameobjects in the
@@ -147,6 +247,15 @@ namespace Gameplay {
 		/// </summary>
 		void PreRender();
 
+		/// <summary>
+		/// Reports the approximate on-screen size of all textures used by renderables in the scene
+		/// to the TextureStreamer, based on the distance to the closest main camera that can see them.
+		/// Visibility is tested with each mesh's bounding sphere in world space. This must be called on
+		/// the thread with the GL context, since meshes without CollisionData read their bounds back from the GPU
+		/// </summary>
+		/// <param name="viewportSize">The size of the viewport that each camera renders to, in pixels</param>
+		void UpdateTextureStreaming(const glm::vec2& viewportSize);
+
 		/// <summary>
 		/// Draws all GUI objects in the scene
 		/// </summary>
@@ -171,11 +280,76 @@ namespace Gameplay {
 		void DrawAllGameObjectGUIs();
 
 		void DrawSkybox(Camera::Sptr cam);
+		/// <summary>
+		/// Draws the skybox with the given camera matrices, for when the camera may be changing on another thread
+		/// </summary>
+		void DrawSkybox(const glm::mat4& view, const glm::mat4& projection);
 
 		/// <summary>
 		/// Gets the scene's Bullet physics world
 		/// </summary>
 		btDynamicsWorld* GetPhysicsWorld() const;
+		/// <summary>
+		/// Gets the object that tracks touching pairs in the physics world and dispatches contact and trigger events
+		/// </summary>
+		Physics::ContactDispatcher& GetContactDispatcher();
+
+		/// <summary>
+		/// Casts a batch of rays into the physics world, reporting the closest hit for each. Queries are run
+		/// against the state from the last physics step, and are split between the physics threads if available
+		/// </summary>
+		/// <param name="queries">The rays to cast</param>
+		/// <param name="results">Caller provided storage for the results, one per query</param>
+		/// <param name="count">The number of queries in the batch</param>
+		void Raycast(const Physics::RaycastQuery* queries, Physics::QueryHit* results, int count) const;
+		/// <summary>
+		/// Sweeps a batch of spheres through the physics world, reporting the closest hit for each
+		/// </summary>
+		/// <param name="queries">The spheres to cast</param>
+		/// <param name="results">Caller provided storage for the results, one per query</param>
+		/// <param name="count">The number of queries in the batch</param>
+		void SphereCast(const Physics::SphereCastQuery* queries, Physics::QueryHit* results, int count) const;
+		/// <summary>
+		/// Finds every object touching each of a batch of spheres
+		/// </summary>
+		/// <param name="queries">The spheres to test</param>
+		/// <param name="results">Caller provided storage for the results, one per query, with Objects and Capacity filled in</param>
+		/// <param name="count">The number of queries in the batch</param>
+		void Overlap(const Physics::OverlapQuery* queries, Physics::OverlapResult* results, int count) const;
+
+		/// <summary>
+		/// Captures the state of the physics world into a snapshot, see PhysicsSnapshot
+		/// </summary>
+		/// <param name="snapshot">The snapshot to capture into, its storage is reused</param>
+		/// <param name="frame">A frame number to tag the snapshot with</param>
+		void CapturePhysicsSnapshot(Physics::PhysicsSnapshot& snapshot, uint64_t frame = 0) const;
+		/// <summary>
+		/// Restores the physics world to a snapshot, and moves the gameobjects of any dynamic bodies to match.
+		/// The simulation step counter is set back to the snapshot's frame number
+		/// </summary>
+		/// <param name="snapshot">The snapshot to restore</param>
+		/// <returns>True if the snapshot was restored, false if the bodies in the world have changed since it was captured</returns>
+		bool RestorePhysicsSnapshot(const Physics::PhysicsSnapshot& snapshot);
+		/// <summary>
+		/// Runs a number of fixed steps in one go, for re-simulating after restoring a snapshot. Each step
+		/// runs FixedUpdate and the frame's forces like a live step, but contact and trigger events are not
+		/// sent, the next call to DoPhysics will report changes compared to the last re-simulated step
+		/// </summary>
+		/// <param name="numSteps">The number of steps to simulate</param>
+		/// <param name="timeStep">The length of each step, in seconds</param>
+		void ResimulatePhysics(int numSteps, float timeStep);
+
+		/// <summary>
+		/// Gets the number of physics steps that have been simulated, this is the frame number that
+		/// physics snapshots should be tagged with
+		/// </summary>
+		uint64_t GetSimulationStep() const;
+		/// <summary>
+		/// Sets a function to invoke after every physics step (including re-simulated ones), ex to record
+		/// a snapshot of each step. When pipelining this is invoked from the simulation thread
+		/// </summary>
+		/// <param name="callback">The function to invoke with the step number that just finished, or nullptr to remove it</param>
+		void SetPostStepCallback(const std::function<void(uint64_t)>& callback);
 
 		/// <summary>
 		/// Loads a scene from a JSON blob
@@ -215,6 +389,32 @@ namespace Gameplay {
 		btConstraintSolver*       _constraintSolver;
 		// this is what allows us to get our pairs from the trigger volumes
 		btGhostPairCallback*      _ghostCallback;
+		// Whether the world is a btDiscreteDynamicsWorldMt
+		bool                      _isPhysicsMultithreaded;
+		// Builds the contact lists after each step and sends out collision and trigger events
+		Physics::ContactDispatcher _contactDispatcher;
+
+		// Fixed step simulation clock
+		float _fixedTimeStep;
+		int   _maxSimulationSteps;
+		float _simulationAccumulator;
+		int   _lastSimulationSteps;
+		float _interpolationAlpha;
+		bool  _isInFixedStep;
+		// The number of steps simulated, and who wants to know when it changes
+		uint64_t _simulationStep;
+		std::function<void(uint64_t)> _postStepCallback;
+
+		// Sends any gameobject changes to Bullet for all bodies and triggers
+		void _PhysicsPreStep(float dt);
+		// Runs fixed update, and steps physics forward a single step. Contact events are only sent if dispatchEvents is set
+		void _DoFixedStep(float dt, bool dispatchEvents = true);
+
+		// Bullet's task scheduler is global, so it is shared between all scenes
+		static btITaskScheduler*  _taskScheduler;
+		static int                _physicsThreadCount;
+		// Creates and installs the task scheduler the first time it's needed, nullptr if not supported
+		static btITaskScheduler*  _GetTaskScheduler();
 
 		BulletDebugDraw* _bulletDebugDraw;
 
@@ -264,8 +464,19 @@ namespace Gameplay {
 			glm::mat4 EnvironmentRotation;
 		};
 		UniformBuffer<LightingUboStruct>::Sptr _lightingUbo;
+		// Headless scenes have no UBO, so the lighting data is kept here instead
+		LightingUboStruct                      _headlessLighting;
 
 		bool                       _isAwake;
+		bool                       _isHeadless;
+		uint64_t                   _serial;
+		static uint64_t            _nextSerial;
+		FrameTimings               _frameTimings;
+
+		// Gets the lighting data from the UBO, or the headless copy
+		LightingUboStruct& _GetLightingData();
+		// Sends the lighting data to OpenGL, if we have a UBO
+		void _UpdateLightingUbo();
 
 		/// <summary>
 		/// Handles configuring our bullet physics stuff
@@ -275,6 +486,11 @@ namespace Gameplay {
 		/// Handles cleaning up bullet physics for this scene
 		/// </summary>
 		void _CleanupPhysics();
+		/// <summary>
+		/// Builds the bullet triangle meshes for all mesh colliders in parallel, before the
+		/// colliders are awoken
+		/// </summary>
+		void _PrebuildCollisionMeshes();
 
 		void _FlushDeleteQueue();
 	};
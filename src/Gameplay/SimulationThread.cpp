@@ -0,0 +1,83 @@
+#include "Gameplay/SimulationThread.h"
+#include <chrono>
+
+#include "Utils/Profiler.h"
+
+namespace Gameplay {
+	SimulationThread::~SimulationThread() {
+		Stop();
+	}
+
+	void SimulationThread::Start() {
+		if (_isRunning) {
+			return;
+		}
+		_isRunning = true;
+		_worker = std::thread(&SimulationThread::_WorkerMain, this);
+	}
+
+	void SimulationThread::Stop() {
+		if (!_isRunning) {
+			return;
+		}
+		Wait();
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_isRunning = false;
+		}
+		_condition.notify_all();
+		_worker.join();
+	}
+
+	void SimulationThread::Kick(std::function<void()> work) {
+		PROFILE_SCOPE("SimulationThread::Kick");
+		Wait();
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_work = std::move(work);
+			_hasWork = true;
+			_flowId = Profiler::NewFlowId();
+			PROFILE_FLOW_BEGIN("Simulation Kick", _flowId);
+		}
+		_condition.notify_all();
+	}
+
+	void SimulationThread::Wait() {
+		PROFILE_SCOPE("Wait For Simulation");
+		auto startTime = std::chrono::high_resolution_clock::now();
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condition.wait(lock, [this]() { return !_hasWork; });
+		}
+		auto endTime = std::chrono::high_resolution_clock::now();
+		_lastWaitMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+	}
+
+	void SimulationThread::_WorkerMain() {
+		Profiler::SetThreadName("Simulation");
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_condition.wait(lock, [this]() { return !_isRunning || _hasWork; });
+				if (!_isRunning) {
+					return;
+				}
+			}
+
+			auto startTime = std::chrono::high_resolution_clock::now();
+			{
+				PROFILE_SCOPE("Simulation Thread");
+				PROFILE_FLOW_END("Simulation Kick", _flowId);
+				_work();
+			}
+			auto endTime = std::chrono::high_resolution_clock::now();
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_lastWorkMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+				_hasWork = false;
+			}
+			_condition.notify_all();
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+namespace Gameplay {
+	/// <summary>
+	/// A persistent worker thread that runs one frame of simulation at a time, so the next frame can be
+	/// simulated while the main thread draws the last one. Work is handed over with Kick, and Wait
+	/// blocks until it is done. Only one piece of work can be in flight at a time
+	///
+	/// The work must not make any GL calls, since the context belongs to the main thread
+	/// </summary>
+	class SimulationThread {
+	public:
+		SimulationThread() = default;
+		~SimulationThread();
+
+		SimulationThread(const SimulationThread& other) = delete;
+		SimulationThread& operator=(const SimulationThread& other) = delete;
+
+		/// <summary>
+		/// Starts the worker thread, does nothing if it is already running
+		/// </summary>
+		void Start();
+		/// <summary>
+		/// Waits for any work in flight to finish and stops the worker thread
+		/// </summary>
+		void Stop();
+		bool IsRunning() const { return _isRunning; }
+
+		/// <summary>
+		/// Hands a frame of work to the worker, waiting for the previous frame's work if it is still running
+		/// </summary>
+		/// <param name="work">The work to run on the worker thread</param>
+		void Kick(std::function<void()> work);
+		/// <summary>
+		/// Blocks until the work handed over by Kick is done, returns right away if there is none
+		/// </summary>
+		void Wait();
+
+		/// <summary>
+		/// Gets how long the last piece of work took, and how long the last call to Wait blocked for, in milliseconds
+		/// </summary>
+		float GetLastWorkMs() const { return _lastWorkMs; }
+		float GetLastWaitMs() const { return _lastWaitMs; }
+
+	protected:
+		std::thread             _worker;
+		std::mutex              _mutex;
+		std::condition_variable _condition;
+		std::function<void()>   _work;
+		bool                    _hasWork = false;
+		bool                    _isRunning = false;
+		// Connects each Kick to the work it started in traces
+		uint64_t                _flowId = 0;
+		float                   _lastWorkMs = 0.0f;
+		float                   _lastWaitMs = 0.0f;
+
+		void _WorkerMain();
+	};
+}
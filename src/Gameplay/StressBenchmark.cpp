@@ -0,0 +1,195 @@
+#include "Gameplay/StressBenchmark.h"
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+#include "Gameplay/Scene.h"
+#include "Gameplay/GameObject.h"
+#include "Gameplay/Components/RotatingBehaviour.h"
+#include "Gameplay/Physics/RigidBody.h"
+#include "Gameplay/Physics/TriggerVolume.h"
+#include "Gameplay/Physics/Colliders/BoxCollider.h"
+#include "Gameplay/Physics/Colliders/SphereCollider.h"
+
+#include "Utils/FileHelpers.h"
+#include "Logging.h"
+
+namespace Gameplay {
+	using namespace Gameplay::Physics;
+
+	// Gets the average, min, max and percentiles of a set of samples
+	static nlohmann::json Summarize(std::vector<double>& samples) {
+		nlohmann::json result;
+		if (samples.empty()) {
+			return result;
+		}
+		std::sort(samples.begin(), samples.end());
+		double total = 0.0;
+		for (double sample : samples) {
+			total += sample;
+		}
+		result["avg_ms"] = total / samples.size();
+		result["min_ms"] = samples.front();
+		result["max_ms"] = samples.back();
+		result["p50_ms"] = samples[samples.size() / 2];
+		result["p95_ms"] = samples[std::min(samples.size() - 1, (size_t)(samples.size() * 0.95))];
+		result["total_ms"] = total;
+		return result;
+	}
+
+	nlohmann::json StressBenchmark::Run(const Params& params) {
+		std::mt19937 rng(params.Seed);
+		// Spread things out so the density stays about the same as the body count grows
+		float halfSize = glm::max(10.0f, glm::sqrt((float)params.RigidBodies) * 2.0f);
+		std::uniform_real_distribution<float> horizontal(-halfSize, halfSize);
+		std::uniform_real_distribution<float> height(2.0f, 20.0f);
+		std::uniform_real_distribution<float> spin(-90.0f, 90.0f);
+
+		auto setupStart = std::chrono::high_resolution_clock::now();
+
+		Scene::Sptr scene = std::make_shared<Scene>(true);
+		scene->SetPhysicsMultithreaded(params.Multithreaded);
+
+		// Static ground for everything to land on
+		int numObjects = 0;
+		GameObject::Sptr ground = scene->CreateGameObject("Ground");
+		{
+			RigidBody::Sptr physics = ground->Add<RigidBody>(RigidBodyType::Static);
+			physics->AddCollider(BoxCollider::Create(glm::vec3(halfSize + 5.0f, halfSize + 5.0f, 1.0f)))->SetPosition(glm::vec3(0.0f, 0.0f, -1.0f));
+			numObjects++;
+		}
+
+		// Dynamic bodies, alternating between boxes and spheres
+		for (int ix = 0; ix < params.RigidBodies; ix++, numObjects++) {
+			GameObject::Sptr object = scene->CreateGameObject("Body " + std::to_string(ix));
+			object->SetPosition(glm::vec3(horizontal(rng), horizontal(rng), height(rng)));
+			RigidBody::Sptr physics = object->Add<RigidBody>(RigidBodyType::Dynamic);
+			if (ix % 2 == 0) {
+				physics->AddCollider(BoxCollider::Create(glm::vec3(0.5f)));
+			} else {
+				physics->AddCollider(SphereCollider::Create(0.5f));
+			}
+		}
+
+		// Trigger volumes sitting on the ground
+		for (int ix = 0; ix < params.Triggers; ix++, numObjects++) {
+			GameObject::Sptr object = scene->CreateGameObject("Trigger " + std::to_string(ix));
+			object->SetPosition(glm::vec3(horizontal(rng), horizontal(rng), 1.0f));
+			TriggerVolume::Sptr volume = object->Add<TriggerVolume>();
+			volume->AddCollider(BoxCollider::Create(glm::vec3(2.0f)));
+		}
+
+		// Everything else goes into spinning hierarchies, to exercise updates and transform propagation
+		int depth = glm::max(params.HierarchyDepth, 1);
+		GameObject::Sptr parent = nullptr;
+		for (int ix = 0; numObjects < params.Objects; ix++, numObjects++) {
+			GameObject::Sptr object = scene->CreateGameObject("Node " + std::to_string(ix));
+			object->SetPosition(parent == nullptr ? glm::vec3(horizontal(rng), horizontal(rng), 5.0f) : glm::vec3(1.0f, 0.0f, 0.0f));
+			RotatingBehaviour::Sptr rotate = object->Add<RotatingBehaviour>();
+			rotate->RotationSpeed = glm::vec3(0.0f, 0.0f, spin(rng));
+
+			if (parent != nullptr) {
+				parent->AddChild(object);
+			}
+			// Start a new hierarchy once this one is deep enough
+			parent = (ix + 1) % depth == 0 ? nullptr : object;
+		}
+
+		double setupMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - setupStart).count();
+
+		auto awakeStart = std::chrono::high_resolution_clock::now();
+		scene->Awake();
+		scene->IsPlaying = true;
+		double awakeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - awakeStart).count();
+
+		// Feed exactly one fixed step per tick, so every tick does the same amount of work
+		const float dt = scene->GetFixedTimeStep();
+		std::vector<double> update, fixedUpdate, preStep, step, sync, contacts, interpolation, frame;
+		for (auto* samples : { &update, &fixedUpdate, &preStep, &step, &sync, &contacts, &interpolation, &frame }) {
+			samples->reserve(params.Ticks);
+		}
+
+		for (int ix = 0; ix < params.Ticks; ix++) {
+			auto frameStart = std::chrono::high_resolution_clock::now();
+			scene->Update(dt);
+			scene->DoPhysics(dt);
+			frame.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count());
+
+			const Scene::FrameTimings& timings = scene->GetLastFrameTimings();
+			update.push_back(timings.Update);
+			fixedUpdate.push_back(timings.FixedUpdate);
+			preStep.push_back(timings.PhysicsPreStep);
+			step.push_back(timings.PhysicsStep);
+			sync.push_back(timings.PhysicsSync);
+			contacts.push_back(timings.Contacts);
+			interpolation.push_back(timings.Interpolation);
+		}
+
+		nlohmann::json result;
+		result["params"] = {
+			{ "objects", numObjects },
+			{ "rigid_bodies", params.RigidBodies },
+			{ "triggers", params.Triggers },
+			{ "hierarchy_depth", depth },
+			{ "ticks", params.Ticks },
+			{ "seed", params.Seed },
+			{ "multithreaded", scene->IsPhysicsMultithreaded() },
+			{ "fixed_time_step", dt }
+		};
+		result["setup_ms"] = setupMs;
+		result["awake_ms"] = awakeMs;
+		result["phases"] = {
+			{ "update", Summarize(update) },
+			{ "fixed_update", Summarize(fixedUpdate) },
+			{ "physics_pre_step", Summarize(preStep) },
+			{ "physics_step", Summarize(step) },
+			{ "physics_sync", Summarize(sync) },
+			{ "contacts", Summarize(contacts) },
+			{ "interpolation", Summarize(interpolation) }
+		};
+		result["frame"] = Summarize(frame);
+		return result;
+	}
+
+	int StressBenchmark::RunFromCommandLine(int argc, char** argv) {
+		Params params;
+		for (int ix = 1; ix < argc; ix++) {
+			std::string arg = argv[ix];
+			size_t split = arg.find('=');
+			if (split == std::string::npos) {
+				continue;
+			}
+			std::string key = arg.substr(0, split);
+			std::string value = arg.substr(split + 1);
+
+			try {
+				if (key == "objects")       params.Objects        = std::stoi(value);
+				else if (key == "bodies")   params.RigidBodies    = std::stoi(value);
+				else if (key == "triggers") params.Triggers       = std::stoi(value);
+				else if (key == "depth")    params.HierarchyDepth = std::stoi(value);
+				else if (key == "ticks")    params.Ticks          = std::stoi(value);
+				else if (key == "seed")     params.Seed           = (uint32_t)std::stoul(value);
+				else if (key == "mt")       params.Multithreaded  = value == "1" || value == "true";
+				else if (key == "out")      params.OutputPath     = value;
+				else LOG_WARN("Unknown benchmark argument \"{}\"", key);
+			} catch (const std::exception&) {
+				LOG_ERROR("Invalid value \"{}\" for benchmark argument \"{}\"", value, key);
+				return 1;
+			}
+		}
+
+		params.Ticks = std::max(params.Ticks, 1);
+
+		LOG_INFO("Running stress benchmark: {} objects, {} bodies, {} triggers, depth {}, {} ticks",
+			params.Objects, params.RigidBodies, params.Triggers, params.HierarchyDepth, params.Ticks);
+		nlohmann::json result = Run(params);
+
+		std::string output = result.dump(1, '\t');
+		LOG_INFO("Stress benchmark frame time: {:.3f} ms avg, {:.3f} ms p95", result["frame"]["avg_ms"].get<double>(), result["frame"]["p95_ms"].get<double>());
+		if (!params.OutputPath.empty()) {
+			FileHelpers::WriteContentsToFile(params.OutputPath, output);
+			LOG_INFO("Wrote benchmark results to \"{}\"", params.OutputPath);
+		}
+		return 0;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include "json.hpp"
+
+namespace Gameplay {
+	/// <summary>
+	/// Generates procedural stress scenes and simulates them headless (no window or GL context needed),
+	/// reporting the CPU time spent in each phase of the frame as JSON so that runs can be compared
+	/// between builds. Run from the command line with:
+	///
+	///     GameEngine --benchmark objects=2000 bodies=500 triggers=50 depth=4 ticks=600 out=benchmark.json
+	/// </summary>
+	class StressBenchmark {
+	public:
+		struct Params {
+			// The total number of gameobjects in the scene, including the ones with bodies and triggers
+			int         Objects        = 2000;
+			// The number of dynamic rigid bodies, dropped onto a static ground plane
+			int         RigidBodies    = 500;
+			// The number of static trigger volumes spread over the ground
+			int         Triggers       = 50;
+			// The depth of the hierarchies the remaining objects are arranged into
+			int         HierarchyDepth = 4;
+			// The number of fixed steps to simulate
+			int         Ticks          = 600;
+			// Seed for object placement, so that runs are repeatable
+			uint32_t    Seed           = 12345;
+			// Whether the scene uses the multithreaded physics world
+			bool        Multithreaded  = false;
+			// Where to write the results, empty to only log them
+			std::string OutputPath     = "benchmark.json";
+		};
+
+		StressBenchmark() = delete;
+
+		/// <summary>
+		/// Builds and runs a stress scene
+		/// </summary>
+		/// <param name="params">The scene and run parameters</param>
+		/// <returns>The results, including the parameters and per phase timings</returns>
+		static nlohmann::json Run(const Params& params);
+
+		/// <summary>
+		/// Parses key=value arguments into benchmark parameters, runs the benchmark and writes the results
+		/// </summary>
+		/// <param name="argc">The number of arguments, as passed to main</param>
+		/// <param name="argv">The arguments, as passed to main</param>
+		/// <returns>The process exit code</returns>
+		static int RunFromCommandLine(int argc, char** argv);
+	};
+}
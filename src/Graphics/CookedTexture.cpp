@@ -0,0 +1,106 @@
+#include "Graphics/CookedTexture.h"
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+#include "Logging.h"
+
+// All level data is aligned to this many bytes within the file
+static constexpr uint64_t LEVEL_ALIGNMENT = 16;
+
+inline uint64_t AlignOffset(uint64_t offset) {
+	return (offset + LEVEL_ALIGNMENT - 1) & ~(LEVEL_ALIGNMENT - 1);
+}
+
+const uint8_t* CookedTexture::GetLevelData(uint32_t level, uint32_t face) const {
+	LOG_ASSERT(level < _header.NumLevels, "Mip level is out of range!");
+	LOG_ASSERT(face < _header.NumFaces, "Face index is out of range!");
+	return _file->GetData() + _levels[level].Offset + _levels[level].FaceSize * face;
+}
+
+CookedTexture::Sptr CookedTexture::Load(const std::string& filename) {
+	MappedFile::Sptr file = MappedFile::Open(filename);
+	if (file == nullptr) {
+		return nullptr;
+	}
+
+	// Make sure there's enough data for our header
+	if (file->GetSize() < sizeof(Header)) {
+		LOG_ERROR("Not enough data in cooked texture \"{}\"", filename);
+		return nullptr;
+	}
+
+	CookedTexture::Sptr result = std::make_shared<CookedTexture>();
+	result->_file = file;
+	memcpy(&result->_header, file->GetData(), sizeof(Header));
+
+	const Header& header = result->_header;
+	if (memcmp(header.HeaderBytes, "CTEX", 4) != 0) {
+		LOG_ERROR("File \"{}\" is not a cooked texture", filename);
+		return nullptr;
+	}
+	if (header.Version != CURRENT_VERSION) {
+		LOG_WARN("Cooked texture \"{}\" has an unsupported version ({}), it should be re-cooked", filename, header.Version);
+		return nullptr;
+	}
+	if (header.NumLevels == 0 || (header.NumFaces != 1 && header.NumFaces != 6)) {
+		LOG_ERROR("Cooked texture \"{}\" has an invalid layout", filename);
+		return nullptr;
+	}
+
+	// Read the level table, and make sure that every level is actually inside the file
+	size_t tableSize = sizeof(CookedMipLevel) * header.NumLevels;
+	if (file->GetSize() < sizeof(Header) + tableSize) {
+		LOG_ERROR("Not enough data in cooked texture \"{}\"", filename);
+		return nullptr;
+	}
+	result->_levels.resize(header.NumLevels);
+	memcpy(result->_levels.data(), file->GetData() + sizeof(Header), tableSize);
+
+	for (const CookedMipLevel& level : result->_levels) {
+		if (level.Offset + level.FaceSize * header.NumFaces > file->GetSize()) {
+			LOG_ERROR("Cooked texture \"{}\" is truncated", filename);
+			return nullptr;
+		}
+	}
+
+	return result;
+}
+
+void CookedTexture::Save(const std::string& filename, Header header, const std::vector<std::vector<uint8_t>>& levels) {
+	LOG_ASSERT(header.NumLevels == levels.size(), "Level count does not match the header!");
+
+	std::ofstream file(filename, std::ios::binary);
+	if (!file) {
+		throw std::runtime_error("Failed to open output file");
+	}
+
+	header.Version = CURRENT_VERSION;
+
+	// Lay out our level table, each level is aligned so the driver gets nicely aligned pointers
+	std::vector<CookedMipLevel> table(levels.size());
+	uint64_t offset = AlignOffset(sizeof(Header) + sizeof(CookedMipLevel) * levels.size());
+	uint32_t width  = header.Width;
+	uint32_t height = header.Height;
+	for (size_t ix = 0; ix < levels.size(); ix++) {
+		table[ix].Width    = width;
+		table[ix].Height   = height;
+		table[ix].Offset   = offset;
+		table[ix].FaceSize = levels[ix].size() / header.NumFaces;
+		offset = AlignOffset(offset + levels[ix].size());
+
+		width  = std::max(1u, width / 2);
+		height = std::max(1u, height / 2);
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	file.write(reinterpret_cast<const char*>(table.data()), sizeof(CookedMipLevel) * table.size());
+
+	// Write each level, padding up to the offset we stored in the table
+	const char padding[LEVEL_ALIGNMENT] = { 0 };
+	for (size_t ix = 0; ix < levels.size(); ix++) {
+		uint64_t position = static_cast<uint64_t>(file.tellp());
+		file.write(padding, table[ix].Offset - position);
+		file.write(reinterpret_cast<const char*>(levels[ix].data()), levels[ix].size());
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <vector>
+#include <string>
+
+#include "Graphics/TextureEnums.h"
+#include "Utils/MappedFile.h"
+
+/// <summary>
+/// Describes the layout of a single mip level within a cooked texture
+/// </summary>
+struct CookedMipLevel {
+	// The size of the level in texels
+	uint32_t Width;
+	uint32_t Height;
+	// The byte offset of the level's data from the start of the file
+	uint64_t Offset;
+	// The number of bytes for a single face of this level, faces are stored back to back
+	uint64_t FaceSize;
+};
+
+/// <summary>
+/// A cooked texture is a binary container that stores an image with its full mip chain already
+/// generated, flipped and laid out exactly as OpenGL expects it, so that each level can be handed
+/// to the driver straight from a memory mapped file without decoding or generating anything at
+/// runtime. The asset side of this format lives in TextureCooker
+/// </summary>
+class CookedTexture {
+public:
+	typedef std::shared_ptr<CookedTexture> Sptr;
+
+	// Will be put at the start of the binary file, contains info about the contents of the file
+	struct Header {
+		// A check value so we can ensure that we're loading in the right file type
+		char           HeaderBytes[4] ={ 'C', 'T', 'E', 'X' };
+		// The version code, we can use this to create different loaders if our format changes
+		uint16_t       Version;
+		// The number of faces in the texture, 1 for 2D textures and 6 for cubemaps
+		uint16_t       NumFaces;
+		// The size of the top level, in texels
+		uint32_t       Width;
+		uint32_t       Height;
+		// The number of mip levels stored in the file
+		uint32_t       NumLevels;
+		// The format that should be used when allocating storage for the texture
+		InternalFormat Format;
+		// The layout and type of the stored texels
+		PixelFormat    Layout;
+		PixelType      Type;
+		// Flags describing how the data is stored, see FLAG_*
+		uint32_t       Flags;
+	};
+
+	static constexpr uint16_t CURRENT_VERSION = 0x01;
+	// Set if the levels are stored as compressed blocks, and should be uploaded with glCompressedTextureSubImage
+	static constexpr uint32_t FLAG_COMPRESSED = 1 << 0;
+	// Set if the mips were filtered in linear space, for color textures
+	static constexpr uint32_t FLAG_GAMMA_CORRECT_MIPS = 1 << 1;
+
+	CookedTexture() = default;
+	~CookedTexture() = default;
+
+	/// <summary>
+	/// Gets the header that was loaded from the file
+	/// </summary>
+	const Header& GetHeader() const { return _header; }
+	/// <summary>
+	/// Gets the number of mip levels stored in the texture
+	/// </summary>
+	uint32_t GetNumLevels() const { return _header.NumLevels; }
+	/// <summary>
+	/// Returns true if the level data is block compressed
+	/// </summary>
+	bool IsCompressed() const { return (_header.Flags & FLAG_COMPRESSED) != 0; }
+	/// <summary>
+	/// Gets the layout information for the given mip level
+	/// </summary>
+	const CookedMipLevel& GetLevel(uint32_t level) const { return _levels[level]; }
+	/// <summary>
+	/// Gets a pointer to the data for the given level and face. The data for all faces
+	/// in a level are stored contiguously, so face 0 can be used to upload an entire level
+	/// </summary>
+	/// <param name="level">The mip level to fetch</param>
+	/// <param name="face">The face index to fetch (0 for 2D textures)</param>
+	const uint8_t* GetLevelData(uint32_t level, uint32_t face = 0) const;
+
+	/// <summary>
+	/// Loads and validates a cooked texture file by mapping it into memory
+	/// </summary>
+	/// <param name="filename">The path to the file to open</param>
+	/// <returns>The cooked texture, or nullptr if the file could not be loaded</returns>
+	static CookedTexture::Sptr Load(const std::string& filename);
+
+	/// <summary>
+	/// Writes a texture to the given file. Level data is expected to contain all faces for each
+	/// level stored back to back
+	/// </summary>
+	/// <param name="filename">The path to write the file to</param>
+	/// <param name="header">The header to write, NumLevels must match the size of levels</param>
+	/// <param name="levels">The data for each mip level</param>
+	static void Save(const std::string& filename, Header header, const std::vector<std::vector<uint8_t>>& levels);
+
+protected:
+	Header                      _header;
+	std::vector<CookedMipLevel> _levels;
+	MappedFile::Sptr            _file;
+};
@@ -0,0 +1,153 @@
+#include "Graphics/FramePacer.h"
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <GLFW/glfw3.h>
+
+#include "Utils/ImGuiHelper.h"
+
+int FramePacer::_maxFramesInFlight = 2;
+bool FramePacer::_justInTime = false;
+bool FramePacer::_vsync = true;
+float FramePacer::_safetyMarginMs = 2.0f;
+
+GLsync FramePacer::_fences[MAX_FRAMES_IN_FLIGHT] = { nullptr };
+uint64_t FramePacer::_frameNumber = 0;
+
+double FramePacer::_workStartTime = 0.0;
+double FramePacer::_lastPresentTime = 0.0;
+double FramePacer::_workEstimate = 0.0;
+double FramePacer::_presentInterval = 1.0 / 60.0;
+
+float FramePacer::_lastFenceWaitMs = 0.0f;
+float FramePacer::_lastSleepMs = 0.0f;
+float FramePacer::_frameTimes[HISTORY_SIZE] = { 0.0f };
+float FramePacer::_workTimes[HISTORY_SIZE] = { 0.0f };
+int FramePacer::_historyIndex = 0;
+
+void FramePacer::BeginFrame() {
+	double startTime = glfwGetTime();
+
+	// The slot this frame will put its fence in holds the fence from MaxFramesInFlight frames ago
+	if (_maxFramesInFlight > 0) {
+		GLsync& fence = _fences[_frameNumber % _maxFramesInFlight];
+		if (fence != nullptr) {
+			// Capped at a second so a lost context can't hang us forever
+			glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+	double waitEndTime = glfwGetTime();
+	_lastFenceWaitMs = (float)((waitEndTime - startTime) * 1000.0);
+
+	// Without vsync there's no vblank to line up with, so there's nothing to gain from waiting
+	_lastSleepMs = 0.0f;
+	if (_justInTime && _vsync && _lastPresentTime > 0.0) {
+		double target = _lastPresentTime + _presentInterval - _workEstimate - _safetyMarginMs / 1000.0;
+		if (target > waitEndTime) {
+			_SleepUntil(target);
+			_lastSleepMs = (float)((glfwGetTime() - waitEndTime) * 1000.0);
+		}
+	}
+
+	_workStartTime = glfwGetTime();
+}
+
+void FramePacer::Present(GLFWwindow* window) {
+	double workTime = glfwGetTime() - _workStartTime;
+	// Track spikes right away, but only trust faster frames slowly so a single quick frame doesn't make us late
+	if (workTime > _workEstimate) {
+		_workEstimate = workTime;
+	} else {
+		_workEstimate += (workTime - _workEstimate) * 0.05;
+	}
+
+	glfwSwapBuffers(window);
+
+	if (_maxFramesInFlight > 0) {
+		GLsync& fence = _fences[_frameNumber % _maxFramesInFlight];
+		if (fence != nullptr) {
+			glDeleteSync(fence);
+		}
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	_frameNumber++;
+
+	double now = glfwGetTime();
+	if (_lastPresentTime > 0.0) {
+		double interval = now - _lastPresentTime;
+		_presentInterval += (interval - _presentInterval) * 0.1;
+
+		_frameTimes[_historyIndex] = (float)(interval * 1000.0);
+		_workTimes[_historyIndex] = (float)(workTime * 1000.0);
+		_historyIndex = (_historyIndex + 1) % HISTORY_SIZE;
+	}
+	_lastPresentTime = now;
+}
+
+void FramePacer::SetMaxFramesInFlight(int frames) {
+	frames = std::clamp(frames, 0, MAX_FRAMES_IN_FLIGHT);
+	if (frames != _maxFramesInFlight) {
+		// The fence slots depend on the frame count, so start over
+		_ClearFences();
+		_maxFramesInFlight = frames;
+	}
+}
+
+void FramePacer::SetVSync(bool enabled) {
+	_vsync = enabled;
+	glfwSwapInterval(enabled ? 1 : 0);
+}
+
+void FramePacer::RenderImGui() {
+	int framesInFlight = _maxFramesInFlight;
+	if (LABEL_LEFT(ImGui::SliderInt, "Max Frames In Flight", &framesInFlight, 0, MAX_FRAMES_IN_FLIGHT)) {
+		SetMaxFramesInFlight(framesInFlight);
+	}
+	if (ImGui::IsItemHovered()) {
+		ImGui::SetTooltip("0 leaves frame queueing up to the driver");
+	}
+	bool vsync = _vsync;
+	if (ImGui::Checkbox("VSync", &vsync)) {
+		SetVSync(vsync);
+	}
+	ImGui::SameLine();
+	ImGui::Checkbox("Just In Time", &_justInTime);
+	if (_justInTime) {
+		LABEL_LEFT(ImGui::DragFloat, "Safety Margin (ms)", &_safetyMarginMs, 0.1f, 0.0f, 16.0f);
+	}
+
+	ImGui::Text("Fence wait: %.2f ms, sleep: %.2f ms", _lastFenceWaitMs, _lastSleepMs);
+	ImGui::Text("Work estimate: %.2f ms, present interval: %.2f ms", _workEstimate * 1000.0, _presentInterval * 1000.0);
+
+	char overlay[32];
+	sprintf_s(overlay, "%.2f ms", GetLastFrameTime());
+	ImGui::PlotLines("Frame", _frameTimes, HISTORY_SIZE, _historyIndex, overlay, 0.0f, 50.0f, ImVec2(0.0f, 60.0f));
+	ImGui::PlotLines("Work", _workTimes, HISTORY_SIZE, _historyIndex, nullptr, 0.0f, 50.0f, ImVec2(0.0f, 60.0f));
+}
+
+void FramePacer::_ClearFences() {
+	for (int ix = 0; ix < MAX_FRAMES_IN_FLIGHT; ix++) {
+		if (_fences[ix] != nullptr) {
+			glDeleteSync(_fences[ix]);
+			_fences[ix] = nullptr;
+		}
+	}
+}
+
+void FramePacer::_SleepUntil(double time) {
+	// Sleeps can overshoot by a millisecond or more, so only sleep while we're well away from the
+	// target and yield for the rest
+	while (true) {
+		double remaining = time - glfwGetTime();
+		if (remaining <= 0.0) {
+			break;
+		}
+		if (remaining > 0.002) {
+			std::this_thread::sleep_for(std::chrono::duration<double>(remaining - 0.002));
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
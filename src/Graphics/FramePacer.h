@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <glad/glad.h>
+
+struct GLFWwindow;
+
+/// <summary>
+/// Limits how far the CPU can run ahead of the GPU, instead of leaving it up to how many frames the
+/// driver decides to queue. A fence is inserted after each frame is presented, and before starting a
+/// new frame we wait on the fence from MaxFramesInFlight frames ago
+///
+/// Optionally, the pacer can also sleep at the start of a frame so that the frame starts as late as
+/// possible while still finishing before the next vblank. This means input is sampled closer to when
+/// the frame is displayed. The sleep is estimated from recent frame work times and the measured
+/// present interval
+///
+/// BeginFrame should be called at the very top of the frame (before polling events), and Present
+/// replaces glfwSwapBuffers
+/// </summary>
+class FramePacer {
+public:
+	// The most frames that can be allowed in flight
+	static constexpr int MAX_FRAMES_IN_FLIGHT = 4;
+	// The number of frames of history kept for the frame time graph
+	static constexpr int HISTORY_SIZE = 240;
+
+	FramePacer() = delete;
+
+	/// <summary>
+	/// Waits until the GPU has caught up enough to start another frame, then sleeps for the just in time
+	/// delay if it is enabled
+	/// </summary>
+	static void BeginFrame();
+	/// <summary>
+	/// Swaps the window's buffers and inserts the fence for this frame
+	/// </summary>
+	/// <param name="window">The window to present</param>
+	static void Present(GLFWwindow* window);
+
+	/// <summary>
+	/// Sets how many frames may be submitted before the CPU waits for the GPU, 0 leaves it up to the driver
+	/// </summary>
+	static void SetMaxFramesInFlight(int frames);
+	static int GetMaxFramesInFlight() { return _maxFramesInFlight; }
+	/// <summary>
+	/// Sets whether frames are delayed so that they start as late as possible before the next vblank
+	/// </summary>
+	static void SetJustInTime(bool enabled) { _justInTime = enabled; }
+	static bool IsJustInTime() { return _justInTime; }
+	/// <summary>
+	/// Sets how much earlier than the estimate a just in time frame starts, in milliseconds
+	/// </summary>
+	static void SetSafetyMargin(float ms) { _safetyMarginMs = ms; }
+	static float GetSafetyMargin() { return _safetyMarginMs; }
+	/// <summary>
+	/// Sets the swap interval, this must be called with the window's context current
+	/// </summary>
+	static void SetVSync(bool enabled);
+	static bool IsVSync() { return _vsync; }
+
+	/// <summary>
+	/// Gets the time spent waiting on the GPU and sleeping at the start of the last frame, in milliseconds
+	/// </summary>
+	static float GetLastFenceWait() { return _lastFenceWaitMs; }
+	static float GetLastSleep() { return _lastSleepMs; }
+	/// <summary>
+	/// Gets the time between the last two presents, in milliseconds
+	/// </summary>
+	static float GetLastFrameTime() { return _frameTimes[(_historyIndex + HISTORY_SIZE - 1) % HISTORY_SIZE]; }
+
+	/// <summary>
+	/// Renders the pacing settings and a graph of recent frame times
+	/// </summary>
+	static void RenderImGui();
+
+protected:
+	static int    _maxFramesInFlight;
+	static bool   _justInTime;
+	static bool   _vsync;
+	static float  _safetyMarginMs;
+
+	// Fence ring, indexed by frame number
+	static GLsync   _fences[MAX_FRAMES_IN_FLIGHT];
+	static uint64_t _frameNumber;
+
+	// All times are GLFW times in seconds
+	static double _workStartTime;
+	static double _lastPresentTime;
+	// Smoothed estimates of the CPU work per frame and the time between presents
+	static double _workEstimate;
+	static double _presentInterval;
+
+	static float _lastFenceWaitMs;
+	static float _lastSleepMs;
+	static float _frameTimes[HISTORY_SIZE];
+	static float _workTimes[HISTORY_SIZE];
+	static int   _historyIndex;
+
+	static void _ClearFences();
+	static void _SleepUntil(double time);
+};
@@ -0,0 +1,195 @@
+#include "Graphics/GpuProfiler.h"
+#include <algorithm>
+#include <string>
+#include <exception>
+
+#include "Utils/ImGuiHelper.h"
+#include "Logging.h"
+
+bool GpuProfiler::_isSupported = false;
+bool GpuProfiler::_isActive = false;
+int GpuProfiler::_timeline = -1;
+int GpuProfiler::_frameIndex = 0;
+int GpuProfiler::_depth = 0;
+GpuProfiler::FrameQueries GpuProfiler::_frames[QUERY_FRAMES];
+
+float GpuProfiler::_lastFrameMs = 0.0f;
+uint64_t GpuProfiler::_skippedFrames = 0;
+uint64_t GpuProfiler::_resolvedRanges = 0;
+
+void GpuProfiler::Init() {
+	// Drivers without a usable timestamp counter report 0 bits for it
+	GLint bits = 0;
+	glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+	_isSupported = bits > 0;
+	if (!_isSupported) {
+		LOG_WARN("GL_TIMESTAMP queries are not supported, GPU timings will not be available");
+		return;
+	}
+
+	_timeline = Profiler::RegisterTimeline("GPU");
+	for (FrameQueries& frame : _frames) {
+		frame.NumUsed = 0;
+	}
+}
+
+void GpuProfiler::Cleanup() {
+	for (FrameQueries& frame : _frames) {
+		if (!frame.Queries.empty()) {
+			glDeleteQueries((GLsizei)frame.Queries.size(), frame.Queries.data());
+		}
+		frame.Queries.clear();
+		frame.Ranges.clear();
+		frame.NumUsed = 0;
+	}
+	_isActive = false;
+}
+
+void GpuProfiler::BeginFrame() {
+	if (!_isSupported) {
+		return;
+	}
+
+	_frameIndex = (_frameIndex + 1) % QUERY_FRAMES;
+	FrameQueries& frame = _frames[_frameIndex];
+	_Resolve(frame);
+
+	frame.NumUsed = 0;
+	frame.Ranges.clear();
+	_depth = 0;
+	_isActive = Profiler::IsEnabled();
+}
+
+int GpuProfiler::RunCheckFromCommandLine(int argc, char** argv) {
+	int numFrames = 8;
+	for (int ix = 1; ix < argc; ix++) {
+		std::string arg = argv[ix];
+		size_t split = arg.find('=');
+		if (split == std::string::npos) {
+			continue;
+		}
+		std::string key = arg.substr(0, split);
+		std::string value = arg.substr(split + 1);
+
+		try {
+			if (key == "frames") numFrames = std::stoi(value);
+			else LOG_WARN("Unknown GPU profiler check argument \"{}\"", key);
+		} catch (const std::exception&) {
+			LOG_ERROR("Invalid value \"{}\" for GPU profiler check argument \"{}\"", value, key);
+			return 1;
+		}
+	}
+	numFrames = std::max(numFrames, 1);
+
+	if (!_isSupported) {
+		LOG_ERROR("GPU profiler check failed, GL_TIMESTAMP queries are not supported");
+		return 1;
+	}
+
+	bool wasEnabled = Profiler::IsEnabled();
+	Profiler::SetEnabled(true);
+	uint64_t startRanges = _resolvedRanges;
+	uint64_t startSkipped = _skippedFrames;
+
+	// Each frame gets one range, and we wait on the GPU so that none of them can be skipped
+	for (int ix = 0; ix < numFrames; ix++) {
+		BeginFrame();
+		{
+			PROFILE_GPU_SCOPE("GPU Profiler Check");
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		}
+		glFinish();
+	}
+	// A frame's queries are only read back when its set comes around again, so cycle through all of them
+	for (int ix = 0; ix < QUERY_FRAMES; ix++) {
+		BeginFrame();
+	}
+	Profiler::SetEnabled(wasEnabled);
+
+	uint64_t resolved = _resolvedRanges - startRanges;
+	uint64_t skipped = _skippedFrames - startSkipped;
+	if (resolved != (uint64_t)numFrames) {
+		LOG_ERROR("GPU profiler check failed, resolved {} of {} ranges ({} frames weren't ready)", resolved, numFrames, skipped);
+		return 1;
+	}
+	LOG_INFO("GPU profiler check passed, resolved {} ranges, last frame took {:.3f} ms", resolved, _lastFrameMs);
+	return 0;
+}
+
+void GpuProfiler::RenderImGui() {
+	if (!_isSupported) {
+		ImGui::TextUnformatted("GPU timing is not supported by this driver");
+		return;
+	}
+	ImGui::Text("GPU: %.2f ms (%d frames behind)", _lastFrameMs, QUERY_FRAMES - 1);
+	if (_skippedFrames > 0) {
+		ImGui::SameLine();
+		ImGui::Text(", %llu frames weren't ready in time", (unsigned long long)_skippedFrames);
+	}
+}
+
+int GpuProfiler::_Begin(int zone) {
+	if (!_isActive || zone < 0) {
+		return -1;
+	}
+
+	FrameQueries& frame = _frames[_frameIndex];
+	Range range;
+	range.Zone       = (uint16_t)zone;
+	range.Depth      = (uint16_t)_depth++;
+	range.BeginQuery = _NextQuery(frame);
+	range.EndQuery   = range.BeginQuery;
+	glQueryCounter(frame.Queries[range.BeginQuery], GL_TIMESTAMP);
+
+	frame.Ranges.push_back(range);
+	return (int)frame.Ranges.size() - 1;
+}
+
+void GpuProfiler::_End(int index) {
+	FrameQueries& frame = _frames[_frameIndex];
+	Range& range = frame.Ranges[index];
+	range.EndQuery = _NextQuery(frame);
+	glQueryCounter(frame.Queries[range.EndQuery], GL_TIMESTAMP);
+	_depth--;
+}
+
+uint32_t GpuProfiler::_NextQuery(FrameQueries& frame) {
+	if (frame.NumUsed == frame.Queries.size()) {
+		GLuint query = 0;
+		glGenQueries(1, &query);
+		frame.Queries.push_back(query);
+	}
+	return frame.NumUsed++;
+}
+
+void GpuProfiler::_Resolve(FrameQueries& frame) {
+	if (frame.Ranges.empty()) {
+		return;
+	}
+
+	// Timestamps are written in order, so once the last one is available they all are
+	GLint available = 0;
+	glGetQueryObjectiv(frame.Queries[frame.NumUsed - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available) {
+		_skippedFrames++;
+		return;
+	}
+
+	// Line the GPU's clock up with the profiler's, the GL time is read without waiting on the GPU
+	GLint64 gpuNow = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+	int64_t offset = Profiler::Now() - gpuNow;
+
+	double totalMs = 0.0;
+	for (const Range& range : frame.Ranges) {
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(frame.Queries[range.BeginQuery], GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(frame.Queries[range.EndQuery], GL_QUERY_RESULT, &end);
+		Profiler::RecordScope(_timeline, range.Zone, (int64_t)begin + offset, (int64_t)end + offset, range.Depth);
+		_resolvedRanges++;
+		if (range.Depth == 0) {
+			totalMs += (end - begin) / 1000000.0;
+		}
+	}
+	_lastFrameMs = (float)totalMs;
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <glad/glad.h>
+
+#include "Utils/Profiler.h"
+
+/// <summary>
+/// Times render passes on the GPU with pairs of GL_TIMESTAMP queries, and feeds the results into the
+/// Profiler on a "GPU" timeline so they show up next to the CPU timings. Timestamps are used rather
+/// than GL_TIME_ELAPSED so that passes can be nested (ex the opaque pass inside a viewport)
+///
+/// Each frame's queries are kept in one of QUERY_FRAMES sets, and a set is only read back when it comes
+/// around again. By then the GPU has almost always finished with it, if it hasn't, that frame's results
+/// are dropped rather than stalling on them
+///
+/// Init must be called once the GL context is created, and BeginFrame at the top of every frame
+/// </summary>
+class GpuProfiler {
+public:
+	// The number of frames of queries that can be waiting on the GPU
+	static constexpr int QUERY_FRAMES = 3;
+
+	/// <summary>
+	/// Times the GL commands issued from its construction until it goes out of scope
+	/// </summary>
+	class Scope {
+	public:
+		inline Scope(int zone) { _range = GpuProfiler::_Begin(zone); }
+		inline ~Scope() {
+			if (_range >= 0) {
+				GpuProfiler::_End(_range);
+			}
+		}
+
+		Scope(const Scope& other) = delete;
+		Scope& operator=(const Scope& other) = delete;
+
+	private:
+		int _range;
+	};
+
+	GpuProfiler() = delete;
+
+	/// <summary>
+	/// Checks that timer queries are supported, and registers the GPU timeline with the Profiler
+	/// </summary>
+	static void Init();
+	/// <summary>
+	/// Deletes all of our query objects
+	/// </summary>
+	static void Cleanup();
+	static bool IsSupported() { return _isSupported; }
+
+	/// <summary>
+	/// Reads back the results for the query set we are about to reuse, and starts a new frame of queries.
+	/// Scopes only record while the Profiler is enabled
+	/// </summary>
+	static void BeginFrame();
+
+	/// <summary>
+	/// Gets the total GPU time of the outermost scopes in the last frame that was read back, in milliseconds
+	/// </summary>
+	static float GetLastFrameMs() { return _lastFrameMs; }
+	/// <summary>
+	/// Gets the number of ranges that have been read back and sent to the Profiler since Init
+	/// </summary>
+	static uint64_t GetResolvedRangeCount() { return _resolvedRanges; }
+
+	/// <summary>
+	/// Renders whether GPU timing is available, and how it's keeping up
+	/// </summary>
+	static void RenderImGui();
+
+	/// <summary>
+	/// Checks that GPU timings make it back to the Profiler, by timing a few frames of clears and reading
+	/// them back. Needs a current GL context but no scene, so it can run in CI on a software driver
+	///
+	/// Arguments are key=value pairs, frames=N sets the number of frames to time (default 8)
+	/// </summary>
+	/// <param name="argc">The number of arguments, the first one is skipped</param>
+	/// <param name="argv">The arguments</param>
+	/// <returns>0 if every frame's GPU range was resolved, 1 otherwise</returns>
+	static int RunCheckFromCommandLine(int argc, char** argv);
+
+protected:
+	struct Range {
+		uint16_t Zone;
+		uint16_t Depth;
+		uint32_t BeginQuery;
+		uint32_t EndQuery;
+	};
+
+	struct FrameQueries {
+		// Grows as needed, and is reused from frame to frame
+		std::vector<GLuint> Queries;
+		uint32_t            NumUsed;
+		std::vector<Range>  Ranges;
+	};
+
+	static bool         _isSupported;
+	static bool         _isActive;
+	static int          _timeline;
+	static int          _frameIndex;
+	static int          _depth;
+	static FrameQueries _frames[QUERY_FRAMES];
+
+	static float    _lastFrameMs;
+	static uint64_t _skippedFrames;
+	static uint64_t _resolvedRanges;
+
+	static int _Begin(int zone);
+	static void _End(int range);
+	static uint32_t _NextQuery(FrameQueries& frame);
+	static void _Resolve(FrameQueries& frame);
+};
+
+#if PROFILER_ENABLED
+// Times the GL commands in the rest of the enclosing scope under the given name
+#define PROFILE_GPU_SCOPE(name) \
+	static const int PROFILER_CONCAT(__profileGpuZone, __LINE__) = Profiler::RegisterZone(name); \
+	GpuProfiler::Scope PROFILER_CONCAT(__profileGpuScope, __LINE__)(PROFILER_CONCAT(__profileGpuZone, __LINE__))
+#else
+#define PROFILE_GPU_SCOPE(name)
+#endif
@@ -2,6 +2,7 @@
 #include <GLM/gtc/matrix_transform.hpp>
 #include <GLM/gtc/matrix_inverse.hpp>
 #include "Utils/ResourceManager/ResourceManager.h"
+#include "Graphics/GpuProfiler.h"
 #include <locale>
 #include <codecvt>
 
@@ -13,6 +14,8 @@ IndexBuffer::Sptr GuiBatcher::__ibo = nullptr;
 
 Texture2D::Sptr GuiBatcher::__defaultUITexture = nullptr;
 int GuiBatcher::__defaultEdgeRadius = 0;
+GuiBatcher::DrawList* GuiBatcher::__capture = nullptr;
+glm::ivec4 GuiBatcher::__captureScissor = glm::ivec4(0);
 
 VertexBuffer::Sptr GuiBatcher::__vbo = nullptr;
 Shader::Sptr GuiBatcher::__shader = nullptr;
@@ -33,6 +36,9 @@ void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm:
 		
 	// Grab mesh info for the texture batch
 	MeshData& mesh = _meshBuilders[tex.get()];
+	if (mesh.Texture == nullptr) {
+		mesh.Texture = tex;
+	}
 	// We can use the vertex count for depth, so that things drawn later have a bit of spacing
 	float depth = mesh.Builder.GetVertexCount() / 1000.0f;
 
@@ -113,6 +119,9 @@ void GuiBatcher::RenderText(const std::wstring& text, const Font::Sptr& font, co
 	// Grab the mesh builder and make sure it's a texture batch
 	MeshData& mesh = _meshBuilders[atlas.get()];
 	mesh.IsFont = true;
+	if (mesh.Texture == nullptr) {
+		mesh.Texture = atlas;
+	}
 
 	// Allocate some space for the vertices
 	VertexPosColTex verts[4];
@@ -180,6 +189,7 @@ void GuiBatcher::RenderText(const std::string& text, const Font::Sptr& font, con
 
 void GuiBatcher::Flush()
 {
+	PROFILE_SCOPE("GuiBatcher::Flush");
 	__StaticInit();
 
 	// Iterate over each texture and it's mesh
@@ -187,26 +197,82 @@ void GuiBatcher::Flush()
 		Texture2D* tex = key;
 		// If the texture exists and the mesh has data
 		if (tex != nullptr && value.Builder.GetIndexCount() > 0) {
-			// Update the VAO and it's buffers
-			__vao->Bind();
-			__vbo->UpdateData(value.Builder.GetVertexDataPtr(), sizeof(VertexPosColTex), value.Builder.GetVertexCount(), true);
-			__ibo->UpdateData(value.Builder.GetIndexDataPtr(), sizeof(uint32_t), value.Builder.GetIndexCount(), true);
-
-			// Bind texture, send uniforms to shader
-			tex->Bind(0);
-			Shader::Sptr shader = value.IsFont ? __fontShader : __shader;
-			shader->Bind();
-			shader->SetUniformMatrix(0, &__projection, 1, false);
-
-			// Draw geometry
-			__vao->Draw();
+			if (__capture != nullptr) {
+				// Copy the geometry into the draw list instead of drawing it
+				DrawList::Batch batch;
+				batch.Texture     = value.Texture;
+				batch.IsFont      = value.IsFont;
+				batch.Scissor     = __captureScissor;
+				batch.FirstVertex = (uint32_t)__capture->Vertices.size();
+				batch.NumVertices = (uint32_t)value.Builder.GetVertexCount();
+				batch.FirstIndex  = (uint32_t)__capture->Indices.size();
+				batch.NumIndices  = (uint32_t)value.Builder.GetIndexCount();
+				__capture->Vertices.insert(__capture->Vertices.end(), value.Builder.GetVertexDataPtr(), value.Builder.GetVertexDataPtr() + batch.NumVertices);
+				__capture->Indices.insert(__capture->Indices.end(), value.Builder.GetIndexDataPtr(), value.Builder.GetIndexDataPtr() + batch.NumIndices);
+				__capture->Batches.push_back(batch);
+			} else {
+				__DrawBatch(tex, value.IsFont, value.Builder.GetVertexDataPtr(), value.Builder.GetVertexCount(),
+							value.Builder.GetIndexDataPtr(), value.Builder.GetIndexCount(), __projection);
+			}
 
 			// Clear mesh
 			value.Builder.Reset();
 		}
+		value.Texture = nullptr;
+	}
+}
+
+void GuiBatcher::DrawList::Clear() {
+	Vertices.clear();
+	Indices.clear();
+	Batches.clear();
+}
+
+void GuiBatcher::BeginCapture(DrawList& list) {
+	LOG_ASSERT(__capture == nullptr, "GUI capture is already running");
+	list.Clear();
+	list.Projection = __projection;
+	__captureScissor = glm::ivec4(0, 0, __windowSize.x, __windowSize.y);
+	__capture = &list;
+}
+
+void GuiBatcher::EndCapture() {
+	Flush();
+	__capture = nullptr;
+}
+
+void GuiBatcher::Submit(const DrawList& list) {
+	PROFILE_SCOPE("GuiBatcher::Submit");
+	PROFILE_GPU_SCOPE("GUI (GPU)");
+	__StaticInit();
+
+	glm::ivec4 scissor = glm::ivec4(-1);
+	for (const DrawList::Batch& batch : list.Batches) {
+		if (batch.Scissor != scissor) {
+			scissor = batch.Scissor;
+			glScissor(scissor.x, scissor.y, scissor.z, scissor.w);
+		}
+		__DrawBatch(batch.Texture.get(), batch.IsFont, list.Vertices.data() + batch.FirstVertex, batch.NumVertices,
+					list.Indices.data() + batch.FirstIndex, batch.NumIndices, list.Projection);
 	}
 }
 
+void GuiBatcher::__DrawBatch(Texture2D* tex, bool isFont, const VertexPosColTex* vertices, size_t numVertices, const uint32_t* indices, size_t numIndices, const glm::mat4& projection) {
+	// Update the VAO and it's buffers
+	__vao->Bind();
+	__vbo->UpdateData(vertices, sizeof(VertexPosColTex), numVertices, true);
+	__ibo->UpdateData(indices, sizeof(uint32_t), numIndices, true);
+
+	// Bind texture, send uniforms to shader
+	tex->Bind(0);
+	Shader::Sptr shader = isFont ? __fontShader : __shader;
+	shader->Bind();
+	shader->SetUniformMatrix(0, &projection, 1, false);
+
+	// Draw geometry
+	__vao->Draw();
+}
+
 void GuiBatcher::PushModelTransform(const glm::mat3& transform) {
 	__modelTransformStack.push_back(transform);
 	__model = transform * __model;
@@ -351,7 +417,11 @@ void GuiBatcher::PushScissorRect(const glm::vec2& min, const glm::vec2& max) {
 
 	// Draw current geo with the current scissor, then update it
 	Flush();
-	glScissor(minWin.x, maxWin.y, width, height);
+	if (__capture != nullptr) {
+		__captureScissor = glm::ivec4(minWin.x, maxWin.y, width, height);
+	} else {
+		glScissor(minWin.x, maxWin.y, width, height);
+	}
 }
 
 void GuiBatcher::PopScissorRect() {
@@ -367,7 +437,11 @@ void GuiBatcher::PopScissorRect() {
 
 	// Draw current geo with the current scissor, then update it
 	Flush();
-	glScissor(glm::min(bounds.Min.x, bounds.Max.x), glm::min(bounds.Min.y, bounds.Max.y), width, height);
+	if (__capture != nullptr) {
+		__captureScissor = glm::ivec4(glm::min(bounds.Min.x, bounds.Max.x), glm::min(bounds.Min.y, bounds.Max.y), width, height);
+	} else {
+		glScissor(glm::min(bounds.Min.x, bounds.Max.x), glm::min(bounds.Min.y, bounds.Max.y), width, height);
+	}
 }
 
 void GuiBatcher::SetDefaultTexture(const Texture2D::Sptr& value) {
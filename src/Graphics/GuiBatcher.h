@@ -9,6 +9,7 @@
 #include "Graphics/Font.h"
 #include "Utils/MeshBuilder.h"
 #include <unordered_map>
+#include <vector>
 
 	/// <summary>
 	/// The GUI Batcher class provides utilities for drawing rectangles and
@@ -16,6 +17,31 @@
 	/// </summary>
 	class GuiBatcher {
 	public:
+		/// <summary>
+		/// GUI geometry recorded between BeginCapture and EndCapture. This lets the GUI be built at one
+		/// point in the frame and drawn later with Submit. The buffers keep their capacity when cleared,
+		/// so a draw list can be reused every frame without reallocating
+		/// </summary>
+		struct DrawList {
+			struct Batch {
+				Texture2D::Sptr Texture;
+				bool            IsFont;
+				// The scissor rect as x, y, width, height
+				glm::ivec4      Scissor;
+				uint32_t        FirstVertex;
+				uint32_t        NumVertices;
+				uint32_t        FirstIndex;
+				uint32_t        NumIndices;
+			};
+
+			glm::mat4                    Projection = glm::mat4(1.0f);
+			std::vector<VertexPosColTex> Vertices;
+			std::vector<uint32_t>        Indices;
+			std::vector<Batch>           Batches;
+
+			void Clear();
+		};
+
 		/// <summary>
 		/// Adds a rectangle to the GUI batch, with a given border radius in pixels.
 		/// This can be used with textures to create rounded borders
@@ -70,6 +96,22 @@
 		/// </summary>
 		static void Flush();
 
+		/// <summary>
+		/// Starts recording GUI geometry into a draw list instead of drawing it. The list is cleared, and
+		/// will use the current projection and window size
+		/// </summary>
+		/// <param name="list">The draw list to record into</param>
+		static void BeginCapture(DrawList& list);
+		/// <summary>
+		/// Flushes any remaining geometry into the draw list and stops recording
+		/// </summary>
+		static void EndCapture();
+		/// <summary>
+		/// Draws a recorded draw list to the screen
+		/// </summary>
+		/// <param name="list">The list to draw</param>
+		static void Submit(const DrawList& list);
+
 		/// <summary>
 		/// Push a new transform to the stack, this will be multiplied with the
 		/// existing transformation
@@ -120,6 +162,8 @@
 
 		struct MeshData {
 			MeshBuilder<VertexPosColTex> Builder;
+			// Keeps the texture alive until the batch is flushed, so captured batches can hold on to it
+			Texture2D::Sptr Texture;
 			bool IsFont;
 		};
 
@@ -137,6 +181,9 @@
 
 		static Texture2D::Sptr __defaultUITexture;
 		static int __defaultEdgeRadius;
+		static DrawList* __capture;
+		static glm::ivec4 __captureScissor;
 
 		static void __StaticInit();
+		static void __DrawBatch(Texture2D* tex, bool isFont, const VertexPosColTex* vertices, size_t numVertices, const uint32_t* indices, size_t numIndices, const glm::mat4& projection);
 	};
@@ -53,6 +53,7 @@ void ITexture::__StaticInit()
 	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &__limits.MAX_TEXTURE_UNITS);
 	glGetIntegerv(GL_MAX_3D_TEXTURE_SIZE, &__limits.MAX_3D_TEXTURE_SIZE);
 	glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &__limits.MAX_TEXTURE_IMAGE_UNITS);
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &__limits.MAX_ARRAY_TEXTURE_LAYERS);
 	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &__limits.MAX_ANISOTROPY);
 
 	// Enable seamless cube maps (we'll need this later!)
@@ -64,6 +65,7 @@ void ITexture::__StaticInit()
 	LOG_INFO("\tUnits:      {}", __limits.MAX_TEXTURE_UNITS);
 	LOG_INFO("\t3D Size:    {}", __limits.MAX_3D_TEXTURE_SIZE);
 	LOG_INFO("\tUnits (FS): {}", __limits.MAX_TEXTURE_IMAGE_UNITS);
+	LOG_INFO("\tLayers:     {}", __limits.MAX_ARRAY_TEXTURE_LAYERS);
 	LOG_INFO("\tMax Aniso.: {}", __limits.MAX_ANISOTROPY);
 
 	__isStaticInit = true;
@@ -28,6 +28,7 @@ public:
 		int   MAX_TEXTURE_UNITS;
 		int   MAX_3D_TEXTURE_SIZE;
 		int   MAX_TEXTURE_IMAGE_UNITS;
+		int   MAX_ARRAY_TEXTURE_LAYERS;
 		float MAX_ANISOTROPY;
 	};
 	
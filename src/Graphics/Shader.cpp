@@ -5,6 +5,7 @@
 #include <filesystem>
 
 #include "Utils/FileHelpers.h"
+#include "Utils/Profiler.h"
 
 Shader::Shader() : 
 	IResource(),
@@ -83,6 +84,7 @@ bool Shader::LoadShaderPart(const char* source, ShaderPartType type) {
 }
 
 bool Shader::LoadShaderPartFromFile(const char* path, ShaderPartType type) {
+	PROFILE_SCOPE("Shader Compile");
 	// Make sure that the file exists before we try reading
 	if (std::filesystem::exists(path)) {
 		// Load the source from the file, using our helper that will
@@ -103,6 +105,7 @@ bool Shader::LoadShaderPartFromFile(const char* path, ShaderPartType type) {
 }
 
 bool Shader::Link() {
+	PROFILE_SCOPE("Shader Link");
 	LOG_ASSERT(_handles[ShaderPartType::Vertex] != 0 && _handles[ShaderPartType::Fragment] != 0, "Must attach both a vertex and fragment shader!");
 
 	LOG_TRACE("Starting shader link:");
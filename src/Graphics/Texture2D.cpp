@@ -1,8 +1,13 @@
 #include "Texture2D.h"
 #include <stb_image.h>
+#include <filesystem>
 #include <Logging.h>
 #include "GLM/glm.hpp"
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/TextureCooker.h"
+#include "Graphics/CookedTexture.h"
+#include "Graphics/TextureStreamer.h"
+#include "Utils/Profiler.h"
 
 /// <summary>
 /// Get the number of mipmap levels required for a texture of the given size
@@ -23,6 +28,10 @@ nlohmann::json Texture2D::ToJson() const {
 		{ "filter_mag",       ~_description.MagnificationFilter },
 		{ "anisotropic",       _description.MaxAnisotropic },
 		{ "generate_mipmaps",  _description.GenerateMipMaps },
+		{ "compression",      ~_description.Compression },
+		{ "compression_quality", ~_description.Quality },
+		{ "streaming",         _description.Streaming },
+		{ "color",             _description.IsColor },
 	};
 }
 
@@ -36,10 +45,21 @@ Texture2D::Sptr Texture2D::FromJson(const nlohmann::json& data)
 	descr.MagnificationFilter = JsonParseEnum(MagFilter, data, "filter_mag", MagFilter::Linear);
 	descr.MaxAnisotropic      = JsonGet(data, "anisotropic", 0.0f);
 	descr.GenerateMipMaps     = JsonGet(data, "generate_mipmaps", false);
+	descr.Compression         = JsonParseEnum(TextureCompression, data, "compression", TextureCompression::None);
+	descr.Quality             = JsonParseEnum(CompressionQuality, data, "compression_quality", CompressionQuality::Normal);
+	descr.Streaming           = JsonGet(data, "streaming", false);
+	// Older manifests don't say whether a texture is color, so fall back to guessing from the name
+	descr.IsColor             = JsonGet(data, "color", TextureCooker::IsColorTexture(descr.Filename));
 	return std::make_shared<Texture2D>(descr);
 }
 
-Texture2D::Texture2D(const Texture2DDescription& description) : ITexture(TextureType::_2D) {
+Texture2D::Texture2D(const Texture2DDescription& description) :
+	ITexture(TextureType::_2D),
+	_streamSource(nullptr),
+	_numLevels(0),
+	_allocatedLevel(0),
+	_residentLevel(0)
+{
 	_description = description;
 	_SetTextureParams();
 	if (!description.Filename.empty()) {
@@ -47,8 +67,15 @@ Texture2D::Texture2D(const Texture2DDescription& description) : ITexture(Texture
 	}
 }
 
-Texture2D::Texture2D(const std::string& filePath) : ITexture(TextureType::_2D) {
+Texture2D::Texture2D(const std::string& filePath) :
+	ITexture(TextureType::_2D),
+	_streamSource(nullptr),
+	_numLevels(0),
+	_allocatedLevel(0),
+	_residentLevel(0)
+{
 	_description.Filename = filePath;
+	_description.IsColor = TextureCooker::IsColorTexture(filePath);
 	_SetTextureParams();
 	_LoadDataFromFile();
 }
@@ -67,14 +94,11 @@ void Texture2D::SetAnisoLevel(float value) {
 	if (value != _description.MaxAnisotropic) {
 		_description.MaxAnisotropic = glm::clamp(value, 1.0f, ITexture::GetLimits().MAX_ANISOTROPY);
 		glTextureParameterf(_handle, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
-
-		if (_description.GenerateMipMaps) {
-			glGenerateTextureMipmap(_handle);
-		}
 	}
 }
 
 void Texture2D::LoadData(uint32_t width, uint32_t height, PixelFormat format, PixelType type, void* data, uint32_t offsetX, uint32_t offsetY) {
+	LOG_ASSERT(!IsCompressedFormat(_description.Format), "Cannot load uncompressed data into a block compressed texture!");
 	// Ensure the rectangle we're setting is within the bounds of the image
 	LOG_ASSERT((width + offsetX) <= _description.Width, "Pixel bounds are outside of the X extents of the image!");
 	LOG_ASSERT((height + offsetY) <= _description.Height, "Pixel bounds are outside of the Y extents of the image!");
@@ -94,9 +118,15 @@ void Texture2D::LoadData(uint32_t width, uint32_t height, PixelFormat format, Pi
 }
 
 void Texture2D::_LoadDataFromFile() {
+	PROFILE_SCOPE("Texture2D Load");
 	LOG_ASSERT(_description.Width + _description.Height == 0, "This texture has already been configured with a size! Cannot re-allocate memory!");
 
 	if (!_description.Filename.empty()) {
+		// Prefer loading the cooked version of the texture, since it already has all it's mips
+		if (TextureCooker::IsEnabled() && _LoadCookedData()) {
+			return;
+		}
+
 		// Variables that will store properties about our image
 		int width, height, numChannels;
 		const int targetChannels = GetTexelComponentCount(_description.FormatHint);
@@ -144,6 +174,97 @@ void Texture2D::_LoadDataFromFile() {
 	}
 }
 
+bool Texture2D::_LoadCookedData() {
+	const int targetChannels = GetTexelComponentCount(_description.FormatHint);
+
+	// The format we expect to find in the cooked file, based on our description
+	InternalFormat expectedFormat = _description.Compression != TextureCompression::None ?
+		GetInternalFormatForCompression(_description.Compression) :
+		GetInternalFormatForChannels8(targetChannels);
+
+	// If we were given a cooked file directly we load it as is, otherwise we look for the cooked
+	// file that sits next to the source image
+	bool isCookedFile = _description.Filename.size() > 5 && _description.Filename.substr(_description.Filename.size() - 5) == ".ctex";
+	std::string cookedPath = isCookedFile ? _description.Filename : TextureCooker::GetCookedPath(_description.Filename);
+
+	TextureCookSettings settings;
+	settings.NumChannels = targetChannels;
+	settings.Compression = _description.Compression;
+	settings.Quality     = _description.Quality;
+	settings.GammaCorrectMips = _description.IsColor;
+
+	// Cook the texture if it's missing or older than the source image
+	bool canCook = !isCookedFile && TextureCooker::IsAutoCookEnabled();
+	if (canCook && !TextureCooker::IsUpToDate({ _description.Filename }, cookedPath)) {
+		TextureCooker::Cook2D(_description.Filename, cookedPath, settings);
+		canCook = false;
+	}
+
+	if (!std::filesystem::exists(cookedPath)) {
+		return false;
+	}
+
+	CookedTexture::Sptr cooked = CookedTexture::Load(cookedPath);
+
+	// If the format was changed since we cooked, we need to cook again (or fall back to the source image)
+	bool isGammaCorrect = cooked != nullptr && (cooked->GetHeader().Flags & CookedTexture::FLAG_GAMMA_CORRECT_MIPS) != 0;
+	if (!isCookedFile && cooked != nullptr && (cooked->GetHeader().Format != expectedFormat || isGammaCorrect != settings.GammaCorrectMips)) {
+		cooked = nullptr;
+		if (canCook && TextureCooker::Cook2D(_description.Filename, cookedPath, settings)) {
+			cooked = CookedTexture::Load(cookedPath);
+		} else {
+			LOG_WARN("Cooked texture \"{}\" does not match the requested format, it should be re-cooked", cookedPath);
+		}
+	}
+
+	if (cooked == nullptr || cooked->GetHeader().NumFaces != 1) {
+		return false;
+	}
+
+	const CookedTexture::Header& header = cooked->GetHeader();
+
+	// Update our description to match what we loaded
+	_description.Format = header.Format;
+	_description.Width  = header.Width;
+	_description.Height = header.Height;
+
+	uint32_t numLevels = _description.GenerateMipMaps ? glm::min(header.NumLevels, (uint32_t)CalcRequiredMipLevels(header.Width, header.Height)) : 1;
+
+	// Streamed textures only allocate and upload their smallest mips, the rest are handled by the TextureStreamer
+	if (_description.Streaming && numLevels > 1) {
+		_streamSource   = cooked;
+		_numLevels      = numLevels;
+		_allocatedLevel = numLevels;
+		_residentLevel  = numLevels;
+
+		uint32_t initialLevel = TextureStreamer::GetInitialLevel(header.Width, header.Height, numLevels);
+		_StreamReallocate(initialLevel);
+		for (uint32_t level = numLevels; level > initialLevel; level--) {
+			_StreamUploadLevel(level - 1, cooked->GetLevelData(level - 1));
+		}
+		return true;
+	}
+
+	// Allocates our memory
+	_SetTextureParams();
+
+	// Rows in the cooked data are tightly packed
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	// Upload each level straight from the mapped file, we only upload the levels we allocated
+	for (uint32_t level = 0; level < numLevels; level++) {
+		const CookedMipLevel& info = cooked->GetLevel(level);
+		if (cooked->IsCompressed()) {
+			glCompressedTextureSubImage2D(_handle, level, 0, 0, info.Width, info.Height, *header.Format, (GLsizei)info.FaceSize, cooked->GetLevelData(level));
+		} else {
+			glTextureSubImage2D(_handle, level, 0, 0, info.Width, info.Height, *header.Layout, *header.Type, cooked->GetLevelData(level));
+		}
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	return true;
+}
+
 void Texture2D::_SetTextureParams() {
 	// If the anisotropy is negative, we assume that we want max anisotropy
 	if (_description.MaxAnisotropic < 0.0f) {
@@ -156,13 +277,91 @@ void Texture2D::_SetTextureParams() {
 		int layers = _description.GenerateMipMaps ? CalcRequiredMipLevels(_description.Width, _description.Height) : 1;
 		// Allocates the memory for our texture
 		glTextureStorage2D(_handle, layers, (GLenum)_description.Format, _description.Width, _description.Height);
+		_numLevels = layers;
 
-		glTextureParameteri(_handle, GL_TEXTURE_WRAP_S, (GLenum)_description.HorizontalWrap);
-		glTextureParameteri(_handle, GL_TEXTURE_WRAP_T, (GLenum)_description.VerticalWrap);
-		glTextureParameteri(_handle, GL_TEXTURE_MIN_FILTER, (GLenum)_description.MinificationFilter);
-		glTextureParameteri(_handle, GL_TEXTURE_MAG_FILTER, (GLenum)_description.MagnificationFilter);
-		glTextureParameterf(_handle, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
+		_ApplySamplerParams();
+	}
+}
+
+void Texture2D::_ApplySamplerParams() {
+	glTextureParameteri(_handle, GL_TEXTURE_WRAP_S, (GLenum)_description.HorizontalWrap);
+	glTextureParameteri(_handle, GL_TEXTURE_WRAP_T, (GLenum)_description.VerticalWrap);
+	glTextureParameteri(_handle, GL_TEXTURE_MIN_FILTER, (GLenum)_description.MinificationFilter);
+	glTextureParameteri(_handle, GL_TEXTURE_MAG_FILTER, (GLenum)_description.MagnificationFilter);
+	glTextureParameterf(_handle, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
+}
+
+void Texture2D::_StreamReallocate(uint32_t topLevel) {
+	LOG_ASSERT(_streamSource != nullptr, "Only streamed textures can be re-allocated!");
+	topLevel = glm::min(topLevel, _numLevels - 1);
+	if (topLevel == _allocatedLevel) {
+		return;
+	}
+
+	if (_description.MaxAnisotropic < 0.0f) {
+		_description.MaxAnisotropic = ITexture::GetLimits().MAX_ANISOTROPY;
 	}
+
+	// Create new storage that starts at the requested level
+	GLuint newHandle = 0;
+	glCreateTextures(GL_TEXTURE_2D, 1, &newHandle);
+	const CookedMipLevel& top = _streamSource->GetLevel(topLevel);
+	glTextureStorage2D(newHandle, _numLevels - topLevel, *_description.Format, top.Width, top.Height);
+
+	// Copy over any levels that are resident in both the old and new storage, this all stays on the GPU
+	uint32_t firstCopied = glm::max(topLevel, _residentLevel);
+	if (_allocatedLevel < _numLevels) {
+		for (uint32_t level = firstCopied; level < _numLevels; level++) {
+			const CookedMipLevel& info = _streamSource->GetLevel(level);
+			glCopyImageSubData(
+				_handle, GL_TEXTURE_2D, level - _allocatedLevel, 0, 0, 0,
+				newHandle, GL_TEXTURE_2D, level - topLevel, 0, 0, 0,
+				info.Width, info.Height, 1);
+		}
+	} else {
+		firstCopied = _numLevels;
+	}
+
+	// Swap over to the new storage, materials bind by handle so they'll pick it up next time they're applied
+	glDeleteTextures(1, &_handle);
+	_handle = newHandle;
+	_allocatedLevel = topLevel;
+	_residentLevel = firstCopied;
+
+	_ApplySamplerParams();
+	// Clamp sampling to the levels that actually have data in them
+	glTextureParameteri(_handle, GL_TEXTURE_BASE_LEVEL, glm::min(_residentLevel, _numLevels - 1) - _allocatedLevel);
+}
+
+void Texture2D::_StreamUploadLevel(uint32_t level, const uint8_t* data) {
+	// The storage may have been re-allocated since this level was requested
+	if (level < _allocatedLevel || level >= _numLevels) {
+		return;
+	}
+
+	const CookedMipLevel& info = _streamSource->GetLevel(level);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	if (_streamSource->IsCompressed()) {
+		glCompressedTextureSubImage2D(_handle, level - _allocatedLevel, 0, 0, info.Width, info.Height, *_description.Format, (GLsizei)info.FaceSize, data);
+	} else {
+		const CookedTexture::Header& header = _streamSource->GetHeader();
+		glTextureSubImage2D(_handle, level - _allocatedLevel, 0, 0, info.Width, info.Height, *header.Layout, *header.Type, data);
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	// Levels are streamed in from coarse to fine, so we can now sample from this level
+	if (level + 1 == _residentLevel) {
+		_residentLevel = level;
+		glTextureParameteri(_handle, GL_TEXTURE_BASE_LEVEL, _residentLevel - _allocatedLevel);
+	}
+}
+
+size_t Texture2D::_GetStreamedSize(uint32_t topLevel) const {
+	size_t result = 0;
+	for (uint32_t level = topLevel; level < _numLevels; level++) {
+		result += _streamSource->GetLevel(level).FaceSize;
+	}
+	return result;
 }
 
 Texture2D::Sptr Texture2D::LoadFromFile(const std::string& path, const Texture2DDescription& description, bool forceRgba) {
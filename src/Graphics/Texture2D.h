@@ -1,5 +1,6 @@
 #pragma once
 #include "ITexture.h"
+#include "Graphics/CookedTexture.h"
 
 /// <summary>
 /// Describes all parameters we can manipulate with our 2D Textures
@@ -56,6 +57,26 @@ struct Texture2DDescription {
 	/// </summary>
 	PixelFormat    FormatHint;
 
+	/// <summary>
+	/// The block compression format to cook this texture to, or None to keep it uncompressed
+	/// Only applies when the texture is loaded from a cooked file
+	/// </summary>
+	TextureCompression Compression;
+	/// <summary>
+	/// The quality level to use when compressing this texture
+	/// </summary>
+	CompressionQuality Quality;
+	/// <summary>
+	/// True if this texture should start with only it's smallest mips resident, and have higher
+	/// mips streamed in by the TextureStreamer as they are needed. Only applies to cooked textures
+	/// </summary>
+	bool           Streaming;
+	/// <summary>
+	/// True if this texture holds colors (ex albedo), false if it holds data like normals or masks.
+	/// Color textures have their mips filtered in linear space when they are cooked
+	/// </summary>
+	bool           IsColor;
+
 	Texture2DDescription() :
 		Width(0), Height(0),
 		Format(InternalFormat::Unknown),
@@ -66,7 +87,11 @@ struct Texture2DDescription {
 		MaxAnisotropic(-1.0f), // max aniso by default
 		GenerateMipMaps(true),
 		Filename(""),
-		FormatHint(PixelFormat::RGBA)
+		FormatHint(PixelFormat::RGBA),
+		Compression(TextureCompression::None),
+		Quality(CompressionQuality::Normal),
+		Streaming(false),
+		IsColor(false)
 	{ }
 };
 
@@ -142,6 +167,19 @@ public:
 	/// </summary>
 	const Texture2DDescription& GetDescription() const { return _description; }
 
+	/// <summary>
+	/// Returns true if this texture's mips are being managed by the TextureStreamer
+	/// </summary>
+	bool IsStreaming() const { return _streamSource != nullptr; }
+	/// <summary>
+	/// Gets the finest mip level that is currently resident on the GPU, 0 being the full resolution image
+	/// </summary>
+	uint32_t GetResidentLevel() const { return _residentLevel; }
+	/// <summary>
+	/// Gets the total number of mip levels in the full texture, including any that are not resident
+	/// </summary>
+	uint32_t GetNumLevels() const { return _numLevels; }
+
 	virtual nlohmann::json ToJson() const override;
 	static Texture2D::Sptr FromJson(const nlohmann::json& data);
 
@@ -154,9 +192,49 @@ protected:
 	/// </summary>
 	void _LoadDataFromFile();
 	/// <summary>
+	/// Attempts to load the cooked version of the texture specified in the description,
+	/// cooking it first if it is missing or out of date
+	/// </summary>
+	/// <returns>True if the cooked texture was loaded, false if we should fall back to the source image</returns>
+	bool _LoadCookedData();
+	/// <summary>
 	/// Allocates our texture's memory and sets sampling / filtering parameters
 	/// </summary>
 	void _SetTextureParams();
+	/// <summary>
+	/// Applies our wrap, filter and anisotropy settings to the texture
+	/// </summary>
+	void _ApplySamplerParams();
+
+	friend class TextureStreamer;
+	friend class Texture2DArray;
+
+	// The cooked file that streamed mips are loaded from, or nullptr if the texture is fully resident
+	CookedTexture::Sptr _streamSource;
+	// The number of levels in the full mip chain
+	uint32_t _numLevels;
+	// The source level that level 0 of our current storage corresponds to
+	uint32_t _allocatedLevel;
+	// The finest source level that has been uploaded
+	uint32_t _residentLevel;
+
+	/// <summary>
+	/// Re-allocates storage for the texture so that it can hold all levels from the given level down,
+	/// copying any levels that are already resident. Used both to make room for finer mips and to drop them
+	/// </summary>
+	/// <param name="topLevel">The finest source level the new storage should be able to hold</param>
+	void _StreamReallocate(uint32_t topLevel);
+	/// <summary>
+	/// Uploads a single mip level that was streamed in, and lowers our base level if the level is
+	/// directly above our finest resident level
+	/// </summary>
+	/// <param name="level">The source level to upload</param>
+	/// <param name="data">The data for the level, as stored in the cooked file</param>
+	void _StreamUploadLevel(uint32_t level, const uint8_t* data);
+	/// <summary>
+	/// Gets the number of bytes needed to store all levels from the given level down
+	/// </summary>
+	size_t _GetStreamedSize(uint32_t topLevel) const;
 
 public:
 	static Texture2D::Sptr LoadFromFile(const std::string& path, const Texture2DDescription& description = Texture2DDescription(), bool forceRgba = true);
@@ -0,0 +1,111 @@
+#include "Graphics/Texture2DArray.h"
+#include <algorithm>
+
+#include "Utils/ResourceManager/ResourceManager.h"
+#include "Utils/JsonGlmHelpers.h"
+#include "Logging.h"
+
+Texture2DArray::Texture2DArray(const Texture2DArrayDescription& description) :
+	ITexture(TextureType::_2DArray),
+	_description(description),
+	_format(InternalFormat::Unknown),
+	_width(0),
+	_height(0),
+	_numLevels(0)
+{
+	_CopyLayers();
+}
+
+int Texture2DArray::GetLayerIndex(const Texture2D::Sptr& texture) const {
+	auto it = std::find(_description.Layers.begin(), _description.Layers.end(), texture);
+	return it != _description.Layers.end() ? (int)(it - _description.Layers.begin()) : -1;
+}
+
+bool Texture2DArray::IsCompatible(const Texture2D::Sptr& texture) const {
+	return
+		texture != nullptr &&
+		texture->GetWidth() == _width &&
+		texture->GetHeight() == _height &&
+		texture->GetFormat() == _format &&
+		texture->GetNumLevels() >= _numLevels &&
+		texture->GetResidentLevel() == 0;
+}
+
+void Texture2DArray::_CopyLayers() {
+	LOG_ASSERT(!_description.Layers.empty(), "Cannot create a texture array with no layers!");
+	LOG_ASSERT(_description.Layers.size() <= (size_t)ITexture::GetLimits().MAX_ARRAY_TEXTURE_LAYERS, "Too many layers for a texture array!");
+
+	// The first layer determines the size and format for the rest of the array
+	const Texture2D::Sptr& first = _description.Layers[0];
+	_format = first->GetFormat();
+	_width  = first->GetWidth();
+	_height = first->GetHeight();
+	_numLevels = first->GetNumLevels();
+	for (const auto& layer : _description.Layers) {
+		_numLevels = glm::min(_numLevels, layer->GetNumLevels());
+	}
+
+	if (_description.MaxAnisotropic < 0.0f) {
+		_description.MaxAnisotropic = ITexture::GetLimits().MAX_ANISOTROPY;
+	}
+
+	glTextureStorage3D(_handle, _numLevels, *_format, _width, _height, (GLsizei)_description.Layers.size());
+	glTextureParameteri(_handle, GL_TEXTURE_WRAP_S, *_description.HorizontalWrap);
+	glTextureParameteri(_handle, GL_TEXTURE_WRAP_T, *_description.VerticalWrap);
+	glTextureParameteri(_handle, GL_TEXTURE_MIN_FILTER, *_description.MinificationFilter);
+	glTextureParameteri(_handle, GL_TEXTURE_MAG_FILTER, *_description.MagnificationFilter);
+	glTextureParameterf(_handle, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
+
+	// Copy each level of each layer over, this all stays on the GPU
+	for (size_t ix = 0; ix < _description.Layers.size(); ix++) {
+		const Texture2D::Sptr& layer = _description.Layers[ix];
+		if (!IsCompatible(layer)) {
+			LOG_WARN("Texture \"{}\" does not match the layout of texture array, layer {} will be empty", layer->GetDescription().Filename, ix);
+			continue;
+		}
+
+		uint32_t width = _width, height = _height;
+		for (uint32_t level = 0; level < _numLevels; level++) {
+			glCopyImageSubData(
+				layer->_handle, GL_TEXTURE_2D, level, 0, 0, 0,
+				_handle, GL_TEXTURE_2D_ARRAY, level, 0, 0, (GLint)ix,
+				width, height, 1);
+			width  = glm::max(1u, width / 2);
+			height = glm::max(1u, height / 2);
+		}
+	}
+}
+
+nlohmann::json Texture2DArray::ToJson() const {
+	nlohmann::json layers = nlohmann::json::array();
+	for (const auto& layer : _description.Layers) {
+		layers.push_back(layer->GetGUID().str());
+	}
+
+	return {
+		{ "layers",      layers },
+		{ "wrap_s",      ~_description.HorizontalWrap },
+		{ "wrap_t",      ~_description.VerticalWrap },
+		{ "filter_min",  ~_description.MinificationFilter },
+		{ "filter_mag",  ~_description.MagnificationFilter },
+		{ "anisotropic",  _description.MaxAnisotropic },
+	};
+}
+
+Texture2DArray::Sptr Texture2DArray::FromJson(const nlohmann::json& data) {
+	Texture2DArrayDescription descr = Texture2DArrayDescription();
+	for (const auto& guid : data["layers"]) {
+		Texture2D::Sptr layer = ResourceManager::Get<Texture2D>(Guid(guid.get<std::string>()));
+		if (layer == nullptr) {
+			LOG_WARN("Texture array is missing layer {}, has the texture been removed from the manifest?", guid.get<std::string>());
+			continue;
+		}
+		descr.Layers.push_back(layer);
+	}
+	descr.HorizontalWrap      = JsonParseEnum(WrapMode, data, "wrap_s", WrapMode::Repeat);
+	descr.VerticalWrap        = JsonParseEnum(WrapMode, data, "wrap_t", WrapMode::Repeat);
+	descr.MinificationFilter  = JsonParseEnum(MinFilter, data, "filter_min", MinFilter::NearestMipLinear);
+	descr.MagnificationFilter = JsonParseEnum(MagFilter, data, "filter_mag", MagFilter::Linear);
+	descr.MaxAnisotropic      = JsonGet(data, "anisotropic", -1.0f);
+	return std::make_shared<Texture2DArray>(descr);
+}
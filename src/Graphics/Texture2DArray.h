@@ -0,0 +1,120 @@
+#pragma once
+#include <vector>
+#include "Graphics/Texture2D.h"
+
+/// <summary>
+/// Describes the layers and sampling parameters for a 2D texture array
+/// </summary>
+struct Texture2DArrayDescription {
+	/// <summary>
+	/// The textures to copy into each layer of the array, all textures must have the
+	/// same size and internal format
+	/// </summary>
+	std::vector<Texture2D::Sptr> Layers;
+	/// <summary>
+	/// The wrap mode to use when a UV coordinate is outside the 0-1 range on the x axis
+	/// </summary>
+	WrapMode       HorizontalWrap;
+	/// <summary>
+	/// The wrap mode to use when a UV coordinate is outside the 0-1 range on the y axis
+	/// </summary>
+	WrapMode       VerticalWrap;
+	/// <summary>
+	/// The filter to use when multiple texels will map to a single pixel
+	/// </summary>
+	MinFilter      MinificationFilter;
+	/// <summary>
+	/// The filter to use when one texel will map to multiple pixels
+	/// </summary>
+	MagFilter      MagnificationFilter;
+	/// <summary>
+	/// The level of anisotropic filtering to use when this texture is viewed at an oblique angle
+	/// </summary>
+	float          MaxAnisotropic;
+
+	Texture2DArrayDescription() :
+		Layers(std::vector<Texture2D::Sptr>()),
+		HorizontalWrap(WrapMode::Repeat),
+		VerticalWrap(WrapMode::Repeat),
+		MinificationFilter(MinFilter::NearestMipLinear),
+		MagnificationFilter(MagFilter::Linear),
+		MaxAnisotropic(-1.0f)
+	{ }
+};
+
+/// <summary>
+/// A GL_TEXTURE_2D_ARRAY made up of copies of existing 2D textures. Materials that only differ
+/// by their textures can share a texture array, and select their layer per instance, allowing
+/// them to be drawn without re-binding any material state
+/// 
+/// Layers are copied on the GPU from the source textures when the array is created, so the
+/// source textures must be fully resident (not streamed)
+/// </summary>
+class Texture2DArray : public ITexture {
+public:
+	typedef std::shared_ptr<Texture2DArray> Sptr;
+
+	// Remove the copy and and assignment operators
+	Texture2DArray(const Texture2DArray& other) = delete;
+	Texture2DArray(Texture2DArray&& other) = delete;
+	Texture2DArray& operator=(const Texture2DArray& other) = delete;
+	Texture2DArray& operator=(Texture2DArray&& other) = delete;
+
+	// Make sure we mark our destructor as virtual so base class is called
+	virtual ~Texture2DArray() = default;
+
+public:
+	Texture2DArray(const Texture2DArrayDescription& description);
+
+	/// <summary>
+	/// Gets the internal format OpenGL is using for this texture
+	/// </summary>
+	InternalFormat GetFormat() const { return _format; }
+	/// <summary>
+	/// Gets the width of each layer in pixels
+	/// </summary>
+	uint32_t GetWidth() const { return _width; }
+	/// <summary>
+	/// Gets the height of each layer in pixels
+	/// </summary>
+	uint32_t GetHeight() const { return _height; }
+	/// <summary>
+	/// Gets the number of mip levels in each layer
+	/// </summary>
+	uint32_t GetNumLevels() const { return _numLevels; }
+	/// <summary>
+	/// Gets the number of layers in this texture array
+	/// </summary>
+	uint32_t GetNumLayers() const { return (uint32_t)_description.Layers.size(); }
+
+	/// <summary>
+	/// Gets the index of the layer that the given texture was copied into, or -1 if the
+	/// texture is not in this array
+	/// </summary>
+	int GetLayerIndex(const Texture2D::Sptr& texture) const;
+
+	/// <summary>
+	/// Returns true if the given texture can be copied into a layer of this array
+	/// </summary>
+	bool IsCompatible(const Texture2D::Sptr& texture) const;
+
+	/// <summary>
+	/// Gets this texture's description
+	/// </summary>
+	const Texture2DArrayDescription& GetDescription() const { return _description; }
+
+	virtual nlohmann::json ToJson() const override;
+	static Texture2DArray::Sptr FromJson(const nlohmann::json& data);
+
+protected:
+	Texture2DArrayDescription _description;
+	InternalFormat _format;
+	uint32_t       _width;
+	uint32_t       _height;
+	uint32_t       _numLevels;
+
+	/// <summary>
+	/// Allocates our storage and copies all of the layers from their source textures
+	/// </summary>
+	void _CopyLayers();
+};
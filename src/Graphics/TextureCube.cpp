@@ -2,6 +2,9 @@
 #include <filesystem>
 #include "stb_image.h"
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/TextureCooker.h"
+#include "Graphics/CookedTexture.h"
+#include "Utils/Profiler.h"
 
 TextureCube::TextureCube(const std::string& baseFilename) :
 	ITexture(TextureType::Cubemap),
@@ -31,6 +34,8 @@ nlohmann::json TextureCube::ToJson() const
 	nlohmann::json result;
 	result["filter_min"] = ~_description.MinificationFilter;
 	result["filter_mag"] = ~_description.MagnificationFilter;
+	result["compression"] = ~_description.Compression;
+	result["compression_quality"] = ~_description.Quality;
 	
 	if (!_description.FaceFileNames.empty()) {
 		result["face_filenames"] = nlohmann::json();
@@ -49,6 +54,8 @@ TextureCube::Sptr TextureCube::FromJson(const nlohmann::json& data)
 	TextureCubeDescription descr = TextureCubeDescription();
 	descr.MinificationFilter  = JsonParseEnum(MinFilter, data, "filter_min", MinFilter::NearestMipNearest);
 	descr.MagnificationFilter = JsonParseEnum(MagFilter, data, "filter_mag", MagFilter::Linear);
+	descr.Compression         = JsonParseEnum(TextureCompression, data, "compression", TextureCompression::None);
+	descr.Quality             = JsonParseEnum(CompressionQuality, data, "compression_quality", CompressionQuality::Normal);
 	descr.Filename       = JsonGet<std::string>(data, "base_filename", "");
 	if (data.contains("face_filenames") && data["face_filenames"].is_object()) {
 		for (auto& [key, value] : data["face_filenames"].items()) {
@@ -63,6 +70,7 @@ TextureCube::Sptr TextureCube::FromJson(const nlohmann::json& data)
 
 void TextureCube::_LoadFromDescription()
 {
+	PROFILE_SCOPE("TextureCube Load");
 	// If we weren't passed face filenames but WERE passed a base filename, try and get the 6 face files
 	if (_description.FaceFileNames.empty() && !_description.Filename.empty()) {
 		// Get the file path and it's directory to extract the root file name w/o extension
@@ -94,10 +102,86 @@ void TextureCube::_LoadFromDescription()
 		return;
 	}
 
+	// Prefer the cooked cubemap, since it already has all it's mips
+	if (TextureCooker::IsEnabled() && _LoadCookedImages(_description.FaceFileNames)) {
+		return;
+	}
+
 	// Load all the images into the texture
 	_LoadImages(_description.FaceFileNames);
 }
 
+bool TextureCube::_LoadCookedImages(const std::unordered_map<CubeMapFace, std::string>& faceFilenames)
+{
+	// Collect the faces in order so we can check them against the cooked file
+	std::vector<std::string> sources;
+	for (int ix = 0; ix < 6; ix++) {
+		sources.push_back(faceFilenames.at((CubeMapFace)ix));
+	}
+
+	// The cooked file sits next to the base file if we have one, otherwise next to the PosX face
+	std::string cookedPath = TextureCooker::GetCookedPath(_description.Filename.empty() ? sources[0] : _description.Filename);
+
+	TextureCookSettings settings;
+	settings.Compression = _description.Compression;
+	settings.Quality     = _description.Quality;
+	// Skyboxes are always color
+	settings.GammaCorrectMips = true;
+
+	bool canCook = TextureCooker::IsAutoCookEnabled();
+	if (canCook && !TextureCooker::IsUpToDate(sources, cookedPath)) {
+		TextureCooker::CookCube(sources, cookedPath, settings);
+		canCook = false;
+	}
+
+	if (!std::filesystem::exists(cookedPath)) {
+		return false;
+	}
+
+	CookedTexture::Sptr cooked = CookedTexture::Load(cookedPath);
+
+	// If the compression mode was changed since we cooked, we need to cook again
+	bool isCompressed = _description.Compression != TextureCompression::None;
+	if (cooked != nullptr && (cooked->IsCompressed() != isCompressed || (isCompressed && cooked->GetHeader().Format != GetInternalFormatForCompression(_description.Compression)))) {
+		cooked = nullptr;
+		if (canCook && TextureCooker::CookCube(sources, cookedPath, settings)) {
+			cooked = CookedTexture::Load(cookedPath);
+		} else {
+			LOG_WARN("Cooked cubemap \"{}\" does not match the requested format, it should be re-cooked", cookedPath);
+		}
+	}
+
+	if (cooked == nullptr || cooked->GetHeader().NumFaces != 6) {
+		return false;
+	}
+
+	const CookedTexture::Header& header = cooked->GetHeader();
+	_description.Size = header.Width;
+	_description.Format = header.Format;
+	if (!cooked->IsCompressed()) {
+		_description.FormatHint = header.Layout;
+	}
+
+	// Allocate memory for the full mip chain and set up initial parameters
+	_SetTextureParams(header.NumLevels);
+
+	// Rows in the cooked data are tightly packed
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	// Each level stores all 6 faces back to back, so we can upload a level in one go
+	for (uint32_t level = 0; level < header.NumLevels; level++) {
+		const CookedMipLevel& info = cooked->GetLevel(level);
+		if (cooked->IsCompressed()) {
+			glCompressedTextureSubImage3D(_handle, level, 0, 0, 0, info.Width, info.Height, 6, *header.Format, (GLsizei)(info.FaceSize * 6), cooked->GetLevelData(level));
+		} else {
+			glTextureSubImage3D(_handle, level, 0, 0, 0, info.Width, info.Height, 6, *header.Layout, *header.Type, cooked->GetLevelData(level));
+		}
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	return true;
+}
+
 void TextureCube::_LoadImages(const std::unordered_map<CubeMapFace, std::string>& faceFilenames)
 {
 	// Will store all of our texture data, back to back in memory
@@ -177,11 +261,11 @@ void TextureCube::_LoadImages(const std::unordered_map<CubeMapFace, std::string>
 	delete[] datastore;
 }
 
-void TextureCube::_SetTextureParams(){
+void TextureCube::_SetTextureParams(int levels){
 	// Make sure the size is greater than zero and that we have a format specified before trying to set parameters
 	if (_description.Size > 0 && _description.Format != InternalFormat::Unknown) {
 		// Allocates the memory for our texture
-		glTextureStorage2D(_handle, 1, (GLenum)_description.Format, _description.Size, _description.Size);
+		glTextureStorage2D(_handle, levels, (GLenum)_description.Format, _description.Size, _description.Size);
 
 		// Set up our texture parameters
 		glTextureParameteri(_handle, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
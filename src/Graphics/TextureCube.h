@@ -59,6 +59,15 @@ struct TextureCubeDescription {
 	/// </summary>
 	PixelFormat    FormatHint;
 
+	/// <summary>
+	/// The block compression format to cook this cubemap to, or None to keep it uncompressed
+	/// </summary>
+	TextureCompression Compression;
+	/// <summary>
+	/// The quality level to use when compressing this cubemap
+	/// </summary>
+	CompressionQuality Quality;
+
 	/// <summary>
 	/// Creates a default (empty) cubemap description
 	/// </summary>
@@ -68,7 +77,9 @@ struct TextureCubeDescription {
 		MinificationFilter(MinFilter::NearestMipLinear),
 		MagnificationFilter(MagFilter::Linear),
 		Filename(""),
-		FormatHint(PixelFormat::RGBA)
+		FormatHint(PixelFormat::RGBA),
+		Compression(TextureCompression::None),
+		Quality(CompressionQuality::Normal)
 	{ }
 };
 
@@ -121,9 +132,15 @@ protected:
 
 	virtual void _LoadFromDescription();
 	virtual void _LoadImages(const std::unordered_map<CubeMapFace, std::string>& faceFilenames);
+	/// <summary>
+	/// Attempts to load the cooked version of the cubemap, cooking it first if it is missing or out of date
+	/// </summary>
+	/// <returns>True if the cooked cubemap was loaded, false if we should fall back to the source images</returns>
+	virtual bool _LoadCookedImages(const std::unordered_map<CubeMapFace, std::string>& faceFilenames);
 
 	/// <summary>
 	/// Allocates our texture's memory and sets sampling / filtering parameters
 	/// </summary>
-	void _SetTextureParams();
+	/// <param name="levels">The number of mip levels to allocate</param>
+	void _SetTextureParams(int levels = 1);
 };
\ No newline at end of file
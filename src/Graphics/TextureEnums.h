@@ -5,6 +5,15 @@
 #include "Logging.h"
 #include "glad/glad.h"
 
+// S3TC formats are provided by EXT_texture_compression_s3tc, which is supported by all desktop
+// drivers, but may not be in our GL loader
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT  0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 /// <summary>
 /// The types of texture we will support in our framework
 /// </summary>
@@ -12,6 +21,7 @@
 ENUM(TextureType, GLenum,
 	_1D = GL_TEXTURE_1D,
 	_2D = GL_TEXTURE_2D,
+	_2DArray = GL_TEXTURE_2D_ARRAY,
 	_3D = GL_TEXTURE_3D,
 	Cubemap = GL_TEXTURE_CUBE_MAP,
 	_2DMultisample = GL_TEXTURE_2D_MULTISAMPLE
@@ -34,10 +44,33 @@ ENUM(InternalFormat, GLint,
 	RGBA8        = GL_RGBA8,
 	SRGBA        = GL_SRGB8_ALPHA8,
 	RGBA16       = GL_RGBA16,
-	RGB32AF      = GL_RGBA32F
+	RGB32AF      = GL_RGBA32F,
+	// Block compressed formats, these can only be uploaded with glCompressedTextureSubImage
+	BC1          = GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+	BC3          = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+	BC4          = GL_COMPRESSED_RED_RGTC1,
+	BC5          = GL_COMPRESSED_RG_RGTC2,
+	BC7          = GL_COMPRESSED_RGBA_BPTC_UNORM
 	// Note: There are sized internal formats but there is a LOT of them
 );
 
+// The block compression formats our texture cooker can encode to
+ENUM(TextureCompression, int,
+	None = 0,
+	BC1  = 1, // RGB, 4 bits per texel
+	BC3  = 2, // RGBA, 8 bits per texel
+	BC4  = 3, // Single channel, 4 bits per texel
+	BC5  = 4, // Two channel (ex: normal maps), 8 bits per texel
+	BC7  = 5  // High quality RGBA, 8 bits per texel
+);
+
+// Trades off encoding time against quality when block compressing textures
+ENUM(CompressionQuality, int,
+	Fast   = 0,
+	Normal = 1,
+	High   = 2
+);
+
 // The layout of the input pixel data
 ENUM(PixelFormat, GLint,
     Unknown      = GL_NONE,
@@ -170,4 +203,52 @@ constexpr GLint GetTexelComponentCount(PixelFormat format) {
  */
 constexpr size_t GetTexelSize(PixelFormat format, PixelType type) {
 	return GetTexelComponentSize(type) * GetTexelComponentCount(format);
+}
+
+/*
+ * Returns true if the given internal format is block compressed
+ */
+constexpr bool IsCompressedFormat(InternalFormat format) {
+	switch (format) {
+		case InternalFormat::BC1:
+		case InternalFormat::BC3:
+		case InternalFormat::BC4:
+		case InternalFormat::BC5:
+		case InternalFormat::BC7:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * Gets the internal format that corresponds to a texture compression mode
+ */
+constexpr InternalFormat GetInternalFormatForCompression(TextureCompression compression) {
+	switch (compression) {
+		case TextureCompression::BC1: return InternalFormat::BC1;
+		case TextureCompression::BC3: return InternalFormat::BC3;
+		case TextureCompression::BC4: return InternalFormat::BC4;
+		case TextureCompression::BC5: return InternalFormat::BC5;
+		case TextureCompression::BC7: return InternalFormat::BC7;
+		default:
+			return InternalFormat::Unknown;
+	}
+}
+
+/*
+ * Gets the number of bytes used to store a single 4x4 block of the given compression mode
+ */
+constexpr size_t GetCompressedBlockSize(TextureCompression compression) {
+	switch (compression) {
+		case TextureCompression::BC1:
+		case TextureCompression::BC4:
+			return 8;
+		case TextureCompression::BC3:
+		case TextureCompression::BC5:
+		case TextureCompression::BC7:
+			return 16;
+		default:
+			return 0;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "Graphics/TextureStreamer.h"
+#include <algorithm>
+#include <cmath>
+
+#include "Utils/ImGuiHelper.h"
+#include "Utils/Profiler.h"
+#include "Logging.h"
+
+std::unordered_map<Guid, TextureStreamer::TextureState> TextureStreamer::_textures;
+uint64_t TextureStreamer::_nextSerial = 0;
+
+std::thread                                  TextureStreamer::_worker;
+std::mutex                                   TextureStreamer::_mutex;
+std::condition_variable                      TextureStreamer::_condition;
+std::deque<TextureStreamer::LoadRequest>     TextureStreamer::_requests;
+std::deque<TextureStreamer::LoadResult>      TextureStreamer::_results;
+std::atomic_bool                             TextureStreamer::_isRunning(false);
+
+size_t TextureStreamer::_memoryBudget  = 256 * 1024 * 1024;
+size_t TextureStreamer::_uploadBudget  = 8 * 1024 * 1024;
+size_t TextureStreamer::_residentBytes = 0;
+float  TextureStreamer::_lodBias       = 0.0f;
+
+void TextureStreamer::Init() {
+	if (_isRunning) {
+		return;
+	}
+	_isRunning = true;
+	_worker = std::thread(&TextureStreamer::_WorkerMain);
+}
+
+void TextureStreamer::Cleanup() {
+	if (_isRunning) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_isRunning = false;
+			_requests.clear();
+		}
+		_condition.notify_all();
+		_worker.join();
+	}
+	_results.clear();
+	_textures.clear();
+	_residentBytes = 0;
+}
+
+uint32_t TextureStreamer::GetInitialLevel(uint32_t width, uint32_t height, uint32_t numLevels) {
+	uint32_t level = 0;
+	uint32_t size = std::max(width, height);
+	while (size > MIN_RESIDENT_SIZE && level + 1 < numLevels) {
+		size = std::max(1u, size / 2);
+		level++;
+	}
+	return level;
+}
+
+void TextureStreamer::ReportUsage(const Texture2D::Sptr& texture, float screenPixels) {
+	if (texture == nullptr || !texture->IsStreaming()) {
+		return;
+	}
+
+	// If the texture we were tracking under this GUID has been replaced, start over with the new one
+	auto it = _textures.find(texture->GetGUID());
+	if (it == _textures.end() || it->second.Texture.lock() != texture) {
+		TextureState state;
+		state.Texture         = texture;
+		state.Serial          = _nextSerial++;
+		state.RequestedLevel  = texture->GetNumLevels();
+		state.TargetLevel     = texture->GetResidentLevel();
+		state.FramesSinceUsed = 0;
+		state.HasPendingLoad  = false;
+		it = _textures.insert_or_assign(texture->GetGUID(), state).first;
+	}
+
+	// Pick the level where one texel maps to roughly one pixel
+	uint32_t size = std::max(texture->GetWidth(), texture->GetHeight());
+	float level = std::log2(size / std::max(screenPixels, 1.0f)) + _lodBias;
+	uint32_t requested = (uint32_t)std::clamp(std::floor(level), 0.0f, (float)(texture->GetNumLevels() - 1));
+
+	it->second.RequestedLevel = std::min(it->second.RequestedLevel, requested);
+}
+
+void TextureStreamer::Update() {
+	PROFILE_SCOPE("TextureStreamer::Update");
+	_ApplyResults();
+
+	_residentBytes = 0;
+	for (auto it = _textures.begin(); it != _textures.end();) {
+		Texture2D::Sptr texture = it->second.Texture.lock();
+		// The texture has been destroyed, stop tracking it
+		if (texture == nullptr) {
+			it = _textures.erase(it);
+			continue;
+		}
+
+		TextureState& state = it->second;
+		uint32_t initialLevel = GetInitialLevel(texture->GetWidth(), texture->GetHeight(), texture->GetNumLevels());
+
+		// If the texture was used this frame, we stream towards the requested level, otherwise we hold the
+		// current target for a little while before dropping back to the smallest mips
+		if (state.RequestedLevel < texture->GetNumLevels()) {
+			state.TargetLevel = std::min(state.RequestedLevel, initialLevel);
+			state.FramesSinceUsed = 0;
+		} else if (++state.FramesSinceUsed > DROP_AFTER_FRAMES) {
+			state.TargetLevel = initialLevel;
+		}
+		state.RequestedLevel = texture->GetNumLevels();
+
+		it++;
+	}
+
+	_EnforceBudget();
+
+	for (auto& [key, state] : _textures) {
+		Texture2D::Sptr texture = state.Texture.lock();
+
+		// Drop any mips we no longer need, this frees the memory for the finer levels
+		if (state.TargetLevel > texture->GetResidentLevel()) {
+			texture->_StreamReallocate(state.TargetLevel);
+		}
+		// Make room for finer levels, and request the next level down
+		else if (state.TargetLevel < texture->GetResidentLevel()) {
+			if (state.TargetLevel < texture->_allocatedLevel) {
+				texture->_StreamReallocate(state.TargetLevel);
+			}
+			if (!state.HasPendingLoad) {
+				state.HasPendingLoad = true;
+				uint64_t flow = Profiler::NewFlowId();
+				PROFILE_FLOW_BEGIN("Texture Stream", flow);
+				std::lock_guard<std::mutex> lock(_mutex);
+				_requests.push_back({ key, state.Serial, texture->_streamSource, texture->GetResidentLevel() - 1, flow });
+			}
+		}
+
+		_residentBytes += texture->_GetStreamedSize(std::min(texture->GetResidentLevel(), texture->GetNumLevels() - 1));
+	}
+
+	PROFILE_COUNTER("Texture Memory (MB)", _residentBytes / (1024.0 * 1024.0));
+	_condition.notify_one();
+}
+
+void TextureStreamer::_ApplyResults() {
+	size_t uploaded = 0;
+	while (uploaded < _uploadBudget) {
+		LoadResult result;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (_results.empty()) {
+				break;
+			}
+			result = std::move(_results.front());
+			_results.pop_front();
+		}
+
+		// Drop results for textures that have stopped being tracked, or been replaced since the load was requested
+		auto it = _textures.find(result.Key);
+		if (it == _textures.end() || it->second.Serial != result.Serial) {
+			continue;
+		}
+		it->second.HasPendingLoad = false;
+
+		Texture2D::Sptr texture = it->second.Texture.lock();
+		if (texture != nullptr) {
+			PROFILE_SCOPE("Texture Stream Upload");
+			PROFILE_FLOW_END("Texture Stream", result.FlowId);
+			texture->_StreamUploadLevel(result.Level, result.Data.data());
+			uploaded += result.Data.size();
+		}
+	}
+}
+
+void TextureStreamer::_EnforceBudget() {
+	// Determine how much memory our targets would take up
+	size_t totalBytes = 0;
+	for (auto& [key, state] : _textures) {
+		Texture2D::Sptr texture = state.Texture.lock();
+		totalBytes += texture->_GetStreamedSize(state.TargetLevel);
+	}
+
+	// Step the largest textures down a level at a time until we fit in our budget
+	while (totalBytes > _memoryBudget) {
+		TextureState* largest = nullptr;
+		size_t largestBytes = 0;
+		for (auto& [key, state] : _textures) {
+			Texture2D::Sptr texture = state.Texture.lock();
+			if (state.TargetLevel >= GetInitialLevel(texture->GetWidth(), texture->GetHeight(), texture->GetNumLevels())) {
+				continue;
+			}
+			size_t bytes = texture->_GetStreamedSize(state.TargetLevel);
+			if (bytes > largestBytes) {
+				largest = &state;
+				largestBytes = bytes;
+			}
+		}
+
+		// Everything is already at it's smallest, we can't do any better
+		if (largest == nullptr) {
+			break;
+		}
+
+		Texture2D::Sptr texture = largest->Texture.lock();
+		largest->TargetLevel++;
+		totalBytes -= largestBytes - texture->_GetStreamedSize(largest->TargetLevel);
+	}
+}
+
+void TextureStreamer::_WorkerMain() {
+	Profiler::SetThreadName("Texture Streamer");
+	while (true) {
+		LoadRequest request;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condition.wait(lock, []() { return !_isRunning || !_requests.empty(); });
+			if (!_isRunning) {
+				return;
+			}
+			request = std::move(_requests.front());
+			_requests.pop_front();
+		}
+
+		// Copying out of the mapped file is what actually pulls the data in from the disk, so we
+		// do that here instead of on the render thread
+		LoadResult result;
+		{
+			PROFILE_SCOPE("Texture Stream Load");
+			PROFILE_FLOW_STEP("Texture Stream", request.FlowId);
+			const CookedMipLevel& info = request.Source->GetLevel(request.Level);
+			const uint8_t* data = request.Source->GetLevelData(request.Level);
+
+			result.Key    = request.Key;
+			result.Serial = request.Serial;
+			result.Level  = request.Level;
+			result.FlowId = request.FlowId;
+			result.Data.assign(data, data + info.FaceSize);
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_results.push_back(std::move(result));
+	}
+}
+
+void TextureStreamer::RenderImGui() {
+	float budgetMb = _memoryBudget / (1024.0f * 1024.0f);
+	if (LABEL_LEFT(ImGui::DragFloat, "Memory Budget (MB)", &budgetMb, 1.0f, 1.0f, 4096.0f)) {
+		_memoryBudget = (size_t)(budgetMb * 1024.0f * 1024.0f);
+	}
+	float uploadMb = _uploadBudget / (1024.0f * 1024.0f);
+	if (LABEL_LEFT(ImGui::DragFloat, "Upload Budget (MB)", &uploadMb, 0.1f, 0.1f, 256.0f)) {
+		_uploadBudget = (size_t)(uploadMb * 1024.0f * 1024.0f);
+	}
+	LABEL_LEFT(ImGui::DragFloat, "LOD Bias          ", &_lodBias, 0.1f, -4.0f, 4.0f);
+	ImGui::Text("Resident: %.2f MB in %d textures", _residentBytes / (1024.0f * 1024.0f), (int)_textures.size());
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "Graphics/Texture2D.h"
+
+/// <summary>
+/// Manages mip residency for streamed Texture2Ds. Textures come up with only their smallest mips
+/// resident, and higher mips are read from their cooked files on a background thread as demand
+/// is reported, then uploaded on the main thread under a per-frame upload budget. When the total
+/// resident size goes over the memory budget, or a texture has not been used for a while, mips are
+/// dropped again
+/// 
+/// Demand is reported each frame with ReportUsage (see Scene::UpdateTextureStreaming), then
+/// Update should be called once per frame from the thread that owns the GL context
+/// </summary>
+class TextureStreamer {
+public:
+	TextureStreamer() = delete;
+
+	/// <summary>
+	/// Starts the background streaming thread
+	/// </summary>
+	static void Init();
+	/// <summary>
+	/// Stops the background streaming thread and releases all tracked textures
+	/// </summary>
+	static void Cleanup();
+
+	/// <summary>
+	/// Reports that a texture is being drawn at approximately the given size on screen
+	/// </summary>
+	/// <param name="texture">The texture that is being used</param>
+	/// <param name="screenPixels">The approximate size of the texture on screen, in pixels along it's largest axis</param>
+	static void ReportUsage(const Texture2D::Sptr& texture, float screenPixels);
+
+	/// <summary>
+	/// Uploads any mips that have finished loading, updates the target level for each texture based
+	/// on the usage reported this frame, and kicks off any new loads
+	/// </summary>
+	static void Update();
+
+	/// <summary>
+	/// Gets the finest level that a streamed texture will start with, which is the first level that
+	/// is smaller than the minimum resident size
+	/// </summary>
+	static uint32_t GetInitialLevel(uint32_t width, uint32_t height, uint32_t numLevels);
+
+	/// <summary>
+	/// Sets the maximum number of bytes that streamed textures may use in total
+	/// </summary>
+	static void SetMemoryBudget(size_t bytes) { _memoryBudget = bytes; }
+	static size_t GetMemoryBudget() { return _memoryBudget; }
+	/// <summary>
+	/// Sets the maximum number of bytes that will be uploaded to the GPU in a single frame
+	/// </summary>
+	static void SetUploadBudget(size_t bytes) { _uploadBudget = bytes; }
+	static size_t GetUploadBudget() { return _uploadBudget; }
+	/// <summary>
+	/// Sets the bias applied to requested mip levels, positive values will request blurrier mips
+	/// </summary>
+	static void SetLodBias(float bias) { _lodBias = bias; }
+	static float GetLodBias() { return _lodBias; }
+	/// <summary>
+	/// Gets the total number of bytes used by streamed textures at their current residency
+	/// </summary>
+	static size_t GetResidentBytes() { return _residentBytes; }
+
+	/// <summary>
+	/// Renders some ImGui controls for the streaming settings and stats
+	/// </summary>
+	static void RenderImGui();
+
+protected:
+	// Textures with a largest dimension at or below this size are always resident
+	static const uint32_t MIN_RESIDENT_SIZE = 64;
+	// The number of frames a texture can go unused before it's mips are dropped
+	static const uint32_t DROP_AFTER_FRAMES = 120;
+
+	struct TextureState {
+		std::weak_ptr<Texture2D> Texture;
+		// Unique to each time a texture starts being tracked, so results loaded for a texture that has since
+		// been replaced are never applied to it's replacement
+		uint64_t Serial;
+		// The finest level requested this frame
+		uint32_t RequestedLevel;
+		// The level we are currently streaming towards
+		uint32_t TargetLevel;
+		// The number of frames since the texture was last reported
+		uint32_t FramesSinceUsed;
+		// True if a level is currently being loaded on the worker thread
+		bool     HasPendingLoad;
+	};
+
+	struct LoadRequest {
+		Guid                Key;
+		uint64_t            Serial;
+		CookedTexture::Sptr Source;
+		uint32_t            Level;
+		// Ties the request, load and upload together in traces
+		uint64_t            FlowId;
+	};
+
+	struct LoadResult {
+		Guid                 Key;
+		uint64_t             Serial;
+		uint32_t             Level;
+		std::vector<uint8_t> Data;
+		uint64_t             FlowId;
+	};
+
+	// Keyed by resource GUID rather than pointer, since a new texture can be allocated where a freed one was
+	static std::unordered_map<Guid, TextureState> _textures;
+	static uint64_t _nextSerial;
+
+	static std::thread              _worker;
+	static std::mutex               _mutex;
+	static std::condition_variable  _condition;
+	static std::deque<LoadRequest>  _requests;
+	static std::deque<LoadResult>   _results;
+	static std::atomic_bool         _isRunning;
+
+	static size_t _memoryBudget;
+	static size_t _uploadBudget;
+	static size_t _residentBytes;
+	static float  _lodBias;
+
+	static void _WorkerMain();
+	static void _ApplyResults();
+	static void _EnforceBudget();
+};
@@ -0,0 +1,704 @@
+#include "Utils/BlockCompressor.h"
+#include <algorithm>
+#include <thread>
+#include <cmath>
+#include <limits>
+#include <cstring>
+
+// Stores a 4x4 block of RGBA texels
+struct TexelBlock {
+	uint8_t Texels[16][4];
+};
+
+// The interpolation weights for BC7 4 bit indices
+static const int BC7_WEIGHTS_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+#pragma region Helpers
+
+inline int Square(int value) { return value * value; }
+
+// Copies a 4x4 block out of the image, clamping to the edges for partial blocks
+inline void ExtractBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, TexelBlock& block) {
+	for (int y = 0; y < 4; y++) {
+		uint32_t sy = std::min(blockY * 4 + y, height - 1);
+		for (int x = 0; x < 4; x++) {
+			uint32_t sx = std::min(blockX * 4 + x, width - 1);
+			memcpy(block.Texels[y * 4 + x], rgba + ((size_t)sy * width + sx) * 4, 4);
+		}
+	}
+}
+
+// Calculates the principal axis of the first numChannels channels of a block, returning the
+// endpoints of the texels projected onto that axis
+inline void FindPrincipalEndpoints(const TexelBlock& block, int numChannels, CompressionQuality quality, float minOut[4], float maxOut[4]) {
+	float mean[4] = { 0.0f };
+	for (int ix = 0; ix < 16; ix++) {
+		for (int c = 0; c < numChannels; c++) {
+			mean[c] += block.Texels[ix][c];
+		}
+	}
+	for (int c = 0; c < numChannels; c++) {
+		mean[c] /= 16.0f;
+	}
+
+	// Fast mode just uses the bounding box of the block, with a small inset to reduce error
+	if (quality == CompressionQuality::Fast) {
+		for (int c = 0; c < numChannels; c++) {
+			float lo = 255.0f, hi = 0.0f;
+			for (int ix = 0; ix < 16; ix++) {
+				lo = std::min(lo, (float)block.Texels[ix][c]);
+				hi = std::max(hi, (float)block.Texels[ix][c]);
+			}
+			float inset = (hi - lo) / 32.0f;
+			minOut[c] = lo + inset;
+			maxOut[c] = hi - inset;
+		}
+		return;
+	}
+
+	// Build the covariance matrix
+	float covariance[4][4] = { { 0.0f } };
+	for (int ix = 0; ix < 16; ix++) {
+		float delta[4];
+		for (int c = 0; c < numChannels; c++) {
+			delta[c] = block.Texels[ix][c] - mean[c];
+		}
+		for (int r = 0; r < numChannels; r++) {
+			for (int c = 0; c < numChannels; c++) {
+				covariance[r][c] += delta[r] * delta[c];
+			}
+		}
+	}
+
+	// Power iteration to find the dominant eigenvector
+	float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	for (int iteration = 0; iteration < 8; iteration++) {
+		float next[4] = { 0.0f };
+		for (int r = 0; r < numChannels; r++) {
+			for (int c = 0; c < numChannels; c++) {
+				next[r] += covariance[r][c] * axis[c];
+			}
+		}
+		float length = 0.0f;
+		for (int c = 0; c < numChannels; c++) {
+			length += next[c] * next[c];
+		}
+		// Solid color blocks have no dominant axis
+		if (length < 1e-8f) {
+			break;
+		}
+		length = 1.0f / std::sqrt(length);
+		for (int c = 0; c < numChannels; c++) {
+			axis[c] = next[c] * length;
+		}
+	}
+
+	// Project all our texels onto the axis to find the extents
+	float lo = std::numeric_limits<float>::max();
+	float hi = -std::numeric_limits<float>::max();
+	for (int ix = 0; ix < 16; ix++) {
+		float t = 0.0f;
+		for (int c = 0; c < numChannels; c++) {
+			t += (block.Texels[ix][c] - mean[c]) * axis[c];
+		}
+		lo = std::min(lo, t);
+		hi = std::max(hi, t);
+	}
+	for (int c = 0; c < numChannels; c++) {
+		minOut[c] = std::clamp(mean[c] + axis[c] * lo, 0.0f, 255.0f);
+		maxOut[c] = std::clamp(mean[c] + axis[c] * hi, 0.0f, 255.0f);
+	}
+}
+
+// Solves for the endpoints that best fit the texels given a fixed set of index weights (0-1), in the least squares sense
+inline bool RefineEndpoints(const TexelBlock& block, int numChannels, const float weights[16], float minOut[4], float maxOut[4]) {
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	float ax[4] = { 0.0f }, bx[4] = { 0.0f };
+	for (int ix = 0; ix < 16; ix++) {
+		float b = weights[ix];
+		float a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (int c = 0; c < numChannels; c++) {
+			ax[c] += a * block.Texels[ix][c];
+			bx[c] += b * block.Texels[ix][c];
+		}
+	}
+	float determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) < 1e-6f) {
+		return false;
+	}
+	float inverse = 1.0f / determinant;
+	for (int c = 0; c < numChannels; c++) {
+		minOut[c] = std::clamp((ax[c] * bb - bx[c] * ab) * inverse, 0.0f, 255.0f);
+		maxOut[c] = std::clamp((bx[c] * aa - ax[c] * ab) * inverse, 0.0f, 255.0f);
+	}
+	return true;
+}
+
+// Writes bits into a 128 bit block, least significant bit first
+struct BitWriter {
+	uint8_t* Data;
+	int      Position = 0;
+
+	void Write(uint32_t value, int numBits) {
+		for (int ix = 0; ix < numBits; ix++) {
+			if (value & (1u << ix)) {
+				Data[Position >> 3] |= 1 << (Position & 7);
+			}
+			Position++;
+		}
+	}
+};
+
+// Reads bits from a 128 bit block, least significant bit first
+struct BitReader {
+	const uint8_t* Data;
+	int            Position = 0;
+
+	uint32_t Read(int numBits) {
+		uint32_t result = 0;
+		for (int ix = 0; ix < numBits; ix++) {
+			if (Data[Position >> 3] & (1 << (Position & 7))) {
+				result |= 1u << ix;
+			}
+			Position++;
+		}
+		return result;
+	}
+};
+
+#pragma endregion
+
+#pragma region BC1
+
+inline uint16_t PackRgb565(const float color[3]) {
+	int r = std::clamp((int)std::round(color[0] * 31.0f / 255.0f), 0, 31);
+	int g = std::clamp((int)std::round(color[1] * 63.0f / 255.0f), 0, 63);
+	int b = std::clamp((int)std::round(color[2] * 31.0f / 255.0f), 0, 31);
+	return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+inline void UnpackRgb565(uint16_t packed, int color[3]) {
+	int r = (packed >> 11) & 31;
+	int g = (packed >> 5) & 63;
+	int b = packed & 31;
+	color[0] = (r << 3) | (r >> 2);
+	color[1] = (g << 2) | (g >> 4);
+	color[2] = (b << 3) | (b >> 2);
+}
+
+// Builds the 4 color palette for a pair of BC1 endpoints
+inline void BuildBC1Palette(uint16_t c0, uint16_t c1, int palette[4][3]) {
+	UnpackRgb565(c0, palette[0]);
+	UnpackRgb565(c1, palette[1]);
+	for (int c = 0; c < 3; c++) {
+		palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+		palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+	}
+}
+
+// Selects the best palette entry for each texel, returning the total error
+inline int SelectBC1Indices(const TexelBlock& block, const int palette[4][3], uint8_t indices[16]) {
+	int totalError = 0;
+	for (int ix = 0; ix < 16; ix++) {
+		int bestError = std::numeric_limits<int>::max();
+		for (int p = 0; p < 4; p++) {
+			int error = Square(block.Texels[ix][0] - palette[p][0]) + Square(block.Texels[ix][1] - palette[p][1]) + Square(block.Texels[ix][2] - palette[p][2]);
+			if (error < bestError) {
+				bestError = error;
+				indices[ix] = p;
+			}
+		}
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+// Encodes the color part of a BC1 or BC3 block, always using the 4 color mode
+void EncodeBC1Block(const TexelBlock& block, CompressionQuality quality, uint8_t* output) {
+	float lo[4], hi[4];
+	FindPrincipalEndpoints(block, 3, quality, lo, hi);
+
+	uint16_t c0 = PackRgb565(hi);
+	uint16_t c1 = PackRgb565(lo);
+	int palette[4][3];
+	uint8_t indices[16];
+	BuildBC1Palette(c0, c1, palette);
+	int bestError = SelectBC1Indices(block, palette, indices);
+
+	// Higher quality levels refine the endpoints using the indices we picked
+	int iterations = quality == CompressionQuality::High ? 3 : (quality == CompressionQuality::Normal ? 1 : 0);
+	static const float PALETTE_WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+	for (int iteration = 0; iteration < iterations; iteration++) {
+		float weights[16];
+		for (int ix = 0; ix < 16; ix++) {
+			weights[ix] = PALETTE_WEIGHTS[indices[ix]];
+		}
+		float refinedLo[4], refinedHi[4];
+		if (!RefineEndpoints(block, 3, weights, refinedHi, refinedLo)) {
+			break;
+		}
+		uint16_t r0 = PackRgb565(refinedHi);
+		uint16_t r1 = PackRgb565(refinedLo);
+		int refinedPalette[4][3];
+		uint8_t refinedIndices[16];
+		BuildBC1Palette(r0, r1, refinedPalette);
+		int error = SelectBC1Indices(block, refinedPalette, refinedIndices);
+		if (error >= bestError) {
+			break;
+		}
+		bestError = error;
+		c0 = r0;
+		c1 = r1;
+		memcpy(indices, refinedIndices, 16);
+	}
+
+	// The 4 color mode requires c0 > c1, swap the endpoints and remap indices if needed
+	if (c0 < c1) {
+		std::swap(c0, c1);
+		static const uint8_t SWAPPED[4] = { 1, 0, 3, 2 };
+		for (int ix = 0; ix < 16; ix++) {
+			indices[ix] = SWAPPED[indices[ix]];
+		}
+	} else if (c0 == c1) {
+		memset(indices, 0, 16);
+	}
+
+	uint32_t packedIndices = 0;
+	for (int ix = 0; ix < 16; ix++) {
+		packedIndices |= (uint32_t)indices[ix] << (ix * 2);
+	}
+	memcpy(output + 0, &c0, 2);
+	memcpy(output + 2, &c1, 2);
+	memcpy(output + 4, &packedIndices, 4);
+}
+
+void DecodeBC1Block(const uint8_t* input, TexelBlock& block) {
+	uint16_t c0, c1;
+	uint32_t packedIndices;
+	memcpy(&c0, input + 0, 2);
+	memcpy(&c1, input + 2, 2);
+	memcpy(&packedIndices, input + 4, 4);
+
+	int palette[4][3];
+	BuildBC1Palette(c0, c1, palette);
+	int alpha[4] = { 255, 255, 255, 255 };
+	// 3 color mode, where the 4th entry is transparent black
+	if (c0 <= c1) {
+		for (int c = 0; c < 3; c++) {
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+		alpha[3] = 0;
+	}
+
+	for (int ix = 0; ix < 16; ix++) {
+		int index = (packedIndices >> (ix * 2)) & 3;
+		block.Texels[ix][0] = palette[index][0];
+		block.Texels[ix][1] = palette[index][1];
+		block.Texels[ix][2] = palette[index][2];
+		block.Texels[ix][3] = alpha[index];
+	}
+}
+
+#pragma endregion
+
+#pragma region BC4
+
+// Builds the 8 value palette for a pair of BC4 endpoints
+inline void BuildBC4Palette(int r0, int r1, int palette[8]) {
+	palette[0] = r0;
+	palette[1] = r1;
+	if (r0 > r1) {
+		for (int ix = 1; ix < 7; ix++) {
+			palette[ix + 1] = ((7 - ix) * r0 + ix * r1) / 7;
+		}
+	} else {
+		for (int ix = 1; ix < 5; ix++) {
+			palette[ix + 1] = ((5 - ix) * r0 + ix * r1) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+inline int SelectBC4Indices(const TexelBlock& block, int channel, const int palette[8], uint8_t indices[16]) {
+	int totalError = 0;
+	for (int ix = 0; ix < 16; ix++) {
+		int bestError = std::numeric_limits<int>::max();
+		for (int p = 0; p < 8; p++) {
+			int error = Square(block.Texels[ix][channel] - palette[p]);
+			if (error < bestError) {
+				bestError = error;
+				indices[ix] = p;
+			}
+		}
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+// Encodes a single channel of the block into a BC4 block (also used for BC3 alpha and BC5)
+void EncodeBC4Block(const TexelBlock& block, int channel, CompressionQuality quality, uint8_t* output) {
+	int lo = 255, hi = 0;
+	for (int ix = 0; ix < 16; ix++) {
+		lo = std::min(lo, (int)block.Texels[ix][channel]);
+		hi = std::max(hi, (int)block.Texels[ix][channel]);
+	}
+
+	int bestR0 = hi, bestR1 = lo;
+	uint8_t indices[16] = { 0 };
+	int palette[8];
+	BuildBC4Palette(bestR0, bestR1, palette);
+	int bestError = SelectBC4Indices(block, channel, palette, indices);
+
+	// Higher quality levels try insetting the endpoints, which often reduces error for noisy blocks
+	int searchRadius = quality == CompressionQuality::High ? 4 : (quality == CompressionQuality::Normal ? 1 : 0);
+	for (int insetHi = 0; insetHi <= searchRadius && bestError > 0; insetHi++) {
+		for (int insetLo = 0; insetLo <= searchRadius; insetLo++) {
+			int r0 = hi - insetHi;
+			int r1 = lo + insetLo;
+			if (r0 <= r1 || (insetHi == 0 && insetLo == 0)) {
+				continue;
+			}
+			uint8_t candidate[16];
+			BuildBC4Palette(r0, r1, palette);
+			int error = SelectBC4Indices(block, channel, palette, candidate);
+			if (error < bestError) {
+				bestError = error;
+				bestR0 = r0;
+				bestR1 = r1;
+				memcpy(indices, candidate, 16);
+			}
+		}
+	}
+
+	// Solid blocks can't use the 8 value mode, but index 0 will still decode to r0
+	if (bestR0 == bestR1) {
+		memset(indices, 0, 16);
+	}
+
+	uint64_t packedIndices = 0;
+	for (int ix = 0; ix < 16; ix++) {
+		packedIndices |= (uint64_t)indices[ix] << (ix * 3);
+	}
+	output[0] = (uint8_t)bestR0;
+	output[1] = (uint8_t)bestR1;
+	for (int ix = 0; ix < 6; ix++) {
+		output[2 + ix] = (uint8_t)(packedIndices >> (ix * 8));
+	}
+}
+
+void DecodeBC4Block(const uint8_t* input, int channel, TexelBlock& block) {
+	int palette[8];
+	BuildBC4Palette(input[0], input[1], palette);
+	uint64_t packedIndices = 0;
+	for (int ix = 0; ix < 6; ix++) {
+		packedIndices |= (uint64_t)input[2 + ix] << (ix * 8);
+	}
+	for (int ix = 0; ix < 16; ix++) {
+		block.Texels[ix][channel] = palette[(packedIndices >> (ix * 3)) & 7];
+	}
+}
+
+#pragma endregion
+
+#pragma region BC7
+
+// Quantizes an 8 bit endpoint to 7 bits per channel plus a shared p-bit, picking the p-bit with the lowest error
+inline void QuantizeBC7Endpoint(const float endpoint[4], int quantized[4], int& pBit) {
+	float bestError = std::numeric_limits<float>::max();
+	for (int p = 0; p < 2; p++) {
+		float error = 0.0f;
+		int candidate[4];
+		for (int c = 0; c < 4; c++) {
+			candidate[c] = std::clamp((int)std::round((endpoint[c] - p) / 2.0f), 0, 127);
+			float decoded = (float)((candidate[c] << 1) | p);
+			error += (decoded - endpoint[c]) * (decoded - endpoint[c]);
+		}
+		if (error < bestError) {
+			bestError = error;
+			pBit = p;
+			memcpy(quantized, candidate, sizeof(int) * 4);
+		}
+	}
+}
+
+inline void BuildBC7Palette(const int e0[4], int p0, const int e1[4], int p1, int palette[16][4]) {
+	for (int c = 0; c < 4; c++) {
+		int a = (e0[c] << 1) | p0;
+		int b = (e1[c] << 1) | p1;
+		for (int ix = 0; ix < 16; ix++) {
+			palette[ix][c] = ((64 - BC7_WEIGHTS_4[ix]) * a + BC7_WEIGHTS_4[ix] * b + 32) >> 6;
+		}
+	}
+}
+
+inline int SelectBC7Indices(const TexelBlock& block, const int palette[16][4], uint8_t indices[16]) {
+	int totalError = 0;
+	for (int ix = 0; ix < 16; ix++) {
+		int bestError = std::numeric_limits<int>::max();
+		for (int p = 0; p < 16; p++) {
+			int error =
+				Square(block.Texels[ix][0] - palette[p][0]) + Square(block.Texels[ix][1] - palette[p][1]) +
+				Square(block.Texels[ix][2] - palette[p][2]) + Square(block.Texels[ix][3] - palette[p][3]);
+			if (error < bestError) {
+				bestError = error;
+				indices[ix] = p;
+			}
+		}
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+// Encodes a block using BC7 mode 6 (one subset, RGBA endpoints with unique p-bits, 4 bit indices)
+void EncodeBC7Block(const TexelBlock& block, CompressionQuality quality, uint8_t* output) {
+	float lo[4], hi[4];
+	FindPrincipalEndpoints(block, 4, quality, lo, hi);
+
+	int e0[4], e1[4], p0 = 0, p1 = 0;
+	QuantizeBC7Endpoint(lo, e0, p0);
+	QuantizeBC7Endpoint(hi, e1, p1);
+
+	int palette[16][4];
+	uint8_t indices[16];
+	BuildBC7Palette(e0, p0, e1, p1, palette);
+	int bestError = SelectBC7Indices(block, palette, indices);
+
+	int iterations = quality == CompressionQuality::High ? 3 : (quality == CompressionQuality::Normal ? 1 : 0);
+	for (int iteration = 0; iteration < iterations && bestError > 0; iteration++) {
+		float weights[16];
+		for (int ix = 0; ix < 16; ix++) {
+			weights[ix] = BC7_WEIGHTS_4[indices[ix]] / 64.0f;
+		}
+		float refinedLo[4], refinedHi[4];
+		if (!RefineEndpoints(block, 4, weights, refinedLo, refinedHi)) {
+			break;
+		}
+		int r0[4], r1[4], rp0 = 0, rp1 = 0;
+		QuantizeBC7Endpoint(refinedLo, r0, rp0);
+		QuantizeBC7Endpoint(refinedHi, r1, rp1);
+		int refinedPalette[16][4];
+		uint8_t refinedIndices[16];
+		BuildBC7Palette(r0, rp0, r1, rp1, refinedPalette);
+		int error = SelectBC7Indices(block, refinedPalette, refinedIndices);
+		if (error >= bestError) {
+			break;
+		}
+		bestError = error;
+		memcpy(e0, r0, sizeof(e0));
+		memcpy(e1, r1, sizeof(e1));
+		p0 = rp0;
+		p1 = rp1;
+		memcpy(indices, refinedIndices, 16);
+	}
+
+	// The anchor index (texel 0) has an implicit high bit of 0, so swap our endpoints if it's set
+	if (indices[0] & 0b1000) {
+		std::swap(e0, e1);
+		std::swap(p0, p1);
+		for (int ix = 0; ix < 16; ix++) {
+			indices[ix] = 15 - indices[ix];
+		}
+	}
+
+	memset(output, 0, 16);
+	BitWriter writer = { output };
+	writer.Write(1 << 6, 7); // Mode 6
+	for (int c = 0; c < 4; c++) {
+		writer.Write(e0[c], 7);
+		writer.Write(e1[c], 7);
+	}
+	writer.Write(p0, 1);
+	writer.Write(p1, 1);
+	writer.Write(indices[0], 3);
+	for (int ix = 1; ix < 16; ix++) {
+		writer.Write(indices[ix], 4);
+	}
+}
+
+void DecodeBC7Block(const uint8_t* input, TexelBlock& block) {
+	BitReader reader = { input };
+	if (reader.Read(7) != (1 << 6)) {
+		// We only support decoding mode 6, fill unsupported blocks with magenta so they stand out
+		for (int ix = 0; ix < 16; ix++) {
+			block.Texels[ix][0] = 255;
+			block.Texels[ix][1] = 0;
+			block.Texels[ix][2] = 255;
+			block.Texels[ix][3] = 255;
+		}
+		return;
+	}
+
+	int e0[4], e1[4];
+	for (int c = 0; c < 4; c++) {
+		e0[c] = reader.Read(7);
+		e1[c] = reader.Read(7);
+	}
+	int p0 = reader.Read(1);
+	int p1 = reader.Read(1);
+
+	int palette[16][4];
+	BuildBC7Palette(e0, p0, e1, p1, palette);
+	for (int ix = 0; ix < 16; ix++) {
+		int index = reader.Read(ix == 0 ? 3 : 4);
+		for (int c = 0; c < 4; c++) {
+			block.Texels[ix][c] = palette[index][c];
+		}
+	}
+}
+
+#pragma endregion
+
+std::vector<uint8_t> BlockCompressor::Compress(const uint8_t* rgba, uint32_t width, uint32_t height, TextureCompression format, CompressionQuality quality, int numThreads) {
+	const size_t blockSize = GetCompressedBlockSize(format);
+	LOG_ASSERT(blockSize > 0, "Cannot compress to format {}", ~format);
+
+	const uint32_t blocksX = (width + 3) / 4;
+	const uint32_t blocksY = (height + 3) / 4;
+	std::vector<uint8_t> result(blocksX * blocksY * blockSize);
+
+	// Encodes a range of block rows
+	auto encodeRows = [&](uint32_t startRow, uint32_t endRow) {
+		TexelBlock block;
+		for (uint32_t by = startRow; by < endRow; by++) {
+			for (uint32_t bx = 0; bx < blocksX; bx++) {
+				ExtractBlock(rgba, width, height, bx, by, block);
+				uint8_t* output = result.data() + ((size_t)by * blocksX + bx) * blockSize;
+				switch (format) {
+					case TextureCompression::BC1:
+						EncodeBC1Block(block, quality, output);
+						break;
+					case TextureCompression::BC3:
+						EncodeBC4Block(block, 3, quality, output);
+						EncodeBC1Block(block, quality, output + 8);
+						break;
+					case TextureCompression::BC4:
+						EncodeBC4Block(block, 0, quality, output);
+						break;
+					case TextureCompression::BC5:
+						EncodeBC4Block(block, 0, quality, output);
+						EncodeBC4Block(block, 1, quality, output + 8);
+						break;
+					case TextureCompression::BC7:
+						EncodeBC7Block(block, quality, output);
+						break;
+					default:
+						break;
+				}
+			}
+		}
+	};
+
+	// Split the block rows between our worker threads, small images aren't worth spinning up threads for
+	if (numThreads <= 0) {
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	numThreads = std::min<int>(numThreads, blocksY);
+	if (numThreads <= 1) {
+		encodeRows(0, blocksY);
+	} else {
+		std::vector<std::thread> workers;
+		uint32_t rowsPerThread = (blocksY + numThreads - 1) / numThreads;
+		for (int ix = 0; ix < numThreads; ix++) {
+			uint32_t start = ix * rowsPerThread;
+			uint32_t end = std::min(blocksY, start + rowsPerThread);
+			if (start < end) {
+				workers.emplace_back(encodeRows, start, end);
+			}
+		}
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	return result;
+}
+
+std::vector<uint8_t> BlockCompressor::Decompress(const uint8_t* blocks, uint32_t width, uint32_t height, TextureCompression format) {
+	const size_t blockSize = GetCompressedBlockSize(format);
+	LOG_ASSERT(blockSize > 0, "Cannot decompress format {}", ~format);
+
+	const uint32_t blocksX = (width + 3) / 4;
+	const uint32_t blocksY = (height + 3) / 4;
+	std::vector<uint8_t> result((size_t)width * height * 4);
+
+	TexelBlock block;
+	for (uint32_t by = 0; by < blocksY; by++) {
+		for (uint32_t bx = 0; bx < blocksX; bx++) {
+			const uint8_t* input = blocks + ((size_t)by * blocksX + bx) * blockSize;
+
+			// Channels that aren't stored by the format decode to 0, with an opaque alpha
+			for (int ix = 0; ix < 16; ix++) {
+				block.Texels[ix][0] = block.Texels[ix][1] = block.Texels[ix][2] = 0;
+				block.Texels[ix][3] = 255;
+			}
+
+			switch (format) {
+				case TextureCompression::BC1:
+					DecodeBC1Block(input, block);
+					break;
+				case TextureCompression::BC3:
+					DecodeBC1Block(input + 8, block);
+					DecodeBC4Block(input, 3, block);
+					break;
+				case TextureCompression::BC4:
+					DecodeBC4Block(input, 0, block);
+					break;
+				case TextureCompression::BC5:
+					DecodeBC4Block(input, 0, block);
+					DecodeBC4Block(input + 8, 1, block);
+					break;
+				case TextureCompression::BC7:
+					DecodeBC7Block(input, block);
+					break;
+				default:
+					break;
+			}
+
+			// Copy the texels that are inside the image back out
+			for (int y = 0; y < 4 && by * 4 + y < height; y++) {
+				for (int x = 0; x < 4 && bx * 4 + x < width; x++) {
+					memcpy(result.data() + ((size_t)(by * 4 + y) * width + bx * 4 + x) * 4, block.Texels[y * 4 + x], 4);
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+double BlockCompressor::ComputePSNR(const uint8_t* a, const uint8_t* b, uint32_t width, uint32_t height, int numChannels) {
+	double sumSquaredError = 0.0;
+	size_t texelCount = (size_t)width * height;
+	for (size_t ix = 0; ix < texelCount; ix++) {
+		for (int c = 0; c < numChannels; c++) {
+			double delta = (double)a[ix * 4 + c] - (double)b[ix * 4 + c];
+			sumSquaredError += delta * delta;
+		}
+	}
+	double meanSquaredError = sumSquaredError / (texelCount * numChannels);
+	if (meanSquaredError <= 0.0) {
+		return std::numeric_limits<double>::infinity();
+	}
+	return 10.0 * std::log10((255.0 * 255.0) / meanSquaredError);
+}
+
+size_t BlockCompressor::GetCompressedSize(uint32_t width, uint32_t height, TextureCompression format) {
+	return (size_t)((width + 3) / 4) * ((height + 3) / 4) * GetCompressedBlockSize(format);
+}
+
+int BlockCompressor::GetChannelCount(TextureCompression format) {
+	switch (format) {
+		case TextureCompression::BC1: return 3;
+		case TextureCompression::BC4: return 1;
+		case TextureCompression::BC5: return 2;
+		case TextureCompression::BC3:
+		case TextureCompression::BC7: return 4;
+		default:
+			return 4;
+	}
+}
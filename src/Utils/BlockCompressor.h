@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "Graphics/TextureEnums.h"
+
+/// <summary>
+/// A CPU encoder for BCn block compressed textures, used by the texture cooker to generate
+/// compressed mip chains offline. Images are split into 4x4 blocks which are encoded in parallel
+/// across worker threads. BC7 output uses mode 6 (a single RGBA subset with 4 bit indices), which
+/// gives good quality for most content while keeping the encoder simple
+/// </summary>
+class BlockCompressor {
+public:
+	BlockCompressor() = delete;
+
+	/// <summary>
+	/// Compresses an RGBA8 image into the given block format. Images that are not a multiple
+	/// of 4 in size are padded by clamping to the edge texels
+	/// </summary>
+	/// <param name="rgba">The image data, 4 bytes per texel, tightly packed</param>
+	/// <param name="width">The width of the image in texels</param>
+	/// <param name="height">The height of the image in texels</param>
+	/// <param name="format">The block format to encode to</param>
+	/// <param name="quality">The quality level to encode with</param>
+	/// <param name="numThreads">The number of threads to use, or 0 to use all hardware threads</param>
+	/// <returns>The encoded blocks, in row major order</returns>
+	static std::vector<uint8_t> Compress(const uint8_t* rgba, uint32_t width, uint32_t height, TextureCompression format, CompressionQuality quality = CompressionQuality::Normal, int numThreads = 0);
+
+	/// <summary>
+	/// Decodes block compressed data back into an RGBA8 image, mainly so that we can measure the
+	/// quality of the encoder. Only BC7 mode 6 blocks are supported, since that is all we emit
+	/// </summary>
+	/// <param name="blocks">The encoded block data</param>
+	/// <param name="width">The width of the image in texels</param>
+	/// <param name="height">The height of the image in texels</param>
+	/// <param name="format">The block format the data is encoded with</param>
+	/// <returns>The decoded image, 4 bytes per texel</returns>
+	static std::vector<uint8_t> Decompress(const uint8_t* blocks, uint32_t width, uint32_t height, TextureCompression format);
+
+	/// <summary>
+	/// Calculates the peak signal to noise ratio between two RGBA8 images, in decibels
+	/// </summary>
+	/// <param name="a">The first image, 4 bytes per texel</param>
+	/// <param name="b">The second image, 4 bytes per texel</param>
+	/// <param name="width">The width of both images in texels</param>
+	/// <param name="height">The height of both images in texels</param>
+	/// <param name="numChannels">The number of leading channels to compare (ex: 1 for BC4, 3 for BC1)</param>
+	/// <returns>The PSNR in dB, or infinity if the images are identical</returns>
+	static double ComputePSNR(const uint8_t* a, const uint8_t* b, uint32_t width, uint32_t height, int numChannels = 4);
+
+	/// <summary>
+	/// Gets the number of bytes needed to store an image of the given size in the given format
+	/// </summary>
+	static size_t GetCompressedSize(uint32_t width, uint32_t height, TextureCompression format);
+	/// <summary>
+	/// Gets the number of channels that are stored by the given format
+	/// </summary>
+	static int GetChannelCount(TextureCompression format);
+};
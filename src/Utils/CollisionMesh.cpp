@@ -0,0 +1,54 @@
+#include "Utils/CollisionMesh.h"
+#include <algorithm>
+
+#include "Logging.h"
+
+size_t CollisionMesh::GetTriangleCount() const {
+	return Indices.size() > 0 ? Indices.size() / 3 : Positions.size() / 3;
+}
+
+size_t CollisionMesh::GetMemoryUsage() const {
+	return Positions.size() * sizeof(glm::vec3) + Indices.size() * sizeof(uint32_t);
+}
+
+CollisionMesh::Sptr CollisionMesh::Create(const void* vertices, size_t numVertices, const VertexArrayObject::VertexDeclaration& vDecl, const void* indices, size_t numIndices, IndexType indexType) {
+	// Find the position attribute in the vertex declaration
+	auto it = std::find_if(vDecl.begin(), vDecl.end(), [](const BufferAttribute& attrib) {
+		return attrib.Usage == AttribUsage::Position;
+	});
+	if (it == vDecl.end() || it->Type != AttributeType::Float || it->Size < 3) {
+		LOG_WARN("Vertex declaration does not have a float3 position element, cannot create collision mesh");
+		return nullptr;
+	}
+	const BufferAttribute& posAttrib = *it;
+
+	CollisionMesh::Sptr result = std::make_shared<CollisionMesh>();
+
+	// Pull the positions out of the interleaved vertex data
+	const uint8_t* vertexStore = reinterpret_cast<const uint8_t*>(vertices);
+	result->Positions.resize(numVertices);
+	for (size_t ix = 0; ix < numVertices; ix++) {
+		result->Positions[ix] = *reinterpret_cast<const glm::vec3*>(vertexStore + (ix * posAttrib.Stride) + posAttrib.Offset);
+	}
+
+	// Widen the indices to 32 bit so consumers only need to handle one type
+	if (indices != nullptr && numIndices > 0) {
+		result->Indices.resize(numIndices);
+		for (size_t ix = 0; ix < numIndices; ix++) {
+			switch (indexType) {
+				case IndexType::UByte:
+					result->Indices[ix] = reinterpret_cast<const uint8_t*>(indices)[ix];
+					break;
+				case IndexType::UShort:
+					result->Indices[ix] = reinterpret_cast<const uint16_t*>(indices)[ix];
+					break;
+				case IndexType::UInt:
+				default:
+					result->Indices[ix] = reinterpret_cast<const uint32_t*>(indices)[ix];
+					break;
+			}
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <GLM/glm.hpp>
+
+#include "Graphics/VertexArrayObject.h"
+#include "Utils/MeshBuilder.h"
+
+/// <summary>
+/// A compact CPU side copy of a mesh's positions and triangle indices, captured when the mesh is
+/// loaded so that collision shapes can be built without reading buffers back from the GPU (and
+/// without needing a GL context at all)
+/// </summary>
+class CollisionMesh {
+public:
+	typedef std::shared_ptr<CollisionMesh> Sptr;
+
+	CollisionMesh() = default;
+	~CollisionMesh() = default;
+
+	/// <summary>
+	/// The vertex positions of the mesh
+	/// </summary>
+	std::vector<glm::vec3> Positions;
+	/// <summary>
+	/// Triangle list indices into Positions, empty if the positions are a non-indexed triangle list
+	/// </summary>
+	std::vector<uint32_t>  Indices;
+
+	/// <summary>
+	/// Gets the number of triangles in this mesh
+	/// </summary>
+	size_t GetTriangleCount() const;
+	/// <summary>
+	/// Gets the number of bytes of CPU memory used by this mesh
+	/// </summary>
+	size_t GetMemoryUsage() const;
+
+	/// <summary>
+	/// Extracts the positions and indices from interleaved vertex data
+	/// </summary>
+	/// <param name="vertices">The raw interleaved vertex data</param>
+	/// <param name="numVertices">The number of vertices in the vertex data</param>
+	/// <param name="vDecl">The vertex declaration, must contain a 3 component float position attribute</param>
+	/// <param name="indices">The raw index data, or nullptr if the mesh is not indexed</param>
+	/// <param name="numIndices">The number of indices in the index data</param>
+	/// <param name="indexType">The type of the elements in the index data</param>
+	/// <returns>The collision mesh, or nullptr if the vertex declaration has no position attribute</returns>
+	static CollisionMesh::Sptr Create(const void* vertices, size_t numVertices, const VertexArrayObject::VertexDeclaration& vDecl,
+									  const void* indices = nullptr, size_t numIndices = 0, IndexType indexType = IndexType::UInt);
+
+	/// <summary>
+	/// Extracts the positions and indices from a mesh builder
+	/// </summary>
+	/// <typeparam name="VertType">The type of vertex the mesh builder is using</typeparam>
+	/// <param name="mesh">The mesh builder to copy from</param>
+	template <typename VertType>
+	static CollisionMesh::Sptr Create(const MeshBuilder<VertType>& mesh) {
+		return Create(mesh.GetVertexDataPtr(), mesh.GetVertexCount(), VertType::V_DECL, mesh.GetIndexDataPtr(), mesh.GetIndexCount(), IndexType::UInt);
+	}
+};
@@ -0,0 +1,205 @@
+#include "Utils/FrameTelemetry.h"
+#include <algorithm>
+#include <cfloat>
+
+#include "Utils/FileHelpers.h"
+#include "Utils/ImGuiHelper.h"
+#include "Utils/Profiler.h"
+#include "Logging.h"
+
+SampleRing<FrameTelemetry::Sample> FrameTelemetry::_samples(MAX_SAMPLES);
+std::vector<FrameTelemetry::Region> FrameTelemetry::_regions;
+FrameTelemetry::Region FrameTelemetry::_session = { "Session", 0.0 };
+
+std::chrono::high_resolution_clock::time_point FrameTelemetry::_sessionStart = std::chrono::high_resolution_clock::now();
+std::chrono::high_resolution_clock::time_point FrameTelemetry::_lastFrameEnd;
+bool FrameTelemetry::_hasLastFrame = false;
+
+FrameTelemetry::Histogram::Histogram() :
+	Bins(),
+	Count(0),
+	Total(0.0),
+	Max(0.0f)
+{ }
+
+void FrameTelemetry::Histogram::Add(float ms) {
+	int bin = std::min((int)(ms / BIN_WIDTH_MS), NUM_BINS);
+	Bins[std::max(bin, 0)]++;
+	Count++;
+	Total += ms;
+	Max = std::max(Max, ms);
+}
+
+float FrameTelemetry::Histogram::Percentile(float percentile) const {
+	if (Count == 0) {
+		return 0.0f;
+	}
+	uint64_t target = (uint64_t)(percentile * (Count - 1)) + 1;
+	uint64_t seen = 0;
+	for (int ix = 0; ix < NUM_BINS; ix++) {
+		seen += Bins[ix];
+		if (seen >= target) {
+			return std::min((ix + 1) * BIN_WIDTH_MS, Max);
+		}
+	}
+	// Anything that lands in the overflow bin could be as slow as the slowest frame
+	return Max;
+}
+
+uint64_t FrameTelemetry::Histogram::CountAbove(float ms) const {
+	uint64_t result = Bins[NUM_BINS];
+	for (int ix = std::min((int)(ms / BIN_WIDTH_MS) + 1, NUM_BINS); ix < NUM_BINS; ix++) {
+		result += Bins[ix];
+	}
+	return result;
+}
+
+nlohmann::json FrameTelemetry::Histogram::Summarize() const {
+	nlohmann::json result;
+	result["count"]  = Count;
+	result["avg_ms"] = Count > 0 ? Total / Count : 0.0;
+	result["p50_ms"] = Percentile(0.5f);
+	result["p95_ms"] = Percentile(0.95f);
+	result["p99_ms"] = Percentile(0.99f);
+	result["max_ms"] = Max;
+	// A simple stutter measure that doesn't depend on the frame rate we're running at
+	result["over_2x_p50"] = CountAbove(Percentile(0.5f) * 2.0f);
+	return result;
+}
+
+void FrameTelemetry::EndFrame(float simulateMs, float renderMs) {
+	auto now = std::chrono::high_resolution_clock::now();
+	if (!_hasLastFrame) {
+		_lastFrameEnd = now;
+		_hasLastFrame = true;
+		return;
+	}
+	float frameMs = std::chrono::duration<float, std::milli>(now - _lastFrameEnd).count();
+	_lastFrameEnd = now;
+
+	if (_regions.empty()) {
+		Mark("Start");
+	}
+
+	Sample sample;
+	sample.FrameMs    = frameMs;
+	sample.SimulateMs = simulateMs;
+	sample.RenderMs   = renderMs;
+	sample.Region     = (uint32_t)(_regions.size() - 1);
+	_samples.Push(sample);
+
+	for (Region* region : { &_regions.back(), &_session }) {
+		region->Frame.Add(frameMs);
+		region->Simulate.Add(simulateMs);
+		region->Render.Add(renderMs);
+	}
+}
+
+void FrameTelemetry::Mark(const char* label) {
+	Region& region = _regions.emplace_back();
+	region.Label = label;
+	region.StartTime = _GetSessionTime();
+
+	Profiler::Marker(Profiler::RegisterZone(label));
+}
+
+nlohmann::json FrameTelemetry::GetSummary() {
+	nlohmann::json result;
+	result["build"]      = __DATE__ " " __TIME__;
+	result["duration_s"] = _GetSessionTime();
+	result["frame"]      = _session.Frame.Summarize();
+	result["simulate"]   = _session.Simulate.Summarize();
+	result["render"]     = _session.Render.Summarize();
+
+	// Trailing empty bins are left off to keep the file small
+	int lastBin = NUM_BINS - 1;
+	while (lastBin > 0 && _session.Frame.Bins[lastBin] == 0) {
+		lastBin--;
+	}
+	result["histogram"]["bin_width_ms"] = BIN_WIDTH_MS;
+	result["histogram"]["frame_bins"]   = std::vector<uint32_t>(_session.Frame.Bins, _session.Frame.Bins + lastBin + 1);
+	result["histogram"]["overflow"]     = _session.Frame.Bins[NUM_BINS];
+
+	result["regions"] = nlohmann::json::array();
+	for (const Region& region : _regions) {
+		nlohmann::json blob;
+		blob["label"]    = region.Label;
+		blob["start_s"]  = region.StartTime;
+		blob["frame"]    = region.Frame.Summarize();
+		blob["simulate"] = region.Simulate.Summarize();
+		blob["render"]   = region.Render.Summarize();
+		result["regions"].push_back(blob);
+	}
+	return result;
+}
+
+void FrameTelemetry::SaveSummary(const std::string& path) {
+	FileHelpers::WriteContentsToFile(path, GetSummary().dump(1, '\t'));
+	LOG_INFO("Wrote frame telemetry for {} frames to \"{}\"", _session.Frame.Count, path);
+}
+
+void FrameTelemetry::Reset() {
+	_samples.Clear();
+	_session = { "Session", 0.0 };
+	_sessionStart = std::chrono::high_resolution_clock::now();
+
+	// Keep the region we're in, so the frames after this are still tagged with it
+	if (!_regions.empty()) {
+		const char* label = _regions.back().Label;
+		_regions.clear();
+		Mark(label);
+	}
+}
+
+void FrameTelemetry::RenderImGui() {
+	std::vector<float> frame, simulate, render;
+	frame.reserve(_samples.GetCount());
+	simulate.reserve(_samples.GetCount());
+	render.reserve(_samples.GetCount());
+	_samples.ForEach([&](const Sample& sample) {
+		frame.push_back(sample.FrameMs);
+		simulate.push_back(sample.SimulateMs);
+		render.push_back(sample.RenderMs);
+	});
+
+	if (!frame.empty()) {
+		char overlay[32];
+		sprintf_s(overlay, "%.2f ms", frame.back());
+		ImGui::PlotLines("Frame", frame.data(), (int)frame.size(), 0, overlay, 0.0f, 50.0f, ImVec2(0.0f, 60.0f));
+	}
+
+	std::sort(frame.begin(), frame.end());
+	std::sort(simulate.begin(), simulate.end());
+	std::sort(render.begin(), render.end());
+
+	ImGui::Text("Region: %s, %d recent frames, %llu this session", _regions.empty() ? "-" : _regions.back().Label, (int)_samples.GetCount(), (unsigned long long)_session.Frame.Count);
+	ImGui::Text("%-10s %7s %7s %7s %7s", "(ms)", "p50", "p95", "p99", "max");
+	auto row = [](const char* label, const std::vector<float>& values) {
+		ImGui::Text("%-10s %7.2f %7.2f %7.2f %7.2f", label, Percentile(values, 0.5f), Percentile(values, 0.95f), Percentile(values, 0.99f), Percentile(values, 1.0f));
+	};
+	row("Frame", frame);
+	row("Simulate", simulate);
+	row("Render", render);
+
+	// Only show the histogram up to the slowest frame we've seen
+	int numBins = std::clamp((int)(_session.Frame.Max / BIN_WIDTH_MS) + 2, 1, NUM_BINS + 1);
+	std::vector<float> bins(numBins);
+	for (int ix = 0; ix < numBins; ix++) {
+		bins[ix] = (float)_session.Frame.Bins[ix];
+	}
+	char label[64];
+	sprintf_s(label, "0 - %.1f ms", numBins * BIN_WIDTH_MS);
+	ImGui::PlotHistogram("Session", bins.data(), numBins, 0, label, 0.0f, FLT_MAX, ImVec2(0.0f, 80.0f));
+
+	if (ImGui::Button("Save Summary")) {
+		SaveSummary("frame_telemetry.json");
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Reset")) {
+		Reset();
+	}
+}
+
+double FrameTelemetry::_GetSessionTime() {
+	return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - _sessionStart).count();
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include "json.hpp"
+#include "Utils/SampleRing.h"
+
+/// <summary>
+/// Records how long each frame took, along with the time spent simulating and rendering it, so that
+/// stutter can be measured and compared between builds. The most recent frames are kept in a fixed
+/// size ring for the live percentiles and graphs, and every frame of the session is also counted into
+/// fixed width histograms, so the session summary covers the whole run without keeping every frame
+///
+/// Markers split the session into regions (ex "Scene Load" or "Enter Play Mode"), which get their own
+/// stats in the summary. Markers are also sent to the Profiler, so they show up in traces
+/// </summary>
+class FrameTelemetry {
+public:
+	// The number of recent frames kept for the live stats
+	static constexpr size_t MAX_SAMPLES = 4096;
+	// The number of histogram bins, anything past the last bin goes in an overflow bin
+	static constexpr int    NUM_BINS = 200;
+	// The width of each histogram bin, in milliseconds
+	static constexpr float  BIN_WIDTH_MS = 0.5f;
+
+	/// <summary>
+	/// The timings of one frame, all in milliseconds
+	/// </summary>
+	struct Sample {
+		float    FrameMs;
+		float    SimulateMs;
+		float    RenderMs;
+		// The index of the region the frame was in
+		uint32_t Region;
+	};
+
+	FrameTelemetry() = delete;
+
+	/// <summary>
+	/// Records the frame that just finished, call once per frame after presenting. The frame time is
+	/// measured between calls, so the first call only starts the clock
+	/// </summary>
+	/// <param name="simulateMs">The time spent simulating the frame, in milliseconds</param>
+	/// <param name="renderMs">The time spent rendering and presenting the frame, in milliseconds</param>
+	static void EndFrame(float simulateMs, float renderMs);
+
+	/// <summary>
+	/// Starts a new region, the frames after this are tagged with the label until the next marker
+	/// </summary>
+	/// <param name="label">The region's label, this must outlive the telemetry (ex a string literal)</param>
+	static void Mark(const char* label);
+
+	/// <summary>
+	/// Gets the stats and histograms for the whole session, and for each region
+	/// </summary>
+	static nlohmann::json GetSummary();
+	/// <summary>
+	/// Writes the session summary to a JSON file
+	/// </summary>
+	/// <param name="path">The file to write</param>
+	static void SaveSummary(const std::string& path);
+
+	/// <summary>
+	/// Drops the recent frames, the histograms and all regions but the current one
+	/// </summary>
+	static void Reset();
+
+	/// <summary>
+	/// Renders the percentiles of the recent frames, a graph of them, and the session's frame time histogram
+	/// </summary>
+	static void RenderImGui();
+
+protected:
+	struct Histogram {
+		uint32_t Bins[NUM_BINS + 1];
+		uint64_t Count;
+		double   Total;
+		float    Max;
+
+		Histogram();
+		void Add(float ms);
+		// Gets an upper bound on the value at the given percentile (0-1), accurate to a bin
+		float Percentile(float percentile) const;
+		uint64_t CountAbove(float ms) const;
+		nlohmann::json Summarize() const;
+	};
+
+	struct Region {
+		const char* Label;
+		// The time since the session started that the region began, in seconds
+		double      StartTime;
+		Histogram   Frame;
+		Histogram   Simulate;
+		Histogram   Render;
+	};
+
+	static SampleRing<Sample>  _samples;
+	static std::vector<Region> _regions;
+	static Region              _session;
+
+	static std::chrono::high_resolution_clock::time_point _sessionStart;
+	static std::chrono::high_resolution_clock::time_point _lastFrameEnd;
+	static bool _hasLastFrame;
+
+	static double _GetSessionTime();
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/// <summary>
+/// Provides 64 bit FNV-1a hashing, used for the cache keys of meshes, materials and collision shapes.
+/// Start from FNV_OFFSET_BASIS and feed everything that makes up the key into HashBytes
+/// </summary>
+class HashUtils {
+public:
+	// FNV-1a constants for 64 bit hashes
+	static constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+	static constexpr uint64_t FNV_PRIME        = 0x00000100000001b3ull;
+
+	HashUtils() = delete;
+
+	/// <summary>
+	/// Mixes a block of bytes into a running hash
+	/// </summary>
+	/// <param name="hash">The hash to update, in place</param>
+	/// <param name="data">The bytes to hash</param>
+	/// <param name="size">The number of bytes in data</param>
+	static inline void HashBytes(uint64_t& hash, const void* data, size_t size) {
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+		for (size_t ix = 0; ix < size; ix++) {
+			hash ^= bytes[ix];
+			hash *= FNV_PRIME;
+		}
+	}
+};
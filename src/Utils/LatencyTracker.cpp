@@ -0,0 +1,193 @@
+#include "Utils/LatencyTracker.h"
+#include <algorithm>
+#include <fstream>
+#include <GLFW/glfw3.h>
+
+#include "Gameplay/InputEngine.h"
+#include "Utils/ImGuiHelper.h"
+#include "Logging.h"
+
+bool LatencyTracker::_enabled = false;
+bool LatencyTracker::_trackGpu = false;
+uint64_t LatencyTracker::_frameId = 0;
+bool LatencyTracker::_hasInput = false;
+bool LatencyTracker::_isCurrentPipelined = false;
+LatencyTracker::Sample LatencyTracker::_current;
+bool LatencyTracker::_hasDelayed = false;
+LatencyTracker::Sample LatencyTracker::_delayed;
+std::deque<LatencyTracker::PendingFrame> LatencyTracker::_pendingFrames;
+SampleRing<LatencyTracker::Sample> LatencyTracker::_samples(MAX_SAMPLES);
+
+void LatencyTracker::SetEnabled(bool enabled) {
+	_enabled = enabled;
+	if (!_enabled) {
+		_hasInput = false;
+		_hasDelayed = false;
+		_PollFences(true);
+	}
+}
+
+void LatencyTracker::SetGpuTracking(bool enabled) {
+	_trackGpu = enabled;
+	if (!_trackGpu) {
+		_PollFences(true);
+	}
+}
+
+void LatencyTracker::MarkInput(bool pipelined) {
+	if (!_enabled) {
+		return;
+	}
+
+	// Check for finished frames mid-frame as well, so that GPU times are a bit tighter
+	_PollFences(false);
+
+	// Replayed input has no real events, so it gets skipped here as well
+	double eventTime = InputEngine::GetOldestEventTime();
+	double sampleTime = InputEngine::GetSampleTime();
+	_hasInput = InputEngine::HasInputEvents();
+	_isCurrentPipelined = pipelined;
+	if (_hasInput) {
+		_current.Frame      = _frameId;
+		_current.EventTime  = eventTime;
+		_current.SampleTime = sampleTime;
+		_current.SwapTime   = 0.0;
+		_current.GpuTime    = 0.0;
+	}
+}
+
+void LatencyTracker::MarkSwap() {
+	_frameId++;
+	if (!_enabled) {
+		return;
+	}
+
+	_PollFences(false);
+	double swapTime = glfwGetTime();
+
+	// Input from the last pipelined frame was simulated while that frame was drawn, so this is the first swap that shows it
+	if (_hasDelayed) {
+		_hasDelayed = false;
+		_Swapped(_delayed, swapTime);
+	}
+
+	if (!_hasInput) {
+		return;
+	}
+	_hasInput = false;
+	if (_isCurrentPipelined) {
+		_delayed = _current;
+		_hasDelayed = true;
+	} else {
+		_Swapped(_current, swapTime);
+	}
+}
+
+void LatencyTracker::Clear() {
+	_PollFences(true);
+	_samples.Clear();
+}
+
+bool LatencyTracker::SaveCsv(const std::string& path) {
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		LOG_ERROR("Failed to open \"{}\" for writing input latency", path);
+		return false;
+	}
+
+	file << "frame,event_time,sample_time,swap_time,gpu_time,input_to_sample_ms,input_to_swap_ms,input_to_gpu_ms\n";
+	_samples.ForEach([&](const Sample& sample) {
+		file << sample.Frame << ","
+			<< sample.EventTime << "," << sample.SampleTime << "," << sample.SwapTime << "," << sample.GpuTime << ","
+			<< (sample.SampleTime - sample.EventTime) * 1000.0 << ","
+			<< (sample.SwapTime - sample.EventTime) * 1000.0 << ",";
+		if (sample.GpuTime > 0.0) {
+			file << (sample.GpuTime - sample.EventTime) * 1000.0;
+		}
+		file << "\n";
+	});
+
+	LOG_INFO("Wrote {} input latency samples to \"{}\"", _samples.GetCount(), path);
+	return true;
+}
+
+void LatencyTracker::RenderImGui() {
+	bool enabled = _enabled;
+	if (ImGui::Checkbox("Track Latency", &enabled)) {
+		SetEnabled(enabled);
+	}
+	ImGui::SameLine();
+	bool trackGpu = _trackGpu;
+	if (ImGui::Checkbox("Until GPU Done", &trackGpu)) {
+		SetGpuTracking(trackGpu);
+	}
+
+	std::vector<double> toSample, toSwap, toGpu;
+	toSample.reserve(_samples.GetCount());
+	toSwap.reserve(_samples.GetCount());
+	_samples.ForEach([&](const Sample& sample) {
+		toSample.push_back(sample.SampleTime - sample.EventTime);
+		toSwap.push_back(sample.SwapTime - sample.EventTime);
+		if (sample.GpuTime > 0.0) {
+			toGpu.push_back(sample.GpuTime - sample.EventTime);
+		}
+	});
+	std::sort(toSample.begin(), toSample.end());
+	std::sort(toSwap.begin(), toSwap.end());
+	std::sort(toGpu.begin(), toGpu.end());
+
+	ImGui::Text("Samples: %d", (int)_samples.GetCount());
+	ImGui::Text("%-16s %7s %7s %7s %7s", "(ms)", "p50", "p95", "p99", "max");
+	// Latencies are stored in seconds, but shown in milliseconds
+	auto row = [](const char* label, const std::vector<double>& values) {
+		ImGui::Text("%-16s %7.2f %7.2f %7.2f %7.2f", label, Percentile(values, 0.5) * 1000.0, Percentile(values, 0.95) * 1000.0,
+			Percentile(values, 0.99) * 1000.0, Percentile(values, 1.0) * 1000.0);
+	};
+	row("Input -> Sample", toSample);
+	row("Input -> Swap", toSwap);
+	if (!toGpu.empty()) {
+		row("Input -> GPU", toGpu);
+	}
+
+	if (ImGui::Button("Clear")) {
+		Clear();
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Export CSV")) {
+		SaveCsv("input_latency.csv");
+	}
+}
+
+void LatencyTracker::_Swapped(Sample sample, double swapTime) {
+	sample.SwapTime = swapTime;
+	if (_trackGpu) {
+		// The fence goes in after the swap, so it is signaled once all of the frame's commands are done
+		PendingFrame pending;
+		pending.Data = sample;
+		pending.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		_pendingFrames.push_back(pending);
+	} else {
+		_Complete(sample);
+	}
+}
+
+void LatencyTracker::_Complete(const Sample& sample) {
+	_samples.Push(sample);
+}
+
+void LatencyTracker::_PollFences(bool flush) {
+	// Frames finish in order, so we can stop at the first one that isn't done
+	while (!_pendingFrames.empty()) {
+		PendingFrame& pending = _pendingFrames.front();
+		if (!flush) {
+			GLenum result = glClientWaitSync(pending.Fence, 0, 0);
+			if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+				break;
+			}
+			pending.Data.GpuTime = glfwGetTime();
+			_Complete(pending.Data);
+		}
+		glDeleteSync(pending.Fence);
+		_pendingFrames.pop_front();
+	}
+}
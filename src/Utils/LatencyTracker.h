@@ -0,0 +1,108 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <string>
+#include <cstdint>
+#include <glad/glad.h>
+#include "Utils/SampleRing.h"
+
+/// <summary>
+/// Measures how long it takes from an input event reaching InputEngine until the frame that reflects it
+/// is presented. When a frame applies input, the time of its earliest input event is tagged with the
+/// frame ID. The frame is completed when its buffers are swapped, and optionally when the GPU has
+/// finished it, which is detected with a fence placed right after the swap
+///
+/// MarkInput should be called right after InputEngine::BeginFrame, and MarkSwap right after the buffers
+/// are swapped (see FramePacer::Present). When the simulation is pipelined with rendering, the input sampled
+/// in a frame is first drawn by the next one, so those samples are completed on the following swap
+/// </summary>
+class LatencyTracker {
+public:
+	/// <summary>
+	/// The timeline of one frame that applied input, all times are GLFW times in seconds
+	/// </summary>
+	struct Sample {
+		uint64_t Frame;
+		// The earliest input event that was applied in the frame
+		double   EventTime;
+		// When InputEngine sampled input for the frame
+		double   SampleTime;
+		// When glfwSwapBuffers returned for the frame
+		double   SwapTime;
+		// When the frame's fence was first seen as signaled, or 0 if GPU tracking was off. Fences are
+		// only polled once or twice a frame, so this is an upper bound
+		double   GpuTime;
+	};
+
+	LatencyTracker() = delete;
+
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled() { return _enabled; }
+	/// <summary>
+	/// Sets whether frames are also tracked until the GPU has finished them
+	/// </summary>
+	static void SetGpuTracking(bool enabled);
+	static bool IsGpuTracking() { return _trackGpu; }
+
+	/// <summary>
+	/// Gets the ID of the frame that is currently being built, this is incremented by MarkSwap
+	/// </summary>
+	static uint64_t GetFrameId() { return _frameId; }
+
+	/// <summary>
+	/// Records the input events applied this frame, call after InputEngine::BeginFrame
+	/// </summary>
+	/// <param name="pipelined">True if the input is simulated while this frame is drawn, so it won't be presented until the next swap</param>
+	static void MarkInput(bool pipelined = false);
+	/// <summary>
+	/// Completes the current frame and moves to the next frame ID, call right after glfwSwapBuffers
+	/// </summary>
+	static void MarkSwap();
+
+	/// <summary>
+	/// Drops all recorded samples
+	/// </summary>
+	static void Clear();
+	/// <summary>
+	/// Writes the recorded samples to a CSV file, oldest first
+	/// </summary>
+	/// <param name="path">The file to write</param>
+	/// <returns>True if the file was written</returns>
+	static bool SaveCsv(const std::string& path);
+
+	/// <summary>
+	/// Renders the tracking settings, and latency percentiles over the recorded samples
+	/// </summary>
+	static void RenderImGui();
+
+protected:
+	// The number of samples that are kept for the stats and CSV export
+	static constexpr size_t MAX_SAMPLES = 2048;
+
+	struct PendingFrame {
+		Sample Data;
+		GLsync Fence;
+	};
+
+	static bool     _enabled;
+	static bool     _trackGpu;
+	static uint64_t _frameId;
+
+	// The frame currently being built, if it applied any input
+	static bool     _hasInput;
+	static bool     _isCurrentPipelined;
+	static Sample   _current;
+	// Input from a pipelined frame that was swapped, but that won't be presented until the next swap
+	static bool     _hasDelayed;
+	static Sample   _delayed;
+
+	// Frames that have been swapped but that the GPU might not have finished yet
+	static std::deque<PendingFrame> _pendingFrames;
+	// Ring of completed samples
+	static SampleRing<Sample> _samples;
+
+	// Stamps the sample with the swap time, and completes it now or once the GPU is done
+	static void _Swapped(Sample sample, double swapTime);
+	static void _Complete(const Sample& sample);
+	static void _PollFences(bool flush);
+};
@@ -0,0 +1,104 @@
+#include "Utils/MappedFile.h"
+#include "Logging.h"
+
+#ifdef WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() :
+	_data(nullptr),
+	_size(0),
+	#ifdef WINDOWS
+	_fileHandle(INVALID_HANDLE_VALUE),
+	_mappingHandle(nullptr)
+	#else
+	_fileHandle(-1)
+	#endif
+{ }
+
+MappedFile::~MappedFile() {
+	_Close();
+}
+
+MappedFile::Sptr MappedFile::Open(const std::string& filename) {
+	MappedFile::Sptr result = std::make_shared<MappedFile>();
+
+	#ifdef WINDOWS
+	result->_fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (result->_fileHandle == INVALID_HANDLE_VALUE) {
+		LOG_WARN("Failed to open file \"{}\" for mapping", filename);
+		return nullptr;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(result->_fileHandle, &size) || size.QuadPart == 0) {
+		LOG_WARN("File \"{}\" is empty or could not be queried", filename);
+		return nullptr;
+	}
+	result->_size = static_cast<size_t>(size.QuadPart);
+
+	result->_mappingHandle = CreateFileMappingA(result->_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (result->_mappingHandle == nullptr) {
+		LOG_WARN("Failed to create file mapping for \"{}\"", filename);
+		return nullptr;
+	}
+
+	result->_data = reinterpret_cast<const uint8_t*>(MapViewOfFile(result->_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	#else
+	result->_fileHandle = open(filename.c_str(), O_RDONLY);
+	if (result->_fileHandle < 0) {
+		LOG_WARN("Failed to open file \"{}\" for mapping", filename);
+		return nullptr;
+	}
+
+	struct stat info;
+	if (fstat(result->_fileHandle, &info) != 0 || info.st_size == 0) {
+		LOG_WARN("File \"{}\" is empty or could not be queried", filename);
+		return nullptr;
+	}
+	result->_size = static_cast<size_t>(info.st_size);
+
+	void* mapped = mmap(nullptr, result->_size, PROT_READ, MAP_PRIVATE, result->_fileHandle, 0);
+	result->_data = mapped == MAP_FAILED ? nullptr : reinterpret_cast<const uint8_t*>(mapped);
+	#endif
+
+	if (result->_data == nullptr) {
+		LOG_WARN("Failed to map view of \"{}\"", filename);
+		return nullptr;
+	}
+
+	return result;
+}
+
+void MappedFile::_Close() {
+	#ifdef WINDOWS
+	if (_data != nullptr) {
+		UnmapViewOfFile(_data);
+	}
+	if (_mappingHandle != nullptr) {
+		CloseHandle(_mappingHandle);
+	}
+	if (_fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(_fileHandle);
+	}
+	_mappingHandle = nullptr;
+	_fileHandle = INVALID_HANDLE_VALUE;
+	#else
+	if (_data != nullptr) {
+		munmap(const_cast<uint8_t*>(_data), _size);
+	}
+	if (_fileHandle >= 0) {
+		close(_fileHandle);
+	}
+	_fileHandle = -1;
+	#endif
+	_data = nullptr;
+	_size = 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <cstdint>
+
+/// <summary>
+/// A read-only view of a file that has been mapped into memory, allowing large binary
+/// assets to be read without copying the entire file into a separate buffer first
+/// </summary>
+class MappedFile {
+public:
+	typedef std::shared_ptr<MappedFile> Sptr;
+
+	// Remove the copy and and assignment operators
+	MappedFile(const MappedFile& other) = delete;
+	MappedFile(MappedFile&& other) = delete;
+	MappedFile& operator=(const MappedFile& other) = delete;
+	MappedFile& operator=(MappedFile&& other) = delete;
+
+	MappedFile();
+	~MappedFile();
+
+	/// <summary>
+	/// Gets a pointer to the start of the mapped data, or nullptr if the file is not open
+	/// </summary>
+	const uint8_t* GetData() const { return _data; }
+	/// <summary>
+	/// Gets the size of the mapped file, in bytes
+	/// </summary>
+	size_t GetSize() const { return _size; }
+	/// <summary>
+	/// Returns true if the file has been successfully mapped
+	/// </summary>
+	bool IsOpen() const { return _data != nullptr; }
+
+	/// <summary>
+	/// Maps the given file into memory for reading
+	/// </summary>
+	/// <param name="filename">The path to the file to open</param>
+	/// <returns>The mapped file, or nullptr if the file could not be opened</returns>
+	static MappedFile::Sptr Open(const std::string& filename);
+
+protected:
+	const uint8_t* _data;
+	size_t         _size;
+
+	#ifdef WINDOWS
+	void* _fileHandle;
+	void* _mappingHandle;
+	#else
+	int   _fileHandle;
+	#endif
+
+	void _Close();
+};
@@ -1,4 +1,8 @@
 #include "Utils/MeshFactory.h"
+#include <algorithm>
+#include <cmath>
+
+#include "Utils/HashUtils.h"
 
 MeshBuilderParam MeshBuilderParam::CreateCube(const glm::vec3& pos, const glm::vec3& scale, const glm::vec3& eulerDeg /*= glm::vec3(0.0f)*/, const glm::vec4& col /*= glm::vec4(1.0f)*/) {
 	MeshBuilderParam result;
@@ -78,4 +82,51 @@ nlohmann::json MeshBuilderParam::ToJson() const {
 		result["params"][key] = GlmToJson(value);
 	}
 	return result;
-}
\ No newline at end of file
+}
+
+// Values are snapped to this resolution before hashing so that tiny float
+// differences from JSON round trips do not produce different hashes
+static constexpr float HASH_QUANTIZATION = 10000.0f;
+
+inline void HashFloat(uint64_t& hash, float value) {
+	int64_t quantized = static_cast<int64_t>(std::round(value * HASH_QUANTIZATION));
+	HashUtils::HashBytes(hash, &quantized, sizeof(int64_t));
+}
+
+uint64_t MeshBuilderParam::Hash() const {
+	uint64_t result = HashUtils::FNV_OFFSET_BASIS;
+
+	int type = *Type;
+	HashUtils::HashBytes(result, &type, sizeof(int));
+	for (int ix = 0; ix < 4; ix++) {
+		HashFloat(result, Color[ix]);
+	}
+
+	// Unordered map iteration order is not stable, so we sort the keys first
+	std::vector<std::string> keys;
+	keys.reserve(Params.size());
+	for (auto& [key, value] : Params) {
+		keys.push_back(key);
+	}
+	std::sort(keys.begin(), keys.end());
+
+	for (const std::string& key : keys) {
+		HashUtils::HashBytes(result, key.data(), key.size());
+		const glm::vec3& value = Params.at(key);
+		HashFloat(result, value.x);
+		HashFloat(result, value.y);
+		HashFloat(result, value.z);
+	}
+	return result;
+}
+
+uint64_t MeshBuilderParam::Hash(const std::vector<MeshBuilderParam>& params) {
+	uint64_t result = HashUtils::FNV_OFFSET_BASIS;
+	uint64_t count = params.size();
+	HashUtils::HashBytes(result, &count, sizeof(uint64_t));
+	for (const MeshBuilderParam& param : params) {
+		uint64_t paramHash = param.Hash();
+		HashUtils::HashBytes(result, &paramHash, sizeof(uint64_t));
+	}
+	return result;
+}
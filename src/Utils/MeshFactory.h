@@ -37,6 +37,17 @@ struct MeshBuilderParam {
 
 	static MeshBuilderParam FromJson(const nlohmann::json& blob);
 	nlohmann::json   ToJson() const;
+
+	/// <summary>
+	/// Gets a canonical hash for this parameter. Parameter keys are hashed in sorted order
+	/// and values are quantized, so equivalent params will always produce the same hash
+	/// </summary>
+	uint64_t Hash() const;
+	/// <summary>
+	/// Gets a canonical hash for a list of parameters, in the order they will be applied
+	/// </summary>
+	/// <param name="params">The list of parameters to hash</param>
+	static uint64_t Hash(const std::vector<MeshBuilderParam>& params);
 };
 
 
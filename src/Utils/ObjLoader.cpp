@@ -8,9 +8,11 @@
 #include <filesystem>
 
 #include "Utils/StringUtils.h"
+#include "Utils/Profiler.h"
 
-VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
+VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename, CollisionMesh::Sptr* collisionMesh /*= nullptr*/)
 {
+	PROFILE_SCOPE("ObjLoader::LoadFromFile");
 	if (!std::filesystem::exists(filename)) {
 		LOG_WARN("Failed to find OBJ file: \"{}\"", filename);
 		return nullptr;
@@ -126,6 +128,17 @@ VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
 	result->AddVertexBuffer(vertexBuffer, VertexPosNormTexCol::V_DECL);
 
 	result->SetVDecl(VertexPosNormTexCol::V_DECL);
+
+	// The OBJ positions are already de-duplicated, so we can index into them directly for collision
+	if (collisionMesh != nullptr) {
+		CollisionMesh::Sptr collision = std::make_shared<CollisionMesh>();
+		collision->Positions = positions;
+		collision->Indices.resize(vertices.size());
+		for (int ix = 0; ix < vertices.size(); ix++) {
+			collision->Indices[ix] = vertices[ix].x;
+		}
+		*collisionMesh = collision;
+	}
 	
 	// Calculate and trace out how long it took us to load
 	float endTime = glfwGetTime();
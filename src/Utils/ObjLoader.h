@@ -2,11 +2,18 @@
 
 #include "MeshBuilder.h"
 #include "MeshFactory.h"
+#include "CollisionMesh.h"
 
 class ObjLoader
 {
 public:
-	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename);
+	/// <summary>
+	/// Loads a VAO from an OBJ file
+	/// </summary>
+	/// <param name="filename">The path to the OBJ file to load</param>
+	/// <param name="collisionMesh">If not null, will receive a CPU side copy of the positions and triangles</param>
+	/// <returns>A VAO loaded from disk</returns>
+	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename, CollisionMesh::Sptr* collisionMesh = nullptr);
 
 protected:
 	ObjLoader() = default;
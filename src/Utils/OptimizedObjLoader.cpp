@@ -11,13 +11,15 @@
 #include "Utils/StringUtils.h"
 #include "GLFW/glfw3.h"
 #include "Logging.h"
+#include "Utils/Profiler.h"
 
 const char HEADER_BYTES[4] = { 'B', 'O', 'B', 'J' };
 const std::string binaryExtension = ".bin";
 
 namespace fs = std::filesystem;
 
-VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& filename) {
+VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& filename, CollisionMesh::Sptr* collisionMesh /*= nullptr*/) {
+	PROFILE_SCOPE("OptimizedObjLoader::LoadFromFile");
 	// Get the file extension and lowercase it
 	fs::path filePath = std::filesystem::path(filename);
 	std::string extension = filePath.extension().string();
@@ -32,11 +34,11 @@ VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& file
 			ConvertToBinary(filename, binPath.string());
 		}
 		// Load the corresponding binary file
-		return _LoadFromBinFile(binPath.string());
+		return _LoadFromBinFile(binPath.string(), collisionMesh);
 	} 
 	// Load our fancy binary files
 	else if (extension == ".bin") {
-		return _LoadFromBinFile(filename);
+		return _LoadFromBinFile(filename, collisionMesh);
 	}
 	// We've never met this extension in our life
 	else {
@@ -233,7 +235,7 @@ MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(c
 	return mesh;
 }
 
-VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string& filename) {
+VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string& filename, CollisionMesh::Sptr* collisionMesh /*= nullptr*/) {
 
 	// Open the output file
 	std::ifstream file(filename, std::ios::binary);
@@ -283,6 +285,7 @@ VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string&
 		// These will have the buffer pointers
 		IndexBuffer::Sptr indices = nullptr;
 		VertexBuffer::Sptr vertices = nullptr;
+		void* indexStore = nullptr;
 
 		// If we have index data, load it
 		if (header.NumIndices > 0) {
@@ -290,12 +293,11 @@ VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string&
 			indices = IndexBuffer::Create(BufferUsage::StaticDraw);
 
 			// Create memory to store indices, then read from the file
-			void* dataStore = malloc(header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			file.read(reinterpret_cast<char*>(dataStore), header.NumIndices * GetIndexTypeSize(header.IndicesType));
+			indexStore = malloc(header.NumIndices * GetIndexTypeSize(header.IndicesType));
+			file.read(reinterpret_cast<char*>(indexStore), header.NumIndices * GetIndexTypeSize(header.IndicesType));
 			
-			// Load data into OpenGL and free the CPU memory we allocated
-			indices->LoadData(dataStore, GetIndexTypeSize(header.IndicesType), header.NumIndices, header.IndicesType);
-			free(dataStore);
+			// Load data into OpenGL, the CPU copy is freed once we're done with the vertices
+			indices->LoadData(indexStore, GetIndexTypeSize(header.IndicesType), header.NumIndices, header.IndicesType);
 		}
 
 		// Create a new VBO
@@ -305,9 +307,17 @@ VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string&
 		void* vertexStore = malloc(header.NumVertices * (size_t)header.VertexStride);
 		file.read(reinterpret_cast<char*>(vertexStore), header.NumVertices * (size_t)header.VertexStride);
 
-		// Load data into OpenGL and free the CPU copy
+		// Load data into OpenGL
 		vertices->LoadData(vertexStore, header.VertexStride, header.NumVertices);
+
+		// Keep a compact copy of the positions and indices around for physics if requested
+		if (collisionMesh != nullptr) {
+			*collisionMesh = CollisionMesh::Create(vertexStore, header.NumVertices, vertexDeclaration, indexStore, header.NumIndices, header.IndicesType);
+		}
+
+		// Free the CPU copies
 		free(vertexStore);
+		free(indexStore);
 
 		// Create the VAO and attach our index and vertex buffers
 		VertexArrayObject::Sptr result = VertexArrayObject::Create();
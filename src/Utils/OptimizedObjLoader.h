@@ -12,6 +12,7 @@
 #include "Graphics/VertexTypes.h"
 
 #include "Utils/MeshBuilder.h"
+#include "Utils/CollisionMesh.h"
 
 /// <summary>
 /// An optimized OBJ loader that can convert an OBJ file to a binary representation
@@ -24,8 +25,9 @@ public:
 	/// to a binary file and load that instead. On subsequent runs, the binary file will be loaded instead
 	/// </summary>
 	/// <param name="filename">The path to the .obj or .bin file to load</param>
+	/// <param name="collisionMesh">If not null, will receive a CPU side copy of the positions and triangles</param>
 	/// <returns>A VAO loaded from disk</returns>
-	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename);
+	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename, CollisionMesh::Sptr* collisionMesh = nullptr);
 	/// <summary>
 	/// Manually converts an OBJ file into a binary mesh file
 	/// </summary>
@@ -65,7 +67,7 @@ protected:
 	~OptimizedObjLoader() = default;
 
 	static MeshBuilder<VertexPosNormTexColTangents>* _LoadFromObjFile(const std::string& filename);
-	static VertexArrayObject::Sptr _LoadFromBinFile(const std::string& filename);
+	static VertexArrayObject::Sptr _LoadFromBinFile(const std::string& filename, CollisionMesh::Sptr* collisionMesh = nullptr);
 };
 
 template <typename VertexType>
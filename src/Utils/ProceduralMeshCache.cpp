@@ -0,0 +1,152 @@
+#include "Utils/ProceduralMeshCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+
+#include "Utils/OptimizedObjLoader.h"
+#include "Logging.h"
+
+namespace fs = std::filesystem;
+
+std::unordered_map<uint64_t, ProceduralMeshCache::CacheEntry> ProceduralMeshCache::_meshes;
+std::string ProceduralMeshCache::_cacheDirectory = "cache/meshes";
+bool        ProceduralMeshCache::_isDiskCacheEnabled = true;
+
+VertexArrayObject::Sptr ProceduralMeshCache::Get(const std::vector<MeshBuilderParam>& params, CollisionMesh::Sptr* collisionMesh /*= nullptr*/) {
+	uint64_t hash = MeshBuilderParam::Hash(params);
+	CacheEntry& entry = _meshes[hash];
+
+	// If another resource already has this mesh loaded, we can just share it
+	VertexArrayObject::Sptr result = entry.Mesh.lock();
+	if (result != nullptr) {
+		if (collisionMesh != nullptr) {
+			CollisionMesh::Sptr collision = entry.Collision.lock();
+			// Nobody is holding on to the collision data, re-generating on the CPU is cheap and avoids a GPU readback
+			if (collision == nullptr) {
+				MeshBuilder<VertexPosNormTexColTangents> mesh;
+				_Generate(params, mesh);
+				collision = CollisionMesh::Create(mesh);
+				entry.Collision = collision;
+			}
+			*collisionMesh = collision;
+		}
+		return result;
+	}
+
+	std::string path = _GetCachePath(hash);
+	CollisionMesh::Sptr collision = nullptr;
+
+	// Try and load the pre-baked mesh from the disk
+	if (_isDiskCacheEnabled && fs::exists(path) && _IsCacheValid(path, hash)) {
+		try {
+			result = OptimizedObjLoader::LoadFromFile(path, collisionMesh != nullptr ? &collision : nullptr);
+		} catch (const std::exception& e) {
+			LOG_WARN("Failed to load cached mesh \"{}\": {}", path, e.what());
+			result = nullptr;
+		}
+	}
+
+	// Cache miss, we need to generate the mesh from scratch
+	if (result == nullptr) {
+		MeshBuilder<VertexPosNormTexColTangents> mesh;
+		_Generate(params, mesh);
+		result = mesh.Bake();
+		if (collisionMesh != nullptr) {
+			collision = CollisionMesh::Create(mesh);
+		}
+
+		if (_isDiskCacheEnabled) {
+			try {
+				fs::create_directories(fs::path(path).parent_path());
+				OptimizedObjLoader::SaveBinaryFile(mesh, path);
+				_WriteFooter(path, hash);
+			} catch (const std::exception& e) {
+				LOG_WARN("Failed to write mesh cache file \"{}\": {}", path, e.what());
+			}
+		}
+	}
+
+	entry.Mesh = result;
+	if (collisionMesh != nullptr) {
+		entry.Collision = collision;
+		*collisionMesh = collision;
+	}
+	return result;
+}
+
+void ProceduralMeshCache::SetCacheDirectory(const std::string& directory) {
+	_cacheDirectory = directory;
+}
+
+void ProceduralMeshCache::SetDiskCacheEnabled(bool enabled) {
+	_isDiskCacheEnabled = enabled;
+}
+
+void ProceduralMeshCache::Prune() {
+	for (auto it = _meshes.begin(); it != _meshes.end();) {
+		if (it->second.Mesh.expired()) {
+			it = _meshes.erase(it);
+		} else {
+			it++;
+		}
+	}
+}
+
+void ProceduralMeshCache::Clear(bool clearDisk) {
+	_meshes.clear();
+	if (clearDisk && fs::exists(_cacheDirectory)) {
+		std::error_code error;
+		fs::remove_all(_cacheDirectory, error);
+		if (error) {
+			LOG_WARN("Failed to clear mesh cache directory \"{}\": {}", _cacheDirectory, error.message());
+		}
+	}
+}
+
+std::string ProceduralMeshCache::_GetCachePath(uint64_t hash) {
+	std::stringstream stream;
+	stream << _cacheDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+	return stream.str();
+}
+
+bool ProceduralMeshCache::_IsCacheValid(const std::string& path, uint64_t hash) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file || (size_t)file.tellg() < sizeof(CacheFooter)) {
+		return false;
+	}
+
+	CacheFooter footer;
+	file.seekg(-(std::streamoff)sizeof(CacheFooter), std::ios::end);
+	file.read(reinterpret_cast<char*>(&footer), sizeof(CacheFooter));
+	if (!file || memcmp(footer.FooterBytes, "PMCF", 4) != 0 || footer.ParamHash != hash) {
+		LOG_INFO("Cached mesh \"{}\" is not from the mesh cache, re-generating", path);
+		return false;
+	}
+	if (footer.Version != GENERATOR_VERSION) {
+		LOG_INFO("Cached mesh \"{}\" is from generator version {} (current is {}), re-generating", path, footer.Version, GENERATOR_VERSION);
+		return false;
+	}
+	return true;
+}
+
+void ProceduralMeshCache::_WriteFooter(const std::string& path, uint64_t hash) {
+	std::ofstream file(path, std::ios::binary | std::ios::app);
+	if (!file) {
+		throw std::runtime_error("Failed to open mesh cache file");
+	}
+
+	CacheFooter footer;
+	footer.Version   = GENERATOR_VERSION;
+	footer.ParamHash = hash;
+	file.write(reinterpret_cast<const char*>(&footer), sizeof(CacheFooter));
+}
+
+void ProceduralMeshCache::_Generate(const std::vector<MeshBuilderParam>& params, MeshBuilder<VertexPosNormTexColTangents>& mesh) {
+	for (const MeshBuilderParam& param : params) {
+		MeshFactory::AddParameterized(mesh, param);
+	}
+	MeshFactory::CalculateTBN(mesh);
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+#include <unordered_map>
+#include <string>
+
+#include "Graphics/VertexArrayObject.h"
+#include "Utils/MeshFactory.h"
+#include "Utils/CollisionMesh.h"
+
+/// <summary>
+/// Caches meshes that were generated from MeshBuilderParams, keyed by the canonical hash
+/// of the parameter list. Baked meshes are shared in memory between any resources with
+/// identical parameters, and are written to disk so that subsequent runs can skip
+/// generating and calculating tangents for the mesh
+/// </summary>
+class ProceduralMeshCache {
+public:
+	ProceduralMeshCache() = delete;
+
+	/// <summary>
+	/// Gets the mesh for the given list of parameters, re-using an existing VAO if one with the same
+	/// parameters is still alive, then loading from the disk cache, and finally generating the mesh if
+	/// neither was available
+	/// </summary>
+	/// <param name="params">The parameters to generate the mesh from</param>
+	/// <param name="collisionMesh">If not null, will receive a CPU side copy of the positions and triangles</param>
+	/// <returns>The VAO for the given parameters</returns>
+	static VertexArrayObject::Sptr Get(const std::vector<MeshBuilderParam>& params, CollisionMesh::Sptr* collisionMesh = nullptr);
+
+	/// <summary>
+	/// Sets the directory that baked meshes will be stored in, defaults to "cache/meshes"
+	/// </summary>
+	/// <param name="directory">The path to the cache directory, relative to the working directory</param>
+	static void SetCacheDirectory(const std::string& directory);
+	/// <summary>
+	/// Enables or disables storing baked meshes on disk, the in-memory cache is always used
+	/// </summary>
+	static void SetDiskCacheEnabled(bool enabled);
+
+	/// <summary>
+	/// Removes any in-memory entries whose meshes have been released
+	/// </summary>
+	static void Prune();
+	/// <summary>
+	/// Clears the in-memory cache, and optionally deletes all the baked meshes on disk
+	/// </summary>
+	/// <param name="clearDisk">True to also delete the files in the cache directory</param>
+	static void Clear(bool clearDisk = false);
+
+protected:
+	struct CacheEntry {
+		std::weak_ptr<VertexArrayObject> Mesh;
+		std::weak_ptr<CollisionMesh>     Collision;
+	};
+
+	// Appended to the end of each baked mesh file, the BOBJ loader ignores anything past the mesh data
+	struct CacheFooter {
+		// A check value so we can ensure that the file was written by the cache
+		char     FooterBytes[4] ={ 'P', 'M', 'C', 'F' };
+		// The generator version that baked the mesh, meshes from any other version are re-generated
+		uint16_t Version;
+		// The hash of the params the mesh was generated from
+		uint64_t ParamHash;
+	};
+	// Bump this whenever MeshFactory changes the meshes it generates, so stale caches are not loaded
+	static constexpr uint16_t GENERATOR_VERSION = 0x01;
+
+	static std::unordered_map<uint64_t, CacheEntry> _meshes;
+	static std::string _cacheDirectory;
+	static bool        _isDiskCacheEnabled;
+
+	static std::string _GetCachePath(uint64_t hash);
+	static bool _IsCacheValid(const std::string& path, uint64_t hash);
+	static void _WriteFooter(const std::string& path, uint64_t hash);
+	static void _Generate(const std::vector<MeshBuilderParam>& params, MeshBuilder<VertexPosNormTexColTangents>& mesh);
+};
@@ -0,0 +1,606 @@
+#include "Utils/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+#include "Utils/ImGuiHelper.h"
+#include "Logging.h"
+
+// The shortest time between two flight recorder dumps, saving a dump is slow enough to cause a hitch itself
+static const double HITCH_COOLDOWN_SECONDS = 2.0;
+
+std::atomic<bool> Profiler::_enabled(false);
+bool Profiler::_liveStats = false;
+bool Profiler::_capturing = false;
+bool Profiler::_flightRecorder = false;
+std::atomic<uint64_t> Profiler::_nextFlowId(1);
+
+std::mutex Profiler::_mutex;
+const char* Profiler::_zoneNames[MAX_ZONES] = { nullptr };
+std::atomic<int> Profiler::_zoneCount(0);
+std::vector<Profiler::ThreadBuffer*> Profiler::_threads;
+
+double Profiler::_zoneTotals[MAX_ZONES] = { 0.0 };
+int Profiler::_zoneCalls[MAX_ZONES] = { 0 };
+int Profiler::_zoneLastCalls[MAX_ZONES] = { 0 };
+float Profiler::_zoneHistory[MAX_ZONES][HISTORY_SIZE] = { { 0.0f } };
+float Profiler::_frameHistory[HISTORY_SIZE] = { 0.0f };
+int Profiler::_historyIndex = 0;
+uint64_t Profiler::_droppedEvents = 0;
+
+int64_t Profiler::_frameStart = 0;
+std::vector<Profiler::ThreadEvent> Profiler::_lastFrame;
+int64_t Profiler::_lastFrameStart = 0;
+int64_t Profiler::_lastFrameEnd = 0;
+bool Profiler::_pauseFlameGraph = false;
+
+std::vector<Profiler::ThreadEvent> Profiler::_captureEvents;
+std::deque<Profiler::ThreadEvent> Profiler::_flightEvents;
+float Profiler::_flightSeconds = 10.0f;
+float Profiler::_hitchThresholdMs = 50.0f;
+int64_t Profiler::_lastDumpTime = 0;
+int Profiler::_dumpCount = 0;
+
+// Converts a span of profiler ticks (nanoseconds) into milliseconds
+static double TicksToMs(int64_t ticks) {
+	return ticks / 1000000.0;
+}
+
+// Writes a string in quotes, escaping anything JSON doesn't allow
+static void WriteJsonString(std::ostream& stream, const char* value) {
+	stream << '"';
+	for (const char* c = value; *c != '\0'; c++) {
+		if (*c == '"' || *c == '\\') {
+			stream << '\\' << *c;
+		} else if ((unsigned char)*c >= 0x20) {
+			stream << *c;
+		}
+	}
+	stream << '"';
+}
+
+int Profiler::RegisterZone(const char* name) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	int count = _zoneCount.load(std::memory_order_relaxed);
+	for (int ix = 0; ix < count; ix++) {
+		if (strcmp(_zoneNames[ix], name) == 0) {
+			return ix;
+		}
+	}
+	if (count >= MAX_ZONES) {
+		return -1;
+	}
+	_zoneNames[count] = name;
+	_zoneCount.store(count + 1, std::memory_order_release);
+	return count;
+}
+
+const char* Profiler::GetZoneName(int zone) {
+	return zone >= 0 && zone < _zoneCount.load(std::memory_order_acquire) ? _zoneNames[zone] : "";
+}
+
+void Profiler::SetThreadName(const char* name) {
+	ThreadBuffer* buffer = _GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(_mutex);
+	buffer->Name = name;
+}
+
+void Profiler::SetEnabled(bool enabled) {
+	_liveStats = enabled;
+	_UpdateEnabled();
+}
+
+void Profiler::Counter(int zone, double value) {
+	if (zone < 0 || !IsEnabled()) {
+		return;
+	}
+	Event event;
+	event.Start = Now();
+	event.Value = value;
+	event.Zone  = (uint16_t)zone;
+	event.Type  = EventType::Counter;
+	_Record(event);
+}
+
+void Profiler::Marker(int zone) {
+	if (zone < 0 || !IsEnabled()) {
+		return;
+	}
+	Event event;
+	event.Start = Now();
+	event.End   = event.Start;
+	event.Zone  = (uint16_t)zone;
+	event.Type  = EventType::Marker;
+	_Record(event);
+}
+
+uint64_t Profiler::NewFlowId() {
+	return _nextFlowId.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Flow events only differ by their type, so they share one implementation
+#define IMPLEMENT_FLOW_EVENT(func, type) \
+	void Profiler::func(int zone, uint64_t id) { \
+		if (zone < 0 || !IsEnabled()) { \
+			return; \
+		} \
+		Event event; \
+		event.Start  = Now(); \
+		event.FlowId = id; \
+		event.Zone   = (uint16_t)zone; \
+		event.Type   = type; \
+		_Record(event); \
+	}
+
+IMPLEMENT_FLOW_EVENT(FlowBegin, EventType::FlowBegin)
+IMPLEMENT_FLOW_EVENT(FlowStep, EventType::FlowStep)
+IMPLEMENT_FLOW_EVENT(FlowEnd, EventType::FlowEnd)
+
+#undef IMPLEMENT_FLOW_EVENT
+
+void Profiler::BeginCapture() {
+	// Anything recorded before now isn't part of the capture
+	_Drain(false);
+	_captureEvents.clear();
+	_capturing = true;
+	_UpdateEnabled();
+}
+
+bool Profiler::EndCapture(const std::string& path) {
+	if (!_capturing) {
+		return false;
+	}
+	_Drain(false);
+	_capturing = false;
+	_UpdateEnabled();
+
+	std::vector<const ThreadEvent*> events;
+	events.reserve(_captureEvents.size());
+	for (const ThreadEvent& event : _captureEvents) {
+		events.push_back(&event);
+	}
+	bool result = _WriteTrace(path, events);
+
+	// Captures can get big, so give the memory back
+	_captureEvents.clear();
+	_captureEvents.shrink_to_fit();
+	return result;
+}
+
+void Profiler::SetFlightRecorder(bool enabled) {
+	_flightRecorder = enabled;
+	if (!_flightRecorder) {
+		_flightEvents.clear();
+	}
+	_UpdateEnabled();
+}
+
+bool Profiler::DumpFlightRecorder(const std::string& path) {
+	_Drain(false);
+	std::vector<const ThreadEvent*> events;
+	events.reserve(_flightEvents.size());
+	for (const ThreadEvent& event : _flightEvents) {
+		events.push_back(&event);
+	}
+	return _WriteTrace(path, events);
+}
+
+void Profiler::EndFrame() {
+	int64_t now = Now();
+	if (!IsEnabled()) {
+		_frameStart = now;
+		return;
+	}
+
+	int zoneCount = _zoneCount.load(std::memory_order_acquire);
+	std::fill(_zoneTotals, _zoneTotals + zoneCount, 0.0);
+	std::fill(_zoneCalls, _zoneCalls + zoneCount, 0);
+	if (!_pauseFlameGraph) {
+		_lastFrame.clear();
+	}
+
+	_Drain(true);
+
+	for (int ix = 0; ix < zoneCount; ix++) {
+		_zoneHistory[ix][_historyIndex] = (float)_zoneTotals[ix];
+		_zoneLastCalls[ix] = _zoneCalls[ix];
+	}
+	float frameMs = _frameStart > 0 ? (float)TicksToMs(now - _frameStart) : 0.0f;
+	_frameHistory[_historyIndex] = frameMs;
+	_historyIndex = (_historyIndex + 1) % HISTORY_SIZE;
+
+	if (!_pauseFlameGraph) {
+		_lastFrameStart = _frameStart;
+		_lastFrameEnd = now;
+	}
+
+	// Save what led up to a hitch while it's still in memory
+	if (_flightRecorder && frameMs > _hitchThresholdMs && TicksToMs(now - _lastDumpTime) > HITCH_COOLDOWN_SECONDS * 1000.0) {
+		std::string path = "hitch_" + std::to_string(_dumpCount++) + ".json";
+		LOG_WARN("Frame took {:.2f} ms, saving the flight recorder to \"{}\"", frameMs, path);
+		DumpFlightRecorder(path);
+		_lastDumpTime = Now();
+	}
+
+	_frameStart = Now();
+}
+
+void Profiler::_Drain(bool updateStats) {
+	int zoneCount = _zoneCount.load(std::memory_order_acquire);
+
+	// The lock only keeps new threads from being added while we walk the list, the rings themselves are lock free
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (int thread = 0; thread < (int)_threads.size(); thread++) {
+		ThreadBuffer* buffer = _threads[thread];
+		uint64_t write = buffer->WriteIndex.load(std::memory_order_acquire);
+		// If the thread got more than a full ring ahead of us, the oldest events have been overwritten
+		if (write - buffer->ReadIndex > RING_SIZE) {
+			_droppedEvents += write - buffer->ReadIndex - RING_SIZE;
+			buffer->ReadIndex = write - RING_SIZE;
+		}
+
+		for (; buffer->ReadIndex < write; buffer->ReadIndex++) {
+			Event event = buffer->Events[buffer->ReadIndex % RING_SIZE];
+			// The thread keeps writing while we read, so make sure it didn't lap us and overwrite the slot mid copy
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (buffer->WriteIndex.load(std::memory_order_relaxed) - buffer->ReadIndex >= RING_SIZE) {
+				_droppedEvents++;
+				continue;
+			}
+
+			if (updateStats && event.Type == EventType::Scope && event.Zone < zoneCount) {
+				_zoneTotals[event.Zone] += TicksToMs(event.End - event.Start);
+				_zoneCalls[event.Zone]++;
+				if (!_pauseFlameGraph) {
+					_lastFrame.push_back({ event, thread });
+				}
+			}
+			if (_capturing) {
+				_captureEvents.push_back({ event, thread });
+			}
+			if (_flightRecorder) {
+				_flightEvents.push_back({ event, thread });
+			}
+		}
+	}
+
+	// Events come in roughly in order, so trimming from the front is close enough to keep the recorder to it's window
+	if (_flightRecorder) {
+		int64_t oldest = Now() - (int64_t)(_flightSeconds * 1000000000.0);
+		while (!_flightEvents.empty() && (_flightEvents.size() > MAX_FLIGHT_EVENTS || _flightEvents.front().Data.Start < oldest)) {
+			_flightEvents.pop_front();
+		}
+	}
+}
+
+bool Profiler::_WriteTrace(const std::string& path, const std::vector<const ThreadEvent*>& events) {
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		LOG_ERROR("Failed to open \"{}\" for writing a trace", path);
+		return false;
+	}
+
+	// Times are written in microseconds from the first event, to keep the numbers readable
+	int64_t base = INT64_MAX;
+	for (const ThreadEvent* event : events) {
+		base = std::min(base, event->Data.Start);
+	}
+	auto timestamp = [&](int64_t time) {
+		return (time - base) / 1000.0;
+	};
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (int thread = 0; thread < (int)_threads.size(); thread++) {
+			file << (thread > 0 ? ",\n" : "\n");
+			file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread << ",\"args\":{\"name\":";
+			WriteJsonString(file, _threads[thread]->Name.c_str());
+			file << "}}";
+		}
+	}
+
+	for (size_t ix = 0; ix < events.size(); ix++) {
+		const Event& event = events[ix]->Data;
+		file << ",\n{\"name\":";
+		WriteJsonString(file, GetZoneName(event.Zone));
+		file << ",\"pid\":0,\"tid\":" << events[ix]->Thread << ",\"ts\":" << timestamp(event.Start);
+		switch (event.Type) {
+			case EventType::Scope:
+				file << ",\"ph\":\"X\",\"dur\":" << (event.End - event.Start) / 1000.0;
+				break;
+			case EventType::Counter:
+				file << ",\"ph\":\"C\",\"args\":{\"value\":" << event.Value << "}";
+				break;
+			case EventType::Marker:
+				file << ",\"ph\":\"i\",\"s\":\"g\"";
+				break;
+			case EventType::FlowBegin:
+				file << ",\"ph\":\"s\",\"cat\":\"flow\",\"id\":" << event.FlowId;
+				break;
+			case EventType::FlowStep:
+				file << ",\"ph\":\"t\",\"cat\":\"flow\",\"bp\":\"e\",\"id\":" << event.FlowId;
+				break;
+			case EventType::FlowEnd:
+				file << ",\"ph\":\"f\",\"cat\":\"flow\",\"bp\":\"e\",\"id\":" << event.FlowId;
+				break;
+		}
+		file << "}";
+	}
+	file << "\n]}\n";
+
+	LOG_INFO("Wrote {} trace events to \"{}\"", events.size(), path);
+	return true;
+}
+
+double Profiler::GetAverageMs(int zone) {
+	if (zone < 0 || zone >= MAX_ZONES) {
+		return 0.0;
+	}
+	double total = 0.0;
+	for (int ix = 0; ix < HISTORY_SIZE; ix++) {
+		total += _zoneHistory[zone][ix];
+	}
+	return total / HISTORY_SIZE;
+}
+
+double Profiler::GetMaxMs(int zone) {
+	if (zone < 0 || zone >= MAX_ZONES) {
+		return 0.0;
+	}
+	return *std::max_element(_zoneHistory[zone], _zoneHistory[zone] + HISTORY_SIZE);
+}
+
+void Profiler::RenderImGui() {
+	bool liveStats = _liveStats;
+	if (ImGui::Checkbox("Live Stats", &liveStats)) {
+		SetEnabled(liveStats);
+	}
+	ImGui::SameLine();
+	ImGui::Checkbox("Pause Flame Graph", &_pauseFlameGraph);
+
+	float frameAverage = 0.0f;
+	for (int ix = 0; ix < HISTORY_SIZE; ix++) {
+		frameAverage += _frameHistory[ix];
+	}
+	frameAverage /= HISTORY_SIZE;
+	float frameMax = *std::max_element(_frameHistory, _frameHistory + HISTORY_SIZE);
+	ImGui::Text("Frame: avg %.2f ms, max %.2f ms", frameAverage, frameMax);
+	if (_droppedEvents > 0) {
+		ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "Dropped %llu events, the rings filled up before they were collected", (unsigned long long)_droppedEvents);
+	}
+
+	// Busiest zones first, skipping anything that hasn't run recently
+	int zoneCount = _zoneCount.load(std::memory_order_acquire);
+	std::vector<std::pair<double, int>> zones;
+	zones.reserve(zoneCount);
+	for (int ix = 0; ix < zoneCount; ix++) {
+		if (GetMaxMs(ix) > 0.0) {
+			zones.push_back({ GetAverageMs(ix), ix });
+		}
+	}
+	std::sort(zones.begin(), zones.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+	if (ImGui::CollapsingHeader("Zones", ImGuiTreeNodeFlags_DefaultOpen)) {
+		ImGui::Columns(5, "##profilerZones");
+		ImGui::Text("Zone");   ImGui::NextColumn();
+		ImGui::Text("Calls");  ImGui::NextColumn();
+		ImGui::Text("Avg ms"); ImGui::NextColumn();
+		ImGui::Text("Max ms"); ImGui::NextColumn();
+		ImGui::Text("% Frame"); ImGui::NextColumn();
+		ImGui::Separator();
+		for (const auto& [average, zone] : zones) {
+			ImGui::TextUnformatted(_zoneNames[zone]);          ImGui::NextColumn();
+			ImGui::Text("%d", _zoneLastCalls[zone]);           ImGui::NextColumn();
+			ImGui::Text("%.3f", average);                      ImGui::NextColumn();
+			ImGui::Text("%.3f", GetMaxMs(zone));               ImGui::NextColumn();
+			ImGui::Text("%.1f", frameAverage > 0.0f ? average / frameAverage * 100.0 : 0.0); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+
+	if (ImGui::CollapsingHeader("Flame Graph", ImGuiTreeNodeFlags_DefaultOpen)) {
+		_RenderFlameGraph();
+	}
+
+	if (ImGui::CollapsingHeader("Trace Export")) {
+		if (_capturing) {
+			ImGui::Text("Capturing, %d events", (int)_captureEvents.size());
+			if (ImGui::Button("Stop and Save")) {
+				EndCapture("trace.json");
+			}
+		} else if (ImGui::Button("Start Capture")) {
+			BeginCapture();
+		}
+		if (ImGui::IsItemHovered()) {
+			ImGui::SetTooltip("Saves to trace.json, open it in chrome://tracing or ui.perfetto.dev");
+		}
+
+		ImGui::Separator();
+		bool flightRecorder = _flightRecorder;
+		if (ImGui::Checkbox("Flight Recorder", &flightRecorder)) {
+			SetFlightRecorder(flightRecorder);
+		}
+		LABEL_LEFT(ImGui::SliderFloat, "Keep (s)          ", &_flightSeconds, 1.0f, 30.0f, "%.0f");
+		LABEL_LEFT(ImGui::SliderFloat, "Hitch Threshold ms", &_hitchThresholdMs, 10.0f, 500.0f, "%.0f");
+		ImGui::Text("Holding %d events, saved %d hitches", (int)_flightEvents.size(), _dumpCount);
+		if (_flightRecorder && ImGui::Button("Save Now")) {
+			DumpFlightRecorder("flight_recorder.json");
+		}
+	}
+}
+
+void Profiler::Cleanup() {
+	if (_capturing) {
+		EndCapture("trace.json");
+	}
+	_liveStats = false;
+	_flightRecorder = false;
+	_UpdateEnabled();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (ThreadBuffer* buffer : _threads) {
+		delete buffer;
+	}
+	_threads.clear();
+	_lastFrame.clear();
+	_flightEvents.clear();
+}
+
+int64_t Profiler::Now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+int Profiler::RegisterTimeline(const char* name) {
+	ThreadBuffer* buffer = _CreateBuffer(true);
+	std::lock_guard<std::mutex> lock(_mutex);
+	buffer->Name = name;
+	return (int)(std::find(_threads.begin(), _threads.end(), buffer) - _threads.begin());
+}
+
+void Profiler::RecordScope(int timeline, int zone, int64_t start, int64_t end, int depth) {
+	if (zone < 0 || !IsEnabled()) {
+		return;
+	}
+	ThreadBuffer* buffer = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (timeline < 0 || timeline >= (int)_threads.size() || !_threads[timeline]->IsTimeline) {
+			return;
+		}
+		buffer = _threads[timeline];
+	}
+
+	Event event;
+	event.Start = start;
+	event.End   = end;
+	event.Zone  = (uint16_t)zone;
+	event.Depth = (uint16_t)depth;
+	event.Type  = EventType::Scope;
+	_Write(buffer, event);
+}
+
+Profiler::ThreadBuffer* Profiler::_GetThreadBuffer() {
+	thread_local ThreadBuffer* buffer = nullptr;
+	if (buffer == nullptr) {
+		buffer = _CreateBuffer(false);
+	}
+	return buffer;
+}
+
+Profiler::ThreadBuffer* Profiler::_CreateBuffer(bool isTimeline) {
+	ThreadBuffer* buffer = new ThreadBuffer();
+	buffer->WriteIndex.store(0, std::memory_order_relaxed);
+	buffer->ReadIndex = 0;
+	buffer->Depth = 0;
+	buffer->IsTimeline = isTimeline;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	buffer->Name = "Thread " + std::to_string(_threads.size());
+	_threads.push_back(buffer);
+	return buffer;
+}
+
+int64_t Profiler::_BeginScope() {
+	_GetThreadBuffer()->Depth++;
+	return Now();
+}
+
+void Profiler::_EndScope(int zone, int64_t start) {
+	Event event;
+	event.End   = Now();
+	event.Start = start;
+	event.Zone  = (uint16_t)zone;
+	event.Type  = EventType::Scope;
+	_Record(event);
+}
+
+void Profiler::_Record(const Event& event) {
+	ThreadBuffer* buffer = _GetThreadBuffer();
+	if (event.Type == EventType::Scope) {
+		buffer->Depth--;
+	}
+
+	Event result = event;
+	result.Depth = (uint16_t)buffer->Depth;
+	_Write(buffer, result);
+}
+
+void Profiler::_Write(ThreadBuffer* buffer, const Event& event) {
+	// There's only one writer per buffer, so there's no need for anything stronger than publishing the new index
+	uint64_t index = buffer->WriteIndex.load(std::memory_order_relaxed);
+	buffer->Events[index % RING_SIZE] = event;
+	buffer->WriteIndex.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::_UpdateEnabled() {
+	_enabled.store(_liveStats || _capturing || _flightRecorder, std::memory_order_relaxed);
+}
+
+void Profiler::_RenderFlameGraph() {
+	if (_lastFrame.empty() || _lastFrameEnd <= _lastFrameStart) {
+		ImGui::TextUnformatted("Nothing recorded yet");
+		return;
+	}
+
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+	float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+	double span = (double)(_lastFrameEnd - _lastFrameStart);
+	ImGui::Text("%.2f ms", TicksToMs(_lastFrameEnd - _lastFrameStart));
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (int thread = 0; thread < (int)_threads.size(); thread++) {
+		int maxDepth = -1;
+		int64_t firstStart = INT64_MAX;
+		for (const ThreadEvent& flame : _lastFrame) {
+			if (flame.Thread == thread) {
+				maxDepth = std::max(maxDepth, (int)flame.Data.Depth);
+				firstStart = std::min(firstStart, flame.Data.Start);
+			}
+		}
+		if (maxDepth < 0) {
+			continue;
+		}
+
+		// Timelines measured elsewhere usually describe an earlier frame, so line them up with their own start
+		int64_t offset = _threads[thread]->IsTimeline ? _lastFrameStart - firstStart : 0;
+
+		ImGui::TextUnformatted(_threads[thread]->Name.c_str());
+		ImVec2 origin = ImGui::GetCursorScreenPos();
+		ImVec2 size = ImVec2(width, rowHeight * (maxDepth + 1));
+		drawList->AddRectFilled(origin, ImVec2(origin.x + size.x, origin.y + size.y), IM_COL32(30, 30, 30, 255));
+
+		for (const ThreadEvent& flame : _lastFrame) {
+			if (flame.Thread != thread) {
+				continue;
+			}
+
+			// Work from a pipelined thread can start before the frame did, so clip it to the frame
+			float x0 = (float)std::clamp((flame.Data.Start + offset - _lastFrameStart) / span, 0.0, 1.0) * width;
+			float x1 = (float)std::clamp((flame.Data.End + offset - _lastFrameStart) / span, 0.0, 1.0) * width;
+			if (x1 - x0 < 1.0f) {
+				x1 = x0 + 1.0f;
+			}
+			ImVec2 min = ImVec2(origin.x + x0, origin.y + flame.Data.Depth * rowHeight);
+			ImVec2 max = ImVec2(origin.x + x1, min.y + rowHeight - 1.0f);
+
+			// Spread the hues out with the golden ratio so neighbouring zones are easy to tell apart
+			float hue = fmodf(flame.Data.Zone * 0.618034f, 1.0f);
+			drawList->AddRectFilled(min, max, ImColor::HSV(hue, 0.5f, 0.7f));
+
+			const char* name = _zoneNames[flame.Data.Zone];
+			if (max.x - min.x > ImGui::CalcTextSize(name).x + 4.0f) {
+				drawList->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32(255, 255, 255, 255), name);
+			}
+			if (ImGui::IsMouseHoveringRect(min, max)) {
+				ImGui::SetTooltip("%s\n%.3f ms", name, TicksToMs(flame.Data.End - flame.Data.Start));
+			}
+		}
+		ImGui::Dummy(size);
+	}
+}
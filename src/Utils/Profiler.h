@@ -0,0 +1,309 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <deque>
+#include <string>
+#include <cstdint>
+
+// Set to 0 to compile all profiling scopes out
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+/// <summary>
+/// A small CPU profiler for seeing where frame time goes. Code is instrumented with named zones using
+/// PROFILE_SCOPE (or PROFILE_ZONE for zones registered ahead of time, such as one per component type).
+/// Every thread writes its finished scopes into its own fixed size ring, which only that thread writes
+/// to and only EndFrame reads from, so recording a scope never takes a lock. EndFrame drains the rings
+/// once a frame into per zone stats, which RenderImGui shows as rolling averages and maxima, along with
+/// a flame graph of the last frame
+///
+/// Besides scopes, threads can record counters, instant markers, and flows (ex a request made on one
+/// thread and handled on another). Everything recorded can be saved as a Chrome trace (JSON, which
+/// chrome://tracing and the Perfetto UI both open), either by capturing a span of frames, or with the
+/// flight recorder, which keeps the last few seconds in memory and saves them whenever a frame takes
+/// longer than a threshold
+///
+/// While the profiler is not recording, a scope costs a single relaxed atomic load
+/// </summary>
+class Profiler {
+public:
+	// The most zones that can be registered
+	static constexpr int MAX_ZONES = 256;
+	// The number of frames the rolling stats are taken over
+	static constexpr int HISTORY_SIZE = 120;
+
+	/// <summary>
+	/// Times the code from its construction until it goes out of scope, and records it under a zone
+	/// </summary>
+	class Scope {
+	public:
+		inline Scope(int zone) {
+			if (zone >= 0 && _enabled.load(std::memory_order_relaxed)) {
+				_zone = zone;
+				_start = _BeginScope();
+			} else {
+				_zone = -1;
+			}
+		}
+		inline ~Scope() {
+			// A scope that started while recording always ends, so the thread's depth stays balanced
+			if (_zone >= 0) {
+				_EndScope(_zone, _start);
+			}
+		}
+
+		Scope(const Scope& other) = delete;
+		Scope& operator=(const Scope& other) = delete;
+
+	private:
+		int     _zone;
+		int64_t _start;
+	};
+
+	Profiler() = delete;
+
+	/// <summary>
+	/// Gets the ID for a zone with the given name, registering it if it does not exist yet. Zones are
+	/// matched by name, so the same name used in multiple places is reported as one zone
+	/// </summary>
+	/// <param name="name">The zone's name, this must outlive the profiler (ex a string literal)</param>
+	/// <returns>The zone's ID, or -1 if we have run out of zones</returns>
+	static int RegisterZone(const char* name);
+	static const char* GetZoneName(int zone);
+
+	/// <summary>
+	/// Sets the name the calling thread is shown with in the flame graph
+	/// </summary>
+	static void SetThreadName(const char* name);
+
+	/// <summary>
+	/// Gets the current time on the profiler's clock, in nanoseconds
+	/// </summary>
+	static int64_t Now();
+
+	/// <summary>
+	/// Adds a timeline that isn't tied to a thread, for timings measured elsewhere such as on the GPU.
+	/// Its events are shown next to the threads, lined up with their own start in the flame graph
+	/// since they usually arrive a few frames late
+	/// </summary>
+	/// <param name="name">The name to show the timeline with</param>
+	/// <returns>The ID to pass to RecordScope</returns>
+	static int RegisterTimeline(const char* name);
+	/// <summary>
+	/// Records a finished scope on a timeline from RegisterTimeline. Each timeline must only be written
+	/// from one thread
+	/// </summary>
+	/// <param name="timeline">The timeline to record to</param>
+	/// <param name="zone">The zone to record the scope under</param>
+	/// <param name="start">The start time, on the profiler's clock (see Now)</param>
+	/// <param name="end">The end time, on the profiler's clock</param>
+	/// <param name="depth">How deeply the scope is nested in other scopes on the timeline</param>
+	static void RecordScope(int timeline, int zone, int64_t start, int64_t end, int depth);
+
+	/// <summary>
+	/// Sets whether we record for the live stats. We also record while capturing or while the
+	/// flight recorder is on, IsEnabled returns whether we're recording for any reason
+	/// </summary>
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+	/// <summary>
+	/// Records the value of a counter at the current time, such as memory use or a number of objects
+	/// </summary>
+	static void Counter(int zone, double value);
+	/// <summary>
+	/// Records an instant event on the calling thread, for things like scene loads
+	/// </summary>
+	static void Marker(int zone);
+	/// <summary>
+	/// Gets a new ID for connecting events across threads with FlowBegin, FlowStep and FlowEnd
+	/// </summary>
+	static uint64_t NewFlowId();
+	/// <summary>
+	/// Records the start, a middle step, or the end of a flow. Flows attach to the scope that is open on the
+	/// calling thread, and are drawn as arrows between those scopes in the trace viewer
+	/// </summary>
+	static void FlowBegin(int zone, uint64_t id);
+	static void FlowStep(int zone, uint64_t id);
+	static void FlowEnd(int zone, uint64_t id);
+
+	/// <summary>
+	/// Starts keeping every event that is recorded, until EndCapture is called
+	/// </summary>
+	static void BeginCapture();
+	/// <summary>
+	/// Stops a capture started with BeginCapture, and saves it as a Chrome trace
+	/// </summary>
+	/// <param name="path">The file to write</param>
+	/// <returns>True if the file was written</returns>
+	static bool EndCapture(const std::string& path);
+	static bool IsCapturing() { return _capturing; }
+
+	/// <summary>
+	/// Sets whether the flight recorder keeps the last few seconds of events, and saves them to
+	/// "hitch_N.json" when a frame takes longer than the hitch threshold
+	/// </summary>
+	static void SetFlightRecorder(bool enabled);
+	static bool IsFlightRecorderEnabled() { return _flightRecorder; }
+	/// <summary>
+	/// Saves what the flight recorder has in memory as a Chrome trace
+	/// </summary>
+	/// <param name="path">The file to write</param>
+	/// <returns>True if the file was written</returns>
+	static bool DumpFlightRecorder(const std::string& path);
+
+	/// <summary>
+	/// Collects everything recorded since the last call into the stats, call once per frame from the main thread
+	/// </summary>
+	static void EndFrame();
+
+	/// <summary>
+	/// Gets the average and max time spent in a zone per frame over the last HISTORY_SIZE frames, in milliseconds
+	/// </summary>
+	static double GetAverageMs(int zone);
+	static double GetMaxMs(int zone);
+
+	/// <summary>
+	/// Renders the zone stats, and a flame graph of the last frame
+	/// </summary>
+	static void RenderImGui();
+
+	/// <summary>
+	/// Frees the thread rings, no scopes may be running when this is called. A capture that is still
+	/// running is saved to "trace.json" first
+	/// </summary>
+	static void Cleanup();
+
+protected:
+	// The number of events each thread can have waiting to be collected, anything past this is dropped
+	static constexpr uint64_t RING_SIZE = 16384;
+	// The most events the flight recorder will hold on to, on top of its time limit
+	static constexpr size_t MAX_FLIGHT_EVENTS = 1000000;
+
+	enum class EventType : uint8_t {
+		Scope,
+		Counter,
+		Marker,
+		FlowBegin,
+		FlowStep,
+		FlowEnd
+	};
+
+	struct Event {
+		int64_t   Start;
+		// Scopes store their end time, counters their value, and flows their ID
+		union {
+			int64_t  End;
+			double   Value;
+			uint64_t FlowId;
+		};
+		uint16_t  Zone;
+		uint16_t  Depth;
+		EventType Type;
+	};
+
+	struct ThreadBuffer {
+		std::string           Name;
+		Event                 Events[RING_SIZE];
+		// Only the owning thread writes this, published with release so the events before it are visible
+		std::atomic<uint64_t> WriteIndex;
+		// Only EndFrame touches this
+		uint64_t              ReadIndex;
+		// The number of scopes currently open on the owning thread
+		int                   Depth;
+		// True if this is a timeline from RegisterTimeline instead of a thread
+		bool                  IsTimeline;
+	};
+
+	// An event along with which thread it was recorded on
+	struct ThreadEvent {
+		Event Data;
+		int   Thread;
+	};
+
+	// True when we are recording for any reason, this is what scopes check
+	static std::atomic<bool> _enabled;
+	static bool _liveStats;
+	static bool _capturing;
+	static bool _flightRecorder;
+	static std::atomic<uint64_t> _nextFlowId;
+
+	static std::mutex                 _mutex;
+	static const char*                _zoneNames[MAX_ZONES];
+	static std::atomic<int>           _zoneCount;
+	static std::vector<ThreadBuffer*> _threads;
+
+	// Per zone totals for the frame being collected, and the totals of the last HISTORY_SIZE frames
+	static double _zoneTotals[MAX_ZONES];
+	static int    _zoneCalls[MAX_ZONES];
+	static int    _zoneLastCalls[MAX_ZONES];
+	static float  _zoneHistory[MAX_ZONES][HISTORY_SIZE];
+	static float  _frameHistory[HISTORY_SIZE];
+	static int    _historyIndex;
+	static uint64_t _droppedEvents;
+
+	static int64_t _frameStart;
+	static std::vector<ThreadEvent> _lastFrame;
+	static int64_t _lastFrameStart;
+	static int64_t _lastFrameEnd;
+	static bool    _pauseFlameGraph;
+
+	static std::vector<ThreadEvent> _captureEvents;
+	static std::deque<ThreadEvent>  _flightEvents;
+	static float    _flightSeconds;
+	static float    _hitchThresholdMs;
+	static int64_t  _lastDumpTime;
+	static int      _dumpCount;
+
+	static ThreadBuffer* _GetThreadBuffer();
+	static ThreadBuffer* _CreateBuffer(bool isTimeline);
+	static void _Write(ThreadBuffer* buffer, const Event& event);
+	static int64_t _BeginScope();
+	static void _EndScope(int zone, int64_t start);
+	static void _Record(const Event& event);
+	static void _UpdateEnabled();
+	// Collects all the events the threads have finished, and hands them to the live stats, capture and flight recorder
+	static void _Drain(bool updateStats);
+	static bool _WriteTrace(const std::string& path, const std::vector<const ThreadEvent*>& events);
+	static void _RenderFlameGraph();
+};
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+#if PROFILER_ENABLED
+// Times the rest of the enclosing scope under a zone ID from Profiler::RegisterZone
+#define PROFILE_ZONE(zone) Profiler::Scope PROFILER_CONCAT(__profileScope, __LINE__)(zone)
+// Times the rest of the enclosing scope under the given name, the zone is only looked up the first time
+#define PROFILE_SCOPE(name) \
+	static const int PROFILER_CONCAT(__profileZone, __LINE__) = Profiler::RegisterZone(name); \
+	PROFILE_ZONE(PROFILER_CONCAT(__profileZone, __LINE__))
+// Records a counter's value, ex PROFILE_COUNTER("Draw Calls", count)
+#define PROFILE_COUNTER(name, value) { \
+	static const int __profileCounter = Profiler::RegisterZone(name); \
+	Profiler::Counter(__profileCounter, (double)(value)); }
+// Records an instant event, ex PROFILE_MARKER("Scene Loaded")
+#define PROFILE_MARKER(name) { \
+	static const int __profileMarker = Profiler::RegisterZone(name); \
+	Profiler::Marker(__profileMarker); }
+// Records the start, a step or the end of a flow with an ID from Profiler::NewFlowId
+#define PROFILE_FLOW_BEGIN(name, id) { \
+	static const int __profileFlow = Profiler::RegisterZone(name); \
+	Profiler::FlowBegin(__profileFlow, id); }
+#define PROFILE_FLOW_STEP(name, id) { \
+	static const int __profileFlow = Profiler::RegisterZone(name); \
+	Profiler::FlowStep(__profileFlow, id); }
+#define PROFILE_FLOW_END(name, id) { \
+	static const int __profileFlow = Profiler::RegisterZone(name); \
+	Profiler::FlowEnd(__profileFlow, id); }
+#else
+#define PROFILE_ZONE(zone)
+#define PROFILE_SCOPE(name)
+#define PROFILE_COUNTER(name, value)
+#define PROFILE_MARKER(name)
+#define PROFILE_FLOW_BEGIN(name, id)
+#define PROFILE_FLOW_STEP(name, id)
+#define PROFILE_FLOW_END(name, id)
+#endif
@@ -3,6 +3,7 @@
 #include "Utils/ObjLoader.h"
 #include "Utils/FileHelpers.h"
 #include "Utils/StringUtils.h"
+#include "Utils/Profiler.h"
 
 std::map<std::type_index, std::map<Guid, IResource::Sptr>> ResourceManager::_resources;
 std::map<std::string, std::function<Guid(const nlohmann::json&)>> ResourceManager::_typeLoaders;
@@ -22,6 +23,7 @@ const nlohmann::json& ResourceManager::GetManifest() {
 }
 
 void ResourceManager::LoadManifest(const std::string& path) {
+	PROFILE_SCOPE("ResourceManager::LoadManifest");
 	std::string contents = FileHelpers::ReadFile(path);
 	nlohmann::ordered_json blob = nlohmann::ordered_json::parse(contents);
 
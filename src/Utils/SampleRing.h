@@ -0,0 +1,76 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+
+/// <summary>
+/// A fixed size ring of recent samples, once it is full each new sample overwrites the oldest one.
+/// Used for the rolling stats in the telemetry and latency tools
+/// </summary>
+/// <typeparam name="T">The type of sample to store</typeparam>
+template <typename T>
+class SampleRing
+{
+public:
+	SampleRing(size_t capacity) :
+		_samples(std::vector<T>()),
+		_capacity(capacity),
+		_next(0) {}
+	~SampleRing() = default;
+
+	/// <summary>
+	/// Adds a sample to the ring, overwriting the oldest one if the ring is full
+	/// </summary>
+	/// <param name="sample">The sample to add</param>
+	void Push(const T& sample) {
+		if (_samples.size() < _capacity) {
+			_samples.push_back(sample);
+		} else {
+			_samples[_next] = sample;
+		}
+		_next = (_next + 1) % _capacity;
+	}
+
+	/// <summary>
+	/// Removes all samples, keeping the storage for reuse
+	/// </summary>
+	void Clear() {
+		_samples.clear();
+		_next = 0;
+	}
+
+	/// <summary>
+	/// Invokes a callback for every sample in the ring, oldest first
+	/// </summary>
+	/// <param name="callback">The function to invoke with each sample</param>
+	template <typename Func>
+	void ForEach(const Func& callback) const {
+		// Once the ring has wrapped, the oldest sample is the next one to be overwritten
+		size_t start = _samples.size() < _capacity ? 0 : _next;
+		for (size_t ix = 0; ix < _samples.size(); ix++) {
+			callback(_samples[(start + ix) % _samples.size()]);
+		}
+	}
+
+	size_t GetCount() const { return _samples.size(); }
+	size_t GetCapacity() const { return _capacity; }
+
+protected:
+	std::vector<T> _samples;
+	size_t         _capacity;
+	size_t         _next;
+};
+
+/// <summary>
+/// Gets the value at the given percentile of a sorted list, using the nearest sample
+/// </summary>
+/// <param name="sorted">The values to search, sorted from smallest to largest</param>
+/// <param name="percentile">The percentile to get, in the range [0, 1]</param>
+/// <returns>The value at the percentile, or 0 if the list is empty</returns>
+template <typename V>
+inline V Percentile(const std::vector<V>& sorted, double percentile) {
+	if (sorted.empty()) {
+		return V(0);
+	}
+	size_t index = std::min((size_t)(percentile * (sorted.size() - 1) + 0.5), sorted.size() - 1);
+	return sorted[index];
+}
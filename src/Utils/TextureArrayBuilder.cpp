@@ -0,0 +1,86 @@
+#include "Utils/TextureArrayBuilder.h"
+#include <map>
+#include <algorithm>
+
+#include "Utils/ResourceManager/ResourceManager.h"
+#include "Logging.h"
+
+std::vector<Texture2DArray::Sptr> TextureArrayBuilder::Build(
+	const std::vector<Gameplay::Material::Sptr>& materials,
+	const Shader::Sptr& arrayShader,
+	uint32_t maxLayersPerPage)
+{
+	std::vector<Texture2DArray::Sptr> result;
+
+	if (maxLayersPerPage == 0) {
+		maxLayersPerPage = (uint32_t)ITexture::GetLimits().MAX_ARRAY_TEXTURE_LAYERS;
+	}
+
+	// Group materials by their shader, parameters and texture layouts, we use an ordered map so that
+	// pages are built in a consistent order between runs
+	std::map<uint64_t, std::vector<Gameplay::Material::Sptr>> groups;
+	for (const auto& material : materials) {
+		if (material == nullptr || material->GetShader() == arrayShader || !_CanBatch(material)) {
+			continue;
+		}
+		groups[material->_ComputeKey(true)].push_back(material);
+	}
+
+	int converted = 0;
+	for (auto& [key, group] : groups) {
+		// There's nothing to gain from batching a single material
+		if (group.size() < 2) {
+			continue;
+		}
+
+		for (size_t start = 0; start < group.size(); start += maxLayersPerPage) {
+			size_t end = std::min(start + (size_t)maxLayersPerPage, group.size());
+
+			// Create a page for each 2D texture uniform, every material in the group has the same set of
+			// uniforms so we can use the first one to find them
+			std::unordered_map<std::string, ITexture::Sptr> pages;
+			for (auto& [name, uniform] : group[start]->_uniforms) {
+				Texture2D::Sptr texture = std::dynamic_pointer_cast<Texture2D>(uniform.TextureAsset);
+				if (uniform.Location < 0 || !uniform.IsTextureResource() || texture == nullptr) {
+					continue;
+				}
+
+				Texture2DArrayDescription descr;
+				descr.HorizontalWrap      = texture->GetWrapS();
+				descr.VerticalWrap        = texture->GetWrapT();
+				descr.MinificationFilter  = texture->GetMinFilter();
+				descr.MagnificationFilter = texture->GetMagFilter();
+				descr.MaxAnisotropic      = texture->GetAnisoLevel();
+				for (size_t ix = start; ix < end; ix++) {
+					descr.Layers.push_back(std::dynamic_pointer_cast<Texture2D>(group[ix]->_uniforms[name].TextureAsset));
+				}
+
+				Texture2DArray::Sptr page = ResourceManager::CreateAsset<Texture2DArray>(descr);
+				pages[name] = page;
+				result.push_back(page);
+			}
+
+			for (size_t ix = start; ix < end; ix++) {
+				group[ix]->UseTextureArrays(arrayShader, pages, (int)(ix - start));
+				converted++;
+			}
+		}
+	}
+
+	LOG_INFO("Batched {} of {} materials into {} texture array pages", converted, materials.size(), result.size());
+	return result;
+}
+
+bool TextureArrayBuilder::_CanBatch(const Gameplay::Material::Sptr& material) {
+	bool hasTextures = false;
+	bool result = true;
+	material->EachTexture([&](const ITexture::Sptr& texture) {
+		Texture2D::Sptr texture2D = std::dynamic_pointer_cast<Texture2D>(texture);
+		if (texture2D != nullptr) {
+			hasTextures = true;
+			// Streamed textures may be missing their higher mips, so we can't copy them
+			result &= texture2D->GetResidentLevel() == 0 && !texture2D->IsStreaming();
+		}
+	});
+	return hasTextures && result;
+}
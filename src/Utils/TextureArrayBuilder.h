@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "Gameplay/Material.h"
+#include "Graphics/Texture2DArray.h"
+
+/// <summary>
+/// Groups materials that only differ by their 2D textures, and packs those textures into texture
+/// array pages so that the whole group can share a single shader and set of textures. Each material
+/// in a group keeps it's own layer index, which is passed to the shader per instance, allowing the
+/// renderer to draw the group without re-applying material state between draws
+/// 
+/// Materials are grouped when they share a shader, all non-texture parameters are equal, and every
+/// 2D texture has the same size, format, mip count and sampler state as the other materials in the group
+/// </summary>
+class TextureArrayBuilder {
+public:
+	TextureArrayBuilder() = delete;
+
+	/// <summary>
+	/// Groups the given materials and switches each group with more than one material over to the array shader,
+	/// creating texture array pages for their textures. Materials that can't be grouped are left untouched
+	/// </summary>
+	/// <param name="materials">The materials to try and group</param>
+	/// <param name="arrayShader">The shader to use for grouped materials, should declare sampler2DArray in place of sampler2D</param>
+	/// <param name="maxLayersPerPage">The maximum number of layers in a single page, or 0 to use the driver limit</param>
+	/// <returns>The texture array pages that were created</returns>
+	static std::vector<Texture2DArray::Sptr> Build(
+		const std::vector<Gameplay::Material::Sptr>& materials,
+		const Shader::Sptr& arrayShader,
+		uint32_t maxLayersPerPage = 0);
+
+protected:
+	/// <summary>
+	/// Returns true if all of the material's 2D textures are fully resident, and can be copied into an array
+	/// </summary>
+	static bool _CanBatch(const Gameplay::Material::Sptr& material);
+};
@@ -0,0 +1,470 @@
+#include "Utils/TextureCooker.h"
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <sstream>
+
+#include <stb_image.h>
+#include "Logging.h"
+
+#include "Graphics/CookedTexture.h"
+#include "Graphics/Texture2D.h"
+#include "Graphics/TextureCube.h"
+#include "Utils/BlockCompressor.h"
+#include "Utils/StringUtils.h"
+
+namespace fs = std::filesystem;
+
+bool TextureCooker::_isEnabled = true;
+bool TextureCooker::_isAutoCookEnabled = true;
+
+const std::string cookedExtension = ".ctex";
+
+// Lookup table for converting 8 bit sRGB values to linear floats
+static float SRGB_TO_LINEAR[256];
+static bool  isSrgbTableInit = false;
+
+inline void InitSrgbTable() {
+	if (!isSrgbTableInit) {
+		for (int ix = 0; ix < 256; ix++) {
+			float c = ix / 255.0f;
+			SRGB_TO_LINEAR[ix] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+		isSrgbTableInit = true;
+	}
+}
+
+inline uint8_t LinearToSrgb8(float value) {
+	value = std::clamp(value, 0.0f, 1.0f);
+	float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	return static_cast<uint8_t>(c * 255.0f + 0.5f);
+}
+
+// Replaces each level of a mip chain with it's block compressed equivalent, returns the PSNR of the top level
+inline double CompressMipChain(std::vector<std::vector<uint8_t>>& levels, uint32_t width, uint32_t height, int numChannels, const TextureCookSettings& settings) {
+	double psnr = 0.0;
+	std::vector<uint8_t> rgba;
+	for (size_t level = 0; level < levels.size(); level++) {
+		// The encoder always works on RGBA data, so expand our texels if needed
+		size_t texelCount = (size_t)width * height;
+		rgba.assign(texelCount * 4, 255);
+		for (size_t ix = 0; ix < texelCount; ix++) {
+			for (int c = 0; c < numChannels; c++) {
+				rgba[ix * 4 + c] = levels[level][ix * numChannels + c];
+			}
+		}
+
+		std::vector<uint8_t> compressed = BlockCompressor::Compress(rgba.data(), width, height, settings.Compression, settings.Quality);
+
+		// We only measure the top level, since it's the one that matters the most and the most expensive to decode
+		if (level == 0) {
+			std::vector<uint8_t> decoded = BlockCompressor::Decompress(compressed.data(), width, height, settings.Compression);
+			psnr = BlockCompressor::ComputePSNR(rgba.data(), decoded.data(), width, height, std::min(numChannels, BlockCompressor::GetChannelCount(settings.Compression)));
+		}
+
+		levels[level] = std::move(compressed);
+		width  = std::max(1u, width / 2);
+		height = std::max(1u, height / 2);
+	}
+	return psnr;
+}
+
+// Fills out the format fields of a cooked texture header based on our cook settings
+inline void SetHeaderFormat(CookedTexture::Header& header, int numChannels, const TextureCookSettings& settings) {
+	if (settings.Compression != TextureCompression::None) {
+		header.Format = GetInternalFormatForCompression(settings.Compression);
+		header.Layout = PixelFormat::Unknown;
+		header.Flags  = CookedTexture::FLAG_COMPRESSED;
+	} else {
+		header.Format = GetInternalFormatForChannels8(numChannels);
+		header.Layout = GetPixelFormatForChannels(numChannels);
+		header.Flags  = 0;
+	}
+	if (settings.GammaCorrectMips) {
+		header.Flags |= CookedTexture::FLAG_GAMMA_CORRECT_MIPS;
+	}
+	header.Type = PixelType::UByte;
+}
+
+bool TextureCooker::IsColorTexture(const std::string& sourceFile) {
+	static const char* dataHints[] = { "normal", "specular", "displacement", "height", "rough", "metal", "mask", "bump", "_ao" };
+
+	std::string name = fs::path(sourceFile).stem().string();
+	StringTools::ToLower(name);
+	for (const char* hint : dataHints) {
+		if (name.find(hint) != std::string::npos) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string TextureCooker::GetCookedPath(const std::string& sourceFile) {
+	// We append rather than replace the extension so that foo.png and foo.jpg don't collide
+	return sourceFile + cookedExtension;
+}
+
+bool TextureCooker::IsUpToDate(const std::vector<std::string>& sourceFiles, const std::string& cookedFile) {
+	std::error_code error;
+	if (!fs::exists(cookedFile, error)) {
+		return false;
+	}
+	fs::file_time_type cookedTime = fs::last_write_time(cookedFile, error);
+	for (const std::string& source : sourceFiles) {
+		// If the source is missing, the cooked file is all we have
+		if (fs::exists(source, error) && fs::last_write_time(source, error) > cookedTime) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::vector<std::vector<uint8_t>> TextureCooker::GenerateMipChain(const uint8_t* data, uint32_t width, uint32_t height, int numChannels, bool gammaCorrect) {
+	InitSrgbTable();
+
+	std::vector<std::vector<uint8_t>> result;
+	result.emplace_back(data, data + (size_t)width * height * numChannels);
+
+	// Alpha (and single/dual channel images, which are usually masks or data) are always filtered linearly
+	const int colorChannels = gammaCorrect && numChannels >= 3 ? 3 : 0;
+
+	std::vector<float> accumulator(numChannels);
+	while (width > 1 || height > 1) {
+		const std::vector<uint8_t>& source = result.back();
+		uint32_t nextWidth  = std::max(1u, width / 2);
+		uint32_t nextHeight = std::max(1u, height / 2);
+
+		std::vector<uint8_t> level((size_t)nextWidth * nextHeight * numChannels);
+		for (uint32_t y = 0; y < nextHeight; y++) {
+			// Determine the rows in the source that map to this texel, odd sizes will give us a 3 texel footprint
+			uint32_t y0 = (y * height) / nextHeight;
+			uint32_t y1 = std::max(y0 + 1, ((y + 1) * height) / nextHeight);
+
+			for (uint32_t x = 0; x < nextWidth; x++) {
+				uint32_t x0 = (x * width) / nextWidth;
+				uint32_t x1 = std::max(x0 + 1, ((x + 1) * width) / nextWidth);
+
+				std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+				for (uint32_t sy = y0; sy < y1; sy++) {
+					const uint8_t* row = source.data() + ((size_t)sy * width) * numChannels;
+					for (uint32_t sx = x0; sx < x1; sx++) {
+						const uint8_t* texel = row + (size_t)sx * numChannels;
+						for (int c = 0; c < numChannels; c++) {
+							accumulator[c] += c < colorChannels ? SRGB_TO_LINEAR[texel[c]] : texel[c] / 255.0f;
+						}
+					}
+				}
+
+				float weight = 1.0f / ((x1 - x0) * (y1 - y0));
+				uint8_t* target = level.data() + ((size_t)y * nextWidth + x) * numChannels;
+				for (int c = 0; c < numChannels; c++) {
+					float value = accumulator[c] * weight;
+					target[c] = c < colorChannels ? LinearToSrgb8(value) : static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+				}
+			}
+		}
+
+		result.push_back(std::move(level));
+		width  = nextWidth;
+		height = nextHeight;
+	}
+
+	return result;
+}
+
+bool TextureCooker::Cook2D(const std::string& sourceFile, const std::string& outFile, const TextureCookSettings& settings) {
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	int width, height, numChannels;
+	stbi_set_flip_vertically_on_load(settings.FlipVertically);
+	uint8_t* data = stbi_load(sourceFile.c_str(), &width, &height, &numChannels, settings.NumChannels);
+	if (data == nullptr) {
+		LOG_WARN("STBI Failed to load image from \"{}\"", sourceFile);
+		return false;
+	}
+	if (settings.NumChannels != 0) {
+		numChannels = settings.NumChannels;
+	}
+
+	CookedTexture::Header header = CookedTexture::Header();
+	header.NumFaces  = 1;
+	header.Width     = width;
+	header.Height    = height;
+	SetHeaderFormat(header, numChannels, settings);
+
+	std::vector<std::vector<uint8_t>> levels = GenerateMipChain(data, width, height, numChannels, settings.GammaCorrectMips);
+	stbi_image_free(data);
+	header.NumLevels = static_cast<uint32_t>(levels.size());
+
+	if (settings.Compression != TextureCompression::None) {
+		double psnr = CompressMipChain(levels, width, height, numChannels, settings);
+		LOG_TRACE("Compressed \"{}\" to {} ({}), PSNR: {:.2f}dB", sourceFile, ~settings.Compression, ~settings.Quality, psnr);
+	}
+
+	try {
+		CookedTexture::Save(outFile, header, levels);
+	} catch (const std::exception& e) {
+		LOG_WARN("Failed to write cooked texture \"{}\": {}", outFile, e.what());
+		return false;
+	}
+
+	auto endTime = std::chrono::high_resolution_clock::now();
+	LOG_TRACE("Cooked texture \"{}\" in {} ms ({}x{}, {} levels)", sourceFile, std::chrono::duration<float, std::milli>(endTime - startTime).count(), width, height, header.NumLevels);
+	return true;
+}
+
+bool TextureCooker::CookCube(const std::vector<std::string>& faceFiles, const std::string& outFile, const TextureCookSettings& settings) {
+	if (faceFiles.size() != 6) {
+		LOG_ERROR("Cubemaps require exactly 6 faces to cook");
+		return false;
+	}
+
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	// Stores the mip chain for each face
+	std::vector<std::vector<uint8_t>> faceLevels[6];
+	int size = 0;
+	int numChannels = settings.NumChannels;
+
+	for (int ix = 0; ix < 6; ix++) {
+		int width, height, fileChannels;
+		stbi_set_flip_vertically_on_load(settings.FlipVertically);
+		uint8_t* data = stbi_load(faceFiles[ix].c_str(), &width, &height, &fileChannels, numChannels);
+		if (data == nullptr) {
+			LOG_ERROR("STBI Failed to load image from \"{}\"", faceFiles[ix]);
+			return false;
+		}
+
+		// The first face determines our size and channel count, and all others must match
+		if (ix == 0) {
+			size = width;
+			numChannels = numChannels == 0 ? fileChannels : numChannels;
+		}
+		if (width != height || width != size) {
+			LOG_ERROR("Image loaded from \"{}\" was not square or did not match the size of the other faces", faceFiles[ix]);
+			stbi_image_free(data);
+			return false;
+		}
+
+		faceLevels[ix] = GenerateMipChain(data, width, height, numChannels, settings.GammaCorrectMips);
+		stbi_image_free(data);
+
+		if (settings.Compression != TextureCompression::None) {
+			double psnr = CompressMipChain(faceLevels[ix], width, height, numChannels, settings);
+			LOG_TRACE("Compressed \"{}\" to {} ({}), PSNR: {:.2f}dB", faceFiles[ix], ~settings.Compression, ~settings.Quality, psnr);
+		}
+	}
+
+	// Interleave the faces so that each level contains all 6 faces back to back
+	std::vector<std::vector<uint8_t>> levels(faceLevels[0].size());
+	for (size_t level = 0; level < levels.size(); level++) {
+		for (int face = 0; face < 6; face++) {
+			levels[level].insert(levels[level].end(), faceLevels[face][level].begin(), faceLevels[face][level].end());
+		}
+	}
+
+	CookedTexture::Header header = CookedTexture::Header();
+	header.NumFaces  = 6;
+	header.Width     = size;
+	header.Height    = size;
+	header.NumLevels = static_cast<uint32_t>(levels.size());
+	SetHeaderFormat(header, numChannels, settings);
+
+	try {
+		CookedTexture::Save(outFile, header, levels);
+	} catch (const std::exception& e) {
+		LOG_WARN("Failed to write cooked texture \"{}\": {}", outFile, e.what());
+		return false;
+	}
+
+	auto endTime = std::chrono::high_resolution_clock::now();
+	LOG_TRACE("Cooked cubemap \"{}\" in {} ms ({}x{}, {} levels)", outFile, std::chrono::duration<float, std::milli>(endTime - startTime).count(), size, size, header.NumLevels);
+	return true;
+}
+
+void TextureCooker::Benchmark(const std::string& textureDirectory, const std::string& cubemapDirectory) {
+	// Times how long it takes to create a texture, including waiting for the driver to finish any uploads
+	auto timeLoad = [](const std::function<void()>& load) {
+		glFinish();
+		auto start = std::chrono::high_resolution_clock::now();
+		load();
+		glFinish();
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	};
+
+	bool wasEnabled = _isEnabled;
+	bool wasAutoCook = _isAutoCookEnabled;
+	double totalSource = 0.0;
+	double totalCooked = 0.0;
+
+	LOG_INFO("Texture load times (stb_image + glGenerateTextureMipmap vs cooked):");
+
+	if (fs::is_directory(textureDirectory)) {
+		for (const auto& entry : fs::directory_iterator(textureDirectory)) {
+			std::string extension = entry.path().extension().string();
+			if (extension != ".png" && extension != ".jpg" && extension != ".tga" && extension != ".bmp") {
+				continue;
+			}
+			std::string path = entry.path().string();
+
+			// Make sure the cooked version exists before we start timing
+			std::string cookedPath = GetCookedPath(path);
+			Texture2DDescription description;
+			description.IsColor = IsColorTexture(path);
+
+			TextureCookSettings settings;
+			settings.NumChannels = 4;
+			settings.GammaCorrectMips = description.IsColor;
+			if (!IsUpToDate({ path }, cookedPath)) {
+				Cook2D(path, cookedPath, settings);
+			}
+
+			_isEnabled = false;
+			double sourceTime = timeLoad([&]() { Texture2D::LoadFromFile(path, description); });
+			_isEnabled = true;
+			_isAutoCookEnabled = false;
+			double cookedTime = timeLoad([&]() { Texture2D::LoadFromFile(path, description); });
+			_isAutoCookEnabled = wasAutoCook;
+
+			totalSource += sourceTime;
+			totalCooked += cookedTime;
+			LOG_INFO("\t{:<40} {:>8.2f} ms -> {:>8.2f} ms", path, sourceTime, cookedTime);
+		}
+	}
+
+	if (fs::is_directory(cubemapDirectory)) {
+		for (const auto& entry : fs::directory_iterator(cubemapDirectory)) {
+			if (!entry.is_directory()) {
+				continue;
+			}
+			// Find the PosX face so we can use it as the base name for the cubemap
+			for (const auto& file : fs::directory_iterator(entry.path())) {
+				std::string stem = file.path().stem().string();
+				if (stem.size() < 5 || stem.substr(stem.size() - 5) != "_PosX") {
+					continue;
+				}
+				fs::path basePath = file.path().parent_path() / (stem.substr(0, stem.size() - 5) + file.path().extension().string());
+				std::string path = basePath.string();
+
+				_isEnabled = false;
+				double sourceTime = timeLoad([&]() { std::make_shared<TextureCube>(path); });
+				_isEnabled = true;
+				// Cook outside of the timed section
+				std::make_shared<TextureCube>(path);
+				_isAutoCookEnabled = false;
+				double cookedTime = timeLoad([&]() { std::make_shared<TextureCube>(path); });
+				_isAutoCookEnabled = wasAutoCook;
+
+				totalSource += sourceTime;
+				totalCooked += cookedTime;
+				LOG_INFO("\t{:<40} {:>8.2f} ms -> {:>8.2f} ms", path, sourceTime, cookedTime);
+			}
+		}
+	}
+
+	LOG_INFO("\t{:<40} {:>8.2f} ms -> {:>8.2f} ms", "Total", totalSource, totalCooked);
+
+	_isEnabled = wasEnabled;
+	_isAutoCookEnabled = wasAutoCook;
+}
+
+int TextureCooker::CheckCompressionQuality(const std::string& textureDirectory, const std::vector<TextureCompression>& formats, CompressionQuality quality, double minPsnr) {
+	if (!fs::is_directory(textureDirectory)) {
+		LOG_ERROR("Texture directory \"{}\" does not exist", textureDirectory);
+		return 1;
+	}
+
+	int failures = 0;
+	int numChecked = 0;
+	LOG_INFO("Block compression PSNR ({}, minimum {:.1f}dB):", ~quality, minPsnr);
+
+	for (const auto& entry : fs::directory_iterator(textureDirectory)) {
+		std::string extension = entry.path().extension().string();
+		if (extension != ".png" && extension != ".jpg" && extension != ".tga" && extension != ".bmp") {
+			continue;
+		}
+		std::string path = entry.path().string();
+
+		int width, height, numChannels;
+		stbi_set_flip_vertically_on_load(false);
+		uint8_t* data = stbi_load(path.c_str(), &width, &height, &numChannels, 4);
+		if (data == nullptr) {
+			LOG_ERROR("STBI Failed to load image from \"{}\"", path);
+			failures++;
+			continue;
+		}
+
+		for (TextureCompression format : formats) {
+			std::vector<uint8_t> compressed = BlockCompressor::Compress(data, width, height, format, quality);
+			std::vector<uint8_t> decoded = BlockCompressor::Decompress(compressed.data(), width, height, format);
+			double psnr = BlockCompressor::ComputePSNR(data, decoded.data(), width, height, BlockCompressor::GetChannelCount(format));
+			numChecked++;
+
+			if (psnr < minPsnr) {
+				LOG_ERROR("\t{:<40} {:<4} {:>7.2f}dB", path, ~format, psnr);
+				failures++;
+			} else {
+				LOG_INFO("\t{:<40} {:<4} {:>7.2f}dB", path, ~format, psnr);
+			}
+		}
+		stbi_image_free(data);
+	}
+
+	LOG_INFO("{} of {} checks were below {:.1f}dB or failed to load", failures, numChecked, minPsnr);
+
+	// A run that checked nothing can't vouch for the compressor, so treat it as a failure
+	if (numChecked == 0) {
+		LOG_ERROR("No images in \"{}\" were checked", textureDirectory);
+		return std::max(failures, 1);
+	}
+	return failures;
+}
+
+int TextureCooker::RunQualityCheckFromCommandLine(int argc, char** argv) {
+	std::string directory = "textures";
+	std::vector<TextureCompression> formats = {
+		TextureCompression::BC1, TextureCompression::BC3, TextureCompression::BC4, TextureCompression::BC5, TextureCompression::BC7
+	};
+	CompressionQuality quality = CompressionQuality::Normal;
+	double minPsnr = 30.0;
+
+	for (int ix = 1; ix < argc; ix++) {
+		std::string arg = argv[ix];
+		size_t split = arg.find('=');
+		if (split == std::string::npos) {
+			continue;
+		}
+		std::string key = arg.substr(0, split);
+		std::string value = arg.substr(split + 1);
+
+		try {
+			if (key == "dir") {
+				directory = value;
+			} else if (key == "formats") {
+				formats.clear();
+				std::stringstream stream(value);
+				std::string name;
+				while (std::getline(stream, name, ',')) {
+					TextureCompression format = ParseTextureCompression(name, TextureCompression::None);
+					if (format == TextureCompression::None) {
+						LOG_ERROR("Unknown compression format \"{}\"", name);
+						return 1;
+					}
+					formats.push_back(format);
+				}
+			}
+			else if (key == "quality")  quality = ParseCompressionQuality(value, CompressionQuality::Normal);
+			else if (key == "min_psnr") minPsnr = std::stod(value);
+			else LOG_WARN("Unknown texture quality argument \"{}\"", key);
+		} catch (const std::exception&) {
+			LOG_ERROR("Invalid value \"{}\" for texture quality argument \"{}\"", value, key);
+			return 1;
+		}
+	}
+
+	return CheckCompressionQuality(directory, formats, quality, minPsnr) > 0 ? 1 : 0;
+}
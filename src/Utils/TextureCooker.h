@@ -0,0 +1,136 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Graphics/TextureEnums.h"
+
+/// <summary>
+/// Settings that control how a texture is cooked
+/// </summary>
+struct TextureCookSettings {
+	/// <summary>
+	/// The number of channels to store, or 0 to use the number of channels in the source image
+	/// </summary>
+	int  NumChannels = 0;
+	/// <summary>
+	/// True if the RGB channels should be treated as sRGB data when filtering mips, so that
+	/// averaging happens in linear space and mips don't get darker as they get smaller. Only
+	/// enable this for color textures, data like normals must be filtered as is
+	/// </summary>
+	bool GammaCorrectMips = false;
+	/// <summary>
+	/// True if the image should be flipped vertically, to match OpenGL's bottom-up texture coordinates
+	/// </summary>
+	bool FlipVertically = true;
+	/// <summary>
+	/// The block compression format to store the texture in, or None to store uncompressed texels
+	/// </summary>
+	TextureCompression Compression = TextureCompression::None;
+	/// <summary>
+	/// The quality level to use when block compressing the texture
+	/// </summary>
+	CompressionQuality Quality = CompressionQuality::Normal;
+};
+
+/// <summary>
+/// Converts source images (PNG, JPG, etc...) into cooked textures, which store a pre-flipped image
+/// along with a complete mip chain that has been filtered offline. Texture2D and TextureCube will
+/// cook textures the first time they are loaded (similar to how OptimizedObjLoader works), and will
+/// load the cooked version on subsequent runs
+/// </summary>
+class TextureCooker {
+public:
+	TextureCooker() = delete;
+
+	/// <summary>
+	/// Gets the path that the cooked version of the given source file will be stored at
+	/// </summary>
+	/// <param name="sourceFile">The path to the source image</param>
+	static std::string GetCookedPath(const std::string& sourceFile);
+
+	/// <summary>
+	/// Checks whether a cooked file exists and is newer than all of its source files
+	/// </summary>
+	/// <param name="sourceFiles">The source images that the cooked file was generated from</param>
+	/// <param name="cookedFile">The path to the cooked file</param>
+	static bool IsUpToDate(const std::vector<std::string>& sourceFiles, const std::string& cookedFile);
+
+	/// <summary>
+	/// Guesses whether an image holds colors, rather than data like normals or masks, based on it's name.
+	/// Files with names containing "normal", "specular", "displacement", "height", "rough", "metal", "mask",
+	/// "bump" or "_ao" are treated as data, everything else is treated as color
+	/// </summary>
+	/// <param name="sourceFile">The path to the source image</param>
+	static bool IsColorTexture(const std::string& sourceFile);
+
+	/// <summary>
+	/// Cooks a single image into a 2D cooked texture
+	/// </summary>
+	/// <param name="sourceFile">The path to the image to load</param>
+	/// <param name="outFile">The path to write the cooked texture to</param>
+	/// <param name="settings">The settings to use when cooking</param>
+	/// <returns>True if the texture was cooked successfully</returns>
+	static bool Cook2D(const std::string& sourceFile, const std::string& outFile, const TextureCookSettings& settings = TextureCookSettings());
+	/// <summary>
+	/// Cooks 6 square images into a cubemap cooked texture
+	/// </summary>
+	/// <param name="faceFiles">The paths to the faces, in the order PosX, NegX, PosY, NegY, PosZ, NegZ</param>
+	/// <param name="outFile">The path to write the cooked texture to</param>
+	/// <param name="settings">The settings to use when cooking</param>
+	/// <returns>True if the texture was cooked successfully</returns>
+	static bool CookCube(const std::vector<std::string>& faceFiles, const std::string& outFile, const TextureCookSettings& settings = TextureCookSettings());
+
+	/// <summary>
+	/// Generates a full mip chain for an 8 bit per channel image, using a box filter that handles
+	/// non power of two sizes. The first entry of the result is a copy of the input image
+	/// </summary>
+	/// <param name="data">The top level image data</param>
+	/// <param name="width">The width of the image in texels</param>
+	/// <param name="height">The height of the image in texels</param>
+	/// <param name="numChannels">The number of 8 bit channels per texel</param>
+	/// <param name="gammaCorrect">True to filter the RGB channels in linear space</param>
+	static std::vector<std::vector<uint8_t>> GenerateMipChain(const uint8_t* data, uint32_t width, uint32_t height, int numChannels, bool gammaCorrect);
+
+	/// <summary>
+	/// Enables or disables loading cooked textures, when disabled textures will be
+	/// decoded from their source images using stb_image
+	/// </summary>
+	static void SetEnabled(bool enabled) { _isEnabled = enabled; }
+	static bool IsEnabled() { return _isEnabled; }
+	/// <summary>
+	/// Enables or disables automatically cooking textures that are missing or out of date when they are loaded
+	/// </summary>
+	static void SetAutoCookEnabled(bool enabled) { _isAutoCookEnabled = enabled; }
+	static bool IsAutoCookEnabled() { return _isAutoCookEnabled; }
+
+	/// <summary>
+	/// Compares the time taken to load every texture in the given directories from their source images
+	/// versus from cooked textures, and logs the results. Must be called with an active OpenGL context
+	/// </summary>
+	/// <param name="textureDirectory">The directory containing 2D textures</param>
+	/// <param name="cubemapDirectory">The directory containing a folder per cubemap</param>
+	static void Benchmark(const std::string& textureDirectory = "textures", const std::string& cubemapDirectory = "cubemaps");
+
+	/// <summary>
+	/// Compresses every image in a directory to each of the given formats, and measures the PSNR of the
+	/// decoded result against the source image. Runs entirely on the CPU, so no OpenGL context is needed
+	/// </summary>
+	/// <param name="textureDirectory">The directory containing the images to check</param>
+	/// <param name="formats">The block formats to compress each image to</param>
+	/// <param name="quality">The quality level to compress with</param>
+	/// <param name="minPsnr">The lowest PSNR that is considered passing, in decibels</param>
+	/// <returns>The number of image and format pairs that fell below minPsnr plus the number of images that failed to load, or 1 if nothing was checked</returns>
+	static int CheckCompressionQuality(const std::string& textureDirectory, const std::vector<TextureCompression>& formats, CompressionQuality quality, double minPsnr);
+	/// <summary>
+	/// Runs CheckCompressionQuality headless with arguments in the form key=value, for use in CI:
+	///
+	///     GameEngine --texture-quality dir=textures formats=BC1,BC7 quality=Normal min_psnr=30
+	/// </summary>
+	/// <returns>The exit code for the process, non zero if any image fell below the threshold</returns>
+	static int RunQualityCheckFromCommandLine(int argc, char** argv);
+
+protected:
+	static bool _isEnabled;
+	static bool _isAutoCookEnabled;
+};
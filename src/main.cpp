@@ -11,6 +11,7 @@
 #include <typeindex>
 #include <optional>
 #include <string>
+#include <chrono>
 
 // GLM math library
 #include <GLM/glm.hpp>
@@ -19,6 +20,9 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <GLM/gtx/common.hpp> // for fmod (floating modulus)
 
+// Bullet
+#include <LinearMath/btThreads.h>
+
 // Graphics
 #include "Graphics/IndexBuffer.h"
 #include "Graphics/VertexBuffer.h"
@@ -26,9 +30,14 @@
 #include "Graphics/Shader.h"
 #include "Graphics/Texture2D.h"
 #include "Graphics/TextureCube.h"
+#include "Graphics/Texture2DArray.h"
 #include "Graphics/VertexTypes.h"
 #include "Graphics/Font.h"
 #include "Graphics/GuiBatcher.h"
+#include "Graphics/TextureStreamer.h"
+#include "Graphics/FramePacer.h"
+#include "Utils/TextureArrayBuilder.h"
+#include "Utils/TextureCooker.h"
 
 // Utilities
 #include "Utils/MeshBuilder.h"
@@ -40,6 +49,10 @@
 #include "Utils/JsonGlmHelpers.h"
 #include "Utils/StringUtils.h"
 #include "Utils/GlmDefines.h"
+#include "Utils/LatencyTracker.h"
+#include "Utils/Profiler.h"
+#include "Utils/FrameTelemetry.h"
+#include "Graphics/GpuProfiler.h"
 
 // Gameplay
 #include "Gameplay/Material.h"
@@ -65,6 +78,12 @@
 #include "Gameplay/Physics/Colliders/PlaneCollider.h"
 #include "Gameplay/Physics/Colliders/SphereCollider.h"
 #include "Gameplay/Physics/Colliders/ConvexMeshCollider.h"
+#include "Gameplay/Physics/Colliders/TriangleMeshCollider.h"
+#include "Gameplay/Physics/ShapeCache.h"
+#include "Gameplay/Physics/PhysicsSnapshot.h"
+#include "Gameplay/StressBenchmark.h"
+#include "Gameplay/RenderSnapshot.h"
+#include "Gameplay/SimulationThread.h"
 #include "Gameplay/Physics/TriggerVolume.h"
 #include "Graphics/DebugDraw.h"
 #include "Gameplay/Components/TriggerVolumeEnterBehaviour.h"
@@ -142,8 +161,9 @@ void GlfwWindowResizedCallback(GLFWwindow* window, int width, int height) {
 /// Handles intializing GLFW, should be called before initGLAD, but after Logger::Init()
 /// Also handles creating the GLFW window
 /// </summary>
+/// <param name="visible">False to create the window hidden, ex for headless checks that only need a GL context</param>
 /// <returns>True if GLFW was initialized, false if otherwise</returns>
-bool initGLFW() {
+bool initGLFW(bool visible = true) {
 	// Initialize GLFW
 	if (glfwInit() == GLFW_FALSE) {
 		LOG_ERROR("Failed to initialize GLFW");
@@ -151,6 +171,7 @@ bool initGLFW() {
 	}
 
 	//Create a new GLFW window and make it current
+	glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
 	window = glfwCreateWindow(windowSize.x, windowSize.y, windowTitle.c_str(), nullptr, nullptr);
 	glfwMakeContextCurrent(window);
 	
@@ -202,6 +223,7 @@ bool DrawSaveLoadImGui(Scene::Sptr& scene, std::string& path) {
 		// overwrite the existing scene!
 		scene = nullptr;
 
+		FrameTelemetry::Mark("Scene Load");
 		std::string newFilename = std::filesystem::path(path).stem().string() + "-manifest.json";
 		ResourceManager::LoadManifest(newFilename);
 		scene = Scene::Load(path);
@@ -264,6 +286,7 @@ void DrawMaterialsWindow() {
 /// handles creating or loading the scene
 /// </summary>
 void CreateScene() {
+	PROFILE_SCOPE("CreateScene");
 	bool loadScene = false;  
 	// For now we can use a toggle to generate our scene vs load from file
 	if (loadScene) {
@@ -288,6 +311,12 @@ void CreateScene() {
 				{ ShaderPartType::Fragment, "shaders/fragment_shaders/frag_blinn_phong_textured.glsl" }
 			});
 
+			// Same as the basic shader, but samples from texture arrays so that materials can share textures
+			Shader::Sptr basicArrayShader = ResourceManager::CreateAsset<Shader>(std::unordered_map<ShaderPartType, std::string>{
+				{ ShaderPartType::Vertex, "shaders/vertex_shaders/basic.glsl" },
+				{ ShaderPartType::Fragment, "shaders/fragment_shaders/frag_blinn_phong_texture_array.glsl" }
+			});
+
 			// This shader handles our basic materials without reflections (cause they expensive)
 			Shader::Sptr specShader = ResourceManager::CreateAsset<Shader>(std::unordered_map<ShaderPartType, std::string>{
 				{ ShaderPartType::Vertex, "shaders/vertex_shaders/basic.glsl" },
@@ -332,14 +361,22 @@ void CreateScene() {
 		MeshResource::Sptr stagePillarMesh = ResourceManager::CreateAsset<MeshResource>("stageObjs/stage_pillar.obj");
 		MeshResource::Sptr stagePillar2Mesh = ResourceManager::CreateAsset<MeshResource>("stageObjs/stage_pillar2.obj");
 
-		// Load in some textures
-		Texture2D::Sptr    boxTexture = ResourceManager::CreateAsset<Texture2D>("textures/box-diffuse.png");
-		Texture2D::Sptr    boxSpec    = ResourceManager::CreateAsset<Texture2D>("textures/box-specular.png");
-		Texture2D::Sptr    monkeyTex  = ResourceManager::CreateAsset<Texture2D>("textures/monkey-uvMap.png");
-		Texture2D::Sptr    leafTex    = ResourceManager::CreateAsset<Texture2D>("textures/leaves.png");
-		Texture2D::Sptr	   catcusTex = ResourceManager::CreateAsset<Texture2D>("textures/cattusGood.png");
-		Texture2D::Sptr	   mainCharTex = ResourceManager::CreateAsset<Texture2D>("textures/Char.png");
-			//Stage Textures
+		// Load in some textures, world textures are streamed in as they get closer to the camera
+		Texture2DDescription streamedDesc = Texture2DDescription();
+		streamedDesc.Streaming = true;
+		auto loadStreamed = [&](const std::string& path) {
+			streamedDesc.Filename = path;
+			streamedDesc.IsColor  = TextureCooker::IsColorTexture(path);
+			return ResourceManager::CreateAsset<Texture2D>(streamedDesc);
+		};
+
+		Texture2D::Sptr    boxTexture = loadStreamed("textures/box-diffuse.png");
+		Texture2D::Sptr    boxSpec    = loadStreamed("textures/box-specular.png");
+		Texture2D::Sptr    monkeyTex  = loadStreamed("textures/monkey-uvMap.png");
+		Texture2D::Sptr    leafTex    = loadStreamed("textures/leaves.png");
+		Texture2D::Sptr	   catcusTex = loadStreamed("textures/cattusGood.png");
+		Texture2D::Sptr	   mainCharTex = loadStreamed("textures/Char.png");
+			//Stage Textures, these get packed into texture arrays below so they can't be streamed
 		Texture2D::Sptr    sandTexture = ResourceManager::CreateAsset<Texture2D>("textures/sandFloor.png");
 		Texture2D::Sptr    rockFloorTexture = ResourceManager::CreateAsset<Texture2D>("textures/rockyFloor.png");
 		Texture2D::Sptr    rockFormationTexture = ResourceManager::CreateAsset<Texture2D>("textures/bigRock.png");
@@ -523,6 +560,10 @@ void CreateScene() {
 			bridgeMaterial->Set("u_Material.Shininess", 0.1f);
 		}
 
+		// The stage materials only differ by their textures, so we pack them into texture arrays
+		// so they can be drawn back to back without re-applying the material
+		TextureArrayBuilder::Build({ sandMaterial, rockFloorMaterial, rockPillarMaterial, rockWallMaterial, bridgeMaterial }, basicArrayShader);
+
 
 		// Create some lights for our scene
 		scene->Lights.resize(3);
@@ -1445,11 +1486,27 @@ void arrive(GameObject::Sptr object, GameObject::Sptr target, float deltaT)
 }
 
 
-int main() {
+int main(int argc, char** argv) {
 	Logger::Init(); // We'll borrow the logger from the toolkit, but we need to initialize it
 
+	// The stress benchmark runs headless, so it needs to happen before we create a window
+	if (argc > 1 && std::string(argv[1]) == "--benchmark") {
+		int result = StressBenchmark::RunFromCommandLine(argc - 1, argv + 1);
+		Logger::Uninitialize();
+		return result;
+	}
+	// Block compression quality is checked on the CPU, so this can also run headless in CI
+	if (argc > 1 && std::string(argv[1]) == "--texture-quality") {
+		int result = TextureCooker::RunQualityCheckFromCommandLine(argc - 1, argv + 1);
+		Logger::Uninitialize();
+		return result;
+	}
+
+	// The GPU profiler check only needs a GL context, so it gets a hidden window
+	bool gpuProfileCheck = argc > 1 && std::string(argv[1]) == "--gpu-profile-check";
+
 	//Initialize GLFW
-	if (!initGLFW())
+	if (!initGLFW(!gpuProfileCheck))
 		return 1;
 
 	//Initialize GLAD
@@ -1464,12 +1521,38 @@ int main() {
 	// Initialize our ImGui helper
 	ImGuiHelper::Init(window);
 
+	// Name the main thread for the profiler's flame graph, and add the GPU's timeline next to it
+	Profiler::SetThreadName("Main");
+	GpuProfiler::Init();
+
+	// Makes sure GPU timings get resolved, this runs on whatever driver we have so it can be used in CI (ex on llvmpipe)
+	if (gpuProfileCheck) {
+		int result = GpuProfiler::RunCheckFromCommandLine(argc - 1, argv + 1);
+		ImGuiHelper::Cleanup();
+		GpuProfiler::Cleanup();
+		Profiler::Cleanup();
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		Logger::Uninitialize();
+		return result;
+	}
+
+	// Capture everything from here until the end of the first frame, so we can see what startup spends it's time on
+	bool traceStartup = argc > 1 && std::string(argv[1]) == "--trace-startup";
+	if (traceStartup) {
+		Profiler::BeginCapture();
+	}
+
 	// Initialize our resource manager
 	ResourceManager::Init();
 
+	// Start up the texture streaming thread
+	TextureStreamer::Init();
+
 	// Register all our resource types so we can load them from manifest files
 	ResourceManager::RegisterType<Texture2D>();
 	ResourceManager::RegisterType<TextureCube>();
+	ResourceManager::RegisterType<Texture2DArray>();
 	ResourceManager::RegisterType<Shader>();
 	ResourceManager::RegisterType<Material>();
 	ResourceManager::RegisterType<MeshResource>();
@@ -1531,6 +1614,8 @@ int main() {
 		glm::mat4 u_Model;
 		// Normal Matrix for transforming normals
 		glm::mat4 u_NormalMatrix;
+		// The layer to sample from for materials that use texture arrays
+		int       u_TextureLayer;
 	};
 
 	// This uniform buffer will hold all our instance level uniforms, to be shared between shaders
@@ -1556,6 +1641,24 @@ int main() {
 	BulletDebugMode physicsDebugMode = BulletDebugMode::None;
 	float playbackSpeed = 1.0f;
 
+	// Ring of recent physics states for testing rollback, only recorded while enabled
+	PhysicsSnapshotRing physicsSnapshots(120);
+	bool recordPhysicsSnapshots = false;
+	int rollbackFrames = 10;
+	// Compared by serial rather than address, since a replacement scene can be allocated where the old one was
+	uint64_t snapshotScene = 0;
+
+	// When pipelining, the next frame is simulated on another thread while we draw the last one from a snapshot
+	RenderSnapshot renderSnapshot;
+	SimulationThread simulationThread;
+	bool pipelineSimulation = false;
+
+	// The profiler only records while its window is open
+	bool isProfilerOpen = false;
+
+	// Where input recordings are saved to and replayed from
+	char inputRecordingPath[256] = "input.rec";
+
 	nlohmann::json editorSceneState;
 
 	GameObject::Sptr player1 = scene->FindObjectByName("Player 1");
@@ -1564,9 +1667,26 @@ int main() {
 	bool arriving = false;
 
 
+	// Make sure we know what the swap interval is, instead of leaving it up to the driver
+	FramePacer::SetVSync(true);
+
+	// Everything up to here is startup, tag it so it's not mixed in with the frames after it
+	FrameTelemetry::Mark("Startup");
+
 	///// Game loop /////
 	while (!glfwWindowShouldClose(window)) {
-		
+		// Wait for the GPU to catch up (and optionally until the latest time we can start) before we read any input
+		FramePacer::BeginFrame();
+		// The frame we're about to reuse the GPU queries of is done now, so read back it's timings
+		GpuProfiler::BeginFrame();
+
+		// Finish simulating the last frame if it was pipelined, nothing can touch the scene until that's done
+		simulationThread.Wait();
+		// The simulation reads input, so we can only move input on to the next frame once it's done
+		InputEngine::EndFrame();
+		// Collect the last frame's timings, including the simulation we just waited on
+		Profiler::EndFrame();
+
 		glfwPollEvents();
 		ImGuiHelper::StartFrame();
 		
@@ -1577,6 +1697,17 @@ int main() {
 		// Draw our material properties window!
 		DrawMaterialsWindow();
 
+		if (isProfilerOpen) {
+			if (ImGui::Begin("Profiler", &isProfilerOpen)) {
+				GpuProfiler::RenderImGui();
+				Profiler::RenderImGui();
+			}
+			ImGui::End();
+			if (!isProfilerOpen) {
+				Profiler::SetEnabled(false);
+			}
+		}
+
 		// Showcasing how to use the imGui library!
 		bool isDebugWindowOpen = ImGui::Begin("Debugging");
 		if (isDebugWindowOpen) {
@@ -1584,6 +1715,7 @@ int main() {
 			static char buttonLabel[64];
 			sprintf_s(buttonLabel, "%s###playmode", scene->IsPlaying ? "Exit Play Mode" : "Enter Play Mode");
 			if (ImGui::Button(buttonLabel)) {
+				PROFILE_SCOPE("Toggle Play Mode");
 				// Save scene so it can be restored when exiting play mode
 				if (!scene->IsPlaying) {
 					editorSceneState = scene->ToJson();
@@ -1601,6 +1733,7 @@ int main() {
 					scene->Window = window;
 					scene->Awake();
 				}
+				FrameTelemetry::Mark(scene->IsPlaying ? "Enter Play Mode" : "Exit Play Mode");
 			}
 
 			ImGui::Separator();
@@ -1637,10 +1770,127 @@ int main() {
 			}
 			LABEL_LEFT(ImGui::SliderFloat, "Playback Speed:    ", &playbackSpeed, 0.0f, 10.0f);
 			ImGui::Separator();
+			if (ImGui::CollapsingHeader("Texture Streaming")) {
+				TextureStreamer::RenderImGui();
+			}
+			if (ImGui::CollapsingHeader("Simulation")) {
+				float stepRate = 1.0f / scene->GetFixedTimeStep();
+				if (LABEL_LEFT(ImGui::SliderFloat, "Step Rate (Hz)", &stepRate, 10.0f, 240.0f, "%.0f")) {
+					scene->SetFixedTimeStep(1.0f / stepRate);
+				}
+				int maxSteps = scene->GetMaxSimulationSteps();
+				if (LABEL_LEFT(ImGui::SliderInt, "Max Steps/Frame", &maxSteps, 1, 15)) {
+					scene->SetMaxSimulationSteps(maxSteps);
+				}
+				ImGui::Text("Steps last frame: %d", scene->GetLastSimulationSteps());
+				ImGui::Text("Interpolation: %.2f", scene->GetInterpolationAlpha());
+				if (ImGui::Checkbox("Pipelined", &pipelineSimulation)) {
+					if (pipelineSimulation) {
+						simulationThread.Start();
+					} else {
+						simulationThread.Stop();
+					}
+				}
+				if (ImGui::IsItemHovered()) {
+					ImGui::SetTooltip("Simulates the next frame on a worker thread while this one is drawn, adds a frame of latency.\nFrames with physics debug drawing are never pipelined");
+				}
+				ImGui::Text("Simulation: %.2f ms, waited %.2f ms", simulationThread.GetLastWorkMs(), simulationThread.GetLastWaitMs());
+				ImGui::Text("Snapshot extraction: %.3f ms", renderSnapshot.GetExtractTimeMs());
+			}
+			if (ImGui::CollapsingHeader("Physics Threading")) {
+				ImGui::Text("Scene world: %s", scene->IsPhysicsMultithreaded() ? "Multithreaded" : "Single threaded");
+				int physicsThreads = Scene::GetPhysicsThreadCount();
+				if (LABEL_LEFT(ImGui::SliderInt, "Threads", &physicsThreads, 1, BT_MAX_THREAD_COUNT)) {
+					Scene::SetPhysicsThreadCount(physicsThreads);
+				}
+				if (ImGui::Button("Run Threading Benchmark")) {
+					Scene::BenchmarkPhysicsThreading();
+				}
+			}
+			if (ImGui::CollapsingHeader("Collision Shape Cache")) {
+				ShapeCache::RenderImGui();
+			}
+			if (ImGui::CollapsingHeader("Physics Snapshots")) {
+				ImGui::Checkbox("Record", &recordPhysicsSnapshots);
+				ImGui::Text("Frames: %d / %d (%.2f KB)", physicsSnapshots.GetCount(), physicsSnapshots.GetCapacity(), physicsSnapshots.GetMemoryUsage() / 1024.0f);
+				LABEL_LEFT(ImGui::SliderInt, "Rollback Frames", &rollbackFrames, 1, physicsSnapshots.GetCapacity() - 1);
+				if (ImGui::Button("Rollback and Resimulate")) {
+					// Restores an older step and simulates back up to the current one, reporting how long it took
+					uint64_t targetStep = scene->GetSimulationStep() - rollbackFrames;
+					const PhysicsSnapshot* snapshot = physicsSnapshots.Find(targetStep);
+					if (snapshot != nullptr) {
+						size_t bodyCount = snapshot->GetBodyCount();
+						auto startTime = std::chrono::high_resolution_clock::now();
+						if (scene->RestorePhysicsSnapshot(*snapshot)) {
+							// The re-simulated steps get recorded again by the post step callback
+							physicsSnapshots.DiscardAfter(targetStep);
+							scene->ResimulatePhysics(rollbackFrames, scene->GetFixedTimeStep());
+						}
+						auto endTime = std::chrono::high_resolution_clock::now();
+						LOG_INFO("Rolled back and resimulated {} frames ({} bodies) in {:.3f} ms", rollbackFrames, bodyCount,
+							std::chrono::duration<double, std::milli>(endTime - startTime).count());
+					} else {
+						LOG_WARN("Frame {} is not in the snapshot ring", targetStep);
+					}
+				}
+			}
+			if (ImGui::CollapsingHeader("Input Recording")) {
+				// Replays are only deterministic if they start from the same scene state as the recording did
+				ImGui::InputText("File", inputRecordingPath, 256);
+				if (InputEngine::IsRecording()) {
+					ImGui::Text("Recording: %d frames (%.2f KB)", (int)InputEngine::GetRecordedFrameCount(), InputEngine::GetRecordingSize() / 1024.0f);
+					if (ImGui::Button("Stop Recording")) {
+						InputEngine::StopRecording();
+					}
+				} else if (InputEngine::IsReplaying()) {
+					ImGui::Text("Replaying: frame %d / %d", (int)InputEngine::GetReplayFrame(), (int)InputEngine::GetReplayFrameCount());
+					if (ImGui::Button("Stop Replay")) {
+						InputEngine::StopReplay();
+					}
+				} else {
+					if (ImGui::Button("Record")) {
+						InputEngine::StartRecording(inputRecordingPath);
+					}
+					ImGui::SameLine();
+					if (ImGui::Button("Replay")) {
+						InputEngine::StartReplay(inputRecordingPath);
+					}
+				}
+			}
+			if (ImGui::CollapsingHeader("Frame Pacing")) {
+				FramePacer::RenderImGui();
+			}
+			if (ImGui::Checkbox("Show Profiler", &isProfilerOpen)) {
+				Profiler::SetEnabled(isProfilerOpen);
+			}
+			if (ImGui::CollapsingHeader("Input Latency")) {
+				LatencyTracker::RenderImGui();
+			}
+			if (ImGui::CollapsingHeader("Frame Telemetry")) {
+				FrameTelemetry::RenderImGui();
+			}
+			if (ImGui::Button("Run Physics Benchmark")) {
+				// Compares convex and BVH mesh shapes on the stage geometry, results go to the log
+				std::vector<MeshResource::Sptr> stageMeshes;
+				ResourceManager::Each<MeshResource>([&](const MeshResource::Sptr& mesh) {
+					if (mesh->Filename.rfind("stageObjs/", 0) == 0) {
+						stageMeshes.push_back(mesh);
+					}
+				});
+				TriangleMeshCollider::Benchmark(stageMeshes);
+			}
+			if (ImGui::Button("Run Texture Load Benchmark")) {
+				// Compares loading from source images against cooked textures, results go to the log
+				TextureCooker::Benchmark();
+			}
+			ImGui::Separator();
 		}
 
 		// Clear the color and depth buffers
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		{
+			PROFILE_GPU_SCOPE("Clear (GPU)");
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		}
 
 		// Draw some ImGui stuff for the lights
 		if (isDebugWindowOpen) {
@@ -1666,9 +1916,19 @@ int main() {
 			}
 			// Split lights from the objects in ImGui
 			ImGui::Separator();
+
+			// Draw object GUIs 
+			scene->DrawAllGameObjectGUIs();
 		}
 
-		dt *= playbackSpeed;
+		// Pick up any events that came in while we were building the UI, and sample input as late as we
+		// can before the simulation. While replaying a recording this also gives us the recorded frame time
+		auto sampleInput = [&](bool pipelined) {
+			glfwPollEvents();
+			dt = InputEngine::BeginFrame(dt);
+			LatencyTracker::MarkInput(pipelined);
+			dt *= playbackSpeed;
+		};
 		/*
 		if (glfwGetKey(window, GLFW_KEY_Q))
 		{
@@ -1681,342 +1941,269 @@ int main() {
 		}
 		*/
 
-		
-
-		// Perform updates for all components
-		scene->Update(dt);
-
-		// Make sure depth testing and culling are re-enabled
-		glEnable(GL_DEPTH_TEST);
-		glEnable(GL_CULL_FACE);
-
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-		// Update our worlds physics!
-		scene->DoPhysics(dt);
+		// Snapshots from another scene are useless, so start over if the scene has been replaced
+		if (scene->GetSerial() != snapshotScene) {
+			physicsSnapshots.Clear();
+			snapshotScene = scene->GetSerial();
 
-		if (arriving)
-		{
-			//arrive(boomerang, player2, dt);
+			// Snapshots are taken after every fixed step, so that frame numbers count simulation steps
+			// rather than rendered frames
+			scene->SetPostStepCallback([&, target = scene.get()](uint64_t step) {
+				if (recordPhysicsSnapshots) {
+					physicsSnapshots.Push(static_cast<btDiscreteDynamicsWorld*>(target->GetPhysicsWorld()), step);
+				}
+			});
 		}
 
-		GameObject::Sptr detachedCam = scene->FindObjectByName("Detached Camera");
-		GameObject::Sptr player1 = scene->FindObjectByName("Player 1");
-
-
-		///////////////Handle some animation stuff////////////////
-		//Note: this code sucks real bad, I need to make this better at some point
+		// Everything that advances the game by a frame. When pipelining, this runs on the simulation thread while
+		// we draw the last frame, so it can't make any GL calls. The scene is captured by value since the UI may
+		// replace it, but only after waiting for the simulation thread
+		auto simulate = [&, scene](float dt) {
+			PROFILE_SCOPE("Simulate");
+			// Perform updates for all components
+			scene->Update(dt);
 
-		if (player1->Get<MorphAnimator>() != nullptr)
-		{
-			//If the player has just jumped, activate the jump anim
-			if (player1->Get<JumpBehaviour>()->IsStartingJump())
-			{
-				player1->Get<MorphAnimator>()->ActivateAnim("Jump");
-			}
+			// Update our worlds physics!
+			scene->DoPhysics(dt);
 
-			//Else if the player is in the air and the jump anim has finished
-			else if (player1->Get<MorphAnimator>()->GetActiveAnim() == "jump" && player1->Get<MorphAnimator>()->IsEndOfClip())
+			if (arriving)
 			{
-				//If the player is moving, then run in the air
-				if (player1->Get<PlayerControl>()->IsMoving())
-					player1->Get<MorphAnimator>()->ActivateAnim("Walk");
-
-				//Else, idle in the air
-				else
-					player1->Get<MorphAnimator>()->ActivateAnim("Idle");
+				//arrive(boomerang, player2, dt);
 			}
 
-			//Else if the player is moving and isn't in the middle of jumping
-			else if (player1->Get<PlayerControl>()->IsMoving() && player1->Get<MorphAnimator>()->GetActiveAnim() != "jump")
-			{
-				//If the player is pressing sprint and isn't already in the running animation
-				if (player1->Get<MorphAnimator>()->GetActiveAnim() != "run" && player1->Get<PlayerControl>()->IsSprinting())
-					player1->Get<MorphAnimator>()->ActivateAnim("Run");
+			GameObject::Sptr player1 = scene->FindObjectByName("Player 1");
 
-				//If the player isn't pressing sprint and isn't already in the walking animation
-				else if (player1->Get<MorphAnimator>()->GetActiveAnim() != "walk" && !player1->Get<PlayerControl>()->IsSprinting())
-					player1->Get<MorphAnimator>()->ActivateAnim("Walk");
-			}
-
-			//Else if the player isn't moving and isn't jumping and isn't already idling
-			else if (!player1->Get<PlayerControl>()->IsMoving() && player1->Get<MorphAnimator>()->GetActiveAnim() != "jump" && player1->Get<MorphAnimator>()->GetActiveAnim() != "Idle")
-			{
-				player1->Get<MorphAnimator>()->ActivateAnim("Idle");
-			}
 
-			//If the player has just jumped, activate the jump anim
-			if (player2->Get<JumpBehaviour>()->IsStartingJump())
-			{
-				player2->Get<MorphAnimator>()->ActivateAnim("Jump");
-			}
+			///////////////Handle some animation stuff////////////////
+			//Note: this code sucks real bad, I need to make this better at some point
 
-			//Else if the player is in the air and the jump anim has finished
-			else if (player2->Get<MorphAnimator>()->GetActiveAnim() == "jump" && player2->Get<MorphAnimator>()->IsEndOfClip())
+			if (player1->Get<MorphAnimator>() != nullptr)
 			{
-				//If the player is moving, then run in the air
-				if (player2->Get<PlayerControl>()->IsMoving())
-					player2->Get<MorphAnimator>()->ActivateAnim("Walk");
-
-				//Else, idle in the air
-				else
-					player2->Get<MorphAnimator>()->ActivateAnim("Idle");
-			}
-
-			//Else if the player is moving and isn't in the middle of jumping
-			else if (player2->Get<PlayerControl>()->IsMoving() && player2->Get<MorphAnimator>()->GetActiveAnim() != "jump")
-			{
-				//If the player is pressing sprint and isn't already in the running animation
-				if (player2->Get<MorphAnimator>()->GetActiveAnim() != "run" && player2->Get<PlayerControl>()->IsSprinting())
-					player2->Get<MorphAnimator>()->ActivateAnim("Run");
-
-				//If the player isn't pressing sprint and isn't already in the walking animation
-				else if (player2->Get<MorphAnimator>()->GetActiveAnim() != "walk" && !player2->Get<PlayerControl>()->IsSprinting())
-					player2->Get<MorphAnimator>()->ActivateAnim("Walk");
-			}
+				//If the player has just jumped, activate the jump anim
+				if (player1->Get<JumpBehaviour>()->IsStartingJump())
+				{
+					player1->Get<MorphAnimator>()->ActivateAnim("Jump");
+				}
 
-			//Else if the player isn't moving and isn't jumping and isn't already idling
-			else if (!player2->Get<PlayerControl>()->IsMoving() && player2->Get<MorphAnimator>()->GetActiveAnim() != "jump" && player2->Get<MorphAnimator>()->GetActiveAnim() != "Idle")
-			{
-				player2->Get<MorphAnimator>()->ActivateAnim("Idle");
-			}
-		}
-		//////////////////////////////////////////////////////////
+				//Else if the player is in the air and the jump anim has finished
+				else if (player1->Get<MorphAnimator>()->GetActiveAnim() == "jump" && player1->Get<MorphAnimator>()->IsEndOfClip())
+				{
+					//If the player is moving, then run in the air
+					if (player1->Get<PlayerControl>()->IsMoving())
+						player1->Get<MorphAnimator>()->ActivateAnim("Walk");
 
-///////////////////////////////////////////////////////////////////////////////////Camera 1 Rendering 
-		glViewport(0, 0, windowSize.x, windowSize.y / 2);
+					//Else, idle in the air
+					else
+						player1->Get<MorphAnimator>()->ActivateAnim("Idle");
+				}
 
-		{;
-		// Grab shorthands to the camera and shader from the scene 
-		Camera::Sptr camera = scene->MainCamera;
-
-		// Cache the camera's viewprojection 
-		glm::mat4 viewProj = camera->GetViewProjection();
-		DebugDrawer::Get().SetViewProjection(viewProj);
-
-		// The current material that is bound for rendering 
-		Material::Sptr currentMat = nullptr;
-		Shader::Sptr shader = nullptr;
-
-		// Bind the skybox texture to a reserved texture slot 
-		// See Material.h and Material.cpp for how we're reserving texture slots 
-		TextureCube::Sptr environment = scene->GetSkyboxTexture();
-		if (environment) environment->Bind(0);
-
-		// Here we'll bind all the UBOs to their corresponding slots 
-		scene->PreRender();
-		frameUniforms->Bind(FRAME_UBO_BINDING);
-		instanceUniforms->Bind(INSTANCE_UBO_BINDING);
-
-		// Upload frame level uniforms 
-		auto& frameData = frameUniforms->GetData();
-		frameData.u_Projection = camera->GetProjection();
-		frameData.u_View = camera->GetView();
-		frameData.u_ViewProjection = camera->GetViewProjection();
-		frameData.u_CameraPos = glm::vec4(camera->GetGameObject()->GetPosition(), 1.0f);
-		frameData.u_Time = static_cast<float>(thisFrame);
-		frameUniforms->Update();
-
-		// Render all our objects 
-		ComponentManager::Each<RenderComponent>([&](const RenderComponent::Sptr& renderable) {
-			// Early bail if mesh not set 
-			if (renderable->GetMesh() == nullptr) {
-				return;
-			}
+				//Else if the player is moving and isn't in the middle of jumping
+				else if (player1->Get<PlayerControl>()->IsMoving() && player1->Get<MorphAnimator>()->GetActiveAnim() != "jump")
+				{
+					//If the player is pressing sprint and isn't already in the running animation
+					if (player1->Get<MorphAnimator>()->GetActiveAnim() != "run" && player1->Get<PlayerControl>()->IsSprinting())
+						player1->Get<MorphAnimator>()->ActivateAnim("Run");
 
-			// If we don't have a material, try getting the scene's fallback material 
-			// If none exists, do not draw anything 
-			if (renderable->GetMaterial() == nullptr) {
-				if (scene->DefaultMaterial != nullptr) {
-					renderable->SetMaterial(scene->DefaultMaterial);
+					//If the player isn't pressing sprint and isn't already in the walking animation
+					else if (player1->Get<MorphAnimator>()->GetActiveAnim() != "walk" && !player1->Get<PlayerControl>()->IsSprinting())
+						player1->Get<MorphAnimator>()->ActivateAnim("Walk");
 				}
-				else {
-					return;
+
+				//Else if the player isn't moving and isn't jumping and isn't already idling
+				else if (!player1->Get<PlayerControl>()->IsMoving() && player1->Get<MorphAnimator>()->GetActiveAnim() != "jump" && player1->Get<MorphAnimator>()->GetActiveAnim() != "Idle")
+				{
+					player1->Get<MorphAnimator>()->ActivateAnim("Idle");
 				}
-			}
 
-			// If the material has changed, we need to bind the new shader and set up our material and frame data 
-			// Note: This is a good reason why we should be sorting the render components in ComponentManager 
-			if (renderable->GetMaterial() != currentMat) {
-				currentMat = renderable->GetMaterial();
-				shader = currentMat->GetShader();
+				//If the player has just jumped, activate the jump anim
+				if (player2->Get<JumpBehaviour>()->IsStartingJump())
+				{
+					player2->Get<MorphAnimator>()->ActivateAnim("Jump");
+				}
 
-				shader->Bind();
-				currentMat->Apply();
-			}
+				//Else if the player is in the air and the jump anim has finished
+				else if (player2->Get<MorphAnimator>()->GetActiveAnim() == "jump" && player2->Get<MorphAnimator>()->IsEndOfClip())
+				{
+					//If the player is moving, then run in the air
+					if (player2->Get<PlayerControl>()->IsMoving())
+						player2->Get<MorphAnimator>()->ActivateAnim("Walk");
 
-			// Grab the game object so we can do some stuff with it 
-			GameObject* object = renderable->GetGameObject();
+					//Else, idle in the air
+					else
+						player2->Get<MorphAnimator>()->ActivateAnim("Idle");
+				}
 
-			// Use our uniform buffer for our instance level uniforms 
-			auto& instanceData = instanceUniforms->GetData();
-			instanceData.u_Model = object->GetTransform();
-			instanceData.u_ModelViewProjection = viewProj * object->GetTransform();
-			instanceData.u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(object->GetTransform())));
-			instanceUniforms->Update();
+				//Else if the player is moving and isn't in the middle of jumping
+				else if (player2->Get<PlayerControl>()->IsMoving() && player2->Get<MorphAnimator>()->GetActiveAnim() != "jump")
+				{
+					//If the player is pressing sprint and isn't already in the running animation
+					if (player2->Get<MorphAnimator>()->GetActiveAnim() != "run" && player2->Get<PlayerControl>()->IsSprinting())
+						player2->Get<MorphAnimator>()->ActivateAnim("Run");
 
-			// Draw the object 
-			renderable->GetMesh()->Draw();
-			});
+					//If the player isn't pressing sprint and isn't already in the walking animation
+					else if (player2->Get<MorphAnimator>()->GetActiveAnim() != "walk" && !player2->Get<PlayerControl>()->IsSprinting())
+						player2->Get<MorphAnimator>()->ActivateAnim("Walk");
+				}
 
+				//Else if the player isn't moving and isn't jumping and isn't already idling
+				else if (!player2->Get<PlayerControl>()->IsMoving() && player2->Get<MorphAnimator>()->GetActiveAnim() != "jump" && player2->Get<MorphAnimator>()->GetActiveAnim() != "Idle")
+				{
+					player2->Get<MorphAnimator>()->ActivateAnim("Idle");
+				}
+			}
+			//////////////////////////////////////////////////////////
 		};
-		// Use our cubemap to draw our skybox 
-		scene->DrawSkybox(scene->MainCamera);
 
-		VertexArrayObject::Unbind();
+		// Physics debug drawing reads the physics world while we draw, so those frames can't be pipelined
+		bool pipelineFrame = pipelineSimulation && physicsDebugMode == BulletDebugMode::None;
+		// When pipelining, the simulation overlaps the frame, so we report the one we waited on at the top of the frame
+		float simulateMs = simulationThread.GetLastWorkMs();
+		if (!pipelineFrame) {
+			sampleInput(false);
+			auto simulateStart = std::chrono::high_resolution_clock::now();
+			simulate(dt);
+			simulateMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - simulateStart).count();
+		}
 
-		GameObject::Sptr detachedCam2 = scene->FindObjectByName("Detached Camera 2");
-		GameObject::Sptr player2 = scene->FindObjectByName("Player 2");
+		// Copy out everything we need to draw, after this the scene is free to move on to the next frame
+		scene->UpdateTextureStreaming({ windowSize.x, windowSize.y / 2 });
+		renderSnapshot.Extract(*scene, { windowSize.x, windowSize.y / 2 });
 
-		//detachedCam2->SetPosition(player2->GetPosition()); 
+		if (pipelineFrame) {
+			sampleInput(true);
+			simulationThread.Kick([simulate, dt]() { simulate(dt); });
+		}
 
-		// Disable culling 
-		glDisable(GL_CULL_FACE);
-		// Disable depth testing, we're going to use order-dependant layering 
-		glDisable(GL_DEPTH_TEST);
-		// Disable depth writing 
-		glDepthMask(GL_FALSE);
+		// Everything from here until the frame is presented counts as rendering
+		auto renderStart = std::chrono::high_resolution_clock::now();
 
-		// Enable alpha blending 
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		// Upload any texture mips that have finished loading
+		TextureStreamer::Update();
 
-		// Our projection matrix will be our entire window for now 
-		glm::mat4 proj = glm::ortho(0.0f, (float)windowSize.x, (float)windowSize.y / 2, 0.f, -1.0f, 1.0f);
-		GuiBatcher::SetProjection(proj);
-		GuiBatcher::SetWindowSize({ windowSize.x, (float)windowSize.y / 2 });
+		// Make sure depth testing and culling are re-enabled
+		glEnable(GL_DEPTH_TEST);
+		glEnable(GL_CULL_FACE);
 
-		// Iterate over and render all the GUI objects 
-		scene->RenderGUI(1);
+		// Draws one of the snapshot's views into the current viewport, this must only read from the snapshot
+		// (or scene state the simulation doesn't touch) since the scene may be simulating at the same time
+		auto renderView = [&](int viewIndex) {
+			const RenderSnapshot::ViewState& view = renderSnapshot.GetView(viewIndex);
+			if (!view.IsValid) {
+				return;
+			}
 
-		// Flush the Gui Batch renderer 
-		GuiBatcher::Flush();
+			DebugDrawer::Get().SetViewProjection(view.ViewProjection);
 
-		// Disable alpha blending 
-		glDisable(GL_BLEND);
-		// Disable scissor testing 
-		glDisable(GL_SCISSOR_TEST);
-		// Re-enable depth writing 
-		glDepthMask(GL_TRUE);
-		glEnable(GL_DEPTH_TEST);
-		glEnable(GL_CULL_FACE);
+			// The current material that is bound for rendering 
+			Material::Sptr currentMat = nullptr;
+			Shader::Sptr shader = nullptr;
 
+			// Bind the skybox texture to a reserved texture slot 
+			// See Material.h and Material.cpp for how we're reserving texture slots 
+			TextureCube::Sptr environment = scene->GetSkyboxTexture();
+			if (environment) environment->Bind(0);
 
-		//split the screen 
-		glViewport(0, windowSize.y / 2, windowSize.x, windowSize.y / 2);
+			// Here we'll bind all the UBOs to their corresponding slots 
+			scene->PreRender();
+			frameUniforms->Bind(FRAME_UBO_BINDING);
+			instanceUniforms->Bind(INSTANCE_UBO_BINDING);
 
-		/////////////////////////////////////////////////////////////////////////////////Camera 2 Rendering 
-		{;
-
-		glm::mat4 viewProj2 = scene->MainCamera->GetViewProjection();
-		// Grab shorthands to the camera and shader from the scene 
-		Camera::Sptr camera = scene->MainCamera2;
-
-		// Cache the camera's viewprojection 
-		glm::mat4 viewProj = camera->GetViewProjection();
-		DebugDrawer::Get().SetViewProjection(viewProj);
-
-		// The current material that is bound for rendering 
-		Material::Sptr currentMat = nullptr;
-		Shader::Sptr shader = nullptr;
-
-		// Bind the skybox texture to a reserved texture slot 
-		// See Material.h and Material.cpp for how we're reserving texture slots 
-		TextureCube::Sptr environment = scene->GetSkyboxTexture();
-		if (environment) environment->Bind(1);
-
-		// Here we'll bind all the UBOs to their corresponding slots 
-		scene->PreRender();
-		frameUniforms->Bind(FRAME_UBO_BINDING);
-		instanceUniforms->Bind(INSTANCE_UBO_BINDING);
-
-		// Upload frame level uniforms 
-		auto& frameData = frameUniforms->GetData();
-		frameData.u_Projection = camera->GetProjection();
-		frameData.u_View = camera->GetView();
-		frameData.u_ViewProjection = camera->GetViewProjection();
-		frameData.u_CameraPos = glm::vec4(camera->GetGameObject()->GetPosition(), 1.0f);
-		frameData.u_Time = static_cast<float>(thisFrame);
-		frameUniforms->Update();
-
-		// Render all our objects 
-		ComponentManager::Each<RenderComponent>([&](const RenderComponent::Sptr& renderable) {
-			// Early bail if mesh not set 
-			if (renderable->GetMesh() == nullptr) {
-				return;
-			}
+			// Upload frame level uniforms 
+			auto& frameData = frameUniforms->GetData();
+			frameData.u_Projection = view.Projection;
+			frameData.u_View = view.View;
+			frameData.u_ViewProjection = view.ViewProjection;
+			frameData.u_CameraPos = glm::vec4(view.Position, 1.0f);
+			frameData.u_Time = static_cast<float>(thisFrame);
+			frameUniforms->Update();
 
-			// If we don't have a material, try getting the scene's fallback material 
-			// If none exists, do not draw anything 
-			if (renderable->GetMaterial() == nullptr) {
-				if (scene->DefaultMaterial != nullptr) {
-					renderable->SetMaterial(scene->DefaultMaterial);
-				}
-				else {
-					return;
+			// Render all our objects, the snapshot has them sorted by batch key already
+			{
+				PROFILE_SCOPE("Opaque Draws");
+				PROFILE_GPU_SCOPE("Opaque Draws (GPU)");
+				for (const RenderSnapshot::DrawItem& item : renderSnapshot.GetItems()) {
+					// Morphed meshes need their frames bound, and the blend is stored in the material so it needs to be applied again
+					if (item.IsMorphed) {
+						MorphAnimator::ApplyMorph(item.Morph, item.Mesh, item.Material);
+						currentMat = nullptr;
+					}
+
+					// If the material has changed, we need to bind the new shader and set up our material and frame data 
+					// Materials in the same batch only differ by texture layer, so we can skip applying them 
+					if (item.Material != currentMat) {
+						bool isSameBatch = currentMat != nullptr && currentMat->GetBatchKey() == item.BatchKey && currentMat->IsSameBatch(*item.Material);
+						currentMat = item.Material;
+						if (!isSameBatch) {
+							shader = currentMat->GetShader();
+
+							shader->Bind();
+							currentMat->Apply();
+						}
+					}
+
+					// Use our uniform buffer for our instance level uniforms 
+					auto& instanceData = instanceUniforms->GetData();
+					instanceData.u_Model = item.Transform;
+					instanceData.u_ModelViewProjection = view.ViewProjection * item.Transform;
+					instanceData.u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(item.Transform)));
+					instanceData.u_TextureLayer = currentMat->GetTextureLayer();
+					instanceUniforms->Update();
+
+					// Draw the object 
+					item.Mesh->Draw();
 				}
 			}
 
-			// If the material has changed, we need to bind the new shader and set up our material and frame data 
-			// Note: This is a good reason why we should be sorting the render components in ComponentManager 
-			if (renderable->GetMaterial() != currentMat) {
-				currentMat = renderable->GetMaterial();
-				shader = currentMat->GetShader();
-
-				shader->Bind();
-				currentMat->Apply();
+			if (!pipelineFrame) {
+				scene->DrawPhysicsDebug();
 			}
 
-			// Grab the game object so we can do some stuff with it 
-			GameObject* object = renderable->GetGameObject();
-
-			// Use our uniform buffer for our instance level uniforms 
-			auto& instanceData = instanceUniforms->GetData();
-			instanceData.u_Model = object->GetTransform();
-			instanceData.u_ModelViewProjection = viewProj * object->GetTransform();
-			instanceData.u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(object->GetTransform())));
-			instanceUniforms->Update();
-
-			// Draw the object 
-			renderable->GetMesh()->Draw();
-			});
+			// Use our cubemap to draw our skybox 
+			scene->DrawSkybox(view.View, view.Projection);
+
+			VertexArrayObject::Unbind();
+
+			// Disable culling 
+			glDisable(GL_CULL_FACE);
+			// Disable depth testing, we're going to use order-dependant layering 
+			glDisable(GL_DEPTH_TEST);
+			// Disable depth writing 
+			glDepthMask(GL_FALSE);
+
+			// Enable alpha blending 
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+			// Draw the GUI that was recorded with the snapshot 
+			GuiBatcher::Submit(view.Gui);
+
+			// Disable alpha blending 
+			glDisable(GL_BLEND);
+			// Disable scissor testing 
+			glDisable(GL_SCISSOR_TEST);
+			// Re-enable depth writing 
+			glDepthMask(GL_TRUE);
+			glEnable(GL_DEPTH_TEST);
+			glEnable(GL_CULL_FACE);
 		};
 
-		// Draw object GUIs 
-		if (isDebugWindowOpen) {
-			scene->DrawAllGameObjectGUIs();
+///////////////////////////////////////////////////////////////////////////////////Camera 1 Rendering 
+		glViewport(0, 0, windowSize.x, windowSize.y / 2);
+		{
+			PROFILE_SCOPE("Viewport 1");
+			PROFILE_GPU_SCOPE("Viewport 1 (GPU)");
+			renderView(0);
 		}
 
-		// Use our cubemap to draw our skybox 
-		scene->DrawSkybox(scene->MainCamera2);
-
-		// Disable culling 
-		glDisable(GL_CULL_FACE);
-		// Disable depth testing, we're going to use order-dependant layering 
-		glDisable(GL_DEPTH_TEST);
-		// Disable depth writing 
-		glDepthMask(GL_FALSE);
-
-		// Enable alpha blending 
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-		GuiBatcher::SetProjection(proj);
-		GuiBatcher::SetWindowSize({ windowSize.x, (float)windowSize.y / 2 });
-
-		// Iterate over and render all the GUI objects 
-		scene->RenderGUI(2);
-
-		// Flush the Gui Batch renderer 
-		GuiBatcher::Flush();
+		//split the screen 
+		glViewport(0, windowSize.y / 2, windowSize.x, windowSize.y / 2);
 
-		// Disable alpha blending 
-		glDisable(GL_BLEND);
-		// Disable scissor testing 
-		glDisable(GL_SCISSOR_TEST);
-		// Re-enable depth writing 
-		glDepthMask(GL_TRUE);
+		/////////////////////////////////////////////////////////////////////////////////Camera 2 Rendering 
+		{
+			PROFILE_SCOPE("Viewport 2");
+			PROFILE_GPU_SCOPE("Viewport 2 (GPU)");
+			renderView(1);
+		}
 
 		////////////////////////////////////////////////////////////////////////// END RENDERING 
 		// End our ImGui window
@@ -2025,14 +2212,43 @@ int main() {
 		VertexArrayObject::Unbind();
 
 		lastFrame = thisFrame;
-		ImGuiHelper::EndFrame();
-		InputEngine::EndFrame();
-		glfwSwapBuffers(window);
+		{
+			PROFILE_SCOPE("ImGui");
+			PROFILE_GPU_SCOPE("ImGui (GPU)");
+			ImGuiHelper::EndFrame();
+		}
+		{
+			PROFILE_SCOPE("Present");
+			FramePacer::Present(window);
+		}
+		FrameTelemetry::EndFrame(simulateMs, std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - renderStart).count());
+
+		if (traceStartup) {
+			Profiler::EndCapture("startup_trace.json");
+			traceStartup = false;
+		}
+		LatencyTracker::MarkSwap();
 	}
 
+	// Let the last pipelined frame finish before we start tearing things down
+	simulationThread.Stop();
+
+	// Make sure a recording that was still running when the window closed gets written out
+	InputEngine::StopRecording();
+
+	// Write out how the session ran, so it can be compared between builds
+	FrameTelemetry::SaveSummary("frame_telemetry.json");
+
 	// Clean up the ImGui library
 	ImGuiHelper::Cleanup();
 
+	// The simulation thread is stopped, so nothing can be recording anymore
+	GpuProfiler::Cleanup();
+	Profiler::Cleanup();
+
+	// Stop streaming textures before the resource manager releases them
+	TextureStreamer::Cleanup();
+
 	// Clean up the resource manager
 	ResourceManager::Cleanup();
 